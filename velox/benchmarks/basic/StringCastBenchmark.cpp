@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/benchmarks/ExpressionBenchmarkBuilder.h"
+
+using namespace facebook;
+
+using namespace facebook::velox;
+
+// Measures casts from VARCHAR to fixed width types, one benchmark set per
+// target type. Each set has canonical input that the batch parsers in
+// FastStringConversion.h convert, input with surrounding white space that goes
+// through the per-row cast, and canonical input with every 10th row invalid.
+int main(int argc, char** argv) {
+  folly::Init init(&argc, &argv);
+  memory::MemoryManager::initialize(memory::MemoryManager::Options{});
+
+  ExpressionBenchmarkBuilder benchmarkBuilder;
+  const vector_size_t vectorSize = 10'000;
+  auto vectorMaker = benchmarkBuilder.vectorMaker();
+
+  auto makeInput = [&](auto format) {
+    auto canonical = vectorMaker.flatVector<std::string>(
+        vectorSize, [&](auto row) { return format(row); });
+    auto padded = vectorMaker.flatVector<std::string>(
+        vectorSize, [&](auto row) { return fmt::format(" {} ", format(row)); });
+    auto mixed = vectorMaker.flatVector<std::string>(vectorSize, [&](auto row) {
+      return row % 10 == 0 ? std::string("n/a") : format(row);
+    });
+    return vectorMaker.rowVector(
+        {"canonical", "padded", "mixed"}, {canonical, padded, mixed});
+  };
+
+  auto addCasts = [&](const std::string& name,
+                      const RowVectorPtr& input,
+                      const std::string& type) {
+    benchmarkBuilder.addBenchmarkSet(name, input)
+        .addExpression(
+            "cast_canonical", fmt::format("cast(canonical as {})", type))
+        .addExpression(
+            "try_cast_padded", fmt::format("try_cast(padded as {})", type))
+        .addExpression(
+            "try_cast_mixed", fmt::format("try_cast(mixed as {})", type))
+        .withIterations(100)
+        .disableTesting();
+  };
+
+  addCasts(
+      "cast_varchar_as_tinyint",
+      makeInput([](auto row) { return std::to_string(row % 256 - 128); }),
+      "tinyint");
+  addCasts(
+      "cast_varchar_as_integer",
+      makeInput([](auto row) { return std::to_string(row * 7'919 - 40'000); }),
+      "integer");
+  addCasts(
+      "cast_varchar_as_bigint",
+      makeInput([](auto row) {
+        return std::to_string(row * 1'000'000'007LL - 5'000'000'000'000LL);
+      }),
+      "bigint");
+  addCasts(
+      "cast_varchar_as_double",
+      makeInput([](auto row) { return fmt::format("{}.{}", row, row % 97); }),
+      "double");
+  addCasts(
+      "cast_varchar_as_date",
+      makeInput([](auto row) {
+        return fmt::format(
+            "{}-{:02d}-{:02d}", 1990 + row % 40, 1 + row % 12, 1 + row % 28);
+      }),
+      "date");
+  addCasts(
+      "cast_varchar_as_timestamp",
+      makeInput([](auto row) {
+        return fmt::format(
+            "{}-{:02d}-{:02d} {:02d}:{:02d}:{:02d}.{:03d}",
+            1990 + row % 40,
+            1 + row % 12,
+            1 + row % 28,
+            row % 24,
+            row % 60,
+            row * 7 % 60,
+            row % 1'000);
+      }),
+      "timestamp");
+
+  benchmarkBuilder.registerBenchmarks();
+  folly::runBenchmarks();
+  return 0;
+}
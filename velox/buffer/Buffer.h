@@ -460,7 +460,9 @@ class AlignedBuffer : public Buffer {
       // called the constructors
       newBuffer->size_ = size;
       *buffer = std::move(newBuffer);
-    } else if (!old->unique()) {
+    } else if (
+        !old->unique() ||
+        !reinterpret_cast<AlignedBuffer*>(old)->ownsAllocation()) {
       auto newBuffer = allocate<T>(numElements, pool);
       newBuffer->copyFrom(old, std::min(size, old->size()));
       reinterpret_cast<AlignedBuffer*>(newBuffer.get())
@@ -568,6 +570,13 @@ class AlignedBuffer : public Buffer {
     return false;
   }
 
+  /// Returns true if 'this' is a separate allocation from pool() that
+  /// pool()->reallocate() can resize. False if 'this' is carved out of a
+  /// larger allocation, e.g. a chunk of a BufferArena.
+  virtual bool ownsAllocation() const {
+    return true;
+  }
+
  protected:
   AlignedBuffer(velox::memory::MemoryPool* pool, size_t capacity)
       : Buffer{
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/buffer/BufferArena.h"
+
+#include <atomic>
+
+namespace facebook::velox {
+namespace {
+// Size of the chunk header and of the chunk pointer before each buffer. Keeps
+// the data of the buffers aligned like that of AlignedBuffers from a pool.
+constexpr uint64_t kHeaderSize = AlignedBuffer::kAlignment;
+} // namespace
+
+// A chunk starts with this header. Each buffer in the chunk is preceded by a
+// pointer to the chunk, followed by the AlignedBuffer header and the data.
+struct BufferArena::Chunk {
+  Chunk(memory::MemoryPool* _pool, uint64_t _size) : pool(_pool), size(_size) {
+    static_assert(sizeof(Chunk) <= kHeaderSize);
+  }
+
+  void addRef() {
+    numRefs.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Frees the chunk to 'pool' when the last reference is released.
+  void release() {
+    if (numRefs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      auto* chunkPool = pool;
+      const auto chunkSize = size;
+      this->~Chunk();
+      chunkPool->free(this, chunkSize);
+    }
+  }
+
+  // True if no buffer in the chunk is alive.
+  bool empty() const {
+    return numRefs.load(std::memory_order_acquire) == 1;
+  }
+
+  // The reference of the arena and one per live buffer.
+  std::atomic_int32_t numRefs{1};
+  memory::MemoryPool* const pool;
+  const uint64_t size;
+};
+
+class BufferArena::ArenaBuffer : public AlignedBuffer {
+ public:
+  ArenaBuffer(memory::MemoryPool* pool, size_t capacity)
+      : AlignedBuffer(pool, capacity) {}
+
+  bool transferTo(memory::MemoryPool* pool) override {
+    // The memory is accounted to the pool of the chunk.
+    return pool == pool_;
+  }
+
+  bool ownsAllocation() const override {
+    return false;
+  }
+
+ protected:
+  void freeToPool() override {
+    checkEndGuard();
+    auto* chunk = *reinterpret_cast<Chunk**>(
+        reinterpret_cast<char*>(this) - kHeaderSize);
+    chunk->release();
+  }
+};
+
+BufferArena::BufferArena(
+    memory::MemoryPool* pool,
+    uint64_t chunkSize,
+    int32_t maxChunks)
+    : pool_(pool),
+      chunkSize_(chunkSize),
+      maxChunks_(maxChunks),
+      maxBufferSize_(chunkSize / 8) {
+  VELOX_CHECK_NOT_NULL(pool_);
+  // A chunk fits its header and a buffer of 'maxBufferSize_'.
+  VELOX_CHECK_LE(3 * kHeaderSize + maxBufferSize_, chunkSize_);
+  VELOX_CHECK_GT(maxChunks_, 0);
+}
+
+BufferArena::~BufferArena() {
+  for (auto* chunk : chunks_) {
+    chunk->release();
+  }
+}
+
+BufferPtr BufferArena::allocateBytes(uint64_t bytes) {
+  const auto dataSize = bits::roundUp(
+      checkedPlus<uint64_t>(bytes, simd::kPadding), AlignedBuffer::kAlignment);
+  if (dataSize > maxBufferSize_) {
+    return nullptr;
+  }
+  const auto slotSize = 2 * kHeaderSize + dataSize;
+  if (current_ == nullptr || offset_ + slotSize > chunkSize_) {
+    nextChunk();
+  }
+  auto* slot = reinterpret_cast<char*>(current_) + offset_;
+  offset_ += slotSize;
+  *reinterpret_cast<Chunk**>(slot) = current_;
+  current_->addRef();
+  auto* buffer =
+      new (slot + kHeaderSize) ArenaBuffer(pool_, dataSize - simd::kPadding);
+  BufferPtr result(buffer);
+  buffer->setSize(bytes);
+  return result;
+}
+
+void BufferArena::nextChunk() {
+  for (auto* chunk : chunks_) {
+    if (chunk->empty()) {
+      current_ = chunk;
+      offset_ = kHeaderSize;
+      return;
+    }
+  }
+  if (chunks_.size() >= static_cast<size_t>(maxChunks_)) {
+    // The oldest chunk is freed with its last live buffer.
+    chunks_.front()->release();
+    chunks_.erase(chunks_.begin());
+  }
+  current_ = new (pool_->allocate(chunkSize_)) Chunk(pool_, chunkSize_);
+  chunks_.push_back(current_);
+  offset_ = kHeaderSize;
+  ++numChunkAllocations_;
+}
+
+void BufferArena::reset() {
+  if (current_ != nullptr && current_->empty()) {
+    offset_ = kHeaderSize;
+  }
+}
+
+// static
+bool BufferArena::isArenaBuffer(const Buffer& buffer) {
+  return dynamic_cast<const ArenaBuffer*>(&buffer) != nullptr;
+}
+
+} // namespace facebook::velox
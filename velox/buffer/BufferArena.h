@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+#include "velox/buffer/Buffer.h"
+
+namespace facebook::velox {
+
+/// Bump allocator of POD buffers that usually live for one batch, e.g. the
+/// intermediate results of expression evaluation. The buffers are carved out
+/// of chunks allocated from 'pool', so that the pool accounts for a chunk
+/// instead of each buffer. A chunk is reused from its start once all the
+/// buffers in it are freed. A buffer that outlives its batch, e.g. because it
+/// ends up in the output of an operator, stays valid and keeps its chunk
+/// allocated until it is freed.
+///
+/// The buffers are AlignedBuffers and may be used like ones allocated from
+/// 'pool'. reallocate() beyond the capacity moves a buffer to 'pool'.
+///
+/// Not thread-safe, except that the buffers may be freed from any thread.
+class BufferArena {
+ public:
+  static constexpr uint64_t kDefaultChunkSize = 1 << 20;
+
+  /// Allocates chunks of 'chunkSize' bytes from 'pool' and keeps at most
+  /// 'maxChunks' of them. Buffers larger than 1/8 of a chunk are not
+  /// allocated from the arena.
+  explicit BufferArena(
+      memory::MemoryPool* pool,
+      uint64_t chunkSize = kDefaultChunkSize,
+      int32_t maxChunks = 4);
+
+  ~BufferArena();
+
+  BufferArena(const BufferArena&) = delete;
+  BufferArena& operator=(const BufferArena&) = delete;
+
+  /// Returns a buffer of 'numElements' of POD type 'T', initialized to
+  /// 'initValue' if set. Returns nullptr if the buffer is too large for the
+  /// arena, in which case the caller allocates it from the pool.
+  template <typename T>
+  BufferPtr allocate(
+      size_t numElements,
+      const std::optional<T>& initValue = std::nullopt) {
+    static_assert(Buffer::is_pod_like_v<T>);
+    auto buffer = allocateBytes(checkedMultiply(numElements, sizeof(T)));
+    if (buffer != nullptr && initValue.has_value()) {
+      std::fill_n(buffer->asMutable<T>(), numElements, *initValue);
+    }
+    return buffer;
+  }
+
+  /// Marks the end of a batch. Reuses the current chunk from its start if
+  /// none of its buffers is alive.
+  void reset();
+
+  /// Returns true if 'buffer' was allocated from a BufferArena.
+  static bool isArenaBuffer(const Buffer& buffer);
+
+  /// Returns the number of chunks allocated from the pool so far.
+  uint64_t numChunkAllocations() const {
+    return numChunkAllocations_;
+  }
+
+ private:
+  struct Chunk;
+  class ArenaBuffer;
+
+  BufferPtr allocateBytes(uint64_t bytes);
+
+  // Makes a chunk with no live buffers, or a new one, the current chunk.
+  void nextChunk();
+
+  memory::MemoryPool* const pool_;
+  const uint64_t chunkSize_;
+  const int32_t maxChunks_;
+  const uint64_t maxBufferSize_;
+
+  // The chunks of 'this' from oldest to newest. Each holds a reference for
+  // 'this' and one for each live buffer.
+  std::vector<Chunk*> chunks_;
+  Chunk* current_{nullptr};
+  // Offset of the next free byte in 'current_'.
+  uint64_t offset_{0};
+  uint64_t numChunkAllocations_{0};
+};
+
+template <>
+inline BufferPtr BufferArena::allocate<bool>(
+    size_t numElements,
+    const std::optional<bool>& initValue) {
+  return allocate<char>(
+      bits::nbytes(numElements),
+      initValue ? std::optional<char>(*initValue ? -1 : 0) : std::nullopt);
+}
+
+} // namespace facebook::velox
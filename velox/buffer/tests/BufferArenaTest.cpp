@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/buffer/BufferArena.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "velox/common/memory/Memory.h"
+
+namespace facebook::velox::test {
+
+class BufferArenaTest : public ::testing::Test {
+ protected:
+  static constexpr uint64_t kChunkSize = 64 << 10;
+
+  void SetUp() override {
+    pool_ = memoryManager_.addLeafPool("BufferArenaTest");
+  }
+
+  memory::MemoryManager memoryManager_;
+  std::shared_ptr<memory::MemoryPool> pool_;
+};
+
+TEST_F(BufferArenaTest, allocate) {
+  BufferArena arena(pool_.get(), kChunkSize);
+  auto ints = arena.allocate<int64_t>(100, 7);
+  ASSERT_TRUE(BufferArena::isArenaBuffer(*ints));
+  ASSERT_EQ(ints->size(), 100 * sizeof(int64_t));
+  ASSERT_GE(ints->capacity(), ints->size());
+  ASSERT_EQ(ints->pool(), pool_.get());
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(ints->as<char>()) % 64, 0);
+  for (auto i = 0; i < 100; ++i) {
+    ASSERT_EQ(ints->as<int64_t>()[i], 7);
+  }
+
+  auto bits = arena.allocate<bool>(100, true);
+  ASSERT_EQ(bits->size(), bits::nbytes(100));
+  ASSERT_TRUE(bits::isBitSet(bits->as<uint64_t>(), 99));
+
+  // The pool accounts for the chunk, not for each buffer.
+  ASSERT_EQ(pool_->usedBytes(), kChunkSize);
+  ASSERT_EQ(arena.numChunkAllocations(), 1);
+
+  // Too large for the arena.
+  ASSERT_EQ(arena.allocate<char>(kChunkSize / 8), nullptr);
+
+  auto pooled = AlignedBuffer::allocate<char>(10, pool_.get());
+  ASSERT_FALSE(BufferArena::isArenaBuffer(*pooled));
+}
+
+TEST_F(BufferArenaTest, reset) {
+  BufferArena arena(pool_.get(), kChunkSize);
+  const auto* first = arena.allocate<int32_t>(1'000)->as<char>();
+
+  // The buffers of the batch are freed, so the next batch reuses the memory.
+  arena.reset();
+  auto buffer = arena.allocate<int32_t>(1'000);
+  ASSERT_EQ(buffer->as<char>(), first);
+
+  // A live buffer is not overwritten by the next batch.
+  arena.reset();
+  auto next = arena.allocate<int32_t>(1'000);
+  ASSERT_NE(next->as<char>(), buffer->as<char>());
+  ASSERT_EQ(arena.numChunkAllocations(), 1);
+}
+
+TEST_F(BufferArenaTest, escape) {
+  BufferArena arena(pool_.get(), kChunkSize, 2);
+  auto escaped = arena.allocate<int64_t>(100, 1);
+
+  // Fill the first chunk and more with temporaries.
+  for (auto i = 0; i < 100; ++i) {
+    arena.allocate<int64_t>(1'000);
+    arena.reset();
+  }
+  // The second chunk is reused while the first has a live buffer.
+  ASSERT_EQ(arena.numChunkAllocations(), 2);
+  ASSERT_EQ(pool_->usedBytes(), 2 * kChunkSize);
+
+  // The escaped buffer keeps its chunk alive when the arena lets it go.
+  std::vector<BufferPtr> live;
+  for (auto i = 0; i < 10; ++i) {
+    live.push_back(arena.allocate<int64_t>(1'000));
+  }
+  ASSERT_EQ(arena.numChunkAllocations(), 3);
+  ASSERT_EQ(pool_->usedBytes(), 3 * kChunkSize);
+  for (auto i = 0; i < 100; ++i) {
+    ASSERT_EQ(escaped->as<int64_t>()[i], 1);
+  }
+  escaped.reset();
+  ASSERT_EQ(pool_->usedBytes(), 2 * kChunkSize);
+
+  // The buffers outlive the arena.
+  live.resize(1);
+  {
+    BufferArena other(pool_.get(), kChunkSize);
+    live.push_back(other.allocate<int64_t>(10));
+  }
+  ASSERT_EQ(pool_->usedBytes(), 3 * kChunkSize);
+  live.clear();
+  ASSERT_EQ(pool_->usedBytes(), 2 * kChunkSize);
+}
+
+TEST_F(BufferArenaTest, reallocate) {
+  BufferArena arena(pool_.get(), kChunkSize);
+  auto buffer = arena.allocate<int32_t>(10);
+  for (auto i = 0; i < 10; ++i) {
+    buffer->asMutable<int32_t>()[i] = i;
+  }
+
+  // Grows in place within the capacity.
+  auto* data = buffer->as<char>();
+  AlignedBuffer::reallocate<int32_t>(&buffer, 12);
+  ASSERT_EQ(buffer->as<char>(), data);
+  ASSERT_TRUE(BufferArena::isArenaBuffer(*buffer));
+
+  // Moves to the pool beyond the capacity.
+  AlignedBuffer::reallocate<int32_t>(&buffer, 10'000);
+  ASSERT_FALSE(BufferArena::isArenaBuffer(*buffer));
+  ASSERT_EQ(buffer->size(), 10'000 * sizeof(int32_t));
+  for (auto i = 0; i < 10; ++i) {
+    ASSERT_EQ(buffer->as<int32_t>()[i], i);
+  }
+}
+
+TEST_F(BufferArenaTest, freeFromOtherThread) {
+  BufferArena arena(pool_.get(), kChunkSize);
+  std::vector<BufferPtr> buffers;
+  for (auto i = 0; i < 50; ++i) {
+    buffers.push_back(arena.allocate<int64_t>(100));
+  }
+  std::thread thread([&]() { buffers.clear(); });
+  thread.join();
+  arena.reset();
+  arena.allocate<int64_t>(100);
+  ASSERT_EQ(arena.numChunkAllocations(), 1);
+}
+
+} // namespace facebook::velox::test
@@ -35,6 +35,22 @@ void registerVeloxMetrics() {
   DEFINE_HISTOGRAM_METRIC(
       kMetricDriverExecTimeMs, 1'000, 0, 30'000, 50, 90, 99, 100);
 
+  // Tracks the queue time of the drivers run by MultiLevelDriverScheduler by
+  // scheduling level and reports the average, P50, P90 and P99.
+  DEFINE_DYNAMIC_QUANTILE_STAT(
+      kMetricDriverSchedulerQueuedTimeMs,
+      statTypes(StatType::AVG, StatType::COUNT),
+      percentiles(0.5, 0.9, 0.99),
+      slidingWindowsSeconds(60));
+
+  // Tracks the CPU time of the driver runs of MultiLevelDriverScheduler by
+  // scheduling level and reports the average, P50, P90 and P99.
+  DEFINE_DYNAMIC_QUANTILE_STAT(
+      kMetricDriverSchedulerCpuTimeUs,
+      statTypes(StatType::AVG, StatType::COUNT),
+      percentiles(0.5, 0.9, 0.99),
+      slidingWindowsSeconds(60));
+
   // Tracks the averaged task batch processing time. This only applies for
   // sequential task execution mode.
   DEFINE_METRIC(kMetricTaskBatchProcessTimeMs, facebook::velox::StatType::AVG);
@@ -48,6 +64,19 @@ void registerVeloxMetrics() {
   // Tracks the total number of splits received by all tasks.
   DEFINE_METRIC(kMetricTaskSplitsCount, facebook::velox::StatType::COUNT);
 
+  // Tracks the load of TaskAdmissionController in percent of the load at which
+  // it stops admitting new tasks.
+  DEFINE_METRIC(kMetricTaskAdmissionLoadPct, facebook::velox::StatType::AVG);
+
+  // Tracks the time new tasks wait in TaskAdmissionController in range of [0,
+  // 60s] with 60 buckets and reports P50, P90, P99, and P100.
+  DEFINE_HISTOGRAM_METRIC(
+      kMetricTaskAdmissionQueuedTimeMs, 1'000, 0, 60'000, 50, 90, 99, 100);
+
+  // Tracks the number of new tasks rejected by TaskAdmissionController.
+  DEFINE_METRIC(
+      kMetricTaskAdmissionRejectedCount, facebook::velox::StatType::COUNT);
+
   /// ================== Cache Counters =================
 
   // Tracks hive handle generation latency in range of [0, 100s] and reports
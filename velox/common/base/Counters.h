@@ -129,6 +129,12 @@ constexpr std::string_view kMetricDriverQueueTimeMs{
 
 constexpr std::string_view kMetricDriverExecTimeMs{"velox.driver_exec_time_ms"};
 
+constexpr std::string_view kMetricDriverSchedulerQueuedTimeMs{
+    "velox.driver_scheduler_level_{}_queued_time_ms"};
+
+constexpr std::string_view kMetricDriverSchedulerCpuTimeUs{
+    "velox.driver_scheduler_level_{}_cpu_time_us"};
+
 constexpr std::string_view kMetricSpilledInputBytes{"velox.spill_input_bytes"};
 
 constexpr std::string_view kMetricSpilledBytes{"velox.spill_bytes"};
@@ -393,4 +399,13 @@ constexpr std::string_view kMetricTaskBatchProcessTimeMs{
 constexpr std::string_view kMetricTaskBarrierProcessTimeMs{
     "velox.task_barrier_process_time_ms"};
 
+constexpr std::string_view kMetricTaskAdmissionLoadPct{
+    "velox.task_admission_load_pct"};
+
+constexpr std::string_view kMetricTaskAdmissionQueuedTimeMs{
+    "velox.task_admission_queued_time_ms"};
+
+constexpr std::string_view kMetricTaskAdmissionRejectedCount{
+    "velox.task_admission_rejected_count"};
+
 } // namespace facebook::velox
@@ -503,6 +503,14 @@ DECLARE_CHECK_FAIL_TEMPLATES(::facebook::velox::VeloxRuntimeError)
       /* isRetriable */ true,                                       \
       ##__VA_ARGS__)
 
+#define VELOX_TASK_ADMISSION_REJECTED(...)                           \
+  _VELOX_THROW(                                                      \
+      ::facebook::velox::VeloxRuntimeError,                          \
+      ::facebook::velox::error_source::kErrorSourceRuntime.c_str(),  \
+      ::facebook::velox::error_code::kTaskAdmissionRejected.c_str(), \
+      /* isRetriable */ true,                                        \
+      ##__VA_ARGS__)
+
 DECLARE_CHECK_FAIL_TEMPLATES(::facebook::velox::VeloxUserError)
 
 // For all below macros, an additional message can be passed using a
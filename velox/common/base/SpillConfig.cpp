@@ -37,7 +37,13 @@ SpillConfig::SpillConfig(
     uint32_t _numMaxMergeFiles,
     std::optional<PrefixSortConfig> _prefixSortConfig,
     const std::string& _fileCreateConfig,
-    uint32_t _windowMinReadBatchRows)
+    uint32_t _windowMinReadBatchRows,
+    bool _rowFormatEnabled,
+    bool _readAheadEnabled,
+    uint64_t _mergeReadBufferBudget,
+    SpillDiskSet* _diskSet,
+    bool _memoryTierEnabled,
+    bool _adaptiveCompressionEnabled)
     : getSpillDirPathCb(std::move(_getSpillDirPathCb)),
       updateAndCheckSpillLimitCb(std::move(_updateAndCheckSpillLimitCb)),
       fileNamePrefix(std::move(_fileNamePrefix)),
@@ -58,7 +64,13 @@ SpillConfig::SpillConfig(
       numMaxMergeFiles(_numMaxMergeFiles),
       prefixSortConfig(_prefixSortConfig),
       fileCreateConfig(_fileCreateConfig),
-      windowMinReadBatchRows(_windowMinReadBatchRows) {
+      windowMinReadBatchRows(_windowMinReadBatchRows),
+      rowFormatEnabled(_rowFormatEnabled),
+      readAheadEnabled(_readAheadEnabled),
+      mergeReadBufferBudget(_mergeReadBufferBudget),
+      diskSet(_diskSet),
+      memoryTierEnabled(_memoryTierEnabled),
+      adaptiveCompressionEnabled(_adaptiveCompressionEnabled) {
   VELOX_USER_CHECK_GE(
       spillableReservationGrowthPct,
       minSpillableReservationPct,
@@ -96,4 +108,14 @@ bool SpillConfig::exceedSpillLevelLimit(uint8_t startBitOffset) const {
   }
   return spillLevel(startBitOffset) > maxSpillLevel;
 }
+
+uint64_t SpillConfig::mergeReadBufferSize(size_t numFiles) const {
+  if (mergeReadBufferBudget == 0 || numFiles == 0) {
+    return readBufferSize;
+  }
+  // Each file may hold two buffers when read ahead.
+  const uint64_t budgetPerFile = mergeReadBufferBudget / (2 * numFiles);
+  return std::min(
+      readBufferSize, std::max(budgetPerFile, kMinMergeReadBufferSize));
+}
 } // namespace facebook::velox::common
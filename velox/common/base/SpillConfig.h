@@ -21,6 +21,7 @@
 
 #include <folly/executors/CPUThreadPoolExecutor.h>
 #include "velox/common/base/PrefixSortConfig.h"
+#include "velox/common/base/SpillDiskSet.h"
 #include "velox/common/compression/Compression.h"
 
 namespace facebook::velox::common {
@@ -57,6 +58,10 @@ struct SpillDiskOptions {
   std::string spillDirPath;
   bool spillDirCreated{true};
   std::function<std::string()> spillDirCreateCb{nullptr};
+  /// Additional spill directories, typically on other local disks. If set,
+  /// spill files are striped across 'spillDirPath' and these directories. They
+  /// are created and removed together with 'spillDirPath'.
+  std::vector<std::string> stripeDirPaths{};
 };
 
 /// Specifies the config for spilling.
@@ -81,7 +86,13 @@ struct SpillConfig {
       uint32_t numMaxMergeFiles,
       std::optional<PrefixSortConfig> _prefixSortConfig = std::nullopt,
       const std::string& _fileCreateConfig = {},
-      uint32_t _windowMinReadBatchRows = 1'000);
+      uint32_t _windowMinReadBatchRows = 1'000,
+      bool _rowFormatEnabled = false,
+      bool _readAheadEnabled = false,
+      uint64_t _mergeReadBufferBudget = 0,
+      SpillDiskSet* _diskSet = nullptr,
+      bool _memoryTierEnabled = false,
+      bool _adaptiveCompressionEnabled = false);
 
   /// Returns the spilling level with given 'startBitOffset' and
   /// 'numPartitionBits'.
@@ -98,6 +109,17 @@ struct SpillConfig {
     return prefixSortConfig.has_value();
   }
 
+  /// Returns the executor to read spill files ahead on, or nullptr if spill
+  /// reads are not read ahead on file systems without async reads.
+  folly::Executor* readAheadExecutor() const {
+    return readAheadEnabled ? executor : nullptr;
+  }
+
+  /// Returns the read buffer size for each of 'numFiles' spill files that are
+  /// merged at the same time. This is 'readBufferSize' unless the double
+  /// buffers of all files would exceed 'mergeReadBufferBudget'.
+  uint64_t mergeReadBufferSize(size_t numFiles) const;
+
   /// A callback function that returns the spill directory path. Implementations
   /// can use it to ensure the path exists before returning.
   GetSpillDirectoryPathCB getSpillDirPathCb;
@@ -119,8 +141,9 @@ struct SpillConfig {
   uint64_t writeBufferSize;
 
   /// Specifies the buffer size to read from one spilled file. If the underlying
-  /// filesystem supports async read, we do read-ahead with double buffering,
-  /// which doubles the buffer used to read from each spill file.
+  /// filesystem supports async read, or 'readAheadEnabled' is set, we do
+  /// read-ahead with double buffering, which doubles the buffer used to read
+  /// from each spill file.
   uint64_t readBufferSize;
 
   /// Executor for spilling. If nullptr spilling writes on the Driver's thread.
@@ -177,5 +200,34 @@ struct SpillConfig {
 
   /// The minimum number of rows to read when processing spilled window data.
   uint32_t windowMinReadBatchRows;
+
+  /// If true, spillers that support it write the rows of their RowContainer in
+  /// the container's row layout instead of as columnar vectors. Currently
+  /// used by hash join build.
+  bool rowFormatEnabled{false};
+
+  /// If true, the merge of sorted spill files reads the next buffer of each
+  /// file on 'executor' while the current one is consumed. Only applies to
+  /// file systems without async reads, which always read ahead.
+  bool readAheadEnabled{false};
+
+  /// The total read buffer memory in bytes for the spill files merged at the
+  /// same time. The per-file buffer is reduced from 'readBufferSize' to stay
+  /// within it, but not below kMinMergeReadBufferSize. 0 means no limit.
+  uint64_t mergeReadBufferBudget{0};
+
+  static constexpr uint64_t kMinMergeReadBufferSize{64 << 10};
+
+  /// If set, spill files are striped across the directories of this disk set
+  /// instead of being written to the directory from 'getSpillDirPathCb'.
+  SpillDiskSet* diskSet{nullptr}; // Not owned.
+
+  /// If true, spill files are kept in the process wide spill memory tier, if
+  /// initialized, as long as it has capacity before going to disk.
+  bool memoryTierEnabled{false};
+
+  /// If true, the codec of each spilled page is chosen adaptively instead of
+  /// using 'compressionKind'.
+  bool adaptiveCompressionEnabled{false};
 };
 } // namespace facebook::velox::common
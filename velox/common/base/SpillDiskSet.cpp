@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/base/SpillDiskSet.h"
+
+#include <fmt/format.h>
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/base/Fs.h"
+
+namespace facebook::velox::common {
+
+SpillDiskSet::SpillDiskSet(
+    std::vector<std::string> directories,
+    uint64_t minFreeBytes)
+    : directories_(std::move(directories)),
+      minFreeBytes_(minFreeBytes),
+      disks_(directories_.size()) {
+  VELOX_CHECK(!directories_.empty(), "Spill disk set can't be empty");
+}
+
+uint32_t SpillDiskSet::pickDisk() {
+  const uint32_t numDisks = directories_.size();
+  const uint32_t startDisk = nextDisk_++ % numDisks;
+  std::optional<uint32_t> pickedDisk;
+  // The disk with the most free space, used if all disks are nearly full.
+  uint32_t mostFreeDisk{startDisk};
+  uint64_t mostFreeBytes{0};
+  for (uint32_t i = 0; i < numDisks; ++i) {
+    const uint32_t disk = (startDisk + i) % numDisks;
+    const auto free = freeBytes(directories_[disk]);
+    if (free.has_value() && free.value() < minFreeBytes_) {
+      if (free.value() > mostFreeBytes) {
+        mostFreeDisk = disk;
+        mostFreeBytes = free.value();
+      }
+      continue;
+    }
+    if (!pickedDisk.has_value() ||
+        queuedBytes(disk) < queuedBytes(pickedDisk.value())) {
+      pickedDisk = disk;
+    }
+  }
+  return pickedDisk.value_or(mostFreeDisk);
+}
+
+void SpillDiskSet::addQueuedBytes(uint32_t disk, uint64_t bytes) {
+  VELOX_CHECK_LT(disk, disks_.size());
+  disks_[disk].queuedBytes.fetch_add(bytes);
+}
+
+void SpillDiskSet::removeQueuedBytes(uint32_t disk, uint64_t bytes) {
+  VELOX_CHECK_LT(disk, disks_.size());
+  const auto queuedBytes = disks_[disk].queuedBytes.fetch_sub(bytes);
+  VELOX_CHECK_GE(queuedBytes, bytes);
+}
+
+std::optional<uint64_t> SpillDiskSet::freeBytes(
+    const std::string& directory) const {
+  std::error_code ec;
+  const auto info = fs::space(directory, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  return info.available;
+}
+
+/*static*/
+std::string SpillDiskSet::writeBytesStatName(uint32_t disk) {
+  return fmt::format("spillDisk{}WriteBytes", disk);
+}
+
+/*static*/
+std::string SpillDiskSet::writeTimeStatName(uint32_t disk) {
+  return fmt::format("spillDisk{}WriteTimeNanos", disk);
+}
+
+/*static*/
+std::string SpillDiskSet::readBytesStatName(uint32_t disk) {
+  return fmt::format("spillDisk{}ReadBytes", disk);
+}
+
+/*static*/
+std::string SpillDiskSet::readTimeStatName(uint32_t disk) {
+  return fmt::format("spillDisk{}ReadTimeNanos", disk);
+}
+
+} // namespace facebook::velox::common
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace facebook::velox::common {
+
+/// A set of spill directories, one per local disk, that spill files are
+/// striped across. Each new spill file is placed on the disk with the fewest
+/// queued bytes among the disks with enough free space, so that concurrent
+/// spill writes spread over all the disks instead of saturating one. Is thread
+/// safe.
+class SpillDiskSet {
+ public:
+  /// 'directories' are the spill directories, one per disk. The first one is
+  /// the primary spill directory. A disk with less than 'minFreeBytes' free
+  /// space is only picked if all the disks are below it.
+  explicit SpillDiskSet(
+      std::vector<std::string> directories,
+      uint64_t minFreeBytes = kDefaultMinFreeBytes);
+
+  virtual ~SpillDiskSet() = default;
+
+  static constexpr uint64_t kDefaultMinFreeBytes{1UL << 30};
+
+  uint32_t numDisks() const {
+    return directories_.size();
+  }
+
+  const std::string& directory(uint32_t disk) const {
+    return directories_[disk];
+  }
+
+  /// Returns the disk to create the next spill file on.
+  uint32_t pickDisk();
+
+  /// Adds 'bytes' written to a spill file on 'disk' that is not yet closed.
+  void addQueuedBytes(uint32_t disk, uint64_t bytes);
+
+  /// Removes 'bytes' from the queued bytes of 'disk' when a spill file on it
+  /// is closed.
+  void removeQueuedBytes(uint32_t disk, uint64_t bytes);
+
+  uint64_t queuedBytes(uint32_t disk) const {
+    return disks_[disk].queuedBytes;
+  }
+
+  /// Returns the names of the per-disk spill I/O stats.
+  static std::string writeBytesStatName(uint32_t disk);
+  static std::string writeTimeStatName(uint32_t disk);
+  static std::string readBytesStatName(uint32_t disk);
+  static std::string readTimeStatName(uint32_t disk);
+
+ protected:
+  // Returns the free space of the file system of 'directory' in bytes, or
+  // std::nullopt if it is not known, e.g. for a remote file system.
+  virtual std::optional<uint64_t> freeBytes(
+      const std::string& directory) const;
+
+ private:
+  struct Disk {
+    // The bytes written to the spill files on this disk that are still open.
+    std::atomic_uint64_t queuedBytes{0};
+  };
+
+  const std::vector<std::string> directories_;
+  const uint64_t minFreeBytes_;
+  std::vector<Disk> disks_;
+  // Rotates the first disk to consider so that ties are spread evenly.
+  std::atomic_uint32_t nextDisk_{0};
+};
+
+} // namespace facebook::velox::common
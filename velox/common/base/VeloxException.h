@@ -148,6 +148,10 @@ inline constexpr auto kGenericSpillFailure = "GENERIC_SPILL_FAILURE"_fs;
 /// An error raised when trace bytes exceeds limits.
 inline constexpr auto kTraceLimitExceeded = "TRACE_LIMIT_EXCEEDED"_fs;
 
+/// An error raised when a new task is not admitted because the worker is
+/// overloaded.
+inline constexpr auto kTaskAdmissionRejected = "TASK_ADMISSION_REJECTED"_fs;
+
 /// Errors indicating file read corruptions.
 inline constexpr auto kFileCorruption = "FILE_CORRUPTION"_fs;
 
@@ -197,6 +197,60 @@ TEST_P(SpillConfigTest, spillableReservationPercentages) {
   }
 }
 
+TEST_P(SpillConfigTest, mergeReadBufferSize) {
+  struct {
+    uint64_t readBufferSize;
+    uint64_t budget;
+    size_t numFiles;
+    uint64_t expectedSize;
+
+    std::string debugString() const {
+      return fmt::format(
+          "readBufferSize:{}, budget:{}, numFiles:{}, expectedSize:{}",
+          readBufferSize,
+          budget,
+          numFiles,
+          expectedSize);
+    }
+  } testSettings[] = {
+      {1 << 20, 0, 100, 1 << 20},
+      {1 << 20, 64 << 20, 8, 1 << 20},
+      {1 << 20, 64 << 20, 64, 512 << 10},
+      {1 << 20, 64 << 20, 1'000, SpillConfig::kMinMergeReadBufferSize},
+      {32 << 10, 64 << 20, 1'000, 32 << 10},
+      {1 << 20, 64 << 20, 0, 1 << 20}};
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(testData.debugString());
+    const SpillConfig config(
+        []() -> std::string_view { return ""; },
+        [&](uint64_t) {},
+        "fakeSpillPath",
+        0,
+        0,
+        testData.readBufferSize,
+        nullptr,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        0,
+        "none",
+        0,
+        prefixSortConfig_,
+        "",
+        1'000,
+        false,
+        true,
+        testData.budget);
+    ASSERT_EQ(
+        config.mergeReadBufferSize(testData.numFiles), testData.expectedSize);
+    // No executor to read ahead on.
+    ASSERT_EQ(config.readAheadExecutor(), nullptr);
+  }
+}
+
 VELOX_INSTANTIATE_TEST_SUITE_P(
     SpillConfigTest,
     SpillConfigTest,
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/base/SpillDiskSet.h"
+
+#include <gtest/gtest.h>
+#include <unordered_map>
+
+#include "velox/common/base/tests/GTestUtils.h"
+
+namespace facebook::velox::common::test {
+namespace {
+
+// A disk set with settable free space per directory.
+class TestSpillDiskSet : public SpillDiskSet {
+ public:
+  TestSpillDiskSet(std::vector<std::string> directories, uint64_t minFreeBytes)
+      : SpillDiskSet(std::move(directories), minFreeBytes) {}
+
+  void setFreeBytes(uint32_t disk, std::optional<uint64_t> bytes) {
+    freeBytes_[directory(disk)] = bytes;
+  }
+
+ protected:
+  std::optional<uint64_t> freeBytes(
+      const std::string& directory) const override {
+    const auto it = freeBytes_.find(directory);
+    return it == freeBytes_.end() ? std::nullopt : it->second;
+  }
+
+ private:
+  std::unordered_map<std::string, std::optional<uint64_t>> freeBytes_;
+};
+
+TEST(SpillDiskSetTest, empty) {
+  VELOX_ASSERT_THROW(SpillDiskSet({}), "Spill disk set can't be empty");
+}
+
+TEST(SpillDiskSetTest, roundRobinOnTies) {
+  TestSpillDiskSet diskSet({"/d0", "/d1", "/d2"}, 0);
+  ASSERT_EQ(diskSet.numDisks(), 3);
+  for (auto i = 0; i < 9; ++i) {
+    ASSERT_EQ(diskSet.pickDisk(), i % 3);
+  }
+}
+
+TEST(SpillDiskSetTest, leastQueuedBytes) {
+  TestSpillDiskSet diskSet({"/d0", "/d1", "/d2"}, 0);
+  diskSet.addQueuedBytes(0, 100);
+  diskSet.addQueuedBytes(1, 50);
+  diskSet.addQueuedBytes(2, 200);
+  for (auto i = 0; i < 3; ++i) {
+    ASSERT_EQ(diskSet.pickDisk(), 1);
+  }
+  diskSet.addQueuedBytes(1, 100);
+  ASSERT_EQ(diskSet.pickDisk(), 0);
+  diskSet.removeQueuedBytes(2, 200);
+  ASSERT_EQ(diskSet.queuedBytes(2), 0);
+  ASSERT_EQ(diskSet.pickDisk(), 2);
+  VELOX_ASSERT_THROW(diskSet.removeQueuedBytes(2, 1), "");
+}
+
+TEST(SpillDiskSetTest, freeSpace) {
+  constexpr uint64_t kMinFreeBytes = 1'000;
+  TestSpillDiskSet diskSet({"/d0", "/d1", "/d2"}, kMinFreeBytes);
+  // Disks 0 and 2 are nearly full and disk 1 has unknown free space.
+  diskSet.setFreeBytes(0, 10);
+  diskSet.setFreeBytes(2, 20);
+  diskSet.addQueuedBytes(1, 1'000'000);
+  for (auto i = 0; i < 3; ++i) {
+    ASSERT_EQ(diskSet.pickDisk(), 1);
+  }
+
+  // All disks are nearly full. Picks the one with the most free space.
+  diskSet.setFreeBytes(1, 5);
+  for (auto i = 0; i < 3; ++i) {
+    ASSERT_EQ(diskSet.pickDisk(), 2);
+  }
+
+  diskSet.setFreeBytes(0, kMinFreeBytes);
+  ASSERT_EQ(diskSet.pickDisk(), 0);
+}
+
+TEST(SpillDiskSetTest, statNames) {
+  ASSERT_EQ(SpillDiskSet::writeBytesStatName(1), "spillDisk1WriteBytes");
+  ASSERT_EQ(SpillDiskSet::writeTimeStatName(2), "spillDisk2WriteTimeNanos");
+  ASSERT_EQ(SpillDiskSet::readBytesStatName(0), "spillDisk0ReadBytes");
+  ASSERT_EQ(SpillDiskSet::readTimeStatName(3), "spillDisk3ReadTimeNanos");
+}
+
+} // namespace
+} // namespace facebook::velox::common::test
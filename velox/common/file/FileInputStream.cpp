@@ -16,17 +16,24 @@
 
 #include "velox/common/file/FileInputStream.h"
 
+#include <folly/futures/Future.h>
+
 namespace facebook::velox::common {
 
 FileInputStream::FileInputStream(
     std::unique_ptr<ReadFile>&& file,
     uint64_t bufferSize,
-    memory::MemoryPool* pool)
+    memory::MemoryPool* pool,
+    folly::Executor* readAheadExecutor)
     : file_(std::move(file)),
       fileSize_(file_->size()),
       bufferSize_(std::min(fileSize_, bufferSize)),
       pool_(pool),
-      readAheadEnabled_((bufferSize_ < fileSize_) && file_->hasPreadvAsync()) {
+      readAheadExecutor_(
+          file_->hasPreadvAsync() ? nullptr : readAheadExecutor),
+      readAheadEnabled_(
+          (bufferSize_ < fileSize_) &&
+          (file_->hasPreadvAsync() || readAheadExecutor_ != nullptr)) {
   VELOX_CHECK_NOT_NULL(pool_);
   VELOX_CHECK_GT(fileSize_, 0, "Empty FileInputStream");
 
@@ -214,6 +221,22 @@ void FileInputStream::maybeIssueReadahead() {
   if (size == 0) {
     return;
   }
+  if (readAheadExecutor_ != nullptr) {
+    // The destructor waits for the read, so 'this' outlives it.
+    readAheadWait_ =
+        folly::via(
+            readAheadExecutor_,
+            [this,
+             offset = fileOffset_,
+             size,
+             buffer = nextBuffer()->asMutable<char>()]() -> uint64_t {
+              file_->pread(offset, size, buffer);
+              return size;
+            })
+            .semi();
+    VELOX_CHECK(readAheadWait_.valid());
+    return;
+  }
   std::vector<folly::Range<char*>> ranges;
   ranges.emplace_back(nextBuffer()->asMutable<char>(), size);
   readAheadWait_ = file_->preadvAsync(fileOffset_, ranges);
@@ -27,10 +27,15 @@ namespace facebook::velox::common {
 /// Readonly byte input stream backed by file.
 class FileInputStream : public ByteInputStream {
  public:
+  /// Reads 'file' in chunks of 'bufferSize'. If the file system supports async
+  /// reads, or 'readAheadExecutor' is set, the next chunk is read ahead into a
+  /// second buffer while the current one is consumed. 'readAheadExecutor' runs
+  /// the synchronous read-ahead for file systems without async reads.
   FileInputStream(
       std::unique_ptr<ReadFile>&& file,
       uint64_t bufferSize,
-      memory::MemoryPool* pool);
+      memory::MemoryPool* pool,
+      folly::Executor* readAheadExecutor = nullptr);
 
   ~FileInputStream() override;
 
@@ -77,10 +82,8 @@ class FileInputStream : public ByteInputStream {
   // Invoked to read the next byte range from the file in a buffer.
   void readNextRange();
 
-  // Issues readahead if underlying file system supports async mode read.
-  //
-  // TODO: we might consider to use AsyncSource to support read-ahead on
-  // filesystem which doesn't support async mode read.
+  // Issues readahead if underlying file system supports async mode read, or
+  // on 'readAheadExecutor_' otherwise.
   void maybeIssueReadahead();
 
   inline uint64_t readSize() const;
@@ -112,6 +115,8 @@ class FileInputStream : public ByteInputStream {
   const uint64_t fileSize_;
   const uint64_t bufferSize_;
   memory::MemoryPool* const pool_;
+  // Set if read-ahead is done by synchronous reads on this executor.
+  folly::Executor* const readAheadExecutor_;
   const bool readAheadEnabled_;
 
   // Offset of the next byte to read from file.
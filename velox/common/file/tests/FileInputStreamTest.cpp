@@ -21,6 +21,7 @@
 #include "velox/common/memory/MmapAllocator.h"
 #include "velox/common/testutil/TempDirectoryPath.h"
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 
 using namespace facebook::velox;
@@ -51,7 +52,8 @@ class FileInputStreamTest : public testing::Test {
 
   std::unique_ptr<common::FileInputStream> createStream(
       uint64_t streamSize,
-      uint32_t bufferSize = 1024) {
+      uint32_t bufferSize = 1024,
+      folly::Executor* readAheadExecutor = nullptr) {
     const auto filePath =
         fmt::format("{}/{}", tempDirPath_->getPath(), fileId_++);
     auto writeFile = fs_->openFileForWrite(filePath);
@@ -63,7 +65,10 @@ class FileInputStreamTest : public testing::Test {
         std::string_view(reinterpret_cast<char*>(buffer.data()), streamSize));
     writeFile->close();
     return std::make_unique<common::FileInputStream>(
-        fs_->openFileForRead(filePath), bufferSize, pool_.get());
+        fs_->openFileForRead(filePath),
+        bufferSize,
+        pool_.get(),
+        readAheadExecutor);
   }
 
   folly::Random::DefaultGenerator rng_;
@@ -112,3 +117,43 @@ TEST_F(FileInputStreamTest, stats) {
     ASSERT_GT(byteStream->stats().readTimeNs, 0);
   }
 }
+
+TEST_F(FileInputStreamTest, readAheadOnExecutor) {
+  folly::CPUThreadPoolExecutor executor(2);
+  struct {
+    size_t streamSize;
+    size_t bufferSize;
+
+    std::string debugString() const {
+      return fmt::format(
+          "streamSize {}, bufferSize {}", streamSize, bufferSize);
+    }
+  } testSettings[] = {
+      {4096, 1024}, {4096, 4096}, {4096, 1000}, {10'000, 3'000}};
+
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(testData.debugString());
+
+    auto byteStream =
+        createStream(testData.streamSize, testData.bufferSize, &executor);
+    std::vector<uint8_t> buffer(testData.streamSize / 8);
+    for (int offset = 0; offset < testData.streamSize;) {
+      const auto size =
+          std::min<int32_t>(buffer.size(), testData.streamSize - offset);
+      byteStream->readBytes(buffer.data(), size);
+      for (int i = 0; i < size; ++i, ++offset) {
+        ASSERT_EQ(buffer[i], offset % 256);
+      }
+    }
+    ASSERT_TRUE(byteStream->atEnd());
+    ASSERT_EQ(
+        byteStream->stats().numReads,
+        bits::roundUp(testData.streamSize, testData.bufferSize) /
+            testData.bufferSize);
+    ASSERT_EQ(byteStream->stats().readBytes, testData.streamSize);
+  }
+
+  // Destroying the stream with a read-ahead in flight waits for it.
+  auto byteStream = createStream(4096, 1024, &executor);
+  byteStream.reset();
+}
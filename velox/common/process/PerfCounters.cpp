@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/common/process/PerfCounters.h"
+
+#include <memory>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace facebook::velox::process {
+
+// static
+PerfCounters* PerfCounters::forThread() {
+  thread_local bool opened = false;
+  thread_local std::unique_ptr<PerfCounters> counters;
+  if (!opened) {
+    opened = true;
+    counters.reset(new PerfCounters());
+    if (!counters->open()) {
+      counters.reset();
+    }
+  }
+  return counters.get();
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+  for (auto fd : fds_) {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+  }
+#endif
+}
+
+bool PerfCounters::open() {
+#ifdef __linux__
+  constexpr uint64_t kConfigs[kNumEvents] = {
+      PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES,
+      PERF_COUNT_HW_BRANCH_MISSES};
+  for (auto i = 0; i < kNumEvents; ++i) {
+    struct perf_event_attr attr {};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = kConfigs[i];
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+        PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // The group starts disabled and is enabled once all events are in it.
+    attr.disabled = i == 0;
+    fds_[i] = syscall(
+        __NR_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds_[0], 0);
+    if (fds_[i] < 0) {
+      return false;
+    }
+  }
+  return ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) == 0;
+#else
+  return false;
+#endif
+}
+
+PerfCounters::Values PerfCounters::read() const {
+#ifdef __linux__
+  struct {
+    uint64_t numEvents;
+    uint64_t timeEnabled;
+    uint64_t timeRunning;
+    uint64_t values[kNumEvents];
+  } data{};
+  if (::read(fds_[0], &data, sizeof(data)) != sizeof(data)) {
+    return {};
+  }
+  return {
+      data.values[0],
+      data.values[1],
+      data.values[2],
+      data.values[3],
+      data.timeEnabled,
+      data.timeRunning};
+#else
+  return {};
+#endif
+}
+
+// static
+PerfCounters::Values PerfCounters::delta(
+    const Values& start,
+    const Values& end) {
+  const auto difference = [](uint64_t startValue, uint64_t endValue) {
+    return endValue > startValue ? endValue - startValue : 0;
+  };
+  Values result;
+  result.timeEnabled = difference(start.timeEnabled, end.timeEnabled);
+  result.timeRunning = difference(start.timeRunning, end.timeRunning);
+  if (result.timeRunning == 0) {
+    return result;
+  }
+  // Scaling by the times in between, rather than since the counters were
+  // opened, keeps a change of multiplexing from applying to earlier counts.
+  const double scale = result.timeRunning < result.timeEnabled
+      ? static_cast<double>(result.timeEnabled) / result.timeRunning
+      : 1;
+  const auto scaled = [&](uint64_t startValue, uint64_t endValue) {
+    return static_cast<uint64_t>(difference(startValue, endValue) * scale);
+  };
+  result.cycles = scaled(start.cycles, end.cycles);
+  result.instructions = scaled(start.instructions, end.instructions);
+  result.cacheMisses = scaled(start.cacheMisses, end.cacheMisses);
+  result.branchMisses = scaled(start.branchMisses, end.branchMisses);
+  return result;
+}
+
+} // namespace facebook::velox::process
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace facebook::velox::process {
+
+/// Hardware performance counters of the calling thread, counted in user mode
+/// with perf_event_open on Linux. The counters of a thread are opened on its
+/// first call of forThread() and stay open until it exits.
+class PerfCounters {
+ public:
+  struct Values {
+    uint64_t cycles{0};
+    uint64_t instructions{0};
+    uint64_t cacheMisses{0};
+    uint64_t branchMisses{0};
+    /// The time the counters were enabled and the time they were counting.
+    /// The latter is less if the kernel multiplexed them with other events.
+    uint64_t timeEnabled{0};
+    uint64_t timeRunning{0};
+  };
+
+  /// Returns the counts between the reads 'start' and 'end' of the same
+  /// counters. The counts are scaled up by the share of the time in between
+  /// that the counters were not counting because of multiplexing, and are 0
+  /// if they were not counting at all.
+  static Values delta(const Values& start, const Values& end);
+
+  /// Returns the counters of the calling thread, or nullptr if they are not
+  /// available, e.g. not on Linux, not permitted by perf_event_paranoid or not
+  /// supported by the hardware or hypervisor.
+  static PerfCounters* forThread();
+
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  /// Returns the counts and times since the counters were opened, not scaled
+  /// for multiplexing. Use delta() to get the counts between two reads.
+  Values read() const;
+
+ private:
+  static constexpr int32_t kNumEvents = 4;
+
+  PerfCounters() = default;
+
+  // Opens the counters. Returns false if any is not available.
+  bool open();
+
+  // The file descriptors of the events. The first is the group leader.
+  int fds_[kNumEvents] = {-1, -1, -1, -1};
+};
+
+} // namespace facebook::velox::process
@@ -20,7 +20,15 @@
 #include <stdlib.h>
 #include <time.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <filesystem>
+#include <thread>
 
+#include <folly/Conv.h>
 #include <folly/CpuId.h>
 #include <folly/FileUtil.h>
 #include <folly/String.h>
@@ -103,6 +111,95 @@ uint64_t threadCpuNanos() {
   return ts.tv_sec * 1'000'000'000 + ts.tv_nsec;
 }
 
+std::vector<int32_t> parseCpuList(std::string_view cpuList) {
+  std::vector<int32_t> cpus;
+  std::vector<folly::StringPiece> ranges;
+  folly::split(',', folly::trimWhitespace(cpuList), ranges);
+  for (const auto range : ranges) {
+    if (range.empty()) {
+      continue;
+    }
+    folly::StringPiece first;
+    folly::StringPiece last;
+    if (folly::split('-', range, first, last)) {
+      for (auto cpu = folly::to<int32_t>(first);
+           cpu <= folly::to<int32_t>(last);
+           ++cpu) {
+        cpus.push_back(cpu);
+      }
+    } else {
+      cpus.push_back(folly::to<int32_t>(range));
+    }
+  }
+  return cpus;
+}
+
+std::vector<std::vector<int32_t>> numaNodeCpus() {
+  constexpr std::string_view kNodeDirectory{"/sys/devices/system/node"};
+  std::vector<std::pair<int32_t, std::vector<int32_t>>> nodes;
+  std::error_code error;
+  for (const auto& entry :
+       std::filesystem::directory_iterator(kNodeDirectory, error)) {
+    const auto name = entry.path().filename().string();
+    if (name.rfind("node", 0) != 0) {
+      continue;
+    }
+    const auto node = folly::tryTo<int32_t>(name.substr(4));
+    if (!node.hasValue()) {
+      continue;
+    }
+    std::string cpuList;
+    if (!folly::readFile((entry.path() / "cpulist").c_str(), cpuList)) {
+      continue;
+    }
+    auto cpus = parseCpuList(cpuList);
+    // Nodes with only memory have no CPUs.
+    if (!cpus.empty()) {
+      nodes.emplace_back(node.value(), std::move(cpus));
+    }
+  }
+  std::sort(nodes.begin(), nodes.end(), [](const auto& a, const auto& b) {
+    return a.first < b.first;
+  });
+
+  std::vector<std::vector<int32_t>> nodeCpus;
+  for (auto& [_, cpus] : nodes) {
+    nodeCpus.push_back(std::move(cpus));
+  }
+  if (nodeCpus.empty()) {
+    auto& cpus = nodeCpus.emplace_back();
+    const int32_t numCpus = std::max(1u, std::thread::hardware_concurrency());
+    for (auto cpu = 0; cpu < numCpus; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return nodeCpus;
+}
+
+bool bindThreadToCpus(const std::vector<int32_t>& cpus) {
+#ifdef __linux__
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  for (const auto cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      return false;
+    }
+    CPU_SET(cpu, &cpuSet);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#else
+  return false;
+#endif
+}
+
+int32_t currentCpu() {
+#ifdef __linux__
+  return sched_getcpu();
+#else
+  return -1;
+#endif
+}
+
 namespace {
 bool bmi2CpuFlag = folly::CpuId().bmi2();
 bool avx2CpuFlag = folly::CpuId().avx2();
@@ -20,6 +20,7 @@
 #include <sys/types.h>
 #include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace facebook::velox::process {
@@ -42,6 +43,22 @@ std::string getCurrentDirectory();
 /// Returns elapsed CPU nanoseconds on the calling thread
 uint64_t threadCpuNanos();
 
+/// Returns the CPUs of each NUMA node that has CPUs, as listed in
+/// /sys/devices/system/node. Returns a single node with all the CPUs of the
+/// machine if the NUMA topology is not available.
+std::vector<std::vector<int32_t>> numaNodeCpus();
+
+/// Parses a list of CPUs in the format of /sys/devices/system/node, e.g.
+/// "0-3,8,10-11".
+std::vector<int32_t> parseCpuList(std::string_view cpuList);
+
+/// Binds the calling thread to 'cpus'. Returns false if the binding is not
+/// supported or fails.
+bool bindThreadToCpus(const std::vector<int32_t>& cpus);
+
+/// Returns the CPU the calling thread runs on, or -1 if it is not known.
+int32_t currentCpu();
+
 /// True if the machine has Intel AVX2 instructions and these are not disabled
 /// by flag.
 bool hasAvx2();
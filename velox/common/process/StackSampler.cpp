@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/common/process/StackSampler.h"
+
+#include <signal.h>
+#include <sys/time.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <map>
+
+#include <fmt/format.h>
+#include <gflags/gflags.h>
+
+#include "velox/common/base/Exceptions.h"
+
+DECLARE_bool(velox_stack_sampler_enabled);
+
+namespace facebook::velox::process {
+namespace {
+
+// The frames the thread is in. The signal handler reads these from the
+// interrupted thread, so 'depth' is updated after the frame it covers.
+struct ThreadFrames {
+  StackSampler* sampler{nullptr};
+  int32_t depth{0};
+  int32_t labelIds[StackSampler::kMaxDepth];
+};
+
+thread_local ThreadFrames threadFrames;
+
+std::mutex timerMutex;
+int32_t numStartedSamplers{0};
+struct sigaction previousAction;
+
+void onProfileSignal(int /*signal*/) {
+  const auto savedErrno = errno;
+  const auto depth = threadFrames.depth;
+  std::atomic_signal_fence(std::memory_order_acquire);
+  if (depth > 0) {
+    threadFrames.sampler->record(
+        threadFrames.labelIds, std::min(depth, StackSampler::kMaxDepth));
+  }
+  errno = savedErrno;
+}
+
+void setTimer(uint64_t intervalUs) {
+  struct itimerval timer {};
+  timer.it_interval.tv_sec = intervalUs / 1'000'000;
+  timer.it_interval.tv_usec = intervalUs % 1'000'000;
+  timer.it_value = timer.it_interval;
+  VELOX_CHECK_EQ(setitimer(ITIMER_PROF, &timer, nullptr), 0);
+}
+
+// Returns true if the process has a SIGPROF handler or an ITIMER_PROF timer
+// that is not of a StackSampler.
+bool profileSignalInUse() {
+  struct sigaction action {};
+  VELOX_CHECK_EQ(sigaction(SIGPROF, nullptr, &action), 0);
+  if ((action.sa_flags & SA_SIGINFO) != 0 || action.sa_handler != SIG_DFL) {
+    return true;
+  }
+  struct itimerval timer {};
+  VELOX_CHECK_EQ(getitimer(ITIMER_PROF, &timer), 0);
+  return timer.it_value.tv_sec != 0 || timer.it_value.tv_usec != 0;
+}
+
+uint64_t hashStack(const int32_t* labelIds, int32_t depth) {
+  uint64_t hash = depth;
+  for (auto i = 0; i < depth; ++i) {
+    hash = (hash ^ labelIds[i]) * 0x100000001b3ULL;
+  }
+  return hash ^ (hash >> 29);
+}
+} // namespace
+
+StackSampler::StackSampler() : slots_(new Slot[kNumSlots]) {}
+
+StackSampler::~StackSampler() {
+  stop();
+}
+
+int32_t StackSampler::labelId(std::string_view label) {
+  std::string key(label);
+  std::replace(key.begin(), key.end(), ';', ':');
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = labelIds_.find(key);
+  if (it != labelIds_.end()) {
+    return it->second;
+  }
+  const int32_t id = labels_.size();
+  labels_.push_back(key);
+  labelIds_.emplace(std::move(key), id);
+  return id;
+}
+
+void StackSampler::record(
+    const int32_t* labelIds,
+    int32_t depth,
+    uint64_t weight) {
+  const auto hash = hashStack(labelIds, depth);
+  for (auto probe = 0; probe < kNumSlots; ++probe) {
+    auto& slot = slots_[(hash + probe) % kNumSlots];
+    auto state = slot.state.load(std::memory_order_acquire);
+    if (state == kEmpty) {
+      int32_t expected = kEmpty;
+      if (slot.state.compare_exchange_strong(expected, kWriting)) {
+        slot.depth = depth;
+        std::copy(labelIds, labelIds + depth, slot.labelIds);
+        slot.weight.store(weight, std::memory_order_relaxed);
+        slot.state.store(kReady, std::memory_order_release);
+        return;
+      }
+      state = expected;
+    }
+    // A slot that another thread is writing is skipped, which may leave the
+    // same stack in two slots. folded() merges these.
+    if (state == kReady && slot.depth == depth &&
+        std::equal(labelIds, labelIds + depth, slot.labelIds)) {
+      slot.weight.fetch_add(weight, std::memory_order_relaxed);
+      return;
+    }
+  }
+  numDropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool StackSampler::start(uint64_t intervalUs) {
+  VELOX_CHECK_GT(intervalUs, 0);
+  if (!FLAGS_velox_stack_sampler_enabled) {
+    return false;
+  }
+  std::lock_guard<std::mutex> l(timerMutex);
+  VELOX_CHECK(!started_, "StackSampler is already started");
+  if (numStartedSamplers == 0) {
+    if (profileSignalInUse()) {
+      return false;
+    }
+    struct sigaction action {};
+    action.sa_handler = onProfileSignal;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    VELOX_CHECK_EQ(sigaction(SIGPROF, &action, &previousAction), 0);
+    setTimer(std::max(intervalUs, kMinIntervalUs));
+  }
+  ++numStartedSamplers;
+  started_ = true;
+  return true;
+}
+
+void StackSampler::stop() {
+  std::lock_guard<std::mutex> l(timerMutex);
+  if (!started_) {
+    return;
+  }
+  started_ = false;
+  if (--numStartedSamplers > 0) {
+    return;
+  }
+  setTimer(0);
+  sigaction(SIGPROF, &previousAction, nullptr);
+}
+
+std::string StackSampler::folded() const {
+  std::map<std::string, uint64_t> stacks;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    for (auto i = 0; i < kNumSlots; ++i) {
+      const auto& slot = slots_[i];
+      if (slot.state.load(std::memory_order_acquire) != kReady) {
+        continue;
+      }
+      std::string stack;
+      for (auto frame = 0; frame < slot.depth; ++frame) {
+        if (frame > 0) {
+          stack.push_back(';');
+        }
+        stack += labels_[slot.labelIds[frame]];
+      }
+      stacks[stack] += slot.weight.load(std::memory_order_relaxed);
+    }
+  }
+  std::string result;
+  for (const auto& [stack, weight] : stacks) {
+    result += fmt::format("{} {}\n", stack, weight);
+  }
+  return result;
+}
+
+uint64_t StackSampler::total() const {
+  uint64_t total = 0;
+  for (auto i = 0; i < kNumSlots; ++i) {
+    if (slots_[i].state.load(std::memory_order_acquire) == kReady) {
+      total += slots_[i].weight.load(std::memory_order_relaxed);
+    }
+  }
+  return total;
+}
+
+ScopedProfileFrame::ScopedProfileFrame(StackSampler* sampler, int32_t labelId) {
+  if (sampler == nullptr) {
+    return;
+  }
+  auto& frames = threadFrames;
+  if (frames.depth == 0) {
+    frames.sampler = sampler;
+  } else if (frames.sampler != sampler) {
+    return;
+  }
+  if (frames.depth < StackSampler::kMaxDepth) {
+    frames.labelIds[frames.depth] = labelId;
+  }
+  std::atomic_signal_fence(std::memory_order_release);
+  ++frames.depth;
+  entered_ = true;
+}
+
+ScopedProfileFrame::~ScopedProfileFrame() {
+  if (!entered_) {
+    return;
+  }
+  auto& frames = threadFrames;
+  --frames.depth;
+  std::atomic_signal_fence(std::memory_order_release);
+  if (frames.depth == 0) {
+    frames.sampler = nullptr;
+  }
+}
+
+// static
+StackSampler* ScopedProfileFrame::currentSampler() {
+  return threadFrames.depth > 0 ? threadFrames.sampler : nullptr;
+}
+
+} // namespace facebook::velox::process
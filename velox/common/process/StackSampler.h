@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <folly/container/F14Map.h>
+
+namespace facebook::velox::process {
+
+// Counts samples of the stacks of labeled frames that threads enter with
+// ScopedProfileFrame, e.g. the operator and the expression a driver thread is
+// running. While at least one sampler is started, the process gets a SIGPROF
+// for each interval of CPU time it uses and the signal handler adds a sample
+// to the sampler of the frames the interrupted thread is in, if any. Threads
+// that are in no frame are not sampled. The result is in the folded stacks
+// format of flame graph tools.
+//
+// Since the signal handler and the timer are process wide, samplers start
+// only if the 'velox_stack_sampler_enabled' flag is set and no other SIGPROF
+// handler or ITIMER_PROF timer is installed, e.g. by another profiler.
+//
+// The samples are kept in a fixed size table of distinct stacks that the
+// signal handler updates without locks or allocation. Samples of new stacks
+// that do not fit are dropped and counted in numDropped().
+class StackSampler {
+ public:
+  // The max number of frames of a stack. The frames entered past this are not
+  // in the samples.
+  static constexpr int32_t kMaxDepth = 16;
+
+  // The min interval of the SIGPROF timer. Each signal interrupts a thread of
+  // the process, so shorter intervals would slow down the whole process.
+  static constexpr uint64_t kMinIntervalUs = 1'000;
+
+  StackSampler();
+
+  ~StackSampler();
+
+  StackSampler(const StackSampler&) = delete;
+  StackSampler& operator=(const StackSampler&) = delete;
+
+  // Returns the id of the frame label 'label', adding it if new. ';' in
+  // 'label' is replaced by ':' since it separates the frames in the output.
+  int32_t labelId(std::string_view label);
+
+  // Adds 'weight' to the stack of the 'depth' frames in 'labelIds'. Called by
+  // the signal handler with weight 1 for each sample, and may be used to add
+  // other quantities, e.g. bytes of memory, to a sampler that is not started.
+  // Async signal safe.
+  void record(const int32_t* labelIds, int32_t depth, uint64_t weight = 1);
+
+  // Starts adding samples to 'this' and returns true. The first sampler to
+  // start sets the interval of the SIGPROF timer that the samplers share, at
+  // least kMinIntervalUs. Returns false if sampling is not enabled or another
+  // SIGPROF handler or timer is installed.
+  bool start(uint64_t intervalUs);
+
+  // Stops adding samples to 'this'. The timer stops with the last sampler.
+  void stop();
+
+  // Returns the stacks with their total weight, one per line as 'frame;frame
+  // weight', sorted by stack.
+  std::string folded() const;
+
+  // Returns the total weight of all recorded stacks.
+  uint64_t total() const;
+
+  uint64_t numDropped() const {
+    return numDropped_;
+  }
+
+ private:
+  static constexpr int32_t kNumSlots = 4096;
+
+  enum SlotState : int32_t { kEmpty = 0, kWriting = 1, kReady = 2 };
+
+  struct Slot {
+    std::atomic<int32_t> state{kEmpty};
+    int32_t depth{0};
+    int32_t labelIds[kMaxDepth];
+    std::atomic<uint64_t> weight{0};
+  };
+
+  const std::unique_ptr<Slot[]> slots_;
+  std::atomic<uint64_t> numDropped_{0};
+  bool started_{false};
+
+  mutable std::mutex mutex_;
+  folly::F14FastMap<std::string, int32_t> labelIds_;
+  std::vector<std::string> labels_;
+};
+
+// Enters a labeled frame of a StackSampler on the calling thread for the
+// lifetime of 'this'. The frames of a thread belong to the sampler of its
+// outermost frame, so a frame of another sampler is not entered.
+class ScopedProfileFrame {
+ public:
+  // Enters the frame with 'labelId' of 'sampler'. Does nothing if 'sampler' is
+  // nullptr.
+  ScopedProfileFrame(StackSampler* sampler, int32_t labelId);
+
+  ~ScopedProfileFrame();
+
+  ScopedProfileFrame(const ScopedProfileFrame&) = delete;
+  ScopedProfileFrame& operator=(const ScopedProfileFrame&) = delete;
+
+  // Returns the sampler of the frames the calling thread is in, nullptr if
+  // the thread is in no frame. Cheap enough to check on every call of a hot
+  // function.
+  static StackSampler* currentSampler();
+
+ private:
+  bool entered_{false};
+};
+
+} // namespace facebook::velox::process
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/process/PerfCounters.h"
+
+#include <gtest/gtest.h>
+
+namespace facebook::velox::process {
+namespace {
+
+TEST(PerfCountersTest, delta) {
+  const PerfCounters::Values start{100, 200, 10, 5, 1'000, 1'000};
+  PerfCounters::Values end{150, 400, 30, 7, 2'000, 2'000};
+  auto delta = PerfCounters::delta(start, end);
+  ASSERT_EQ(delta.cycles, 50);
+  ASSERT_EQ(delta.instructions, 200);
+  ASSERT_EQ(delta.cacheMisses, 20);
+  ASSERT_EQ(delta.branchMisses, 2);
+  ASSERT_EQ(delta.timeEnabled, 1'000);
+  ASSERT_EQ(delta.timeRunning, 1'000);
+
+  // The counters counted half of the time in between. The counts before
+  // 'start' are not scaled.
+  end.timeRunning = 1'500;
+  delta = PerfCounters::delta(start, end);
+  ASSERT_EQ(delta.cycles, 100);
+  ASSERT_EQ(delta.instructions, 400);
+  ASSERT_EQ(delta.cacheMisses, 40);
+  ASSERT_EQ(delta.branchMisses, 4);
+  ASSERT_EQ(delta.timeRunning, 500);
+
+  // The counters did not count in between.
+  end = start;
+  end.timeEnabled = 2'000;
+  delta = PerfCounters::delta(start, end);
+  ASSERT_EQ(delta.cycles, 0);
+  ASSERT_EQ(delta.instructions, 0);
+  ASSERT_EQ(delta.timeEnabled, 1'000);
+  ASSERT_EQ(delta.timeRunning, 0);
+}
+
+TEST(PerfCountersTest, count) {
+  auto* counters = PerfCounters::forThread();
+  if (counters == nullptr) {
+    GTEST_SKIP() << "Perf events are not available";
+  }
+  ASSERT_EQ(PerfCounters::forThread(), counters);
+
+  const auto start = counters->read();
+  volatile uint64_t sum = 0;
+  for (auto i = 0; i < 1'000'000; ++i) {
+    sum = sum + i;
+  }
+  const auto delta = PerfCounters::delta(start, counters->read());
+  ASSERT_GT(delta.cycles, 0);
+  ASSERT_GT(delta.instructions, 1'000'000);
+}
+} // namespace
+} // namespace facebook::velox::process
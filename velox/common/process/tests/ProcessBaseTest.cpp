@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/process/ProcessBase.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <unordered_set>
+
+namespace facebook::velox::process {
+namespace {
+
+TEST(ProcessBaseTest, parseCpuList) {
+  ASSERT_EQ(
+      parseCpuList("0-3,8,10-11\n"),
+      (std::vector<int32_t>{0, 1, 2, 3, 8, 10, 11}));
+  ASSERT_EQ(parseCpuList("5"), std::vector<int32_t>{5});
+  ASSERT_TRUE(parseCpuList("").empty());
+  ASSERT_TRUE(parseCpuList("\n").empty());
+}
+
+TEST(ProcessBaseTest, numaNodeCpus) {
+  const auto nodeCpus = numaNodeCpus();
+  ASSERT_FALSE(nodeCpus.empty());
+  std::unordered_set<int32_t> allCpus;
+  for (const auto& cpus : nodeCpus) {
+    ASSERT_FALSE(cpus.empty());
+    for (const auto cpu : cpus) {
+      ASSERT_TRUE(allCpus.insert(cpu).second);
+    }
+  }
+}
+
+TEST(ProcessBaseTest, bindThreadToCpus) {
+  ASSERT_FALSE(bindThreadToCpus({-1}));
+#ifdef __linux__
+  // Binds a thread of its own to leave the other tests unbound.
+  std::thread([]() {
+    const auto cpu = currentCpu();
+    ASSERT_GE(cpu, 0);
+    ASSERT_TRUE(bindThreadToCpus({cpu}));
+    ASSERT_EQ(currentCpu(), cpu);
+  }).join();
+#endif
+}
+} // namespace
+} // namespace facebook::velox::process
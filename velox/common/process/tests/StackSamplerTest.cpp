@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/process/StackSampler.h"
+
+#include <fmt/format.h>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <signal.h>
+
+#include <chrono>
+
+DECLARE_bool(velox_stack_sampler_enabled);
+
+namespace facebook::velox::process {
+namespace {
+
+TEST(StackSamplerTest, record) {
+  StackSampler sampler;
+  const auto a = sampler.labelId("a");
+  const auto b = sampler.labelId("b;c");
+  ASSERT_EQ(sampler.labelId("a"), a);
+  ASSERT_NE(a, b);
+
+  const int32_t ab[] = {a, b};
+  sampler.record(ab, 2);
+  sampler.record(ab, 1, 10);
+  sampler.record(ab, 2, 2);
+  ASSERT_EQ(sampler.total(), 13);
+  ASSERT_EQ(sampler.numDropped(), 0);
+  ASSERT_EQ(sampler.folded(), "a 10\na;b:c 3\n");
+}
+
+TEST(StackSamplerTest, frames) {
+  StackSampler sampler;
+  StackSampler other;
+  ASSERT_EQ(ScopedProfileFrame::currentSampler(), nullptr);
+  {
+    ScopedProfileFrame none(nullptr, 0);
+    ASSERT_EQ(ScopedProfileFrame::currentSampler(), nullptr);
+    ScopedProfileFrame outer(&sampler, sampler.labelId("outer"));
+    ASSERT_EQ(ScopedProfileFrame::currentSampler(), &sampler);
+    {
+      // A frame of another sampler is not entered.
+      ScopedProfileFrame inner(&other, other.labelId("inner"));
+      ASSERT_EQ(ScopedProfileFrame::currentSampler(), &sampler);
+    }
+    ASSERT_EQ(ScopedProfileFrame::currentSampler(), &sampler);
+  }
+  ASSERT_EQ(ScopedProfileFrame::currentSampler(), nullptr);
+}
+
+TEST(StackSamplerTest, sample) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_velox_stack_sampler_enabled = true;
+  StackSampler sampler;
+  ASSERT_TRUE(sampler.start(1'000));
+  {
+    ScopedProfileFrame outer(&sampler, sampler.labelId("outer"));
+    ScopedProfileFrame inner(&sampler, sampler.labelId("inner"));
+    // Uses CPU until there is a sample, for at most 10s of wall time.
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    volatile uint64_t sum = 0;
+    while (sampler.total() == 0 &&
+           std::chrono::steady_clock::now() < deadline) {
+      for (auto i = 0; i < 100'000; ++i) {
+        sum = sum + i;
+      }
+    }
+  }
+  sampler.stop();
+  const auto numSamples = sampler.total();
+  ASSERT_GT(numSamples, 0);
+  ASSERT_EQ(sampler.folded(), fmt::format("outer;inner {}\n", numSamples));
+
+  // Threads that are in no frame are not sampled.
+  ASSERT_TRUE(sampler.start(1'000));
+  volatile uint64_t sum = 0;
+  for (auto i = 0; i < 10'000'000; ++i) {
+    sum = sum + i;
+  }
+  sampler.stop();
+  ASSERT_EQ(sampler.total(), numSamples);
+}
+
+TEST(StackSamplerTest, start) {
+  gflags::FlagSaver flagSaver;
+  StackSampler sampler;
+  StackSampler other;
+
+  // Sampling is off unless enabled for the process.
+  FLAGS_velox_stack_sampler_enabled = false;
+  ASSERT_FALSE(sampler.start(1'000));
+  sampler.stop();
+
+  // A SIGPROF handler of another profiler is not replaced.
+  FLAGS_velox_stack_sampler_enabled = true;
+  ASSERT_NE(signal(SIGPROF, [](int /*signal*/) {}), SIG_ERR);
+  ASSERT_FALSE(sampler.start(1'000));
+  ASSERT_NE(signal(SIGPROF, SIG_DFL), SIG_ERR);
+
+  // The samplers share the handler of the first one.
+  ASSERT_TRUE(sampler.start(1));
+  ASSERT_TRUE(other.start(1'000));
+  other.stop();
+  sampler.stop();
+  struct sigaction action {};
+  ASSERT_EQ(sigaction(SIGPROF, nullptr, &action), 0);
+  ASSERT_EQ(action.sa_handler, SIG_DFL);
+}
+} // namespace
+} // namespace facebook::velox::process
@@ -91,6 +91,15 @@ struct ConnectorSplit : public ISerializable {
     return 0;
   }
 
+  /// Returns splits of about 'morselBytes' each that together read the same
+  /// rows as this split, so that the drivers of a TableScan can share the
+  /// work of a large split. Returns an empty vector if this split cannot be
+  /// divided or is not large enough to be worth dividing.
+  virtual std::vector<std::shared_ptr<ConnectorSplit>> splitIntoMorsels(
+      uint64_t /*morselBytes*/) const {
+    return {};
+  }
+
   virtual ~ConnectorSplit() {
     if (dataSource) {
       dataSource->close();
@@ -16,6 +16,10 @@
 
 #include "velox/connectors/hive/HiveConnectorSplit.h"
 
+#include <typeinfo>
+
+#include "velox/common/base/BitUtil.h"
+
 namespace facebook::velox::connector::hive {
 
 std::string HiveConnectorSplit::toString() const {
@@ -30,6 +34,68 @@ std::string HiveConnectorSplit::toString() const {
   return fmt::format("Hive: {} {} - {}", filePath, start, length);
 }
 
+std::vector<std::shared_ptr<ConnectorSplit>>
+HiveConnectorSplit::splitIntoMorsels(uint64_t morselBytes) const {
+  // Subclasses carry more state, e.g. delete files, than is copied below.
+  if (morselBytes == 0 || typeid(*this) != typeid(HiveConnectorSplit)) {
+    return {};
+  }
+  switch (fileFormat) {
+    case dwio::common::FileFormat::DWRF:
+    case dwio::common::FileFormat::ORC:
+    case dwio::common::FileFormat::PARQUET:
+      break;
+    default:
+      return {};
+  }
+
+  uint64_t end;
+  if (length != std::numeric_limits<uint64_t>::max()) {
+    end = start + length;
+  } else if (properties.has_value() && properties->fileSize.has_value()) {
+    end = properties->fileSize.value();
+  } else {
+    return {};
+  }
+  if (end <= start || end - start < 2 * morselBytes) {
+    return {};
+  }
+
+  const auto totalBytes = end - start;
+  std::vector<std::shared_ptr<ConnectorSplit>> morsels;
+  morsels.reserve(bits::divRoundUp(totalBytes, morselBytes));
+  int64_t remainingWeight = splitWeight;
+  for (auto offset = start; offset < end; offset += morselBytes) {
+    const auto morselLength = std::min(morselBytes, end - offset);
+    // The weights of the morsels add up to the weight of the split.
+    const auto weight = offset + morselLength == end
+        ? remainingWeight
+        : static_cast<int64_t>(
+              static_cast<double>(splitWeight) * morselLength / totalBytes);
+    remainingWeight -= weight;
+    auto morsel = std::make_shared<HiveConnectorSplit>(
+        connectorId,
+        filePath,
+        fileFormat,
+        offset,
+        morselLength,
+        partitionKeys,
+        tableBucketNumber,
+        customSplitInfo,
+        extraFileInfo,
+        serdeParameters,
+        weight,
+        cacheable,
+        infoColumns,
+        properties,
+        rowIdProperties,
+        bucketConversion);
+    morsel->batchSizeHint = batchSizeHint;
+    morsels.push_back(std::move(morsel));
+  }
+  return morsels;
+}
+
 folly::dynamic HiveConnectorSplit::serialize() const {
   folly::dynamic obj = folly::dynamic::object;
   obj["name"] = "HiveConnectorSplit";
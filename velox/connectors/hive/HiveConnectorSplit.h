@@ -97,6 +97,14 @@ struct HiveConnectorSplit : public FileConnectorSplit {
 
   std::string toString() const override;
 
+  /// Divides DWRF, ORC and Parquet splits into byte ranges of 'morselBytes'.
+  /// The readers read the stripes or row groups that start in their range, so
+  /// each stripe or row group is read by exactly one morsel. The byte range of
+  /// the split must be known, i.e. it has a length or the file size is in
+  /// 'properties'. Subclasses are not divided.
+  std::vector<std::shared_ptr<ConnectorSplit>> splitIntoMorsels(
+      uint64_t morselBytes) const override;
+
   folly::dynamic serialize() const override;
 
   static std::shared_ptr<HiveConnectorSplit> create(const folly::dynamic& obj);
@@ -62,3 +62,60 @@ TEST(HiveSplitTest, builder) {
       properties.modificationTime.value(),
       split->properties.value().modificationTime.value());
 }
+
+TEST(HiveSplitTest, splitIntoMorsels) {
+  auto split = HiveConnectorSplitBuilder("filepath")
+                   .start(100)
+                   .length(1'000)
+                   .splitWeight(10)
+                   .fileFormat(dwio::common::FileFormat::PARQUET)
+                   .partitionKey("ds", "2024-11-01")
+                   .tableBucketNumber(3)
+                   .batchSizeHint(7)
+                   .build();
+
+  auto morsels = split->splitIntoMorsels(300);
+  ASSERT_EQ(morsels.size(), 4);
+  uint64_t offset = 100;
+  int64_t weight = 0;
+  for (const auto& morsel : morsels) {
+    const auto* hiveMorsel =
+        dynamic_cast<const HiveConnectorSplit*>(morsel.get());
+    ASSERT_NE(hiveMorsel, nullptr);
+    EXPECT_EQ(hiveMorsel->start, offset);
+    EXPECT_EQ(hiveMorsel->filePath, "filepath");
+    EXPECT_EQ(hiveMorsel->partitionKeys, split->partitionKeys);
+    EXPECT_EQ(hiveMorsel->tableBucketNumber, 3);
+    EXPECT_EQ(hiveMorsel->batchSizeHint, 7);
+    offset += hiveMorsel->length;
+    weight += hiveMorsel->splitWeight;
+  }
+  // The morsels cover the split and share its weight.
+  EXPECT_EQ(offset, 1'100);
+  EXPECT_EQ(morsels.back()->size(), 100);
+  EXPECT_EQ(weight, 10);
+
+  // Too small to divide.
+  EXPECT_TRUE(split->splitIntoMorsels(501).empty());
+  EXPECT_TRUE(split->splitIntoMorsels(0).empty());
+
+  // The file size bounds a split without a length.
+  auto wholeFile = HiveConnectorSplitBuilder("filepath")
+                       .fileFormat(dwio::common::FileFormat::DWRF)
+                       .fileProperties({.fileSize = 1'000})
+                       .build();
+  EXPECT_EQ(wholeFile->splitIntoMorsels(250).size(), 4);
+  EXPECT_TRUE(HiveConnectorSplitBuilder("filepath")
+                  .fileFormat(dwio::common::FileFormat::DWRF)
+                  .build()
+                  ->splitIntoMorsels(250)
+                  .empty());
+
+  // Formats whose readers do not select stripes or row groups by offset.
+  EXPECT_TRUE(HiveConnectorSplitBuilder("filepath")
+                  .length(1'000)
+                  .fileFormat(dwio::common::FileFormat::TEXT)
+                  .build()
+                  ->splitIntoMorsels(250)
+                  .empty());
+}
@@ -50,6 +50,9 @@ struct TransportKind {
   static constexpr std::string_view kMaterialized{"materialized"};
   /// UCX-based RDMA exchange for high-bandwidth GPU transfers between workers.
   static constexpr std::string_view kUcx{"UCX"};
+  /// Passes vectors between tasks of the same process without serializing
+  /// them. See exec::InProcessOutputBufferManager.
+  static constexpr std::string_view kInProcess{"in-process"};
   /// Deprecated source-compat alias for kInMemory; prefer kInMemory.
   static constexpr std::string_view kHttp{kInMemory};
 };
@@ -2485,11 +2488,16 @@ using LocalMergeNodePtr = std::shared_ptr<const LocalMergeNode>;
 /// Calculates partition number for each row of the specified vector.
 class PartitionFunction {
  public:
+  /// The partition number of a row that is replicated to all partitions. Only
+  /// supported by PartitionedOutput.
+  static constexpr uint32_t kAllPartitions =
+      std::numeric_limits<uint32_t>::max();
+
   virtual ~PartitionFunction() = default;
 
   /// @param input RowVector to split into partitions.
   /// @param [out] partitions Computed partition numbers for each row in
-  /// 'input'.
+  /// 'input', or kAllPartitions for a row to replicate to all partitions.
   /// @return Returns partition number in case all rows of 'input' are
   /// assigned to the same partition. In this case 'partitions' vector is left
   /// unchanged. Used to optimize round-robin partitioning in local exchange.
@@ -46,9 +46,16 @@ const std::vector<config::ConfigProperty>& QueryConfig::registeredProperties() {
     VELOX_REGISTER_QUERY_CONFIG(kExprDedupNonDeterministic);
     VELOX_REGISTER_QUERY_CONFIG(kExprMaxArraySizeInReduce);
     VELOX_REGISTER_QUERY_CONFIG(kExprMaxCompiledRegexes);
+    VELOX_REGISTER_QUERY_CONFIG(kExprParallelSlices);
+    VELOX_REGISTER_QUERY_CONFIG(kExprParallelSliceMinRows);
+    VELOX_REGISTER_QUERY_CONFIG(kExprParallelSliceMinCpuNanosPerRow);
+    VELOX_REGISTER_QUERY_CONFIG(kExprDictionaryResultCacheMaxBytes);
+    VELOX_REGISTER_QUERY_CONFIG(kExprDictionaryResultCacheMaxDictionarySize);
+    VELOX_REGISTER_QUERY_CONFIG(kExprBatchArenaChunkSize);
 
     // Operator.
     VELOX_REGISTER_QUERY_CONFIG(kOperatorTrackCpuUsage);
+    VELOX_REGISTER_QUERY_CONFIG(kOperatorTrackPerfCounters);
 
     // Cast.
     VELOX_REGISTER_QUERY_CONFIG(kLegacyCast);
@@ -57,6 +64,7 @@ const std::vector<config::ConfigProperty>& QueryConfig::registeredProperties() {
     // Local exchange.
     VELOX_REGISTER_QUERY_CONFIG(kMaxLocalExchangeBufferSize);
     VELOX_REGISTER_QUERY_CONFIG(kMaxLocalExchangePartitionCount);
+    VELOX_REGISTER_QUERY_CONFIG(kLocalExchangeQueueShards);
     VELOX_REGISTER_QUERY_CONFIG(
         kMinLocalExchangePartitionCountToUsePartitionBuffer);
     VELOX_REGISTER_QUERY_CONFIG(kMaxLocalExchangePartitionBufferSize);
@@ -80,6 +88,7 @@ const std::vector<config::ConfigProperty>& QueryConfig::registeredProperties() {
     // TopN row number.
     VELOX_REGISTER_QUERY_CONFIG(kAbandonPartialTopNRowNumberMinRows);
     VELOX_REGISTER_QUERY_CONFIG(kAbandonPartialTopNRowNumberMinPct);
+    VELOX_REGISTER_QUERY_CONFIG(kTopNRowNumberMemoryCompactionReclaimEnabled);
 
     // Hash build dedup.
     VELOX_REGISTER_QUERY_CONFIG(kAbandonDedupHashMapMinRows);
@@ -102,6 +111,7 @@ const std::vector<config::ConfigProperty>& QueryConfig::registeredProperties() {
     // Table scan.
     VELOX_REGISTER_QUERY_CONFIG(kTableScanGetOutputTimeLimitMs);
     VELOX_REGISTER_QUERY_CONFIG(kTableScanOutputBatchRowsOverride);
+    VELOX_REGISTER_QUERY_CONFIG(kLazySubfieldPushdownEnabled);
 
     // Hash table.
     VELOX_REGISTER_QUERY_CONFIG(kHashAdaptivityEnabled);
@@ -126,10 +136,15 @@ const std::vector<config::ConfigProperty>& QueryConfig::registeredProperties() {
     VELOX_REGISTER_QUERY_CONFIG(kMaxSpillLevel);
     VELOX_REGISTER_QUERY_CONFIG(kMaxSpillFileSize);
     VELOX_REGISTER_QUERY_CONFIG(kSpillCompressionKind);
+    VELOX_REGISTER_QUERY_CONFIG(kSpillAdaptiveCompressionEnabled);
     VELOX_REGISTER_QUERY_CONFIG(kSpillNumMaxMergeFiles);
     VELOX_REGISTER_QUERY_CONFIG(kSpillPrefixSortEnabled);
+    VELOX_REGISTER_QUERY_CONFIG(kSpillRowFormatEnabled);
     VELOX_REGISTER_QUERY_CONFIG(kSpillWriteBufferSize);
     VELOX_REGISTER_QUERY_CONFIG(kSpillReadBufferSize);
+    VELOX_REGISTER_QUERY_CONFIG(kSpillReadAheadEnabled);
+    VELOX_REGISTER_QUERY_CONFIG(kSpillMergeReadBufferBudget);
+    VELOX_REGISTER_QUERY_CONFIG(kSpillMemoryTierEnabled);
     VELOX_REGISTER_QUERY_CONFIG(kSpillFileCreateConfig);
     VELOX_REGISTER_QUERY_CONFIG(kAggregationSpillFileCreateConfig);
     VELOX_REGISTER_QUERY_CONFIG(kHashJoinSpillFileCreateConfig);
@@ -154,6 +169,10 @@ const std::vector<config::ConfigProperty>& QueryConfig::registeredProperties() {
     VELOX_REGISTER_QUERY_CONFIG(kBypassHashProbeBloomFilterMinPct);
     VELOX_REGISTER_QUERY_CONFIG(kMinTableRowsForParallelJoinBuild);
 
+    // Limit and TopN.
+    VELOX_REGISTER_QUERY_CONFIG(kLimitPushdownEnabled);
+    VELOX_REGISTER_QUERY_CONFIG(kTopNDynamicFilterPushdownEnabled);
+
     // Debug and validation.
     VELOX_REGISTER_QUERY_CONFIG(kValidateOutputFromOperators);
     VELOX_REGISTER_QUERY_CONFIG(kEnableExpressionEvaluationCache);
@@ -161,9 +180,11 @@ const std::vector<config::ConfigProperty>& QueryConfig::registeredProperties() {
 
     // Split preload.
     VELOX_REGISTER_QUERY_CONFIG(kMaxSplitPreloadPerDriver);
+    VELOX_REGISTER_QUERY_CONFIG(kTableScanMorselBytes);
 
     // Driver.
     VELOX_REGISTER_QUERY_CONFIG(kDriverCpuTimeSliceLimitMs);
+    VELOX_REGISTER_QUERY_CONFIG(kDriverSchedulingWeight);
 
     // Window.
     VELOX_REGISTER_QUERY_CONFIG(kWindowNumSubPartitions);
@@ -182,6 +203,10 @@ const std::vector<config::ConfigProperty>& QueryConfig::registeredProperties() {
     VELOX_REGISTER_QUERY_CONFIG(kQueryTraceDryRun);
     VELOX_REGISTER_QUERY_CONFIG(kOpTraceDirectoryCreateConfig);
 
+    // Task profile.
+    VELOX_REGISTER_QUERY_CONFIG(kTaskProfileDir);
+    VELOX_REGISTER_QUERY_CONFIG(kTaskProfileSamplingIntervalUs);
+
     // Debug expression.
     VELOX_REGISTER_QUERY_CONFIG(kDebugDisableExpressionWithPeeling);
     VELOX_REGISTER_QUERY_CONFIG(kDebugDisableCommonSubExpressions);
@@ -210,6 +235,7 @@ const std::vector<config::ConfigProperty>& QueryConfig::registeredProperties() {
     // Shuffle.
     VELOX_REGISTER_QUERY_CONFIG(kShuffleCompressionKind);
     VELOX_REGISTER_QUERY_CONFIG(kMinShuffleCompressionPageSizeBytes);
+    VELOX_REGISTER_QUERY_CONFIG(kShuffleAdaptiveCompressionEnabled);
 
     // Map.
     VELOX_REGISTER_QUERY_CONFIG(kThrowExceptionOnDuplicateMapKeys);
@@ -241,6 +267,8 @@ const std::vector<config::ConfigProperty>& QueryConfig::registeredProperties() {
 
     // Memory reclaimer.
     VELOX_REGISTER_QUERY_CONFIG(kQueryMemoryReclaimerPriority);
+    VELOX_REGISTER_QUERY_CONFIG(kOperatorMemoryHistoryEnabled);
+    VELOX_REGISTER_QUERY_CONFIG(kCooperativeMemoryReclaimWaitMs);
 
     // Splits.
     VELOX_REGISTER_QUERY_CONFIG(kMaxNumSplitsListenedTo);
@@ -212,6 +212,18 @@ class QueryConfig {
       true,
       "Track CPU usage for stages of individual operators.")
 
+  /// Whether to count cycles, instructions, cache misses and branch misses of
+  /// individual operators with hardware performance counters. Has no effect
+  /// if perf events are not available. Adds two system calls to each operator
+  /// call.
+  VELOX_QUERY_CONFIG(
+      kOperatorTrackPerfCounters,
+      operatorTrackPerfCounters,
+      "track_operator_perf_counters",
+      bool,
+      false,
+      "Track hardware performance counters of individual operators.")
+
   /// Flags used to configure the CAST operator:
   VELOX_QUERY_CONFIG(
       kLegacyCast,
@@ -251,6 +263,74 @@ class QueryConfig {
       100,
       "Maximum compiled regex patterns per function instance per thread.")
 
+  /// Maximum number of row slices that FilterProject evaluates in parallel on
+  /// the query executor for CPU-heavy projections. 0 or 1 disables slicing.
+  VELOX_QUERY_CONFIG(
+      kExprParallelSlices,
+      exprParallelSlices,
+      "expression.parallel_slices",
+      uint32_t,
+      0,
+      "Max parallel row slices for CPU-heavy projections. 0 disables.")
+
+  /// Minimum number of rows in each slice evaluated in parallel.
+  VELOX_QUERY_CONFIG(
+      kExprParallelSliceMinRows,
+      exprParallelSliceMinRows,
+      "expression.parallel_slice_min_rows",
+      uint32_t,
+      1'024,
+      "Minimum number of rows in a parallel projection slice.")
+
+  /// Observed projection CPU time per row in nanoseconds above which
+  /// FilterProject starts evaluating projections in parallel slices.
+  /// Projections that contain a function flagged as expensive in its metadata
+  /// are sliced regardless of the observed cost.
+  VELOX_QUERY_CONFIG(
+      kExprParallelSliceMinCpuNanosPerRow,
+      exprParallelSliceMinCpuNanosPerRow,
+      "expression.parallel_slice_min_cpu_nanos_per_row",
+      uint64_t,
+      2'000,
+      "Projection CPU nanos per row above which rows are sliced.")
+
+  /// Maximum retained bytes of the cross-batch cache of expensive function
+  /// results over dictionary base vectors. The cache keeps results when the
+  /// base vector changes and reuses them for a later base vector with the same
+  /// values, e.g. the same string dictionary read again in the next stripe. 0
+  /// disables the cache.
+  VELOX_QUERY_CONFIG(
+      kExprDictionaryResultCacheMaxBytes,
+      exprDictionaryResultCacheMaxBytes,
+      "expression.dictionary_result_cache_max_bytes",
+      uint64_t,
+      0,
+      "Max bytes of cached function results over dictionaries. 0 disables.")
+
+  /// Dictionaries with more distinct values than this are not put in the
+  /// cross-batch dictionary result cache.
+  VELOX_QUERY_CONFIG(
+      kExprDictionaryResultCacheMaxDictionarySize,
+      exprDictionaryResultCacheMaxDictionarySize,
+      "expression.dictionary_result_cache_max_dictionary_size",
+      uint32_t,
+      10'000,
+      "Max dictionary size eligible for the dictionary result cache.")
+
+  /// Size of the chunks of the arena of FilterProject that holds the buffers
+  /// of new flat vectors of scalar types in expression evaluation. The pool is
+  /// charged once per chunk instead of once per buffer, and a chunk is reused
+  /// once the vectors of a batch are freed. The results of the projections
+  /// are allocated from the pool, so that only the intermediate vectors use
+  /// the arena. Other operators do not use the arena. 0 disables the arena.
+  VELOX_QUERY_CONFIG(
+      kExprBatchArenaChunkSize,
+      exprBatchArenaChunkSize,
+      "expression.batch_arena_chunk_size",
+      uint64_t,
+      0,
+      "Chunk size of the arena for expression vectors. 0 disables.")
+
   /// Used for backpressure to block local exchange producers when the local
   /// exchange buffer reaches or exceeds this size.
   VELOX_QUERY_CONFIG(
@@ -270,6 +350,17 @@ class QueryConfig {
       std::numeric_limits<uint32_t>::max(),
       "Maximum number of partitions in local exchange.")
 
+  /// The number of independently locked shards of each local exchange queue.
+  /// More shards reduce lock contention when many drivers produce into and
+  /// consume from the same local exchange.
+  VELOX_QUERY_CONFIG(
+      kLocalExchangeQueueShards,
+      localExchangeQueueShards,
+      "local_exchange_queue_shards",
+      uint32_t,
+      1,
+      "Number of shards of each local exchange queue.")
+
   /// Minimum number of local exchange output partitions to use buffered
   /// partitioning.
   VELOX_QUERY_CONFIG(
@@ -417,6 +508,17 @@ class QueryConfig {
       80,
       "Abandon partial TopN row number if reduction percentage exceeds this.")
 
+  /// If true, TopNRowNumber moves the rows that are left after evictions into
+  /// new memory during memory reclaim if that frees enough memory and the
+  /// copy of these rows fits in the unused reservation, instead of spilling.
+  VELOX_QUERY_CONFIG(
+      kTopNRowNumberMemoryCompactionReclaimEnabled,
+      topNRowNumberMemoryCompactionReclaimEnabled,
+      "topn_row_number_memory_compaction_reclaim_enabled",
+      bool,
+      false,
+      "Enable memory compaction before spilling in TopN row number reclaim.")
+
   /// Number of input rows to receive before starting to check whether to
   /// abandon building a HashTable without duplicates in HashBuild.
   VELOX_QUERY_CONFIG(
@@ -530,6 +632,17 @@ class QueryConfig {
       0,
       "Override number of rows in TableScan output batches. 0 means no override.")
 
+  /// If true, FilterProject pushes the subfields its expressions access into
+  /// not yet loaded lazy input columns, so that readers skip decoding struct
+  /// members that are never referenced.
+  VELOX_QUERY_CONFIG(
+      kLazySubfieldPushdownEnabled,
+      lazySubfieldPushdownEnabled,
+      "lazy_subfield_pushdown_enabled",
+      bool,
+      false,
+      "Push subfields accessed by FilterProject into lazy input columns.")
+
   /// If false, the 'group by' code is forced to use generic hash mode
   /// hashtable.
   VELOX_QUERY_CONFIG(
@@ -719,6 +832,17 @@ class QueryConfig {
       "none",
       "Compression codec for spill data.")
 
+  /// If true, chooses the codec of each spilled page among none, LZ4 and ZSTD
+  /// from the measured compression ratios and CPU costs instead of using
+  /// spill_compression_codec.
+  VELOX_QUERY_CONFIG(
+      kSpillAdaptiveCompressionEnabled,
+      spillAdaptiveCompressionEnabled,
+      "spill_adaptive_compression_enabled",
+      bool,
+      false,
+      "Whether to choose the codec of each spilled page adaptively.")
+
   /// The max number of files to merge at a time when merging sorted spilled
   /// files. 0 means unlimited.
   VELOX_QUERY_CONFIG(
@@ -738,6 +862,18 @@ class QueryConfig {
       false,
       "Enable prefix sort in spill instead of timsort.")
 
+  /// If true, hash join build spills rows in the RowContainer row layout
+  /// instead of as columnar vectors. Restoring copies the rows back into the
+  /// row container without decoding vectors. See
+  /// RowContainer::extractSerializedRows().
+  VELOX_QUERY_CONFIG(
+      kSpillRowFormatEnabled,
+      spillRowFormatEnabled,
+      "spill_row_format_enabled",
+      bool,
+      false,
+      "Spill hash join build rows in the row container layout.")
+
   /// Specifies spill write buffer size in bytes. 0 disables buffering.
   VELOX_QUERY_CONFIG(
       kSpillWriteBufferSize,
@@ -756,6 +892,38 @@ class QueryConfig {
       1L << 20,
       "Buffer size in bytes to read from one spilled file.")
 
+  /// If true, merging sorted spill files reads the next buffer of each file on
+  /// the spill executor while the current one is consumed. File systems with
+  /// async reads always read ahead.
+  VELOX_QUERY_CONFIG(
+      kSpillReadAheadEnabled,
+      spillReadAheadEnabled,
+      "spill_read_ahead_enabled",
+      bool,
+      false,
+      "Read spill files ahead on the spill executor when merging them.")
+
+  /// The total read buffer size in bytes for the spill files merged at the
+  /// same time. 0 means each file uses 'spill_read_buffer_size'.
+  VELOX_QUERY_CONFIG(
+      kSpillMergeReadBufferBudget,
+      spillMergeReadBufferBudget,
+      "spill_merge_read_buffer_budget",
+      uint64_t,
+      0,
+      "Total read buffer size in bytes for spill files merged together.")
+
+  /// If true, spill files are kept in the process wide spill memory tier while
+  /// it has capacity, and only go to disk when it is full. Has no effect if the
+  /// host has not initialized the tier.
+  VELOX_QUERY_CONFIG(
+      kSpillMemoryTierEnabled,
+      spillMemoryTierEnabled,
+      "spill_memory_tier_enabled",
+      bool,
+      false,
+      "Keep spill files in the spill memory tier before going to disk.")
+
   /// Config used to create spill files.
   VELOX_QUERY_CONFIG(
       kSpillFileCreateConfig,
@@ -924,6 +1092,29 @@ class QueryConfig {
       1'000,
       "Minimum table rows to trigger parallel hash join table build.")
 
+  /// If true, a Limit without offset counts its output rows across all drivers
+  /// of the pipeline. Once they reach the limit, all drivers finish and the
+  /// table scan at the start of the pipeline stops reading splits.
+  VELOX_QUERY_CONFIG(
+      kLimitPushdownEnabled,
+      limitPushdownEnabled,
+      "limit_pushdown_enabled",
+      bool,
+      false,
+      "Stop the table scan once a Limit has enough rows across all drivers.")
+
+  /// If true, TopN pushes the value of its first sorting key in the last of
+  /// its current top rows to the table scan as a dynamic range filter. The
+  /// scan uses the filter to skip rows and, by min/max statistics, whole row
+  /// groups and stripes. Applies to integer, date and timestamp keys.
+  VELOX_QUERY_CONFIG(
+      kTopNDynamicFilterPushdownEnabled,
+      topNDynamicFilterPushdownEnabled,
+      "topn_dynamic_filter_pushdown_enabled",
+      bool,
+      false,
+      "Push the TopN threshold to the table scan as a dynamic filter.")
+
   /// If set to true, validate output vectors of every operator for consistency.
   VELOX_QUERY_CONFIG(
       kValidateOutputFromOperators,
@@ -952,6 +1143,22 @@ class QueryConfig {
       10,
       "Maximum distinct input sets to cache for shared subexpressions.")
 
+  /// If not zero, the splits of a table scan that are larger than twice this
+  /// many bytes are divided into morsels of this size, which the drivers of
+  /// the scan take from the split queue like splits. Splits are divided when
+  /// they reach the head of the queue, before they are preloaded. Only
+  /// connectors that implement ConnectorSplit::splitIntoMorsels() divide
+  /// splits, e.g. Hive for DWRF, ORC and Parquet files. TaskStats count a
+  /// divided split once and its morsels in 'numTotalMorsels'.
+  VELOX_QUERY_CONFIG(
+      kTableScanMorselBytes,
+      tableScanMorselBytes,
+      "table_scan_morsel_bytes",
+      uint64_t,
+      0,
+      "Size of the morsels that table scan splits are divided into. 0 "
+      "disables dividing splits.")
+
   /// Maximum number of splits to preload. Set to 0 to disable preloading.
   VELOX_QUERY_CONFIG(
       kMaxSplitPreloadPerDriver,
@@ -971,6 +1178,18 @@ class QueryConfig {
       0,
       "CPU time slice limit in ms before yielding. 0 means no limit.")
 
+  /// The relative CPU share of the query among the queries whose drivers are
+  /// at the same level of an exec::MultiLevelDriverScheduler. A query with
+  /// weight 2 gets twice the CPU time of a query with weight 1. Ignored by
+  /// other executors.
+  VELOX_QUERY_CONFIG(
+      kDriverSchedulingWeight,
+      driverSchedulingWeight,
+      "driver_scheduling_weight",
+      uint32_t,
+      1,
+      "Relative CPU share of the query in a multi-level driver scheduler.")
+
   /// Window operator sub-partition count per thread.
   VELOX_QUERY_CONFIG(
       kWindowNumSubPartitions,
@@ -1071,6 +1290,28 @@ class QueryConfig {
       "",
       "Config for creating operator trace directory.")
 
+  /// Directory to write a CPU and a memory profile of each task to when it
+  /// completes. The CPU profile samples the operators and expressions that
+  /// the drivers of the task run, if the process enables it with the
+  /// 'velox_stack_sampler_enabled' flag. Disabled if empty.
+  VELOX_QUERY_CONFIG(
+      kTaskProfileDir,
+      taskProfileDir,
+      "task_profile_dir",
+      std::string,
+      "",
+      "Directory to write task CPU and memory profiles to.")
+
+  /// The CPU time between two samples of the task CPU profile. Shorter
+  /// intervals than StackSampler::kMinIntervalUs are raised to that.
+  VELOX_QUERY_CONFIG(
+      kTaskProfileSamplingIntervalUs,
+      taskProfileSamplingIntervalUs,
+      "task_profile_sampling_interval_us",
+      uint64_t,
+      10'000,
+      "CPU time between two samples of the task CPU profile.")
+
   /// Disable optimization in expression evaluation to peel common dictionary
   /// layer from inputs.
   VELOX_QUERY_CONFIG(
@@ -1247,6 +1488,18 @@ class QueryConfig {
       0,
       "Minimum serialized page size in bytes to attempt shuffle compression.")
 
+  /// If true, chooses the codec of each shuffle page among none, LZ4 and ZSTD
+  /// from the measured compression ratios and whether the network or the CPU
+  /// is the bottleneck. Only supported by the Presto serde between Velox
+  /// workers.
+  VELOX_QUERY_CONFIG(
+      kShuffleAdaptiveCompressionEnabled,
+      shuffleAdaptiveCompressionEnabled,
+      "shuffle_adaptive_compression_enabled",
+      bool,
+      false,
+      "Whether to choose the codec of each shuffle page adaptively.")
+
   /// When true, throw exception on duplicate map key.
   VELOX_QUERY_CONFIG(
       kThrowExceptionOnDuplicateMapKeys,
@@ -1368,6 +1621,29 @@ class QueryConfig {
       std::numeric_limits<int32_t>::max(),
       "Query priority in memory pool reclaimer. Lower means higher priority.")
 
+  /// If true, HashBuild, HashAggregation and OrderBy reserve memory ahead of
+  /// their input from the peak memory usage of the same plan nodes in past
+  /// runs, and record their own peak memory usage. Takes effect only if an
+  /// exec::OperatorMemoryHistory is set.
+  VELOX_QUERY_CONFIG(
+      kOperatorMemoryHistoryEnabled,
+      operatorMemoryHistoryEnabled,
+      "operator_memory_history_enabled",
+      bool,
+      true,
+      "Reserve operator memory from the peak memory usage of past runs.")
+
+  /// The max time in milliseconds that a memory reclaim waits for the running
+  /// drivers of a task to spill at their next operator boundary before it
+  /// pauses the task. 0 pauses the task right away.
+  VELOX_QUERY_CONFIG(
+      kCooperativeMemoryReclaimWaitMs,
+      cooperativeMemoryReclaimWaitMs,
+      "cooperative_memory_reclaim_wait_ms",
+      uint64_t,
+      0,
+      "Max time a memory reclaim waits for running drivers to spill.")
+
   /// The max number of input splits to listen to by SplitListener.
   VELOX_QUERY_CONFIG(
       kMaxNumSplitsListenedTo,
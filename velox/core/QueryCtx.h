@@ -541,13 +541,21 @@ class QueryCtx : public std::enable_shared_from_this<QueryCtx> {
 // Represents the state of one thread of query execution.
 class ExecCtx {
  public:
-  ExecCtx(memory::MemoryPool* pool, QueryCtx* queryCtx)
+  /// If 'vectorArenaChunkSize' is not 0, the VectorPool allocates new flat
+  /// vectors of scalar types from an arena with chunks of that size. The
+  /// owner must then make sure that these vectors do not outlive the batch,
+  /// e.g. in its output, and must call VectorPool::resetArena() after each
+  /// batch.
+  ExecCtx(
+      memory::MemoryPool* pool,
+      QueryCtx* queryCtx,
+      uint64_t vectorArenaChunkSize = 0)
       : pool_(pool),
         queryCtx_(queryCtx),
         optimizationParams_(queryCtx),
         vectorPool_(
             optimizationParams_.exprEvalCacheEnabled
-                ? std::make_unique<VectorPool>(pool)
+                ? std::make_unique<VectorPool>(pool, vectorArenaChunkSize)
                 : nullptr) {}
 
   struct OptimizationParams {
@@ -40,6 +40,16 @@ struct udf_is_deterministic<
     util::detail::void_t<decltype(T::is_deterministic)>>
     : std::integral_constant<bool, T::is_deterministic> {};
 
+// Most UDFs are cheap to evaluate per row. Functions with a high per-row CPU
+// cost, e.g. regular expressions or geometry, can declare
+// 'static constexpr bool is_expensive = true'.
+template <class T, class = void>
+struct udf_is_expensive : std::false_type {};
+
+template <class T>
+struct udf_is_expensive<T, util::detail::void_t<decltype(T::is_expensive)>>
+    : std::integral_constant<bool, T::is_expensive> {};
+
 // Most functions are producing ASCII results for ASCII inputs, but we assume
 // they are not unless specified explicitly.
 template <class T, class = void>
@@ -452,6 +462,7 @@ class ISimpleFunctionMetadata {
   virtual TypePtr tryResolveReturnType() const = 0;
   virtual std::string getName() const = 0;
   virtual bool isDeterministic() const = 0;
+  virtual bool isExpensive() const = 0;
   virtual bool defaultNullBehavior() const = 0;
   // Return the owner of the function. This is used for logging and
   // attribution.
@@ -570,6 +581,10 @@ class SimpleFunctionMetadata : public ISimpleFunctionMetadata {
     return udf_is_deterministic<Fun>();
   }
 
+  bool isExpensive() const final {
+    return udf_is_expensive<Fun>();
+  }
+
   std::string_view owner() const final {
     return udf_owner<Fun>::value();
   }
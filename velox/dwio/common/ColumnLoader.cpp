@@ -16,6 +16,9 @@
 
 #include "velox/dwio/common/ColumnLoader.h"
 
+#include <folly/ScopeGuard.h>
+#include <folly/container/F14Map.h>
+
 namespace facebook::velox::dwio::common {
 
 namespace {
@@ -88,8 +91,125 @@ void scatter(RowSet rows, vector_size_t resultSize, VectorPtr* result) {
   *result = BaseVector::wrapInDictionary(nullptr, indices, resultSize, *result);
 }
 
+// Sets the children of 'spec' not reached by any of 'subfields' to null
+// constants for the current batch of 'structReader'. 'depth' is the position in
+// the subfield paths that corresponds to 'spec'. Leaves 'spec' unchanged if any
+// subfield accesses the whole value.
+void pruneSubfields(
+    velox::common::ScanSpec& spec,
+    const TypePtr& type,
+    const std::vector<const velox::common::Subfield*>& subfields,
+    size_t depth,
+    SelectiveStructColumnReaderBase& structReader,
+    const ColumnLoader* owner,
+    memory::MemoryPool* pool) {
+  if (spec.hasFilter() || spec.deltaUpdate() != nullptr ||
+      spec.hasTransform() || spec.isFlatMapAsStruct()) {
+    return;
+  }
+  for (const auto* subfield : subfields) {
+    if (subfield->path().size() <= depth) {
+      return;
+    }
+  }
+
+  switch (type->kind()) {
+    case TypeKind::ROW: {
+      folly::F14FastMap<std::string, std::vector<const velox::common::Subfield*>>
+          childSubfields;
+      for (const auto* subfield : subfields) {
+        const auto* field =
+            subfield->path()[depth]->as<velox::common::Subfield::NestedField>();
+        if (field == nullptr) {
+          return;
+        }
+        childSubfields[field->name()].push_back(subfield);
+      }
+      const auto& rowType = type->asRow();
+      for (const auto& childSpec : spec.children()) {
+        const auto childIndex =
+            rowType.getChildIdxIfExists(childSpec->fieldName());
+        if (!childIndex.has_value()) {
+          continue;
+        }
+        const auto& childType = rowType.childAt(childIndex.value());
+        auto it = childSubfields.find(childSpec->fieldName());
+        if (it != childSubfields.end()) {
+          pruneSubfields(
+              *childSpec,
+              childType,
+              it->second,
+              depth + 1,
+              structReader,
+              owner,
+              pool);
+          continue;
+        }
+        if (!childSpec->readFromFile() || childSpec->hasFilter() ||
+            childSpec->deltaUpdate() != nullptr ||
+            childSpec->channel() == velox::common::ScanSpec::kNoChannel) {
+          continue;
+        }
+        structReader.pruneScanSpec(
+            owner,
+            *childSpec,
+            BaseVector::createNullConstant(childType, 1, pool));
+      }
+      return;
+    }
+    case TypeKind::ARRAY:
+    case TypeKind::MAP: {
+      for (const auto* subfield : subfields) {
+        if (!subfield->path()[depth]->isSubscript()) {
+          return;
+        }
+      }
+      const bool isArray = type->kind() == TypeKind::ARRAY;
+      auto* valueSpec = spec.childByName(
+          isArray ? velox::common::ScanSpec::kArrayElementsFieldName
+                  : velox::common::ScanSpec::kMapValuesFieldName);
+      if (valueSpec == nullptr) {
+        return;
+      }
+      pruneSubfields(
+          *valueSpec,
+          isArray ? type->asArray().elementType() : type->asMap().valueType(),
+          subfields,
+          depth + 1,
+          structReader,
+          owner,
+          pool);
+      return;
+    }
+    default:
+      return;
+  }
+}
+
 } // namespace
 
+bool ColumnLoader::pushdownSubfields(
+    const std::vector<velox::common::Subfield>& subfields) {
+  if (version_ != structReader_->numReads() || subfields.empty()) {
+    return false;
+  }
+  std::vector<const velox::common::Subfield*> paths;
+  paths.reserve(subfields.size());
+  for (const auto& subfield : subfields) {
+    paths.push_back(&subfield);
+  }
+  // Depth 0 is the name of the column itself.
+  pruneSubfields(
+      *fieldReader_->scanSpec(),
+      fieldReader_->requestedType(),
+      paths,
+      1,
+      *structReader_,
+      this,
+      fieldReader_->memoryPool());
+  return true;
+}
+
 void ColumnLoader::loadInternal(
     RowSet rows,
     ValueHook* hook,
@@ -101,6 +221,10 @@ void ColumnLoader::loadInternal(
              ->debugString();
        },
        structReader_});
+  // The members pruned by pushdownSubfields() are only skipped for this load.
+  SCOPE_EXIT {
+    structReader_->restorePrunedScanSpecs(this);
+  };
   raw_vector<vector_size_t> selectedRows(fieldReader_->memoryPool());
   auto effectiveRows =
       read(structReader_, fieldReader_, version_, rows, selectedRows, hook);
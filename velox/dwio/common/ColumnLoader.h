@@ -38,6 +38,15 @@ class ColumnLoader : public VectorLoader {
     return true;
   }
 
+  /// Replaces the struct members of the loaded column that no subfield in
+  /// 'subfields' reaches with null constants in the ScanSpec of
+  /// 'fieldReader_', so that their readers are skipped. Descends through
+  /// array elements and map values. Map keys are always read. The ScanSpec is
+  /// restored after the load, or at the next read of 'structReader_' if the
+  /// column is not loaded.
+  bool pushdownSubfields(
+      const std::vector<velox::common::Subfield>& subfields) override;
+
  protected:
   void loadInternal(
       RowSet rows,
@@ -71,6 +80,13 @@ class TransformColumnLoader : public ColumnLoader {
     return false;
   }
 
+  // The transform changes the shape of the value, so subfields of the output
+  // type do not map to the ScanSpec of the file type.
+  bool pushdownSubfields(
+      const std::vector<velox::common::Subfield>& /*subfields*/) override {
+    return false;
+  }
+
  private:
   void loadInternal(
       RowSet rows,
@@ -412,10 +412,34 @@ void SelectiveStructColumnReaderBase::readFlatMapChildren(
   readOffset_ = offset + rows.back() + 1;
 }
 
+void SelectiveStructColumnReaderBase::pruneScanSpec(
+    const void* owner,
+    velox::common::ScanSpec& spec,
+    VectorPtr constant) {
+  prunedScanSpecs_.push_back({owner, &spec, spec.constantValue()});
+  spec.setConstantValue(std::move(constant));
+}
+
+void SelectiveStructColumnReaderBase::restorePrunedScanSpecs(
+    const void* owner) {
+  // In reverse so that a spec pruned twice gets its original value back.
+  for (auto i = static_cast<int32_t>(prunedScanSpecs_.size()) - 1; i >= 0;
+       --i) {
+    auto& pruned = prunedScanSpecs_[i];
+    if (owner == nullptr || pruned.owner == owner) {
+      pruned.spec->setConstantValue(std::move(pruned.constantValue));
+      prunedScanSpecs_.erase(prunedScanSpecs_.begin() + i);
+    }
+  }
+}
+
 void SelectiveStructColumnReaderBase::read(
     int64_t offset,
     const RowSet& rows,
     const uint64_t* incomingNulls) {
+  // The members pruned for the lazy vectors of the previous batch are read
+  // again.
+  restorePrunedScanSpecs();
   numReads_ = scanSpec_->newRead();
   prepareRead<char>(offset, rows, incomingNulls);
   RowSet activeRows = rows;
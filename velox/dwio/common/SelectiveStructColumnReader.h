@@ -28,6 +28,10 @@ class SelectiveFlatMapColumnReaderHelper;
 
 class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
  public:
+  ~SelectiveStructColumnReaderBase() override {
+    restorePrunedScanSpecs();
+  }
+
   void resetFilterCaches() override {
     for (auto& child : children_) {
       child->resetFilterCaches();
@@ -101,6 +105,20 @@ class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
     return debugString_;
   }
 
+  /// Replaces 'spec', the ScanSpec of a member under a child of 'this', with
+  /// 'constant' for the current batch. The previous value is restored by
+  /// restorePrunedScanSpecs(owner) or at the next read() of 'this', so that
+  /// later batches and splits read the member again. 'owner' identifies the
+  /// ColumnLoader that pruned 'spec'.
+  void pruneScanSpec(
+      const void* owner,
+      velox::common::ScanSpec& spec,
+      VectorPtr constant);
+
+  /// Restores the ScanSpecs pruned for 'owner', or all of them if 'owner' is
+  /// nullptr.
+  void restorePrunedScanSpecs(const void* owner = nullptr);
+
   void setCurrentRowNumber(int64_t value) final {
     currentRowNumber_ = value;
   }
@@ -223,6 +241,16 @@ class SelectiveStructColumnReaderBase : public SelectiveColumnReader {
   // After read() call mutation_ could go out of scope.  Need to keep this
   // around for lazy columns.
   bool hasDeletion_ = false;
+
+  struct PrunedScanSpec {
+    const void* owner;
+    velox::common::ScanSpec* spec;
+    // The constant value of 'spec' before pruning.
+    VectorPtr constantValue;
+  };
+
+  // The ScanSpecs pruned for the current batch, in pruning order.
+  std::vector<PrunedScanSpec> prunedScanSpecs_;
 };
 
 class SelectiveStructColumnReader : public SelectiveStructColumnReaderBase {
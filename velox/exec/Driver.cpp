@@ -19,6 +19,7 @@
 #include <atomic>
 
 #include "velox/common/process/TraceContext.h"
+#include "velox/exec/DriverScheduler.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/OperatorType.h"
 #include "velox/exec/Task.h"
@@ -218,7 +219,13 @@ std::optional<common::SpillConfig> DriverCtx::makeSpillConfig(
           ? std::optional<common::PrefixSortConfig>(prefixSortConfig())
           : std::nullopt,
       fileCreateConfig,
-      queryConfig.windowSpillMinReadBatchRows());
+      queryConfig.windowSpillMinReadBatchRows(),
+      queryConfig.spillRowFormatEnabled(),
+      queryConfig.spillReadAheadEnabled(),
+      queryConfig.spillMergeReadBufferBudget(),
+      task->spillDiskSet(),
+      queryConfig.spillMemoryTierEnabled(),
+      queryConfig.spillAdaptiveCompressionEnabled());
 }
 
 std::atomic_uint64_t BlockingState::numBlockedDrivers_{0};
@@ -318,8 +325,15 @@ void Driver::enqueue(std::shared_ptr<Driver> driver) {
   if (driver->closed_) {
     return;
   }
-  driver->task()->queryCtx()->executor()->add(
-      [driver]() { Driver::run(driver); });
+  auto* executor = driver->task()->queryCtx()->executor();
+  if (auto* scheduler = dynamic_cast<DriverScheduler*>(executor)) {
+    scheduler->schedule(
+        driver->task(), *driver->driverCtx(), [driver]() {
+          Driver::run(driver);
+        });
+    return;
+  }
+  executor->add([driver]() { Driver::run(driver); });
 }
 
 void Driver::init(
@@ -334,6 +348,7 @@ void Driver::init(
   operators_ = std::move(operators);
   curOperatorId_ = operators_.size() - 1;
   trackOperatorCpuUsage_ = ctx_->queryConfig().operatorTrackCpuUsage();
+  trackOperatorPerfCounters_ = ctx_->queryConfig().operatorTrackPerfCounters();
 }
 
 void Driver::initializeOperators() {
@@ -344,6 +359,17 @@ void Driver::initializeOperators() {
   for (auto& op : operators_) {
     op->initialize();
   }
+  auto* profiler = task()->profiler();
+  stackSampler_ = profiler != nullptr ? profiler->cpuSampler() : nullptr;
+  if (stackSampler_ != nullptr) {
+    pipelineLabelId_ = stackSampler_->labelId(
+        TaskProfiler::pipelineLabel(ctx_->pipelineId));
+    operatorLabelIds_.reserve(operators_.size());
+    for (const auto& op : operators_) {
+      operatorLabelIds_.push_back(
+          stackSampler_->labelId(TaskProfiler::operatorLabel(*op)));
+    }
+  }
 }
 
 RowVectorPtr Driver::next(
@@ -385,6 +411,47 @@ RowVectorPtr Driver::next(
   return result;
 }
 
+void Driver::reclaimCooperatively(
+    uint64_t targetBytes,
+    memory::MemoryReclaimer::Stats& stats) {
+  std::vector<Operator*> operators;
+  for (auto& op : operators_) {
+    if (op->supportsCooperativeReclaim() && op->canReclaim()) {
+      operators.push_back(op.get());
+    }
+  }
+  std::sort(operators.begin(), operators.end(), [](auto* left, auto* right) {
+    return left->pool()->reservedBytes() > right->pool()->reservedBytes();
+  });
+
+  // Allows the spilling operators to exceed the capacity of the query like
+  // the reclaims that the arbitrator runs.
+  memory::ScopedMemoryArbitrationContext arbitrationCtx;
+  uint64_t reclaimedBytes{0};
+  for (auto* op : operators) {
+    if (reclaimedBytes >= targetBytes) {
+      break;
+    }
+    RuntimeStatWriterScopeGuard opStatsGuard(op);
+    reclaimedBytes += memory::MemoryReclaimer::run(
+        [&]() {
+          int64_t opReclaimedBytes{0};
+          {
+            memory::ScopedReclaimedBytesRecorder recorder(
+                op->pool(), &opReclaimedBytes);
+            op->reclaim(targetBytes - reclaimedBytes, stats);
+          }
+          VELOX_CHECK_GE(
+              opReclaimedBytes,
+              0,
+              "Unexpected memory growth after reclaim from operator memory pool {}",
+              op->pool()->name());
+          return opReclaimedBytes;
+        },
+        stats);
+  }
+}
+
 void Driver::enqueueInternal() {
   VELOX_CHECK(!state_.isEnqueued);
   state_.isEnqueued = true;
@@ -400,6 +467,8 @@ void Driver::enqueueInternal() {
     RuntimeStatWriterScopeGuard statsWriterGuard(operatorPtr);             \
     threadNumVeloxThrow() = 0;                                             \
     opCallStatus_.start(operatorId, operatorMethod);                       \
+    process::ScopedProfileFrame profileFrame(                              \
+        stackSampler_, stackSampler_ ? operatorLabelIds_[operatorId] : 0); \
     ExceptionContextSetter exceptionContext(                               \
         {addContextOnException, operatorPtr, true});                       \
     auto stopGuard = folly::makeGuard([&]() { opCallStatus_.stop(); });    \
@@ -593,6 +662,7 @@ StopReason Driver::runInternal(
   try {
     // Invoked to initialize the operators once before driver starts execution.
     initializeOperators();
+    process::ScopedProfileFrame pipelineFrame(stackSampler_, pipelineLabelId_);
     int32_t startingOperator = getStartingOperator();
 
     TestValue::adjust("facebook::velox::exec::Driver::runInternal", this);
@@ -626,6 +696,13 @@ StopReason Driver::runInternal(
           return StopReason::kYield;
         }
 
+        const auto reclaimId = task()->cooperativeReclaimId();
+        if (FOLLY_UNLIKELY(
+                reclaimId != 0 && reclaimId != cooperativeReclaimId_)) {
+          cooperativeReclaimId_ = reclaimId;
+          task()->reclaimCooperatively(*this, reclaimId);
+        }
+
         auto* op = operators_[i].get();
 
         // In case we are blocked, this index will point to the operator, whose
@@ -932,6 +1009,12 @@ void Driver::closeOperators() {
     op->close();
   }
 
+  if (auto* profiler = task()->profiler()) {
+    for (const auto& op : operators_) {
+      profiler->addOperatorMemory(ctx_->pipelineId, *op);
+    }
+  }
+
   // Report driver-level lifecycle timing to the Task accumulator.
   // Use partitionId (0..numDrivers-1) so same-index drivers across split
   // groups in grouped execution are summed together.
@@ -1180,6 +1263,24 @@ std::unordered_set<column_index_t> Driver::canPushdownFilters(
   return supportedChannels;
 }
 
+bool Driver::pushdownLimit(
+    Operator* limitSource,
+    uint64_t numRows,
+    uint64_t limit) {
+  const int limitSourceIndex = operatorIndex(limitSource);
+  {
+    auto lk = pushdownFilters_->at(limitSourceIndex).wlock();
+    lk->numLimitRows += numRows;
+    if (lk->numLimitRows < limit) {
+      return false;
+    }
+  }
+  // Locks are taken downstream first, so the source lock is taken after
+  // releasing the lock on 'limitSource'.
+  pushdownFilters_->at(0).wlock()->limitReached = true;
+  return true;
+}
+
 int Driver::pushdownFilters(
     Operator* filterSource,
     const std::vector<column_index_t>& channels,
@@ -1364,6 +1465,21 @@ void Driver::withDeltaCpuWallTimer(
     Operator* op,
     TimingMemberPtr opTimingMember,
     Func&& opFunction) {
+  // Counts the hardware events of the operator call if
+  // 'trackOperatorPerfCounters_' is true and the thread has perf counters.
+  auto* perfCounters = trackOperatorPerfCounters_
+      ? process::PerfCounters::forThread()
+      : nullptr;
+  const auto perfStart = perfCounters != nullptr
+      ? perfCounters->read()
+      : process::PerfCounters::Values{};
+  auto perfGuard = folly::makeGuard([&]() {
+    if (perfCounters != nullptr) {
+      recordPerfCounters(
+          *op, process::PerfCounters::delta(perfStart, perfCounters->read()));
+    }
+  });
+
   // If 'trackOperatorCpuUsage_' is true, create and initialize the timer object
   // to track cpu and wall time of the opFunction.
   if (!trackOperatorCpuUsage_) {
@@ -1385,6 +1501,18 @@ void Driver::withDeltaCpuWallTimer(
   opFunction();
 }
 
+void Driver::recordPerfCounters(
+    Operator& op,
+    const process::PerfCounters::Values& counts) {
+  op.addRuntimeStat(OperatorStats::kPerfCycles, RuntimeCounter(counts.cycles));
+  op.addRuntimeStat(
+      OperatorStats::kPerfInstructions, RuntimeCounter(counts.instructions));
+  op.addRuntimeStat(
+      OperatorStats::kPerfCacheMisses, RuntimeCounter(counts.cacheMisses));
+  op.addRuntimeStat(
+      OperatorStats::kPerfBranchMisses, RuntimeCounter(counts.branchMisses));
+}
+
 void Driver::validateOperatorOutputResult(
     const RowVectorPtr& result,
     const Operator& op) {
@@ -28,6 +28,9 @@
 #include "velox/common/base/Counters.h"
 #include "velox/common/base/Portability.h"
 #include "velox/common/base/StatsReporter.h"
+#include "velox/common/memory/MemoryArbitrator.h"
+#include "velox/common/process/PerfCounters.h"
+#include "velox/common/process/StackSampler.h"
 #include "velox/common/time/CpuWallTimer.h"
 #include "velox/core/PlanFragment.h"
 #include "velox/exec/BlockingReason.h"
@@ -352,6 +355,14 @@ struct PushdownFilters {
   /// Whether static filters has been added to filters.  This only needs to be
   /// done once per node by the first driver.
   bool staticFiltersInitialized = false;
+
+  /// Rows output so far by all drivers of a Limit node. See
+  /// Driver::pushdownLimit().
+  uint64_t numLimitRows = 0;
+
+  /// Set on the source node once a Limit downstream has output enough rows
+  /// across all drivers. The source stops reading after this is set.
+  bool limitReached = false;
 };
 
 /// Pushdown filters on nodes in the pipeline.  Locks must be acquired in the
@@ -427,6 +438,14 @@ class Driver : public std::enable_shared_from_this<Driver> {
   /// memory arbitration finishes.
   bool checkUnderArbitration(ContinueFuture* future);
 
+  /// Reclaims up to 'targetBytes' from the operators of this driver that
+  /// support cooperative reclaim, largest first. Runs on the thread of this
+  /// driver at an operator boundary, while the other drivers of the task keep
+  /// running. See Task::requestCooperativeReclaim().
+  void reclaimCooperatively(
+      uint64_t targetBytes,
+      memory::MemoryReclaimer::Stats& stats);
+
   /// Accumulates blocked time for driver-level lifecycle tracking.
   /// Called from BlockingState::setResume() when the blocking future resolves.
   void addDriverBlockedTime(uint64_t nanos) {
@@ -466,6 +485,12 @@ class Driver : public std::enable_shared_from_this<Driver> {
       const std::function<bool(column_index_t, common::FilterPtr&)>&
           makeFilter);
 
+  /// Adds 'numRows' to the rows output by all drivers of 'limitSource', a
+  /// Limit without offset. Once these reach 'limit', sets the limitReached
+  /// flag on the source of the pipeline so that it stops reading. Returns true
+  /// if the limit is reached, in which case 'limitSource' should finish.
+  bool pushdownLimit(Operator* limitSource, uint64_t numRows, uint64_t limit);
+
   int operatorIndex(const Operator* op) const;
 
   const std::shared_ptr<PipelinePushdownFilters>& pushdownFilters() const {
@@ -666,6 +691,12 @@ class Driver : public std::enable_shared_from_this<Driver> {
       TimingMemberPtr opTimingMember,
       Func&& opFunction);
 
+  // Adds the hardware performance 'counts' of a call of 'op' to its runtime
+  // stats.
+  void recordPerfCounters(
+      Operator& op,
+      const process::PerfCounters::Values& counts);
+
   // Adjusts 'timing' by removing the lazy load wall time, CPU time, and input
   // bytes accrued since last time timing information was recorded for 'op'. The
   // accrued lazy load times are credited to the source operator of 'this'. The
@@ -702,6 +733,10 @@ class Driver : public std::enable_shared_from_this<Driver> {
   // If not zero, specifies the driver cpu time slice.
   size_t cpuSliceMs_{0};
 
+  // The last request of Task::requestCooperativeReclaim() this driver has
+  // taken part in.
+  uint64_t cooperativeReclaimId_{0};
+
   bool operatorsInitialized_{false};
 
   std::atomic_bool closed_{false};
@@ -756,6 +791,15 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   bool trackOperatorCpuUsage_;
 
+  bool trackOperatorPerfCounters_{false};
+
+  // The CPU sampler of the task profiler and the ids of the frame labels of
+  // the pipeline and of 'operators_'. Set by initializeOperators() if the task
+  // is profiled.
+  process::StackSampler* stackSampler_{nullptr};
+  int32_t pipelineLabelId_{0};
+  std::vector<int32_t> operatorLabelIds_;
+
   // Indicates that a DriverAdapter can rearrange Operators. Set to false at end
   // of DriverFactory::createDriver().
   bool isAdaptable_{true};
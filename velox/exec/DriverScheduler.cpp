@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/DriverScheduler.h"
+
+#include <algorithm>
+#include <optional>
+
+#include <folly/ScopeGuard.h>
+
+#include "velox/common/base/Counters.h"
+#include "velox/common/base/StatsReporter.h"
+#include "velox/common/process/ProcessBase.h"
+#include "velox/common/time/Timer.h"
+#include "velox/exec/Task.h"
+
+namespace facebook::velox::exec {
+namespace {
+std::vector<std::string> makeLevelNames(size_t numLevels) {
+  std::vector<std::string> names;
+  names.reserve(numLevels);
+  for (auto i = 0; i < numLevels; ++i) {
+    names.push_back(std::to_string(i));
+  }
+  return names;
+}
+} // namespace
+
+MultiLevelDriverScheduler::MultiLevelDriverScheduler(
+    folly::Executor* executor,
+    Options options)
+    : executor_(executor),
+      levelThresholdNanos_(std::move(options.levelThresholdNanos)),
+      levelNames_(makeLevelNames(levelThresholdNanos_.size() + 1)) {
+  VELOX_CHECK_NOT_NULL(executor_);
+  VELOX_CHECK_GE(options.levelShareRatio, 1);
+  for (auto i = 1; i < levelThresholdNanos_.size(); ++i) {
+    VELOX_CHECK_GT(levelThresholdNanos_[i], levelThresholdNanos_[i - 1]);
+  }
+  const auto numLevels = levelThresholdNanos_.size() + 1;
+  levels_.resize(numLevels);
+  // The last level has share 1.
+  double share = 1;
+  for (auto i = numLevels; i-- > 0;) {
+    levels_[i].share = share;
+    share *= options.levelShareRatio;
+  }
+  stats_.numRuns.resize(numLevels);
+  stats_.queuedNanos.resize(numLevels);
+  stats_.cpuNanos.resize(numLevels);
+}
+
+void MultiLevelDriverScheduler::add(folly::Func func) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    functions_.push_back(std::move(func));
+  }
+  executor_->add([this]() { runNext(); });
+}
+
+void MultiLevelDriverScheduler::schedule(
+    const std::shared_ptr<Task>& task,
+    const DriverCtx& /*driverCtx*/,
+    folly::Func run) {
+  auto* queryCtx = task->queryCtx().get();
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto& level = levels_[levelLocked(task)];
+    if (level.numQueued == 0) {
+      // A level that had no drivers does not get the CPU share it did not use
+      // in the meantime.
+      for (const auto& other : levels_) {
+        if (other.numQueued > 0) {
+          level.normalizedCpuNanos =
+              std::max(level.normalizedCpuNanos, other.normalizedCpuNanos);
+        }
+      }
+    }
+    ++queryStateLocked(queryCtx).numPending;
+    level.queries[queryCtx].push_back(
+        Entry{std::move(run), task.get(), queryCtx, getCurrentTimeNano()});
+    ++level.numQueued;
+  }
+  executor_->add([this]() { runNext(); });
+}
+
+int32_t MultiLevelDriverScheduler::levelLocked(
+    const std::shared_ptr<Task>& task) {
+  auto it = tasks_.find(task.get());
+  if (it == tasks_.end()) {
+    if (tasks_.size() >= 2 * std::max<size_t>(numTasksAfterCleanup_, 64)) {
+      // Removes the tasks that are gone.
+      for (auto cleanupIt = tasks_.begin(); cleanupIt != tasks_.end();) {
+        if (cleanupIt->second.task.expired()) {
+          cleanupIt = tasks_.erase(cleanupIt);
+        } else {
+          ++cleanupIt;
+        }
+      }
+      numTasksAfterCleanup_ = tasks_.size();
+    }
+    it = tasks_.emplace(task.get(), TaskState{task, 0}).first;
+  } else if (it->second.task.lock() != task) {
+    // A new task at the address of one that is gone.
+    it->second = TaskState{task, 0};
+  }
+  return std::upper_bound(
+             levelThresholdNanos_.begin(),
+             levelThresholdNanos_.end(),
+             it->second.cpuNanos) -
+      levelThresholdNanos_.begin();
+}
+
+MultiLevelDriverScheduler::QueryState&
+MultiLevelDriverScheduler::queryStateLocked(core::QueryCtx* queryCtx) {
+  auto it = queries_.find(queryCtx);
+  if (it != queries_.end()) {
+    return it->second;
+  }
+  // A query that starts or comes back after having no drivers starts even with
+  // the query that has used the least CPU, so that it neither takes over the
+  // CPU nor waits for the others to catch up with its past usage.
+  std::optional<double> minCpuNanos;
+  for (const auto& [_, query] : queries_) {
+    if (!minCpuNanos.has_value() || query.normalizedCpuNanos < *minCpuNanos) {
+      minCpuNanos = query.normalizedCpuNanos;
+    }
+  }
+  const auto weight = queryCtx->queryConfig().driverSchedulingWeight();
+  VELOX_CHECK_GT(weight, 0, "driver_scheduling_weight must be positive");
+  return queries_
+      .emplace(
+          queryCtx,
+          QueryState{static_cast<double>(weight), minCpuNanos.value_or(0)})
+      .first->second;
+}
+
+int32_t MultiLevelDriverScheduler::nextLevelLocked() {
+  int32_t next = -1;
+  for (auto i = 0; i < levels_.size(); ++i) {
+    if (levels_[i].numQueued > 0 &&
+        (next < 0 ||
+         levels_[i].normalizedCpuNanos < levels_[next].normalizedCpuNanos)) {
+      next = i;
+    }
+  }
+  VELOX_CHECK_GE(next, 0, "No driver to run");
+  return next;
+}
+
+void MultiLevelDriverScheduler::runNext() {
+  folly::Func func;
+  Entry entry;
+  int32_t levelIndex{0};
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (!functions_.empty()) {
+      func = std::move(functions_.front());
+      functions_.pop_front();
+    } else {
+      levelIndex = nextLevelLocked();
+      auto& level = levels_[levelIndex];
+      // Takes the first driver of the query with the least CPU time for its
+      // weight.
+      auto next = level.queries.end();
+      double nextCpuNanos{0};
+      for (auto it = level.queries.begin(); it != level.queries.end(); ++it) {
+        const auto cpuNanos = queries_.at(it->first).normalizedCpuNanos;
+        if (next == level.queries.end() || cpuNanos < nextCpuNanos) {
+          next = it;
+          nextCpuNanos = cpuNanos;
+        }
+      }
+      entry = std::move(next->second.front());
+      next->second.pop_front();
+      if (next->second.empty()) {
+        level.queries.erase(next);
+      }
+      --level.numQueued;
+    }
+  }
+  if (func) {
+    func();
+    return;
+  }
+
+  const auto queuedNanos = getCurrentTimeNano() - entry.enqueueTimeNs;
+  const auto startCpuNanos = process::threadCpuNanos();
+  SCOPE_EXIT {
+    recordRun(
+        levelIndex,
+        entry,
+        queuedNanos,
+        process::threadCpuNanos() - startCpuNanos);
+  };
+  entry.run();
+}
+
+void MultiLevelDriverScheduler::recordRun(
+    int32_t levelIndex,
+    const Entry& entry,
+    uint64_t queuedNanos,
+    uint64_t cpuNanos) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    auto& level = levels_[levelIndex];
+    level.normalizedCpuNanos += cpuNanos / level.share;
+
+    auto taskIt = tasks_.find(entry.task);
+    if (taskIt != tasks_.end()) {
+      taskIt->second.cpuNanos += cpuNanos;
+    }
+
+    auto queryIt = queries_.find(entry.queryCtx);
+    VELOX_CHECK(queryIt != queries_.end());
+    queryIt->second.normalizedCpuNanos += cpuNanos / queryIt->second.weight;
+    if (--queryIt->second.numPending == 0) {
+      queries_.erase(queryIt);
+    }
+
+    ++stats_.numRuns[levelIndex];
+    stats_.queuedNanos[levelIndex] += queuedNanos;
+    stats_.cpuNanos[levelIndex] += cpuNanos;
+  }
+
+  RECORD_DYNAMIC_QUANTILE_STAT_VALUE(
+      kMetricDriverSchedulerQueuedTimeMs,
+      subkeys(levelNames_[levelIndex]),
+      queuedNanos / 1'000'000);
+  RECORD_DYNAMIC_QUANTILE_STAT_VALUE(
+      kMetricDriverSchedulerCpuTimeUs,
+      subkeys(levelNames_[levelIndex]),
+      cpuNanos / 1'000);
+}
+
+MultiLevelDriverScheduler::Stats MultiLevelDriverScheduler::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return stats_;
+}
+} // namespace facebook::velox::exec
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <folly/Executor.h>
+#include <folly/container/F14Map.h>
+
+namespace facebook::velox::core {
+class QueryCtx;
+} // namespace facebook::velox::core
+
+namespace facebook::velox::exec {
+
+struct DriverCtx;
+class Task;
+
+/// An executor that decides where and in which order queued drivers run. When
+/// it is the executor of a QueryCtx, Driver::enqueue() passes each driver that
+/// is ready to run to schedule() together with the task it belongs to, instead
+/// of adding it with add() like to a plain executor. add() still runs the
+/// other work of the query, e.g. future callbacks.
+class DriverScheduler : public folly::Executor {
+ public:
+  /// Queues 'run', which runs the driver of 'task' with 'driverCtx' until it
+  /// blocks, yields or finishes.
+  virtual void schedule(
+      const std::shared_ptr<Task>& task,
+      const DriverCtx& driverCtx,
+      folly::Func run) = 0;
+};
+
+/// Multi-level feedback queue of drivers. A driver is queued at the level
+/// given by the CPU time its task has used so far, so that short queries run
+/// ahead of long ones that started earlier. Levels that have drivers share the
+/// CPU with each level getting 'levelShareRatio' times the CPU time of the
+/// next one. Within a level, queries share the CPU in proportion to their
+/// 'driver_scheduling_weight' query config, and the drivers of a query run in
+/// FIFO order. Functions passed to add() run ahead of all drivers.
+///
+/// Drivers run on 'executor', which is typically a thread pool: each queued
+/// driver or function adds a closure to 'executor' that runs the driver or
+/// function that is first at the time the closure runs. A driver stays on the
+/// thread until it blocks, so 'driver_cpu_time_slice_limit_ms' sets the
+/// scheduling quantum. The scheduler must outlive the closures it adds.
+class MultiLevelDriverScheduler : public DriverScheduler {
+ public:
+  struct Options {
+    /// The CPU time of a task in nanoseconds from which its drivers go to the
+    /// next level. Must be increasing. Level 0 has the tasks below the first
+    /// threshold.
+    std::vector<uint64_t> levelThresholdNanos{
+        1'000'000'000,
+        10'000'000'000,
+        60'000'000'000,
+        300'000'000'000};
+
+    /// The CPU time share of a level relative to the next level.
+    double levelShareRatio{2};
+  };
+
+  struct Stats {
+    /// The number of driver runs, their total time in queue and their total
+    /// CPU time by level.
+    std::vector<uint64_t> numRuns;
+    std::vector<uint64_t> queuedNanos;
+    std::vector<uint64_t> cpuNanos;
+  };
+
+  explicit MultiLevelDriverScheduler(
+      folly::Executor* executor,
+      Options options = {});
+
+  void add(folly::Func func) override;
+
+  void schedule(
+      const std::shared_ptr<Task>& task,
+      const DriverCtx& driverCtx,
+      folly::Func run) override;
+
+  int32_t numLevels() const {
+    return levels_.size();
+  }
+
+  Stats stats() const;
+
+ private:
+  struct Entry {
+    folly::Func run;
+    const Task* task{nullptr};
+    core::QueryCtx* queryCtx{nullptr};
+    uint64_t enqueueTimeNs{0};
+  };
+
+  struct Level {
+    /// The relative CPU share of the level.
+    double share{1};
+    /// The CPU time used by the level divided by 'share'.
+    double normalizedCpuNanos{0};
+    int64_t numQueued{0};
+    folly::F14FastMap<core::QueryCtx*, std::deque<Entry>> queries;
+  };
+
+  struct QueryState {
+    double weight{1};
+    /// The CPU time used by the query divided by 'weight'.
+    double normalizedCpuNanos{0};
+    /// The number of queued and running drivers of the query.
+    int32_t numPending{0};
+  };
+
+  struct TaskState {
+    std::weak_ptr<Task> task;
+    uint64_t cpuNanos{0};
+  };
+
+  // Runs the first function or driver.
+  void runNext();
+
+  // Returns the level of the drivers of 'task'.
+  int32_t levelLocked(const std::shared_ptr<Task>& task);
+
+  QueryState& queryStateLocked(core::QueryCtx* queryCtx);
+
+  // Returns the index of the level with queued drivers that has the least
+  // normalized CPU time.
+  int32_t nextLevelLocked();
+
+  // Charges the CPU time of a driver run to its level, task and query.
+  void recordRun(
+      int32_t levelIndex,
+      const Entry& entry,
+      uint64_t queuedNanos,
+      uint64_t cpuNanos);
+
+  folly::Executor* const executor_;
+  const std::vector<uint64_t> levelThresholdNanos_;
+  const std::vector<std::string> levelNames_;
+
+  mutable std::mutex mutex_;
+  std::deque<folly::Func> functions_;
+  std::vector<Level> levels_;
+  folly::F14FastMap<core::QueryCtx*, QueryState> queries_;
+  folly::F14FastMap<const Task*, TaskState> tasks_;
+  // The size of 'tasks_' after the last removal of finished tasks.
+  size_t numTasksAfterCleanup_{0};
+  Stats stats_;
+};
+} // namespace facebook::velox::exec
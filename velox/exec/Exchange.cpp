@@ -16,6 +16,7 @@
 #include "velox/exec/Exchange.h"
 #include "velox/common/Casts.h"
 #include "velox/common/serialization/Serializable.h"
+#include "velox/exec/InProcessExchange.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
 #include "velox/serializers/CompactRowSerializer.h"
@@ -43,11 +44,17 @@ void RemoteConnectorSplit::registerSerDe() {
 }
 
 namespace {
+bool isVectorPage(const SerializedPageBase& page) {
+  return dynamic_cast<const VectorPage*>(&page) != nullptr;
+}
+
 std::unique_ptr<folly::IOBuf> mergePages(
     std::vector<std::unique_ptr<SerializedPageBase>>& pages) {
   VELOX_CHECK(!pages.empty());
   std::unique_ptr<folly::IOBuf> mergedBufs;
   for (const auto& page : pages) {
+    VELOX_CHECK(
+        !isVectorPage(*page), "Vector pages and row pages cannot be merged");
     if (mergedBufs == nullptr) {
       mergedBufs = page->getIOBuf();
     } else {
@@ -56,6 +63,18 @@ std::unique_ptr<folly::IOBuf> mergePages(
   }
   return mergedBufs;
 }
+
+// Returns true if a column of 'vector' is dictionary or constant encoded.
+bool hasEncodedColumn(const RowVector& vector) {
+  for (const auto& child : vector.children()) {
+    const auto encoding = child->encoding();
+    if (encoding == VectorEncoding::Simple::DICTIONARY ||
+        encoding == VectorEncoding::Simple::CONSTANT) {
+      return true;
+    }
+  }
+  return false;
+}
 } // namespace
 
 Exchange::Exchange(
@@ -183,6 +202,10 @@ bool Exchange::isFinished() {
 }
 
 RowVectorPtr Exchange::getOutput() {
+  if (!currentPages_.empty() && inputStream_ == nullptr &&
+      isVectorPage(*currentPages_[columnarPageIdx_])) {
+    return getOutputFromVectorPage();
+  }
   auto* serde = getSerde();
   if (serde->supportsAppendInDeserialize()) {
     return getOutputFromColumnarPages(serde);
@@ -209,6 +232,7 @@ RowVectorPtr Exchange::getOutputFromColumnarPages(VectorSerde* serde) {
   // batch size.
   uint64_t rawInputBytes = 0;
   vector_size_t resultOffset{0};
+  bool hasEncodedColumns{false};
 
   // Should be either starting fresh or continuing from a previous partial page
   VELOX_CHECK(
@@ -217,6 +241,10 @@ RowVectorPtr Exchange::getOutputFromColumnarPages(VectorSerde* serde) {
   // Iterate through pages
   while (columnarPageIdx_ < currentPages_.size()) {
     auto& page = currentPages_[columnarPageIdx_];
+    if (!inputStream_ && isVectorPage(*page)) {
+      // Returned by the next call.
+      break;
+    }
 
     if (!inputStream_) {
       // NOTE: 'rawInputBytes' only counts bytes from pages processed from the
@@ -229,7 +257,8 @@ RowVectorPtr Exchange::getOutputFromColumnarPages(VectorSerde* serde) {
 
     // Inner loop: deserialize vectors from current page until batch is full
     // or page is exhausted.
-    while (!inputStream_->atEnd() && resultOffset < numRows) {
+    while (!inputStream_->atEnd() && resultOffset < numRows &&
+           !hasEncodedColumns) {
       serde->deserialize(
           inputStream_.get(),
           pool(),
@@ -239,6 +268,10 @@ RowVectorPtr Exchange::getOutputFromColumnarPages(VectorSerde* serde) {
           serdeOptions_.get());
 
       resultOffset = result_->size();
+      // Appending to dictionary or constant columns would flatten them, so
+      // the batch ends with the first page that deserializes into any.
+      hasEncodedColumns =
+          serde->preservesEncodings() && hasEncodedColumn(*result_);
     }
 
     if (inputStream_->atEnd()) {
@@ -249,7 +282,7 @@ RowVectorPtr Exchange::getOutputFromColumnarPages(VectorSerde* serde) {
     }
 
     // Stop if accumulated enough rows for this batch.
-    if (resultOffset >= numRows) {
+    if (resultOffset >= numRows || hasEncodedColumns) {
       break;
     }
   }
@@ -325,6 +358,28 @@ RowVectorPtr Exchange::getOutputFromRowPages(VectorSerde* serde) {
   return result_;
 }
 
+RowVectorPtr Exchange::getOutputFromVectorPage() {
+  auto& page = currentPages_[columnarPageIdx_];
+  const auto rawInputBytes = page->size();
+  result_ = checkedPointerCast<VectorPage>(page.get())->vector();
+  if (result_->pool()->root() != pool()->root()) {
+    // The vector is charged to another query. Copies it to charge it to this
+    // one.
+    result_ = std::static_pointer_cast<RowVector>(
+        BaseVector::copy(*result_, pool()));
+  }
+  page.reset();
+  if (++columnarPageIdx_ >= currentPages_.size()) {
+    currentPages_.clear();
+    columnarPageIdx_ = 0;
+  }
+
+  recordInputStats(rawInputBytes);
+  // 'result_' is not reused for deserializing since the producer may still
+  // reference the vector.
+  return std::move(result_);
+}
+
 void Exchange::recordInputStats(uint64_t rawInputBytes) {
   auto lockedStats = stats_.wlock();
   lockedStats->rawInputBytes += rawInputBytes;
@@ -99,6 +99,11 @@ class Exchange : public SourceOperator {
 
   RowVectorPtr getOutputFromRowPages(VectorSerde* serde);
 
+  // Returns the vector of the VectorPage at 'columnarPageIdx_' of
+  // 'currentPages_', copied into the pool of 'this' if it belongs to another
+  // query.
+  RowVectorPtr getOutputFromVectorPage();
+
   const uint64_t preferredOutputBatchBytes_;
 
   const std::string serdeKind_;
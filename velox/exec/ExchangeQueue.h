@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <folly/container/F14Set.h>
+
 #include "velox/exec/SerializedPage.h"
 
 #include <mutex>
@@ -113,6 +115,13 @@ class ExchangeQueue {
 
   void close();
 
+  /// Keeps 'owner' alive as long as 'this'. Used for pages whose data stays
+  /// owned by their producer, e.g. vectors passed in process, since the
+  /// operators of the consumer may hold on to the data after the page is freed.
+  void retainLocked(std::shared_ptr<void> owner) {
+    retained_.insert(std::move(owner));
+  }
+
  private:
   std::vector<ContinuePromise> closeLocked() {
     queue_.clear();
@@ -190,5 +199,7 @@ class ExchangeQueue {
   int64_t receivedBytes_{0};
   // Maximum value of totalBytes_.
   int64_t peakBytes_{0};
+  // Owners of the data of received pages. See retainLocked().
+  folly::F14FastSet<std::shared_ptr<void>> retained_;
 };
 } // namespace facebook::velox::exec
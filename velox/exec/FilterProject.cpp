@@ -14,9 +14,15 @@
  * limitations under the License.
  */
 #include "velox/exec/FilterProject.h"
+
+#include <thread>
+
+#include "velox/buffer/BufferArena.h"
+#include "velox/common/base/AsyncSource.h"
 #include "velox/core/Expressions.h"
 #include "velox/exec/Driver.h"
 #include "velox/exec/OperatorType.h"
+#include "velox/exec/Task.h"
 #include "velox/expression/Expr.h"
 #include "velox/expression/FieldReference.h"
 
@@ -41,6 +47,39 @@ bool checkAddIdentityProjection(
   return false;
 }
 
+// Returns true if 'vector' or a vector it wraps or contains has a buffer
+// from a BufferArena. Only the values of flat vectors of scalar types are
+// allocated from an arena.
+bool usesArena(const BaseVector* vector) {
+  if (vector == nullptr) {
+    return false;
+  }
+  switch (vector->encoding()) {
+    case VectorEncoding::Simple::FLAT:
+      return vector->values() != nullptr &&
+          BufferArena::isArenaBuffer(*vector->values());
+    case VectorEncoding::Simple::CONSTANT:
+    case VectorEncoding::Simple::DICTIONARY:
+      return usesArena(vector->valueVector().get());
+    case VectorEncoding::Simple::ROW:
+      for (const auto& child : vector->asUnchecked<RowVector>()->children()) {
+        if (usesArena(child.get())) {
+          return true;
+        }
+      }
+      return false;
+    case VectorEncoding::Simple::ARRAY:
+      return usesArena(vector->asUnchecked<ArrayVector>()->elements().get());
+    case VectorEncoding::Simple::MAP: {
+      const auto* map = vector->asUnchecked<MapVector>();
+      return usesArena(map->mapKeys().get()) ||
+          usesArena(map->mapValues().get());
+    }
+    default:
+      return false;
+  }
+}
+
 // Split stats to attrbitute cardinality reduction to the Filter node.
 std::vector<OperatorStats> splitStats(
     const OperatorStats& combinedStats,
@@ -94,6 +133,26 @@ void loadReusedLazyVectors(
   }
 }
 
+bool containsExpensiveFunction(const Expr& expr) {
+  if (expr.vectorFunctionMetadata().expensive) {
+    return true;
+  }
+  for (const auto& input : expr.inputs()) {
+    if (containsExpensiveFunction(*input)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns true if 'vector' is a struct with unloaded lazy children. These
+// would be loaded on first access by whichever thread gets there first.
+bool hasLazyNotLoadedChildren(const BaseVector& vector) {
+  const auto* wrapped = vector.loadedVector()->wrappedVector();
+  return wrapped->encoding() == VectorEncoding::Simple::ROW &&
+      wrapped->asUnchecked<RowVector>()->containsLazyNotLoaded();
+}
+
 } // namespace
 
 FilterProject::FilterProject(
@@ -162,8 +221,32 @@ void FilterProject::initialize() {
   }
 
   numExprs_ = allExprs.size();
+  const auto& queryConfig = operatorCtx_->driverCtx()->queryConfig();
+  vectorArenaChunkSize_ = queryConfig.exprBatchArenaChunkSize();
+  if (vectorArenaChunkSize_ > 0) {
+    execCtx_ = std::make_unique<core::ExecCtx>(
+        operatorCtx_->pool(),
+        operatorCtx_->task()->queryCtx().get(),
+        vectorArenaChunkSize_);
+  }
+  if (queryConfig.exprParallelSlices() > 1 && !lazyDereference_ &&
+      !resultProjections_.empty()) {
+    maxProjectionSlices_ = queryConfig.exprParallelSlices();
+    sliceMinRows_ = std::max<uint32_t>(1, queryConfig.exprParallelSliceMinRows());
+    sliceMinCpuNanosPerRow_ = queryConfig.exprParallelSliceMinCpuNanosPerRow();
+    sliceableProjections_.assign(
+        allExprs.begin() + (hasFilter_ ? 1 : 0), allExprs.end());
+  }
   exprs_ = makeExprSetFromFlag(
-      std::move(allExprs), operatorCtx_->execCtx(), lazyDereference_);
+      std::move(allExprs), execCtx(), lazyDereference_);
+  if (maxProjectionSlices_ > 1) {
+    for (auto i = hasFilter_ ? 1 : 0; i < numExprs_; ++i) {
+      if (containsExpensiveFunction(*exprs_->expr(i))) {
+        sliceProjections_ = true;
+        break;
+      }
+    }
+  }
 
   if (numExprs_ > 0 && !identityProjections_.empty()) {
     const auto inputType = project_ ? project_->sources()[0]->outputType()
@@ -180,6 +263,12 @@ void FilterProject::initialize() {
       }
     }
   }
+  if (numExprs_ > 0 &&
+      operatorCtx_->driverCtx()->queryConfig().lazySubfieldPushdownEnabled()) {
+    initializeLazySubfields(
+        project_ ? project_->sources()[0]->outputType()
+                 : filter_->sources()[0]->outputType());
+  }
   filter_.reset();
   project_.reset();
 
@@ -189,6 +278,54 @@ void FilterProject::initialize() {
   }
 }
 
+void FilterProject::initializeLazySubfields(const RowTypePtr& inputType) {
+  std::unordered_map<column_index_t, std::vector<common::Subfield>>
+      channelSubfields;
+  std::unordered_set<column_index_t> wholeChannels;
+  for (const auto& projection : identityProjections_) {
+    wholeChannels.insert(projection.inputChannel);
+  }
+  for (const auto& expr : exprs_->exprs()) {
+    for (auto& subfield : expr->extractSubfields()) {
+      const auto channel = inputType->getChildIdxIfExists(subfield.baseName());
+      if (!channel.has_value()) {
+        continue;
+      }
+      if (subfield.path().size() == 1) {
+        wholeChannels.insert(channel.value());
+        continue;
+      }
+      channelSubfields[channel.value()].push_back(std::move(subfield));
+    }
+  }
+  for (auto& [channel, subfields] : channelSubfields) {
+    const auto& type = inputType->childAt(channel);
+    if (wholeChannels.count(channel) > 0 ||
+        !(type->isRow() || type->isArray() || type->isMap())) {
+      continue;
+    }
+    lazySubfields_.emplace_back(channel, std::move(subfields));
+  }
+}
+
+void FilterProject::pushdownLazySubfields() {
+  int64_t numPushedDown{0};
+  for (const auto& [channel, subfields] : lazySubfields_) {
+    const auto& child = input_->childAt(channel);
+    if (child->encoding() != VectorEncoding::Simple::LAZY) {
+      continue;
+    }
+    if (child->asUnchecked<LazyVector>()->pushdownSubfields(subfields)) {
+      ++numPushedDown;
+    }
+  }
+  if (numPushedDown > 0) {
+    addRuntimeStat(
+        std::string(kLazySubfieldPushdownColumns),
+        RuntimeCounter(numPushedDown));
+  }
+}
+
 void FilterProject::addInput(RowVectorPtr input) {
   input_ = std::move(input);
 }
@@ -203,15 +340,18 @@ RowVectorPtr FilterProject::getOutput() {
   }
   SCOPE_EXIT {
     input_.reset();
+    resetVectorArenas();
   };
 
   vector_size_t size = input_->size();
-  LocalSelectivityVector localRows(*operatorCtx_->execCtx(), size);
+  LocalSelectivityVector localRows(*execCtx(), size);
   auto* rows = localRows.get();
   VELOX_DCHECK_NOT_NULL(rows);
   rows->setAll();
-  EvalCtx evalCtx(
-      operatorCtx_->execCtx(), exprs_.get(), input_.get(), lazyDereference_);
+  if (!lazySubfields_.empty()) {
+    pushdownLazySubfields();
+  }
+  EvalCtx evalCtx(execCtx(), exprs_.get(), input_.get(), lazyDereference_);
 
   if (!lazyDereference_) {
     // Pre-load lazy vectors which are referenced by both expressions and
@@ -224,6 +364,7 @@ RowVectorPtr FilterProject::getOutput() {
   if (!hasFilter_) {
     VELOX_CHECK(!isIdentityProjection_);
     auto results = project(*rows, evalCtx);
+    copyOutOfVectorArena(results);
     if (!lazyDereference_) {
       loadReusedLazyVectors(input_, reusedInputChannels_);
     }
@@ -246,6 +387,7 @@ RowVectorPtr FilterProject::getOutput() {
       rows->setFromBits(filterEvalCtx_.selectedBits->as<uint64_t>(), size);
     }
     results = project(*rows, evalCtx);
+    copyOutOfVectorArena(results);
   }
 
   if (!lazyDereference_) {
@@ -258,12 +400,196 @@ RowVectorPtr FilterProject::getOutput() {
   return output;
 }
 
+void FilterProject::allocateProjectionResults(
+    const SelectivityVector& rows,
+    std::vector<VectorPtr>& results) {
+  if (execCtx_ == nullptr || execCtx_->vectorPool() == nullptr) {
+    return;
+  }
+  results.resize(numExprs_);
+  for (auto i = hasFilter_ ? 1 : 0; i < numExprs_; ++i) {
+    const auto* expr = exprs_->expr(i).get();
+    // Field references and constants do not allocate their results. Only
+    // scalar types are allocated from the arena.
+    if (expr->isFieldAccess() || expr->isConstant() ||
+        expr->type()->kind() > TypeKind::HUGEINT) {
+      continue;
+    }
+    results[i] = BaseVector::create(expr->type(), rows.end(), pool());
+  }
+}
+
+void FilterProject::copyOutOfVectorArena(std::vector<VectorPtr>& results) {
+  if (execCtx_ == nullptr || execCtx_->vectorPool() == nullptr) {
+    return;
+  }
+  for (auto& result : results) {
+    if (usesArena(result.get())) {
+      result = BaseVector::copy(*result, pool());
+    }
+  }
+}
+
+void FilterProject::resetVectorArenas() {
+  uint64_t numChunkAllocations{0};
+  const auto reset = [&](core::ExecCtx& execCtx) {
+    auto* vectorPool = execCtx.vectorPool();
+    if (vectorPool != nullptr && vectorPool->arena() != nullptr) {
+      vectorPool->resetArena();
+      numChunkAllocations += vectorPool->arena()->numChunkAllocations();
+    }
+  };
+  if (execCtx_ != nullptr) {
+    reset(*execCtx_);
+  }
+  for (auto& slice : projectionSlices_) {
+    reset(*slice.execCtx);
+  }
+  if (numChunkAllocations > numVectorArenaChunkAllocations_) {
+    addRuntimeStat(
+        std::string(kVectorArenaChunkAllocations),
+        RuntimeCounter(
+            numChunkAllocations - numVectorArenaChunkAllocations_));
+    numVectorArenaChunkAllocations_ = numChunkAllocations;
+  }
+}
+
 std::vector<VectorPtr> FilterProject::project(
     const SelectivityVector& rows,
     EvalCtx& evalCtx) {
+  if (const auto numSlices = numProjectionSlices(rows); numSlices > 1) {
+    return projectInSlices(rows, evalCtx, numSlices);
+  }
+
   std::vector<VectorPtr> results;
+  allocateProjectionResults(rows, results);
+  if (maxProjectionSlices_ <= 1 || sliceProjections_) {
+    exprs_->eval(
+        hasFilter_ ? 1 : 0, numExprs_, !hasFilter_, rows, evalCtx, results);
+    return results;
+  }
+
+  DeltaCpuWallTimeStopWatch stopWatch;
   exprs_->eval(
       hasFilter_ ? 1 : 0, numExprs_, !hasFilter_, rows, evalCtx, results);
+  serialProjectCpuNanos_ += stopWatch.elapsed().cpuNanos;
+  serialProjectRows_ += rows.countSelected();
+  sliceProjections_ = serialProjectRows_ >= sliceMinRows_ &&
+      serialProjectCpuNanos_ >= sliceMinCpuNanosPerRow_ * serialProjectRows_;
+  return results;
+}
+
+int32_t FilterProject::numProjectionSlices(
+    const SelectivityVector& rows) const {
+  if (!sliceProjections_ ||
+      operatorCtx_->task()->queryCtx()->executor() == nullptr) {
+    return 1;
+  }
+  return std::min<int64_t>(
+      maxProjectionSlices_, rows.countSelected() / sliceMinRows_);
+}
+
+std::vector<VectorPtr> FilterProject::projectInSlices(
+    const SelectivityVector& rows,
+    EvalCtx& evalCtx,
+    int32_t numSlices) {
+  while (projectionSlices_.size() < numSlices) {
+    auto& slice = projectionSlices_.emplace_back();
+    slice.execCtx = std::make_unique<core::ExecCtx>(
+        operatorCtx_->pool(),
+        operatorCtx_->task()->queryCtx().get(),
+        vectorArenaChunkSize_);
+    slice.exprSet =
+        makeExprSetFromFlag(sliceableProjections_, slice.execCtx.get());
+  }
+
+  // The slices share 'input_'. Load the inputs here so that the slices do not
+  // race on loading lazy vectors.
+  const auto& inputType = input_->type()->asRow();
+  for (const auto* field : projectionSlices_[0].exprSet->distinctFields()) {
+    const auto channel = inputType.getChildIdx(field->name());
+    evalCtx.ensureFieldLoaded(channel, rows);
+    if (hasLazyNotLoadedChildren(*input_->childAt(channel))) {
+      std::vector<VectorPtr> results;
+      allocateProjectionResults(rows, results);
+      exprs_->eval(
+          hasFilter_ ? 1 : 0, numExprs_, !hasFilter_, rows, evalCtx, results);
+      return results;
+    }
+  }
+
+  const auto rowsPerSlice =
+      bits::divRoundUp(rows.countSelected(), numSlices);
+  std::vector<SelectivityVector> sliceRows(
+      numSlices, SelectivityVector(rows.end(), false));
+  vector_size_t numRows{0};
+  rows.applyToSelected([&](auto row) {
+    sliceRows[numRows++ / rowsPerSlice].setValid(row, true);
+  });
+
+  std::vector<std::shared_ptr<AsyncSource<SliceResult>>> pending;
+  pending.reserve(numSlices);
+  const auto callerThread = std::this_thread::get_id();
+  for (auto i = 0; i < numSlices; ++i) {
+    sliceRows[i].updateBounds();
+    pending.push_back(std::make_shared<AsyncSource<SliceResult>>(
+        [this, i, &sliceRows, callerThread]() {
+          auto result = std::make_unique<SliceResult>();
+          result->madeOnCaller = std::this_thread::get_id() == callerThread;
+          auto& slice = projectionSlices_[i];
+          try {
+            EvalCtx sliceCtx(
+                slice.execCtx.get(), slice.exprSet.get(), input_.get());
+            slice.exprSet->eval(
+                0,
+                slice.exprSet->exprs().size(),
+                true,
+                sliceRows[i],
+                sliceCtx,
+                result->results);
+          } catch (const std::exception&) {
+            result->error = std::current_exception();
+          }
+          return result;
+        }));
+    // The first slice is evaluated on this thread by move() below.
+    if (i > 0) {
+      operatorCtx_->task()->queryCtx()->executor()->add(
+          [item = pending.back()]() { item->prepare(); });
+    }
+  }
+
+  std::vector<std::unique_ptr<SliceResult>> sliceResults;
+  sliceResults.reserve(numSlices);
+  std::exception_ptr error;
+  for (auto& source : pending) {
+    sliceResults.push_back(source->move());
+    // The slices made on this thread, e.g. the first one, are already in the
+    // timing of getOutput().
+    if (!sliceResults.back()->madeOnCaller) {
+      stats_.wlock()->getOutputTiming.add(source->prepareTiming());
+    }
+    if (!error && sliceResults.back()->error) {
+      error = sliceResults.back()->error;
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  std::vector<VectorPtr> results(numExprs_);
+  const auto firstProjection = hasFilter_ ? 1 : 0;
+  for (auto i = 0; i < sliceableProjections_.size(); ++i) {
+    auto& result = results[firstProjection + i];
+    result = BaseVector::create(
+        sliceableProjections_[i]->type(), rows.end(), pool());
+    for (auto slice = 0; slice < numSlices; ++slice) {
+      result->copy(
+          sliceResults[slice]->results[i].get(), sliceRows[slice], nullptr);
+    }
+  }
+  addRuntimeStat(
+      std::string(kParallelProjectSlices), RuntimeCounter(numSlices));
   return results;
 }
 
@@ -23,6 +23,20 @@
 namespace facebook::velox::exec {
 class FilterProject : public Operator {
  public:
+  /// Runtime stat keys for filter project.
+  /// Number of lazy input columns whose loader accepted the subfields accessed
+  /// by the expressions. See 'lazy_subfield_pushdown_enabled'.
+  static constexpr std::string_view kLazySubfieldPushdownColumns =
+      "lazySubfieldPushdownColumns";
+  /// Number of row slices the projections were evaluated in, for batches that
+  /// were split for parallel evaluation. See 'expression.parallel_slices'.
+  static constexpr std::string_view kParallelProjectSlices =
+      "parallelProjectSlices";
+  /// Number of chunks the vector arenas of the expressions allocated from the
+  /// memory pool. See 'expression.batch_arena_chunk_size'.
+  static constexpr std::string_view kVectorArenaChunkAllocations =
+      "vectorArenaChunkAllocations";
+
   FilterProject(
       int32_t operatorId,
       DriverCtx* driverCtx,
@@ -58,6 +72,9 @@ class FilterProject : public Operator {
 
   void close() override {
     Operator::close();
+    for (auto& slice : projectionSlices_) {
+      slice.exprSet->clear();
+    }
     if (exprs_ != nullptr) {
       exprs_->finishTracers();
       exprs_->clear();
@@ -90,6 +107,20 @@ class FilterProject : public Operator {
   }
 
  private:
+  // Copy of the projections evaluated on one slice of the rows. Exprs keep
+  // per-evaluation state, so each concurrently evaluated slice needs its own.
+  struct ProjectionSlice {
+    std::unique_ptr<core::ExecCtx> execCtx;
+    std::unique_ptr<ExprSet> exprSet;
+  };
+
+  struct SliceResult {
+    std::vector<VectorPtr> results;
+    std::exception_ptr error;
+    // True if the slice was evaluated on the thread running getOutput().
+    bool madeOnCaller{false};
+  };
+
   // Evaluate filter on all rows. Return number of rows that passed the filter.
   // Populate filterEvalCtx_.selectedBits and selectedIndices with the indices
   // of the passing rows if only some rows pass the filter. If all or no rows
@@ -103,6 +134,53 @@ class FilterProject : public Operator {
       const SelectivityVector& rows,
       EvalCtx& evalCtx);
 
+  // Returns the number of slices to evaluate the projections over 'rows' in.
+  // Returns 1 if the projections are to be evaluated serially.
+  int32_t numProjectionSlices(const SelectivityVector& rows) const;
+
+  // Splits 'rows' into 'numSlices' slices with about the same number of
+  // selected rows and evaluates the projections on each slice concurrently on
+  // the query executor. Returns the results in the same layout as project().
+  std::vector<VectorPtr> projectInSlices(
+      const SelectivityVector& rows,
+      EvalCtx& evalCtx,
+      int32_t numSlices);
+
+  // Collects into 'lazySubfields_' the subfields of input columns that the
+  // expressions only access through dereferences and subscripts.
+  void initializeLazySubfields(const RowTypePtr& inputType);
+
+  // Passes 'lazySubfields_' to the input columns that are unloaded lazy
+  // vectors.
+  void pushdownLazySubfields();
+
+  // Returns the ExecCtx of the expressions, which has a vector arena if
+  // 'expression.batch_arena_chunk_size' is set.
+  core::ExecCtx* execCtx() const {
+    return execCtx_ != nullptr ? execCtx_.get() : operatorCtx_->execCtx();
+  }
+
+  // Allocates in the memory pool of the operator the results of the
+  // projections that would otherwise come from the vector arena, so that the
+  // expressions write their results there and only their intermediate
+  // vectors use the arena. An arena buffer in the output would keep its whole
+  // chunk allocated while its retained size, which the consumers of the
+  // output limit their memory by, is only its own.
+  void allocateProjectionResults(
+      const SelectivityVector& rows,
+      std::vector<VectorPtr>& results);
+
+  // Replaces the 'results' that still use memory of the vector arena with
+  // copies in the memory pool of the operator. These are the few results
+  // that the expressions make in a new vector instead of the one from
+  // allocateProjectionResults(), e.g. when peeling dictionaries.
+  void copyOutOfVectorArena(std::vector<VectorPtr>& results);
+
+  // Lets the vector arenas of the expressions reuse the memory of the vectors
+  // of the batch that are freed, and adds the chunks they allocated to the
+  // runtime stats. Called at the end of getOutput().
+  void resetVectorArenas();
+
   // If true exprs_[0] is a filter and the other expressions are projections
   const bool hasFilter_{false};
 
@@ -114,6 +192,14 @@ class FilterProject : public Operator {
   std::shared_ptr<const core::FilterNode> filter_;
   bool initialized_{false};
 
+  // The chunk size of the vector arenas of 'execCtx_' and of the projection
+  // slices. 0 if there are no vector arenas.
+  uint64_t vectorArenaChunkSize_{0};
+
+  // The ExecCtx of 'exprs_' if it has a vector arena. The ExecCtx of the
+  // operator is used otherwise, so that no other operator gets an arena.
+  std::unique_ptr<core::ExecCtx> execCtx_;
+
   std::unique_ptr<ExprSet> exprs_;
   int32_t numExprs_;
 
@@ -136,5 +222,37 @@ class FilterProject : public Operator {
   // (no partial-row loading through pushdown hooks) and expects lazy vectors to
   // remain unloaded for downstream parallel processing.
   std::vector<column_index_t> reusedInputChannels_;
+
+  // Input channels that are neither identity projected nor referenced as a
+  // whole by any expression, paired with the subfields of the channel that the
+  // expressions reach. Empty unless 'lazy_subfield_pushdown_enabled' is set.
+  std::vector<std::pair<column_index_t, std::vector<common::Subfield>>>
+      lazySubfields_;
+
+  // The number of chunks the vector arenas allocated as of the last
+  // resetVectorArenas().
+  uint64_t numVectorArenaChunkAllocations_{0};
+
+  // Max number of slices to evaluate the projections in. 0 if slicing is
+  // disabled by 'expression.parallel_slices'.
+  uint32_t maxProjectionSlices_{0};
+  uint32_t sliceMinRows_{0};
+  uint64_t sliceMinCpuNanosPerRow_{0};
+
+  // The non-identity projections. Used to create 'projectionSlices_'. Set only
+  // if 'maxProjectionSlices_' > 1.
+  std::vector<core::TypedExprPtr> sliceableProjections_;
+
+  // CPU time and number of rows of serially evaluated projections. Used to
+  // decide whether to switch to sliced evaluation.
+  uint64_t serialProjectCpuNanos_{0};
+  uint64_t serialProjectRows_{0};
+
+  // True if the projections are evaluated in slices. Set at initialization if
+  // any projection calls a function flagged as expensive, or once the
+  // observed CPU time per row exceeds 'sliceMinCpuNanosPerRow_'.
+  bool sliceProjections_{false};
+
+  std::vector<ProjectionSlice> projectionSlices_;
 };
 } // namespace facebook::velox::exec
@@ -61,7 +61,8 @@ HashAggregation::HashAggregation(
       abandonPartialAggregationMinPct_(
           driverCtx->queryConfig().abandonPartialAggregationMinPct()),
       maxPartialAggregationMemoryUsage_(
-          driverCtx->queryConfig().maxPartialAggregationMemoryUsage()) {}
+          driverCtx->queryConfig().maxPartialAggregationMemoryUsage()),
+      memoryReserver_(this, *aggregationNode) {}
 
 void HashAggregation::initialize() {
   Operator::initialize();
@@ -203,6 +204,9 @@ void HashAggregation::addInput(RowVectorPtr input) {
     numInputRows_ += input->size();
     return;
   }
+  if (!isPartialOutput_) {
+    memoryReserver_.reserve(input);
+  }
   groupingSet_->addInput(input, mayPushdown_);
   numInputRows_ += input->size();
 
@@ -627,6 +631,7 @@ void HashAggregation::reclaim(
 }
 
 void HashAggregation::close() {
+  memoryReserver_.close();
   Operator::close();
 
   output_ = nullptr;
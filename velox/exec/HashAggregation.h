@@ -19,6 +19,7 @@
 
 #include "velox/exec/GroupingSet.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/OperatorMemoryHistory.h"
 
 namespace facebook::velox::exec {
 
@@ -75,6 +76,10 @@ class HashAggregation : public Operator {
         canSpill();
   }
 
+  bool supportsCooperativeReclaim() const override {
+    return true;
+  }
+
   void reclaim(uint64_t targetBytes, memory::MemoryReclaimer::Stats& stats)
       override;
 
@@ -145,6 +150,8 @@ class HashAggregation : public Operator {
   const int32_t abandonPartialAggregationMinPct_;
 
   int64_t maxPartialAggregationMemoryUsage_;
+  // Not used by partial aggregations, whose memory is capped.
+  OperatorMemoryReserver memoryReserver_;
   std::unique_ptr<GroupingSet> groupingSet_;
 
   // Cached from groupingSet_->hasCompactableAggregates() during initialize().
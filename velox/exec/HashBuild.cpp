@@ -77,7 +77,8 @@ HashBuild::HashBuild(
       joinBridge_(operatorCtx_->task()->getHashJoinBridgeLocked(
           operatorCtx_->driverCtx()->splitGroupId,
           planNodeId())),
-      keyChannelMap_(joinNode_->rightKeys().size()) {
+      keyChannelMap_(joinNode_->rightKeys().size()),
+      memoryReserver_(this, *joinNode_) {
   VELOX_CHECK(pool()->trackUsage());
   VELOX_CHECK_NOT_NULL(joinBridge_);
 
@@ -330,6 +331,12 @@ void HashBuild::setupSpiller(SpillPartition* spillPartition) {
   if (spillPartition != nullptr) {
     spillInputReader_ = spillPartition->createUnorderedReader(
         config->readBufferSize, pool(), spillStats_.get());
+    if (config->rowFormatEnabled && dropDuplicates_ &&
+        !abandonHashBuildDedup_) {
+      // Rows restored in the row format bypass the deduplicating hash table,
+      // so the table is built from the row container like a regular join.
+      abandonHashBuildDedup();
+    }
     VELOX_CHECK(!restoringPartitionId_.has_value());
     restoringPartitionId_ = spillPartition->id();
     const auto numPartitionBits = config->numPartitionBits;
@@ -446,6 +453,11 @@ void HashBuild::addInput(RowVectorPtr input) {
       !useHashTableCache() ||
       (cacheEntry_->builderTaskId == taskId() && !cacheEntry_->buildComplete));
 
+  if (!isInputFromSpill() && memoryReserver_.reserve(input) &&
+      spiller_ != nullptr && spiller_->spillTriggered()) {
+    // The reservation spilled this operator, so the input goes to disk.
+    pool()->release();
+  }
   ensureInputFits(input);
 
   TestValue::adjust("facebook::velox::exec::HashBuild::addInput", this);
@@ -566,6 +578,11 @@ void HashBuild::addInput(RowVectorPtr input) {
       analyzeKeys_ = hasher->mayUseValueIds();
     }
   }
+  storeInput(input);
+}
+
+void HashBuild::storeInput(const RowVectorPtr& input) {
+  const auto& hashers = table_->hashers();
   auto rows = table_->rows();
   auto nextOffset = rows->nextOffset();
   FlatVector<bool>* spillProbedFlagVector{nullptr};
@@ -693,6 +710,15 @@ void HashBuild::spillInput(const RowVectorPtr& input) {
     return;
   }
 
+  if (spiller_->rowFormat()) {
+    // All partitions are spilled once spilling is triggered, so all input
+    // goes to disk. The row format is produced from the row container.
+    storeInput(input);
+    spillStoredRows();
+    activeRows_.clearAll();
+    return;
+  }
+
   const auto numInput = input->size();
   prepareInputIndicesBuffers(numInput);
   computeSpillPartitions(input);
@@ -1087,7 +1113,11 @@ void HashBuild::processSpillInput() {
   checkRunning();
 
   while (spillInputReader_->nextBatch(spillInput_)) {
-    addInput(std::move(spillInput_));
+    if (isHashJoinTableRowSpillType(asRowType(spillInput_->type()))) {
+      addSerializedSpillInput(std::move(spillInput_));
+    } else {
+      addInput(std::move(spillInput_));
+    }
     if (!isRunning()) {
       return;
     }
@@ -1100,6 +1130,41 @@ void HashBuild::processSpillInput() {
   noMoreInputInternal();
 }
 
+void HashBuild::addSerializedSpillInput(RowVectorPtr input) {
+  checkRunning();
+  ensureInputFits(input);
+
+  const auto& serializedRows = *input->childAt(0)->asFlatVector<StringView>();
+  auto* rows = table_->rows();
+  const auto nextOffset = rows->nextOffset();
+  const auto numKeys = rows->keyTypes().size();
+  for (auto i = 0; i < input->size(); ++i) {
+    char* newRow = rows->newRow();
+    if (nextOffset) {
+      *reinterpret_cast<char**>(newRow + nextOffset) = nullptr;
+    }
+    rows->storeSerializedRow(serializedRows, i, newRow);
+    if (nullAware_ && !joinHasNullKeys_) {
+      for (auto key = 0; key < numKeys; ++key) {
+        if (RowContainer::isNullAt(newRow, rows->columnAt(key))) {
+          joinHasNullKeys_ = true;
+          break;
+        }
+      }
+    }
+  }
+
+  if (spiller_ != nullptr && spiller_->spillTriggered()) {
+    spillStoredRows();
+  }
+}
+
+void HashBuild::spillStoredRows() {
+  VELOX_CHECK(spiller_->rowFormat());
+  spiller_->spill();
+  table_->clear(true);
+}
+
 void HashBuild::addRuntimeStats() {
   // Report range sizes and number of distinct values for the join keys.
   const auto& hashers = table_->hashers();
@@ -1435,6 +1500,7 @@ bool HashBuild::nonReclaimableState() const {
 }
 
 void HashBuild::close() {
+  memoryReserver_.close();
   Operator::close();
 
   if (useHashTableCache() && cacheEntry_ != nullptr &&
@@ -1463,7 +1529,8 @@ HashBuildSpiller::HashBuildSpiller(
     exec::SpillStats* spillStats)
     : SpillerBase(
           container,
-          std::move(rowType),
+          spillConfig->rowFormatEnabled ? hashJoinTableRowSpillType()
+                                        : std::move(rowType),
           bits,
           {},
           spillConfig->maxFileSize,
@@ -1471,7 +1538,8 @@ HashBuildSpiller::HashBuildSpiller(
           parentId,
           spillConfig,
           spillStats),
-      spillProbeFlag_(needRightSideJoin(joinType)) {
+      spillProbeFlag_(needRightSideJoin(joinType)),
+      rowFormat_(spillConfig->rowFormatEnabled) {
   VELOX_CHECK(container_->accumulators().empty());
 }
 
@@ -1485,6 +1553,7 @@ void HashBuildSpiller::spill(
     const RowVectorPtr& spillVector) {
   VELOX_CHECK(spillTriggered_);
   VELOX_CHECK(!finalized_);
+  VELOX_CHECK(!rowFormat_);
   if (FOLLY_UNLIKELY(spillVector == nullptr)) {
     return;
   }
@@ -1506,6 +1575,11 @@ void HashBuildSpiller::extractSpill(
   }
 
   auto* result = resultPtr.get();
+  if (rowFormat_) {
+    // The flags, which include the probed flag, are copied with the row.
+    container_->extractSerializedRows(rows, result->childAt(0));
+    return;
+  }
   const auto& types = container_->columnTypes();
   for (auto i = 0; i < types.size(); ++i) {
     container_->extractColumn(rows.data(), rows.size(), i, result->childAt(i));
@@ -21,6 +21,7 @@
 #include "velox/exec/HashTable.h"
 #include "velox/exec/HashTableCache.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/OperatorMemoryHistory.h"
 #include "velox/exec/Spill.h"
 #include "velox/exec/Spiller.h"
 #include "velox/exec/UnorderedStreamReader.h"
@@ -222,6 +223,20 @@ class HashBuild final : public Operator {
   // Invoked to process data from spill input reader on restoring.
   void processSpillInput();
 
+  // Invoked on restoring to copy rows spilled in the row format back into the
+  // row container of 'table_'. Unlike addInput(), this neither decodes nor
+  // hashes the rows.
+  void addSerializedSpillInput(RowVectorPtr input);
+
+  // Stores the selected rows of 'activeRows_' from the decoded key and
+  // dependent columns of 'input' into the row container of 'table_'.
+  void storeInput(const RowVectorPtr& input);
+
+  // Spills all the rows of the row container of 'table_' and clears it. Used
+  // instead of spilling input vectors directly when the spiller writes the row
+  // format.
+  void spillStoredRows();
+
   // Set up for null-aware and regular anti-join with filter processing.
   void setupFilterForAntiJoins(
       const folly::F14FastMap<column_index_t, column_index_t>& keyChannelMap);
@@ -411,6 +426,8 @@ class HashBuild final : public Operator {
   // Maps key channel in 'input_' to channel in key.
   folly::F14FastMap<column_index_t, column_index_t> keyChannelMap_;
 
+  OperatorMemoryReserver memoryReserver_;
+
   // Count the number of hash table input rows for building deduped
   // hash table. It will not be updated after abandonBuildNoDupHash_ is true.
   int64_t numHashInputRows_ = 0;
@@ -447,6 +464,12 @@ class HashBuildSpiller : public SpillerBase {
     return spillTriggered_;
   }
 
+  /// Returns true if rows are spilled in the row container layout with type
+  /// hashJoinTableRowSpillType(). Vectors can then not be spilled directly.
+  bool rowFormat() const {
+    return rowFormat_;
+  }
+
  private:
   void extractSpill(folly::Range<char**> rows, RowVectorPtr& resultPtr)
       override;
@@ -461,6 +484,8 @@ class HashBuildSpiller : public SpillerBase {
 
   const bool spillProbeFlag_;
 
+  const bool rowFormat_;
+
   bool spillTriggered_{false};
 };
 } // namespace facebook::velox::exec
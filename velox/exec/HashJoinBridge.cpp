@@ -20,6 +20,7 @@
 namespace facebook::velox::exec {
 namespace {
 static const char* kSpillProbedFlagColumnName = "__probedFlag";
+static const char* kSpillSerializedRowColumnName = "__serializedRow";
 }
 
 RowTypePtr hashJoinTableType(
@@ -513,4 +514,16 @@ bool isHashJoinTableSpillType(
   }
   return spillType->nameOf(probedColumnChannel) == kSpillProbedFlagColumnName;
 }
+
+RowTypePtr hashJoinTableRowSpillType() {
+  static const RowTypePtr kType =
+      ROW({kSpillSerializedRowColumnName}, {VARBINARY()});
+  return kType;
+}
+
+bool isHashJoinTableRowSpillType(const RowTypePtr& spillType) {
+  return spillType->size() == 1 &&
+      spillType->nameOf(0) == kSpillSerializedRowColumnName &&
+      spillType->childAt(0)->isVarbinary();
+}
 } // namespace facebook::velox::exec
@@ -302,4 +302,14 @@ RowTypePtr hashJoinTableSpillType(
 bool isHashJoinTableSpillType(
     const RowTypePtr& spillType,
     core::JoinType joinType);
+
+/// Returns the type used to spill a hash table in the row format. It has a
+/// single VARBINARY column with each row serialized by
+/// RowContainer::extractSerializedRows(), including the probed flag. See
+/// common::SpillConfig::rowFormatEnabled.
+RowTypePtr hashJoinTableRowSpillType();
+
+/// Returns true if 'spillType' is the type returned by
+/// hashJoinTableRowSpillType().
+bool isHashJoinTableRowSpillType(const RowTypePtr& spillType);
 } // namespace facebook::velox::exec
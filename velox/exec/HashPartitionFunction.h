@@ -52,6 +52,12 @@ class HashPartitionFunction : public core::PartitionFunction {
     return numPartitions_;
   }
 
+  /// Returns the hashes of the partitioning keys of the rows of the last input
+  /// to partition(). Empty if there are no partitioning keys.
+  const raw_vector<uint64_t>& hashes() const {
+    return hashes_;
+  }
+
  private:
   void init(
       const RowTypePtr& inputType,
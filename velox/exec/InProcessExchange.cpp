@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/InProcessExchange.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "velox/exec/OutputTransportRegistry.h"
+#include "velox/exec/PartitionedOutput.h"
+
+namespace facebook::velox::exec {
+
+VectorPage::VectorPage(
+    RowVectorPtr vector,
+    uint64_t bytes,
+    std::shared_ptr<Task> producer) {
+  VELOX_CHECK_NOT_NULL(vector);
+  auto* handle =
+      new Handle{Handle::kMagic, std::move(vector), bytes, std::move(producer)};
+  iobuf_ = folly::IOBuf::takeOwnership(
+      handle, sizeof(Handle), [](void* buffer, void* /*userData*/) {
+        delete static_cast<Handle*>(buffer);
+      });
+}
+
+VectorPage::VectorPage(std::unique_ptr<folly::IOBuf> iobuf)
+    : iobuf_(std::move(iobuf)) {}
+
+// static
+std::unique_ptr<VectorPage> VectorPage::fromIOBuf(
+    std::unique_ptr<folly::IOBuf> iobuf) {
+  VELOX_CHECK_NOT_NULL(iobuf);
+  VELOX_CHECK(!iobuf->isChained(), "IOBuf does not carry a VectorPage");
+  VELOX_CHECK_EQ(
+      iobuf->length(), sizeof(Handle), "IOBuf does not carry a VectorPage");
+  VELOX_CHECK_EQ(
+      reinterpret_cast<const Handle*>(iobuf->data())->magic,
+      Handle::kMagic,
+      "IOBuf does not carry a VectorPage");
+  return std::unique_ptr<VectorPage>(new VectorPage(std::move(iobuf)));
+}
+
+namespace {
+
+// Reads the buffers of a producer task from InProcessOutputBufferManager. A
+// request that finds no data stays registered with the output buffer until
+// data arrives, the producer finishes or close() deletes the results.
+class InProcessExchangeSource : public ExchangeSource {
+ public:
+  InProcessExchangeSource(
+      const std::string& remoteTaskId,
+      int destination,
+      std::shared_ptr<ExchangeQueue> queue,
+      memory::MemoryPool* pool,
+      std::shared_ptr<InProcessOutputBufferManager> manager)
+      : ExchangeSource(remoteTaskId, destination, std::move(queue), pool),
+        manager_(std::move(manager)) {}
+
+  bool supportsMetrics() const override {
+    return true;
+  }
+
+  bool shouldRequestLocked() override {
+    if (atEnd_) {
+      return false;
+    }
+    return !requestPending_.exchange(true);
+  }
+
+  folly::SemiFuture<Response> request(
+      uint32_t maxBytes,
+      std::chrono::microseconds /*maxWait*/) override {
+    auto promise = VeloxPromise<Response>("InProcessExchangeSource::request");
+    auto future = promise.getSemiFuture();
+    int64_t requestedSequence;
+    {
+      std::lock_guard<std::mutex> l(queue_->mutex());
+      promise_ = std::move(promise);
+      requestedSequence = sequence_;
+    }
+
+    // The callback may outlive 'this', so it holds a reference to it.
+    auto self = shared_from_this();
+    const bool found = manager_->getData(
+        remoteTaskId_,
+        destination_,
+        maxBytes,
+        requestedSequence,
+        [self, this, requestedSequence](
+            std::vector<std::unique_ptr<folly::IOBuf>> data,
+            int64_t sequence,
+            std::vector<int64_t> remainingBytes) {
+          processData(
+              std::move(data),
+              sequence,
+              requestedSequence,
+              std::move(remainingBytes));
+        });
+    if (!found) {
+      queue_->setError(
+          fmt::format(
+              "No in-process output buffers for task {}", remoteTaskId_));
+      checkSetRequestPromise();
+    }
+    return future;
+  }
+
+  folly::SemiFuture<Response> requestDataSizes(
+      std::chrono::microseconds maxWait) override {
+    return request(0, maxWait);
+  }
+
+  void pause() override {
+    int64_t ackSequence;
+    {
+      std::lock_guard<std::mutex> l(queue_->mutex());
+      ackSequence = sequence_;
+    }
+    manager_->acknowledge(remoteTaskId_, destination_, ackSequence);
+  }
+
+  void close() override {
+    checkSetRequestPromise();
+    // Completes a pending request with no data.
+    manager_->deleteResults(remoteTaskId_, destination_);
+  }
+
+  folly::F14FastMap<std::string, RuntimeMetric> metrics() const override {
+    return {
+        {"inProcessExchangeSource.numPages", RuntimeMetric(numPages_)},
+        {"inProcessExchangeSource.totalBytes",
+         RuntimeMetric(totalBytes_, RuntimeCounter::Unit::kBytes)},
+    };
+  }
+
+ private:
+  void processData(
+      std::vector<std::unique_ptr<folly::IOBuf>> data,
+      int64_t sequence,
+      int64_t requestedSequence,
+      std::vector<int64_t> remainingBytes) {
+    if (requestedSequence > sequence && !data.empty()) {
+      const int64_t numExtra = requestedSequence - sequence;
+      VELOX_CHECK_LT(numExtra, data.size());
+      data.erase(data.begin(), data.begin() + numExtra);
+      sequence = requestedSequence;
+    }
+    const bool hasData = !data.empty();
+
+    std::vector<std::unique_ptr<VectorPage>> pages;
+    bool atEnd = false;
+    int64_t totalBytes = 0;
+    for (auto& iobuf : data) {
+      if (iobuf == nullptr) {
+        atEnd = true;
+        continue;
+      }
+      auto page = VectorPage::fromIOBuf(std::move(iobuf));
+      totalBytes += page->size();
+      pages.push_back(std::move(page));
+    }
+    numPages_ += pages.size();
+    totalBytes_ += totalBytes;
+
+    VeloxPromise<Response> requestPromise;
+    std::vector<ContinuePromise> queuePromises;
+    {
+      std::lock_guard<std::mutex> l(queue_->mutex());
+      requestPending_ = false;
+      requestPromise = std::move(promise_);
+      for (auto& page : pages) {
+        queue_->retainLocked(page->producer());
+        queue_->enqueueLocked(std::move(page), queuePromises);
+      }
+      if (atEnd) {
+        queue_->enqueueLocked(nullptr, queuePromises);
+        atEnd_ = true;
+      }
+      if (hasData) {
+        sequence_ = sequence + pages.size();
+      }
+    }
+    for (auto& promise : queuePromises) {
+      promise.setValue();
+    }
+
+    // Outside of queue mutex.
+    if (atEnd_) {
+      manager_->deleteResults(remoteTaskId_, destination_);
+    }
+    if (!requestPromise.isFulfilled()) {
+      requestPromise.setValue(
+          Response{totalBytes, atEnd_, std::move(remainingBytes)});
+    }
+  }
+
+  void checkSetRequestPromise() {
+    VeloxPromise<Response> promise{VeloxPromise<Response>::makeEmpty()};
+    {
+      std::lock_guard<std::mutex> l(queue_->mutex());
+      promise = std::move(promise_);
+    }
+    if (promise.valid() && !promise.isFulfilled()) {
+      promise.setValue(Response{0, false, {}});
+    }
+  }
+
+  const std::shared_ptr<InProcessOutputBufferManager> manager_;
+  VeloxPromise<Response> promise_{VeloxPromise<Response>::makeEmpty()};
+  std::atomic<int64_t> numPages_{0};
+  std::atomic<int64_t> totalBytes_{0};
+};
+} // namespace
+
+// static
+const std::shared_ptr<InProcessOutputBufferManager>&
+InProcessOutputBufferManager::getInstanceRef() {
+  static const auto kInstance =
+      std::make_shared<InProcessOutputBufferManager>();
+  return kInstance;
+}
+
+// static
+void InProcessOutputBufferManager::registerTransport() {
+  OutputTransportRegistry::global().insert(
+      std::string{core::TransportKind::kInProcess},
+      OutputTransportEntry::make<InProcessOutputBufferManager>(
+          getInstanceRef(),
+          [](int32_t operatorId,
+             DriverCtx* ctx,
+             const std::shared_ptr<const core::PartitionedOutputNode>& node,
+             bool eagerFlush,
+             const std::shared_ptr<InProcessOutputBufferManager>& manager)
+              -> std::unique_ptr<Operator> {
+            return std::make_unique<PartitionedOutput>(
+                operatorId, ctx, node, eagerFlush, manager);
+          }),
+      /*overwrite=*/true);
+
+  // Goes first so that the other factories do not claim the in-process
+  // producers, e.g. by the scheme of their task ids.
+  auto& factories = ExchangeSource::factories();
+  const bool registered = std::any_of(
+      factories.begin(), factories.end(), [](const auto& factory) {
+        const auto* target =
+            factory.template target<decltype(&createInProcessExchangeSource)>();
+        return target != nullptr && *target == &createInProcessExchangeSource;
+      });
+  if (!registered) {
+    factories.insert(factories.begin(), createInProcessExchangeSource);
+  }
+}
+
+std::shared_ptr<ExchangeSource> createInProcessExchangeSource(
+    const std::string& remoteTaskId,
+    int destination,
+    std::shared_ptr<ExchangeQueue> queue,
+    memory::MemoryPool* pool) {
+  const auto& manager = InProcessOutputBufferManager::getInstanceRef();
+  if (manager->getBufferIfExists(remoteTaskId) == nullptr) {
+    return nullptr;
+  }
+  return std::make_shared<InProcessExchangeSource>(
+      remoteTaskId, destination, std::move(queue), pool, manager);
+}
+} // namespace facebook::velox::exec
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/DefaultOutputBufferManager.h"
+#include "velox/exec/ExchangeSource.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::exec {
+
+class Task;
+
+/// A page that carries a vector instead of its serialization. Passed from
+/// PartitionedOutput to Exchange by the in-process transport. The vector
+/// references the memory of the producer task, which the page keeps alive.
+///
+/// Output buffers hand out pages as IOBufs, so getIOBuf() returns an IOBuf
+/// that shares ownership of the vector instead of bytes to deserialize, and
+/// fromIOBuf() turns it back into a page on the consumer side.
+class VectorPage : public SerializedPageBase {
+ public:
+  /// @param bytes The size of the rows of 'vector' for backpressure and
+  /// stats, e.g. their estimated serialized size.
+  VectorPage(
+      RowVectorPtr vector,
+      uint64_t bytes,
+      std::shared_ptr<Task> producer);
+
+  /// Returns the page carried by 'iobuf', which must come from getIOBuf().
+  static std::unique_ptr<VectorPage> fromIOBuf(
+      std::unique_ptr<folly::IOBuf> iobuf);
+
+  uint64_t size() const override {
+    return handle().bytes;
+  }
+
+  std::optional<int64_t> numRows() const override {
+    return handle().vector->size();
+  }
+
+  std::unique_ptr<ByteInputStream> prepareStreamForDeserialize() override {
+    VELOX_UNSUPPORTED("VectorPage is not serialized");
+  }
+
+  std::unique_ptr<folly::IOBuf> getIOBuf() const override {
+    return iobuf_->clone();
+  }
+
+  const RowVectorPtr& vector() const {
+    return handle().vector;
+  }
+
+  /// The task whose memory 'vector' references.
+  const std::shared_ptr<Task>& producer() const {
+    return handle().producer;
+  }
+
+ private:
+  // The contents of 'iobuf_'. Freed with the last clone of 'iobuf_'.
+  struct Handle {
+    static constexpr uint64_t kMagic{0x5645435450414745}; // "VECTPAGE"
+
+    uint64_t magic{kMagic};
+    RowVectorPtr vector;
+    uint64_t bytes;
+    std::shared_ptr<Task> producer;
+  };
+
+  explicit VectorPage(std::unique_ptr<folly::IOBuf> iobuf);
+
+  const Handle& handle() const {
+    return *reinterpret_cast<const Handle*>(iobuf_->data());
+  }
+
+  std::unique_ptr<folly::IOBuf> iobuf_;
+};
+
+/// Output buffers of the in-process transport, core::TransportKind::kInProcess.
+/// PartitionedOutput enqueues the rows of each destination as a VectorPage
+/// wrapping the rows of its input, and Exchange returns the vectors of the
+/// pages as they are, so that tasks of the same process exchange data without
+/// serializing it. Backpressure and byte accounting are the same as for the
+/// in-memory transport, with the estimated serialized size of the rows as the
+/// size of a page.
+///
+/// The vectors stay owned by the memory pools of the producer. Exchange uses
+/// them as they are if the consumer belongs to the same query as the producer,
+/// i.e. shares its root memory pool, and copies them into its own pool
+/// otherwise. The consumer keeps the producer task alive until it is
+/// destroyed, since its operators may hold on to the vectors.
+///
+/// Consumers read the buffers with the ExchangeSource registered by
+/// registerTransport(), which serves the tasks that have an output buffer in
+/// this manager. A producer task must therefore be started before the splits
+/// naming it are added to its consumers.
+class InProcessOutputBufferManager : public DefaultOutputBufferManager {
+ public:
+  InProcessOutputBufferManager() : DefaultOutputBufferManager(Options{}) {}
+
+  static const std::shared_ptr<InProcessOutputBufferManager>& getInstanceRef();
+
+  /// Registers the transport in the global OutputTransportRegistry under
+  /// core::TransportKind::kInProcess and its ExchangeSource ahead of the other
+  /// ExchangeSource factories unless already there. May be called again, e.g.
+  /// after OutputTransportRegistry::unregisterAll().
+  static void registerTransport();
+};
+
+/// Returns an ExchangeSource that reads the buffers of 'remoteTaskId' from
+/// InProcessOutputBufferManager if the task has output buffers there, nullptr
+/// otherwise.
+std::shared_ptr<ExchangeSource> createInProcessExchangeSource(
+    const std::string& remoteTaskId,
+    int destination,
+    std::shared_ptr<ExchangeQueue> queue,
+    memory::MemoryPool* pool);
+} // namespace facebook::velox::exec
@@ -28,6 +28,11 @@ Limit::Limit(
           operatorId,
           limitNode->id(),
           OperatorType::kLimit),
+      sharedLimit_{
+          limitNode->offset() == 0 &&
+                  driverCtx->queryConfig().limitPushdownEnabled()
+              ? std::optional<int64_t>(limitNode->count())
+              : std::nullopt},
       remainingOffset_{limitNode->offset()},
       remainingLimit_{limitNode->count()} {
   isIdentityProjection_ = true;
@@ -94,7 +99,7 @@ RowVectorPtr Limit::getOutput() {
   if (remainingLimit_ >= inputSize) {
     remainingLimit_ -= inputSize;
     auto output = input_;
-    return output;
+    return countTowardsSharedLimit(std::move(output));
   }
 
   auto output = std::make_shared<RowVector>(
@@ -104,6 +109,19 @@ RowVectorPtr Limit::getOutput() {
       remainingLimit_,
       input_->children());
   remainingLimit_ = 0;
+  return countTowardsSharedLimit(std::move(output));
+}
+
+RowVectorPtr Limit::countTowardsSharedLimit(RowVectorPtr output) {
+  if (!sharedLimit_.has_value()) {
+    return output;
+  }
+  // The rows of all drivers are combined downstream, so once together they
+  // reach the limit, no driver needs more input.
+  if (operatorCtx_->driver()->pushdownLimit(
+          this, output->size(), sharedLimit_.value())) {
+    finished_ = true;
+  }
   return output;
 }
 } // namespace facebook::velox::exec
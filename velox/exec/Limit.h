@@ -41,6 +41,13 @@ class Limit : public Operator {
   }
 
  private:
+  // Returns 'output' after counting its rows towards the limit shared by all
+  // drivers. Finishes this operator if the shared limit is reached.
+  RowVectorPtr countTowardsSharedLimit(RowVectorPtr output);
+
+  // Count of rows to output across all drivers if the limit is pushed down,
+  // std::nullopt otherwise.
+  const std::optional<int64_t> sharedLimit_;
   int64_t remainingOffset_;
   int64_t remainingLimit_;
   bool finished_{false};
@@ -32,28 +32,35 @@ void notify(std::vector<ContinuePromise>& promises) {
 bool LocalExchangeMemoryManager::increaseMemoryUsage(
     ContinueFuture* future,
     int64_t added) {
-  std::lock_guard<std::mutex> l(mutex_);
-  bufferedBytes_ += added;
-
-  if (bufferedBytes_ >= maxBufferSize_) {
-    promises_.emplace_back("LocalExchangeMemoryManager::updateMemoryUsage");
-    *future = promises_.back().getSemiFuture();
-    return true;
+  if (bufferedBytes_.fetch_add(added) + added < maxBufferSize_) {
+    return false;
   }
 
-  return false;
+  std::lock_guard<std::mutex> l(mutex_);
+  // Registers before checking the buffered bytes again, so that either this
+  // sees a concurrent decrease or the decrease sees the promise.
+  ++numPromises_;
+  if (bufferedBytes_ < maxBufferSize_) {
+    --numPromises_;
+    return false;
+  }
+  promises_.emplace_back("LocalExchangeMemoryManager::updateMemoryUsage");
+  *future = promises_.back().getSemiFuture();
+  return true;
 }
 
 std::vector<ContinuePromise> LocalExchangeMemoryManager::decreaseMemoryUsage(
     int64_t removed) {
   std::vector<ContinuePromise> promises;
-  {
-    std::lock_guard<std::mutex> l(mutex_);
-    bufferedBytes_ -= removed;
+  if (bufferedBytes_.fetch_sub(removed) - removed >= maxBufferSize_ ||
+      numPromises_ == 0) {
+    return promises;
+  }
 
-    if (bufferedBytes_ < maxBufferSize_) {
-      promises = std::move(promises_);
-    }
+  std::lock_guard<std::mutex> l(mutex_);
+  if (bufferedBytes_ < maxBufferSize_) {
+    promises = std::move(promises_);
+    numPromises_ = 0;
   }
   return promises;
 }
@@ -83,65 +90,94 @@ RowVectorPtr LocalExchangeVectorPool::pop() {
   });
 }
 
+LocalExchangeQueue::LocalExchangeQueue(
+    std::shared_ptr<LocalExchangeMemoryManager> memoryManager,
+    std::shared_ptr<LocalExchangeVectorPool> vectorPool,
+    int partition,
+    int32_t numShards)
+    : memoryManager_{std::move(memoryManager)},
+      vectorPool_{std::move(vectorPool)},
+      partition_{partition},
+      shards_(numShards) {
+  VELOX_CHECK_GT(numShards, 0);
+}
+
 void LocalExchangeQueue::addProducer() {
-  queue_.withWLock([&](auto& /*queue*/) {
-    VELOX_CHECK(!noMoreProducers_, "addProducer called after noMoreProducers");
-    ++pendingProducers_;
-  });
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(!noMoreProducers_, "addProducer called after noMoreProducers");
+  ++pendingProducers_;
 }
 
 void LocalExchangeQueue::noMoreProducers() {
   std::vector<ContinuePromise> consumerPromises;
-  queue_.withWLock([&](auto& queue) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK(!noMoreProducers_, "noMoreProducers can be called only once");
     noMoreProducers_ = true;
     if (pendingProducers_ == 0) {
       // No more data will be produced.
-      consumerPromises = std::move(consumerPromises_);
+      consumerPromises = takeConsumerPromisesLocked();
     }
-  });
+  }
   notify(consumerPromises);
 }
 
 void LocalExchangeQueue::drain() {
   std::vector<ContinuePromise> consumerPromises;
-  queue_.withWLock([&](auto& queue) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK(!closed_, "Queue is closed");
     ++drainedProducers_;
     VELOX_CHECK_LE(drainedProducers_, pendingProducers_);
     if (drainedProducers_ != pendingProducers_) {
       return;
     }
-    consumerPromises = std::move(consumerPromises_);
-  });
+    consumerPromises = takeConsumerPromisesLocked();
+  }
   notify(consumerPromises);
 }
 
+LocalExchangeQueue::Shard& LocalExchangeQueue::producerShard() {
+  if (shards_.size() == 1) {
+    return shards_[0];
+  }
+  // A driver runs on one thread at a time, so the data of a producer driver
+  // stays in order in its shard.
+  const auto* driverThreadCtx = driverThreadContext();
+  if (driverThreadCtx == nullptr) {
+    return shards_[0];
+  }
+  return shards_[driverThreadCtx->driverCtx()->driverId % shards_.size()];
+}
+
 BlockingReason LocalExchangeQueue::enqueue(
     RowVectorPtr input,
     int64_t inputBytes,
     ContinueFuture* future) {
-  std::vector<ContinuePromise> consumerPromises;
   bool blockedOnConsumer = false;
-  const bool isClosed = queue_.withWLock([&](auto& queue) {
+  {
+    auto& shard = producerShard();
+    std::lock_guard<std::mutex> l(shard.mutex);
+    // Checked under the shard lock so that close() either sees the data or
+    // this sees the close.
     if (closed_) {
-      return true;
+      return BlockingReason::kNotBlocked;
     }
-    queue.emplace(std::move(input), inputBytes);
-    consumerPromises = std::move(consumerPromises_);
-
+    shard.queue.emplace(std::move(input), inputBytes);
+    ++numQueued_;
     if (memoryManager_->increaseMemoryUsage(future, inputBytes)) {
       blockedOnConsumer = true;
     }
-
-    return false;
-  });
-
-  if (isClosed) {
-    return BlockingReason::kNotBlocked;
   }
 
-  notify(consumerPromises);
+  if (numWaitingConsumers_ > 0) {
+    std::vector<ContinuePromise> consumerPromises;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      consumerPromises = takeConsumerPromisesLocked();
+    }
+    notify(consumerPromises);
+  }
 
   if (blockedOnConsumer) {
     return BlockingReason::kWaitForConsumer;
@@ -152,62 +188,83 @@ BlockingReason LocalExchangeQueue::enqueue(
 
 void LocalExchangeQueue::noMoreData() {
   std::vector<ContinuePromise> consumerPromises;
-  queue_.withWLock([&](auto& queue) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
     VELOX_CHECK_EQ(drainedProducers_, 0);
     VELOX_CHECK_GT(pendingProducers_, 0);
     --pendingProducers_;
     if (noMoreProducers_ && pendingProducers_ == 0) {
-      consumerPromises = std::move(consumerPromises_);
+      consumerPromises = takeConsumerPromisesLocked();
     }
-  });
+  }
   notify(consumerPromises);
 }
 
+bool LocalExchangeQueue::tryPop(RowVectorPtr* data, int64_t* size) {
+  const uint32_t numShards = shards_.size();
+  const uint32_t startShard =
+      numShards == 1 ? 0 : nextConsumerShard_++ % numShards;
+  for (uint32_t i = 0; i < numShards; ++i) {
+    if (numQueued_ == 0) {
+      return false;
+    }
+    auto& shard = shards_[(startShard + i) % numShards];
+    std::lock_guard<std::mutex> l(shard.mutex);
+    if (shard.queue.empty()) {
+      continue;
+    }
+    std::tie(*data, *size) = std::move(shard.queue.front());
+    shard.queue.pop();
+    --numQueued_;
+    return true;
+  }
+  return false;
+}
+
 BlockingReason LocalExchangeQueue::next(
     ContinueFuture* future,
     memory::MemoryPool* pool,
     RowVectorPtr* data,
     bool& drained) {
   drained = false;
+  *data = nullptr;
   int64_t size{0};
-  std::vector<ContinuePromise> memoryPromises;
-  const auto blockingReason = queue_.withWLock([&](auto& queue) {
-    *data = nullptr;
-    if (queue.empty()) {
-      if (isFinishedLocked(queue)) {
-        return BlockingReason::kNotBlocked;
-      }
-      if (testAndClearDrainedLocked()) {
-        drained = true;
-        return BlockingReason::kNotBlocked;
-      }
-
-      consumerPromises_.emplace_back("LocalExchangeQueue::next");
-      *future = consumerPromises_.back().getSemiFuture();
-
-      return BlockingReason::kWaitForProducer;
+  while (!tryPop(data, &size)) {
+    std::lock_guard<std::mutex> l(mutex_);
+    ++numWaitingConsumers_;
+    if (numQueued_ != 0) {
+      // A producer added data since the last try.
+      --numWaitingConsumers_;
+      continue;
+    }
+    if (isFinishedLocked()) {
+      --numWaitingConsumers_;
+      return BlockingReason::kNotBlocked;
+    }
+    if (testAndClearDrainedLocked()) {
+      --numWaitingConsumers_;
+      drained = true;
+      return BlockingReason::kNotBlocked;
     }
 
-    std::tie(*data, size) = std::move(queue.front());
-    queue.pop();
+    consumerPromises_.emplace_back("LocalExchangeQueue::next");
+    *future = consumerPromises_.back().getSemiFuture();
 
-    memoryPromises = memoryManager_->decreaseMemoryUsage(size);
-    return BlockingReason::kNotBlocked;
-  });
+    return BlockingReason::kWaitForProducer;
+  }
 
+  auto memoryPromises = memoryManager_->decreaseMemoryUsage(size);
   notify(memoryPromises);
-  if (*data != nullptr) {
-    vectorPool_->push(*data, size);
-  }
-  return blockingReason;
+  vectorPool_->push(*data, size);
+  return BlockingReason::kNotBlocked;
 }
 
-bool LocalExchangeQueue::isFinishedLocked(const Queue& queue) const {
+bool LocalExchangeQueue::isFinishedLocked() const {
   if (closed_) {
     return true;
   }
 
-  if (noMoreProducers_ && pendingProducers_ == 0 && queue.empty()) {
+  if (noMoreProducers_ && pendingProducers_ == 0 && numQueued_ == 0) {
     return true;
   }
 
@@ -224,32 +281,43 @@ bool LocalExchangeQueue::testAndClearDrainedLocked() {
   return true;
 }
 
+std::vector<ContinuePromise> LocalExchangeQueue::takeConsumerPromisesLocked() {
+  numWaitingConsumers_ = 0;
+  return std::move(consumerPromises_);
+}
+
 bool LocalExchangeQueue::isFinished() {
-  return queue_.withWLock([&](auto& queue) { return isFinishedLocked(queue); });
+  std::lock_guard<std::mutex> l(mutex_);
+  return isFinishedLocked();
 }
 
 bool LocalExchangeQueue::testingProducersDone() const {
-  return queue_.withRLock(
-      [&](auto& queue) { return noMoreProducers_ && pendingProducers_ == 0; });
+  std::lock_guard<std::mutex> l(mutex_);
+  return noMoreProducers_ && pendingProducers_ == 0;
 }
 
 void LocalExchangeQueue::close() {
-  std::vector<ContinuePromise> consumerPromises;
-  std::vector<ContinuePromise> memoryPromises;
-  queue_.withWLock([&](auto& queue) {
-    uint64_t freedBytes = 0;
-    while (!queue.empty()) {
-      freedBytes += queue.front().second;
-      queue.pop();
+  closed_ = true;
+  uint64_t freedBytes = 0;
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> l(shard.mutex);
+    while (!shard.queue.empty()) {
+      freedBytes += shard.queue.front().second;
+      shard.queue.pop();
+      --numQueued_;
     }
+  }
 
-    if (freedBytes) {
-      memoryPromises = memoryManager_->decreaseMemoryUsage(freedBytes);
-    }
+  std::vector<ContinuePromise> memoryPromises;
+  if (freedBytes) {
+    memoryPromises = memoryManager_->decreaseMemoryUsage(freedBytes);
+  }
 
-    consumerPromises = std::move(consumerPromises_);
-    closed_ = true;
-  });
+  std::vector<ContinuePromise> consumerPromises;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    consumerPromises = takeConsumerPromisesLocked();
+  }
   notify(consumerPromises);
   notify(memoryPromises);
 }
@@ -15,13 +15,15 @@
  */
 #pragma once
 
+#include <folly/lang/Align.h>
+
 #include "velox/exec/Operator.h"
 #include "velox/exec/VectorHasher.h"
 
 namespace facebook::velox::exec {
 
 /// Keeps track of the total size in bytes of the data buffered in all
-/// LocalExchangeQueues.
+/// LocalExchangeQueues. Updates below the limit don't take a lock.
 class LocalExchangeMemoryManager {
  public:
   explicit LocalExchangeMemoryManager(int64_t maxBufferSize)
@@ -48,8 +50,11 @@ class LocalExchangeMemoryManager {
 
  private:
   const int64_t maxBufferSize_;
+  std::atomic_int64_t bufferedBytes_{0};
+  // The number of entries in 'promises_'. Lets decreaseMemoryUsage() skip the
+  // lock if no producer is blocked.
+  std::atomic_int32_t numPromises_{0};
   std::mutex mutex_;
-  tsan_atomic<int64_t> bufferedBytes_{0};
   std::vector<ContinuePromise> promises_;
 };
 
@@ -77,15 +82,20 @@ class LocalExchangeVectorPool {
 /// must be called after all producers have been registered. A producer calls
 /// 'enqueue' multiple time to put the data and calls 'noMoreData' when done.
 /// Consumers call 'next' repeatedly to fetch the data.
+///
+/// The data is buffered in 'numShards' independently locked shards to reduce
+/// contention between many producers and consumers. A producer driver always
+/// enqueues to the same shard, so the data of a producer is fetched in the
+/// order it was enqueued. Consumers look at all shards. The lock on the
+/// producer and consumer state is only taken when a consumer has to wait for
+/// data or a producer has to wake up waiting consumers.
 class LocalExchangeQueue {
  public:
   LocalExchangeQueue(
       std::shared_ptr<LocalExchangeMemoryManager> memoryManager,
       std::shared_ptr<LocalExchangeVectorPool> vectorPool,
-      int partition)
-      : memoryManager_{std::move(memoryManager)},
-        vectorPool_{std::move(vectorPool)},
-        partition_{partition} {}
+      int partition,
+      int32_t numShards = 1);
 
   std::string toString() const {
     return fmt::format("LocalExchangeQueue({})", partition_);
@@ -141,19 +151,48 @@ class LocalExchangeQueue {
  private:
   using Queue = std::queue<std::pair<RowVectorPtr, int64_t>>;
 
-  bool isFinishedLocked(const Queue& queue) const;
+  struct alignas(folly::hardware_destructive_interference_size) Shard {
+    std::mutex mutex;
+    Queue queue;
+  };
+
+  // Returns the shard the calling producer enqueues to.
+  Shard& producerShard();
+
+  // Pops the oldest vector of the first non-empty shard. Returns false if all
+  // shards are empty.
+  bool tryPop(RowVectorPtr* data, int64_t* size);
+
+  bool isFinishedLocked() const;
 
   bool testAndClearDrainedLocked();
 
+  // Returns the promises of the waiting consumers to fulfill.
+  std::vector<ContinuePromise> takeConsumerPromisesLocked();
+
   const std::shared_ptr<LocalExchangeMemoryManager> memoryManager_;
   const std::shared_ptr<LocalExchangeVectorPool> vectorPool_;
   const int partition_;
 
-  folly::Synchronized<Queue> queue_;
+  std::vector<Shard> shards_;
+  // The number of vectors in 'shards_'. Incremented after a vector is added to
+  // a shard and decremented after one is removed.
+  std::atomic_int64_t numQueued_{0};
+  // The shard to start the next consumer's search for data at.
+  std::atomic_uint32_t nextConsumerShard_{0};
+  std::atomic_bool closed_{false};
+
+  // Protects the producer and consumer state below.
+  mutable std::mutex mutex_;
   // Satisfied when data becomes available or all producers report that they
-  // finished producing, e.g. queue_ is not empty or noMoreProducers_ is true
-  // and pendingProducers_ is zero.
+  // finished producing, e.g. 'numQueued_' is not zero or noMoreProducers_ is
+  // true and pendingProducers_ is zero.
   std::vector<ContinuePromise> consumerPromises_;
+  // The size of 'consumerPromises_'. Producers check it after adding data and
+  // only take 'mutex_' to wake up consumers if it is not zero. A consumer
+  // increments it before checking 'numQueued_' for the last time, so that
+  // either the consumer sees the data or the producer sees the consumer.
+  std::atomic_int32_t numWaitingConsumers_{0};
   int pendingProducers_{0};
   bool noMoreProducers_{false};
   // The number of drained producers when the task is under barrier processing.
@@ -161,7 +200,6 @@ class LocalExchangeQueue {
   // consumer receives the drained signal on the next call to 'next', and
   // 'drainedProducers_' is reset to zero.
   int drainedProducers_{0};
-  bool closed_{false};
 };
 
 /// Fetches data for a single partition produced by local exchange from
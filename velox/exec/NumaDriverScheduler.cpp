@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/NumaDriverScheduler.h"
+
+#include <algorithm>
+
+#include <folly/String.h>
+#include <folly/executors/thread_factory/InitThreadFactory.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+
+#include "velox/common/process/ProcessBase.h"
+#include "velox/exec/Driver.h"
+#include "velox/exec/Task.h"
+
+namespace facebook::velox::exec {
+
+NumaDriverScheduler::NumaDriverScheduler(Options options) {
+  auto nodeCpus = options.nodeCpus.empty() ? process::numaNodeCpus()
+                                           : std::move(options.nodeCpus);
+  VELOX_CHECK_GE(options.numThreadsPerNode, 0);
+  for (auto node = 0; node < nodeCpus.size(); ++node) {
+    const auto& cpus = nodeCpus[node];
+    VELOX_CHECK(!cpus.empty(), "NUMA node {} has no CPUs", node);
+    for (const auto cpu : cpus) {
+      VELOX_CHECK_GE(cpu, 0);
+      if (cpu >= cpuNodes_.size()) {
+        cpuNodes_.resize(cpu + 1, -1);
+      }
+      VELOX_CHECK_EQ(
+          cpuNodes_[cpu], -1, "CPU {} is in more than one NUMA node", cpu);
+      cpuNodes_[cpu] = node;
+    }
+
+    const auto numThreads = options.numThreadsPerNode > 0
+        ? options.numThreadsPerNode
+        : static_cast<int32_t>(cpus.size());
+    auto threadFactory = std::make_shared<folly::InitThreadFactory>(
+        std::make_shared<folly::NamedThreadFactory>(
+            fmt::format("Driver-Node{}-", node)),
+        [cpus]() {
+          if (!process::bindThreadToCpus(cpus)) {
+            LOG(WARNING) << "Failed to bind driver thread to CPUs "
+                         << folly::join(",", cpus);
+          }
+        });
+    auto& state = nodes_.emplace_back(std::make_unique<Node>());
+    state->executor = std::make_unique<folly::CPUThreadPoolExecutor>(
+        numThreads, std::move(threadFactory));
+  }
+}
+
+NumaDriverScheduler::~NumaDriverScheduler() {
+  for (auto& node : nodes_) {
+    node->executor->join();
+  }
+}
+
+void NumaDriverScheduler::add(folly::Func func) {
+  nodes_[nextFunctionNode_++ % nodes_.size()]->executor->add(std::move(func));
+}
+
+void NumaDriverScheduler::schedule(
+    const std::shared_ptr<Task>& task,
+    const DriverCtx& driverCtx,
+    folly::Func run) {
+  const auto node = nodeOf(task, driverCtx.splitGroupId, driverCtx.driverId);
+  nodes_[node]->executor->add(
+      [this, task, node, run = std::move(run)]() mutable {
+        recordRun(*task, node);
+        run();
+      });
+}
+
+int32_t NumaDriverScheduler::nodeOf(
+    const std::shared_ptr<Task>& task,
+    uint32_t splitGroupId,
+    int32_t driverId) {
+  const auto state = taskState(task);
+  if (splitGroupId != kUngroupedGroupId) {
+    return (state.node + splitGroupId) % nodes_.size();
+  }
+  if (state.spread) {
+    return (state.node + driverId) % nodes_.size();
+  }
+  return state.node;
+}
+
+NumaDriverScheduler::TaskState NumaDriverScheduler::taskState(
+    const std::shared_ptr<Task>& task) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = tasks_.find(task.get());
+  if (it != tasks_.end() && it->second.task.lock() == task) {
+    return it->second;
+  }
+  // This runs while the caller may hold the mutex of 'task', so the other
+  // tasks are not asked for their state, which would take their mutexes. A
+  // task counts as running until it is gone.
+  const bool spread = !hasOtherLiveTasksLocked(task.get());
+  auto& state = tasks_[task.get()];
+  // A new task, possibly at the address of one that is gone.
+  state = TaskState{task, nextTaskNode_, spread};
+  nextTaskNode_ = (nextTaskNode_ + 1) % nodes_.size();
+  return state;
+}
+
+bool NumaDriverScheduler::hasOtherLiveTasksLocked(const Task* task) {
+  const bool cleanup =
+      tasks_.size() >= 2 * std::max<size_t>(numTasksAfterCleanup_, 64);
+  bool found{false};
+  for (auto it = tasks_.begin(); it != tasks_.end();) {
+    if (!it->second.task.expired()) {
+      found |= it->first != task;
+      if (found && !cleanup) {
+        break;
+      }
+    } else if (cleanup) {
+      // Removes the tasks that are gone.
+      it = tasks_.erase(it);
+      continue;
+    }
+    ++it;
+  }
+  if (cleanup) {
+    numTasksAfterCleanup_ = tasks_.size();
+  }
+  return found;
+}
+
+void NumaDriverScheduler::recordRun(Task& task, int32_t node) {
+  auto& state = *nodes_[node];
+  ++state.numRuns;
+  const auto cpu = process::currentCpu();
+  if (cpu < 0) {
+    return;
+  }
+  const bool local = cpu < cpuNodes_.size() && cpuNodes_[cpu] == node;
+  if (!local) {
+    ++state.numOffNodeRuns;
+  }
+  task.addNumaDriverRun(local);
+}
+
+NumaDriverScheduler::Stats NumaDriverScheduler::stats() const {
+  Stats stats;
+  for (const auto& node : nodes_) {
+    stats.numRuns.push_back(node->numRuns);
+    stats.numOffNodeRuns.push_back(node->numOffNodeRuns);
+  }
+  return stats;
+}
+} // namespace facebook::velox::exec
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <folly/container/F14Map.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+
+#include "velox/exec/DriverScheduler.h"
+
+namespace facebook::velox::exec {
+
+/// Runs drivers on one thread pool per NUMA node, with the threads of each
+/// pool bound to the CPUs of their node. The drivers of a task run on the node
+/// the task is assigned to, so that the drivers that build a hash table and
+/// the drivers that probe it run where the table is. In grouped execution, the
+/// drivers of a split group run on one node, with consecutive split groups on
+/// consecutive nodes starting at the node of the task. Tasks are assigned to
+/// the nodes round robin.
+///
+/// A task that starts while no other task is alive would leave the other
+/// nodes idle, so its drivers outside of split groups are spread over the
+/// nodes by driver id instead. This trades the locality of its hash tables for
+/// the use of all CPUs. It keeps spreading when other tasks start later.
+///
+/// The allocator does not know about nodes. The operating system places a page
+/// on the node of the thread that touches it first, so the memory that a
+/// memory pool gets fresh from the operating system is on the node of the
+/// driver that first writes it. Memory recycled by MmapAllocator or cached in
+/// AsyncDataCache stays on the node where it was first touched, which may be
+/// another node.
+///
+/// Functions passed to add() run on the nodes round robin. The number of
+/// driver runs on a CPU of the assigned node and on other CPUs are counted in
+/// TaskStats::numLocalNumaDriverRuns and numOffNodeNumaDriverRuns. The latter
+/// are nonzero only if binding the threads of a node to its CPUs failed.
+class NumaDriverScheduler : public DriverScheduler {
+ public:
+  struct Options {
+    /// The CPUs of each node. Defaults to process::numaNodeCpus().
+    std::vector<std::vector<int32_t>> nodeCpus;
+
+    /// The number of threads of each node. 0 means one thread per CPU of the
+    /// node.
+    int32_t numThreadsPerNode{0};
+  };
+
+  struct Stats {
+    /// The number of driver runs by node.
+    std::vector<uint64_t> numRuns;
+    /// The number of driver runs by node that started on a CPU of another
+    /// node because binding the threads of the node to its CPUs failed.
+    std::vector<uint64_t> numOffNodeRuns;
+  };
+
+  explicit NumaDriverScheduler(Options options = {});
+
+  /// Waits for the queued drivers and functions to finish.
+  ~NumaDriverScheduler() override;
+
+  void add(folly::Func func) override;
+
+  void schedule(
+      const std::shared_ptr<Task>& task,
+      const DriverCtx& driverCtx,
+      folly::Func run) override;
+
+  int32_t numNodes() const {
+    return nodes_.size();
+  }
+
+  /// Returns the node that runs the drivers of 'task' in 'splitGroupId', or
+  /// the driver 'driverId' of 'task' if 'splitGroupId' is kUngroupedGroupId.
+  int32_t nodeOf(
+      const std::shared_ptr<Task>& task,
+      uint32_t splitGroupId,
+      int32_t driverId = 0);
+
+  Stats stats() const;
+
+ private:
+  struct Node {
+    std::unique_ptr<folly::CPUThreadPoolExecutor> executor;
+    std::atomic_uint64_t numRuns{0};
+    std::atomic_uint64_t numOffNodeRuns{0};
+  };
+
+  struct TaskState {
+    std::weak_ptr<Task> task;
+    int32_t node{0};
+    // True if the drivers outside of split groups are spread over the nodes.
+    bool spread{false};
+  };
+
+  // Returns the state of 'task', assigning it a node if it is new.
+  TaskState taskState(const std::shared_ptr<Task>& task);
+
+  // Returns true if 'tasks_' has a task other than 'task' that is not gone.
+  // Removes the ones that are gone if 'tasks_' has grown enough since the
+  // last removal. Takes no task mutex.
+  bool hasOtherLiveTasksLocked(const Task* task);
+
+  // Counts a run of a driver of 'task' on 'node'.
+  void recordRun(Task& task, int32_t node);
+
+  std::vector<std::unique_ptr<Node>> nodes_;
+  // The node of each CPU, -1 for the CPUs that are not in 'nodes_'.
+  std::vector<int32_t> cpuNodes_;
+  std::atomic_uint32_t nextFunctionNode_{0};
+
+  std::mutex mutex_;
+  folly::F14FastMap<const Task*, TaskState> tasks_;
+  // The size of 'tasks_' after the last removal of finished tasks.
+  size_t numTasksAfterCleanup_{0};
+  int32_t nextTaskNode_{0};
+};
+} // namespace facebook::velox::exec
@@ -203,6 +203,12 @@ class Operator : public BaseRuntimeStatWriter {
   static constexpr std::string_view kShuffleCompressionKind{
       "shuffleCompressionKind"};
 
+  /// The prefix of the number of shuffle pages written with each codec with
+  /// adaptive shuffle compression, followed by the name of the codec, e.g.
+  /// shuffleAdaptiveCompressionPages.LZ4.
+  static constexpr std::string_view kShuffleAdaptiveCompressionPages{
+      "shuffleAdaptiveCompressionPages"};
+
   /// 'operatorId' is the initial index of the 'this' in the Driver's list of
   /// Operators. This is used as in index into OperatorStats arrays in the Task.
   /// 'planNodeId' is a query-level unique identifier of the PlanNode to which
@@ -409,6 +415,14 @@ class Operator : public BaseRuntimeStatWriter {
     return reclaimable;
   }
 
+  /// Returns true if reclaim() touches the state of this operator only, so
+  /// that the driver of the operator can run it at an operator boundary while
+  /// the other drivers of the task keep running. See
+  /// Task::requestCooperativeReclaim().
+  virtual bool supportsCooperativeReclaim() const {
+    return false;
+  }
+
   /// Invoked by the memory arbitrator to reclaim memory from this operator with
   /// specified reclaim target bytes. If 'targetBytes' is zero, then it tries to
   /// reclaim all the reclaimable memory from this operator.
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/OperatorMemoryHistory.h"
+
+#include <filesystem>
+
+#include <folly/FileUtil.h>
+#include <folly/Synchronized.h>
+#include <folly/hash/FnvHash.h>
+#include <folly/hash/Hash.h>
+#include <folly/lang/Bits.h>
+
+#include "velox/exec/Operator.h"
+
+namespace facebook::velox::exec {
+namespace {
+folly::Synchronized<std::shared_ptr<OperatorMemoryHistory>>& globalHistory() {
+  static folly::Synchronized<std::shared_ptr<OperatorMemoryHistory>> history;
+  return history;
+}
+} // namespace
+
+size_t OperatorMemoryHistory::KeyHasher::operator()(const Key& key) const {
+  return folly::hash::hash_combine(key.fingerprint, key.inputSizeBucket);
+}
+
+// static
+std::string OperatorMemoryHistory::fingerprint(
+    std::string_view operatorType,
+    const core::PlanNode& planNode) {
+  return fmt::format(
+      "{}-{:016x}",
+      operatorType,
+      folly::hash::fnv64(
+          planNode.toString(/*detailed=*/true, /*recursive=*/true)));
+}
+
+// static
+int32_t OperatorMemoryHistory::inputSizeBucket(uint64_t inputBytes) {
+  return inputBytes == 0 ? 0 : folly::findLastSet(inputBytes) - 1;
+}
+
+// static
+void OperatorMemoryHistory::setInstance(
+    std::shared_ptr<OperatorMemoryHistory> history) {
+  *globalHistory().wlock() = std::move(history);
+}
+
+// static
+std::shared_ptr<OperatorMemoryHistory> OperatorMemoryHistory::instance() {
+  return *globalHistory().rlock();
+}
+
+FileOperatorMemoryHistory::FileOperatorMemoryHistory(std::string path)
+    : path_(std::move(path)) {
+  std::string data;
+  if (!folly::readFile(path_.c_str(), data)) {
+    return;
+  }
+  std::vector<folly::StringPiece> lines;
+  folly::split('\n', data, lines);
+  for (const auto line : lines) {
+    // Each line is '<fingerprint> <input size bucket> <peak bytes>'.
+    std::string fingerprint;
+    int32_t inputSizeBucket;
+    uint64_t peakBytes;
+    if (!folly::split(' ', line, fingerprint, inputSizeBucket, peakBytes)) {
+      continue;
+    }
+    peakBytes_[Key{std::move(fingerprint), inputSizeBucket}] = peakBytes;
+  }
+}
+
+FileOperatorMemoryHistory::~FileOperatorMemoryHistory() {
+  try {
+    flush();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Failed to write operator memory history to " << path_
+               << ": " << e.what();
+  }
+}
+
+std::optional<uint64_t> FileOperatorMemoryHistory::peakBytes(const Key& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = peakBytes_.find(key);
+  if (it == peakBytes_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+void FileOperatorMemoryHistory::record(const Key& key, uint64_t peakBytes) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto& peak = peakBytes_[key];
+  peak = std::max(peakBytes, peak - peak / 8);
+}
+
+void FileOperatorMemoryHistory::flush() {
+  std::string data;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    for (const auto& [key, peakBytes] : peakBytes_) {
+      data += fmt::format(
+          "{} {} {}\n", key.fingerprint, key.inputSizeBucket, peakBytes);
+    }
+  }
+  // Replaces the file at once so that a reader never sees a partial file.
+  const auto tempPath = path_ + ".tmp";
+  VELOX_CHECK(
+      folly::writeFile(data, tempPath.c_str()),
+      "Failed to write {}",
+      tempPath);
+  std::filesystem::rename(tempPath, path_);
+}
+
+namespace {
+std::shared_ptr<OperatorMemoryHistory> historyOf(const Operator& op) {
+  const auto& queryConfig = op.operatorCtx()->driverCtx()->queryConfig();
+  if (!queryConfig.operatorMemoryHistoryEnabled()) {
+    return nullptr;
+  }
+  return OperatorMemoryHistory::instance();
+}
+} // namespace
+
+OperatorMemoryReserver::OperatorMemoryReserver(
+    Operator* op,
+    const core::PlanNode& planNode)
+    : op_(op),
+      history_(historyOf(*op)),
+      fingerprint_(
+          history_ == nullptr ? std::string{}
+                              : OperatorMemoryHistory::fingerprint(
+                                    op->operatorType(), planNode)) {}
+
+bool OperatorMemoryReserver::reserve(const RowVectorPtr& input) {
+  if (history_ == nullptr) {
+    return false;
+  }
+  inputBytes_ += input->estimateFlatSize();
+  const auto inputSizeBucket =
+      OperatorMemoryHistory::inputSizeBucket(inputBytes_);
+  if (inputSizeBucket <= inputSizeBucket_) {
+    return false;
+  }
+  inputSizeBucket_ = inputSizeBucket;
+
+  const auto peakBytes = history_->peakBytes({fingerprint_, inputSizeBucket});
+  auto* pool = op_->pool();
+  const uint64_t reservedBytes = pool->reservedBytes();
+  // Does not ask for more than the query can ever get.
+  if (!peakBytes.has_value() || *peakBytes <= reservedBytes ||
+      *peakBytes > static_cast<uint64_t>(pool->maxCapacity())) {
+    return false;
+  }
+  const auto bytesToReserve = *peakBytes - reservedBytes;
+  {
+    Operator::ReclaimableSectionGuard guard(op_);
+    if (!pool->maybeReserve(bytesToReserve)) {
+      return false;
+    }
+  }
+  op_->addRuntimeStat(kNumReservations, RuntimeCounter(1));
+  op_->addRuntimeStat(
+      kReservedBytes,
+      RuntimeCounter(bytesToReserve, RuntimeCounter::Unit::kBytes));
+  return true;
+}
+
+void OperatorMemoryReserver::close() {
+  if (history_ == nullptr || closed_ || inputBytes_ == 0) {
+    return;
+  }
+  closed_ = true;
+  history_->record(
+      {fingerprint_, OperatorMemoryHistory::inputSizeBucket(inputBytes_)},
+      op_->pool()->peakBytes());
+}
+} // namespace facebook::velox::exec
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include <folly/container/F14Map.h>
+
+#include "velox/core/PlanNode.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::exec {
+
+class Operator;
+
+/// Peak memory usage of operators in past runs, by plan node fingerprint and
+/// input size bucket, for reserving the memory of known-heavy operators ahead
+/// of their input instead of growing it in many small arbitration rounds.
+/// HashBuild, HashAggregation and OrderBy use the history registered with
+/// setInstance() if the 'operator_memory_history_enabled' query config is
+/// true. Implementations must be thread-safe.
+class OperatorMemoryHistory {
+ public:
+  struct Key {
+    /// Identifies the operator type and the plan node with its inputs. See
+    /// fingerprint().
+    std::string fingerprint;
+    /// log2 of the total input bytes of the operator. See inputSizeBucket().
+    int32_t inputSizeBucket;
+
+    bool operator==(const Key& other) const {
+      return inputSizeBucket == other.inputSizeBucket &&
+          fingerprint == other.fingerprint;
+    }
+  };
+
+  struct KeyHasher {
+    size_t operator()(const Key& key) const;
+  };
+
+  virtual ~OperatorMemoryHistory() = default;
+
+  /// Returns the peak memory usage of the operators with 'key' in past runs,
+  /// or std::nullopt if there is none.
+  virtual std::optional<uint64_t> peakBytes(const Key& key) = 0;
+
+  /// Records the peak memory usage of an operator with 'key'.
+  virtual void record(const Key& key, uint64_t peakBytes) = 0;
+
+  /// Returns the fingerprint of the operators of 'operatorType' for
+  /// 'planNode'. Covers the plan node and the plan nodes below it.
+  static std::string fingerprint(
+      std::string_view operatorType,
+      const core::PlanNode& planNode);
+
+  static int32_t inputSizeBucket(uint64_t inputBytes);
+
+  /// Sets the history that operators use. nullptr turns the history off.
+  static void setInstance(std::shared_ptr<OperatorMemoryHistory> history);
+
+  static std::shared_ptr<OperatorMemoryHistory> instance();
+};
+
+/// OperatorMemoryHistory that keeps the peaks in memory and in a local file.
+/// Reads the file on construction and writes it in flush() and on
+/// destruction. A recorded peak replaces a higher peak only after decaying
+/// it, so that one outlier run does not inflate the reservations of all later
+/// runs, while growing inputs raise the peak at once.
+class FileOperatorMemoryHistory : public OperatorMemoryHistory {
+ public:
+  explicit FileOperatorMemoryHistory(std::string path);
+
+  ~FileOperatorMemoryHistory() override;
+
+  std::optional<uint64_t> peakBytes(const Key& key) override;
+
+  void record(const Key& key, uint64_t peakBytes) override;
+
+  /// Writes the peaks to the file.
+  void flush();
+
+ private:
+  const std::string path_;
+
+  std::mutex mutex_;
+  folly::F14FastMap<Key, uint64_t, KeyHasher> peakBytes_;
+};
+
+/// Reserves the memory of an operator from the OperatorMemoryHistory and
+/// records the peak memory usage of the operator to it. Each time the total
+/// input of the operator reaches the next input size bucket, reserves the peak
+/// memory usage that past runs with a total input in that bucket reached, as
+/// the operator will get at least as much input. No-op if there is no history
+/// or the query turns it off.
+class OperatorMemoryReserver {
+ public:
+  /// Runtime stats of the operator: the number and total bytes of the
+  /// reservations made from the history.
+  static constexpr std::string_view kNumReservations{
+      "memoryHistoryNumReservations"};
+  static constexpr std::string_view kReservedBytes{
+      "memoryHistoryReservedBytes"};
+
+  OperatorMemoryReserver(Operator* op, const core::PlanNode& planNode);
+
+  /// Called before 'op' adds 'input'. Returns true if it reserved memory,
+  /// which may have spilled 'op'.
+  bool reserve(const RowVectorPtr& input);
+
+  /// Records the peak memory usage of 'op'. Called when 'op' closes.
+  void close();
+
+ private:
+  Operator* const op_;
+  const std::shared_ptr<OperatorMemoryHistory> history_;
+  const std::string fingerprint_;
+
+  uint64_t inputBytes_{0};
+  int32_t inputSizeBucket_{-1};
+  bool closed_{false};
+};
+} // namespace facebook::velox::exec
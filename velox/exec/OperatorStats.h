@@ -106,6 +106,14 @@ struct OperatorStats {
   static constexpr std::string_view kRunningIsBlockedWallNanos =
       "runningIsBlockedWallNanos";
 
+  /// Hardware performance counts of the operator calls, recorded if the
+  /// 'track_operator_perf_counters' query config is set and perf events are
+  /// available.
+  static constexpr std::string_view kPerfCycles = "perfCycles";
+  static constexpr std::string_view kPerfInstructions = "perfInstructions";
+  static constexpr std::string_view kPerfCacheMisses = "perfCacheMisses";
+  static constexpr std::string_view kPerfBranchMisses = "perfBranchMisses";
+
   /// Initial ordinal position in the operator's pipeline.
   int32_t operatorId = 0;
   int32_t pipelineId = 0;
@@ -609,7 +609,8 @@ std::unique_ptr<VectorSerde::Options> getVectorSerdeOptions(
     const std::string& kind,
     std::optional<float> minCompressionRatio,
     int32_t minCompressionPageSizeBytes) {
-  std::unique_ptr<VectorSerde::Options> options = kind == "Presto"
+  std::unique_ptr<VectorSerde::Options> options =
+      kind == "Presto" || kind == "PrestoEncoded"
       ? std::make_unique<serializer::presto::PrestoVectorSerde::PrestoOptions>()
       : std::make_unique<VectorSerde::Options>();
   options->compressionKind = compressionKind;
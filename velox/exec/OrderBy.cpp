@@ -43,7 +43,8 @@ OrderBy::OrderBy(
           OperatorType::kOrderBy,
           orderByNode->canSpill(driverCtx->queryConfig())
               ? driverCtx->makeSpillConfig(operatorId, OperatorType::kOrderBy)
-              : std::nullopt) {
+              : std::nullopt),
+      memoryReserver_(this, *orderByNode) {
   maxOutputRows_ = outputBatchRows(std::nullopt);
   VELOX_CHECK(pool()->trackUsage());
   std::vector<column_index_t> sortColumnIndices;
@@ -73,6 +74,7 @@ OrderBy::OrderBy(
 
 void OrderBy::addInput(RowVectorPtr input) {
   loadLazyReclaimable(input);
+  memoryReserver_.reserve(input);
   sortBuffer_->addInput(input);
 }
 
@@ -107,6 +109,7 @@ RowVectorPtr OrderBy::getOutput() {
 }
 
 void OrderBy::close() {
+  memoryReserver_.close();
   Operator::close();
   sortBuffer_.reset();
 }
@@ -17,6 +17,7 @@
 
 #include "velox/exec/ContainerRowSerde.h"
 #include "velox/exec/Operator.h"
+#include "velox/exec/OperatorMemoryHistory.h"
 #include "velox/exec/RowContainer.h"
 #include "velox/exec/SortBuffer.h"
 #include "velox/exec/Spiller.h"
@@ -56,12 +57,17 @@ class OrderBy : public Operator {
     return finished_;
   }
 
+  bool supportsCooperativeReclaim() const override {
+    return true;
+  }
+
   void reclaim(uint64_t targetBytes, memory::MemoryReclaimer::Stats& stats)
       override;
 
   void close() override;
 
  private:
+  OperatorMemoryReserver memoryReserver_;
   std::unique_ptr<SortBuffer> sortBuffer_;
   bool finished_ = false;
   vector_size_t maxOutputRows_;
@@ -15,12 +15,23 @@
  */
 
 #include "velox/exec/PartitionedOutput.h"
+
+#include <numeric>
+
 #include "velox/exec/DefaultOutputBufferManager.h"
+#include "velox/exec/InProcessExchange.h"
 #include "velox/exec/OperatorType.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/Task.h"
+#include "velox/serializers/PrestoSerializer.h"
 
 namespace facebook::velox::exec {
+namespace {
+// Returns true if 'serde' serializes vectors into PrestoPages.
+bool isPrestoSerde(const VectorSerde& serde) {
+  return serde.kind() == "Presto" || serde.kind() == "PrestoEncoded";
+}
+} // namespace
 
 namespace detail {
 Destination::Destination(
@@ -30,15 +41,15 @@ Destination::Destination(
     VectorSerde::Options* serdeOptions,
     memory::MemoryPool* pool,
     bool eagerFlush,
-    std::function<void(uint64_t bytes, uint64_t rows)> recordEnqueued)
+    std::function<void(uint64_t bytes, uint64_t rows, bool blocked)>
+        recordEnqueued)
     : taskId_(taskId),
       destination_(destination),
       serde_(serde),
       serdeOptions_(serdeOptions),
       pool_(pool),
       eagerFlush_(eagerFlush),
-      recordEnqueued_(std::move(recordEnqueued)),
-      rows_(raw_vector<vector_size_t>(pool)) {
+      recordEnqueued_(std::move(recordEnqueued)) {
   setTargetSizePct();
 }
 
@@ -54,31 +65,19 @@ BlockingReason Destination::advance(
     ContinueFuture* future,
     Scratch& scratch) {
   VELOX_CHECK_LE(!!outputCompactRow + !!outputUnsafeRow, 1);
-  if (rowIdx_ >= rows_.size()) {
+  if (!hasRowsLeft()) {
     *atEnd = true;
     return BlockingReason::kNotBlocked;
   }
 
-  const auto firstRow = rowIdx_;
-  const uint32_t adjustedMaxBytes = (maxBytes * targetSizePct_) / 100;
-  if (bytesInCurrent_ >= adjustedMaxBytes) {
+  const auto rows = nextRows(maxBytes, sizes);
+  if (rows.empty()) {
     return flush(bufferManager, bufferReleaseFn, future);
   }
 
-  // Collect rows to serialize.
-  bool shouldFlush = false;
-  while (rowIdx_ < rows_.size() && !shouldFlush) {
-    bytesInCurrent_ += sizes[rows_[rowIdx_]];
-    ++rowIdx_;
-    ++rowsInCurrent_;
-    shouldFlush =
-        bytesInCurrent_ >= adjustedMaxBytes || rowsInCurrent_ >= targetNumRows_;
-  }
-
   // Serialize
   createVectorStreamGroup(output);
 
-  const auto rows = folly::Range(&rows_[firstRow], rowIdx_ - firstRow);
   if (serde_->kind() == "CompactRow") {
     VELOX_CHECK_NOT_NULL(outputCompactRow);
     current_->append(*outputCompactRow, rows, sizes);
@@ -86,20 +85,131 @@ BlockingReason Destination::advance(
     VELOX_CHECK_NOT_NULL(outputUnsafeRow);
     current_->append(*outputUnsafeRow, rows, sizes);
   } else {
-    VELOX_CHECK_EQ(serde_->kind(), "Presto");
+    VELOX_CHECK(isPrestoSerde(*serde_), "{}", serde_->kind());
     current_->append(output, rows, scratch);
   }
 
   // Update output state variable.
-  if (rowIdx_ == rows_.size()) {
+  if (!hasRowsLeft()) {
     *atEnd = true;
   }
-  if (shouldFlush || (eagerFlush_ && rowsInCurrent_ > 0)) {
+  if (needsFlush(maxBytes)) {
     return flush(bufferManager, bufferReleaseFn, future);
   }
   return BlockingReason::kNotBlocked;
 }
 
+BlockingReason Destination::advanceVector(
+    uint64_t maxBytes,
+    const std::vector<vector_size_t>& sizes,
+    const RowVectorPtr& output,
+    const std::shared_ptr<Task>& producer,
+    DefaultOutputBufferManager& bufferManager,
+    bool* outputCharged,
+    bool* atEnd,
+    ContinueFuture* future) {
+  if (!hasRowsLeft()) {
+    *atEnd = true;
+    return BlockingReason::kNotBlocked;
+  }
+
+  // Nothing is buffered between calls, so there are always rows to select.
+  const auto rows = nextRows(maxBytes, sizes);
+  VELOX_CHECK(!rows.empty());
+  const vector_size_t numRows = rows.size();
+  // A page that wraps its rows keeps all of 'output' alive until consumed. Only
+  // a page with most of the rows of 'output' wraps them. The first such page
+  // is charged the retained size of 'output', so that 'output' is charged once
+  // even if many destinations wrap all of its rows. The rows of the smaller
+  // pages are copied so that they do not keep 'output' alive.
+  RowVectorPtr vector;
+  int64_t enqueuedBytes = bytesInCurrent_;
+  if (2 * numRows > output->size()) {
+    auto indices = allocateIndices(numRows, pool_);
+    std::copy(rows.begin(), rows.end(), indices->asMutable<vector_size_t>());
+    std::vector<VectorPtr> children;
+    children.reserve(output->childrenSize());
+    for (const auto& child : output->children()) {
+      children.push_back(
+          BaseVector::wrapInDictionary(nullptr, indices, numRows, child));
+    }
+    vector = std::make_shared<RowVector>(
+        pool_, output->type(), nullptr, numRows, std::move(children));
+    if (!*outputCharged) {
+      enqueuedBytes =
+          std::max<int64_t>(enqueuedBytes, output->retainedSize());
+      *outputCharged = true;
+    }
+  } else {
+    vector = std::static_pointer_cast<RowVector>(
+        BaseVector::create(output->type(), numRows, pool_));
+    vector->copy(output.get(), SelectivityVector(numRows), rows.begin());
+  }
+
+  bytesInCurrent_ = 0;
+  rowsInCurrent_ = 0;
+  setTargetSizePct();
+
+  const bool blocked = bufferManager.enqueue(
+      taskId_,
+      destination_,
+      std::make_unique<VectorPage>(std::move(vector), enqueuedBytes, producer),
+      future);
+  recordEnqueued_(enqueuedBytes, numRows, blocked);
+
+  if (!hasRowsLeft()) {
+    *atEnd = true;
+  }
+  return blocked ? BlockingReason::kWaitForConsumer
+                 : BlockingReason::kNotBlocked;
+}
+
+folly::Range<const vector_size_t*> Destination::nextRows(
+    uint64_t maxBytes,
+    const std::vector<vector_size_t>& sizes) {
+  const auto firstRow = rowIdx_;
+  const uint32_t adjustedMaxBytes = (maxBytes * targetSizePct_) / 100;
+  // A full batch left by a flush that blocked is flushed before adding rows.
+  if (bytesInCurrent_ >= adjustedMaxBytes ||
+      rowsInCurrent_ >= targetNumRows_) {
+    return {};
+  }
+
+  bool shouldFlush = false;
+  while (rowIdx_ < rows_.size() && !shouldFlush) {
+    bytesInCurrent_ += sizes[rows_[rowIdx_]];
+    ++rowIdx_;
+    ++rowsInCurrent_;
+    shouldFlush =
+        bytesInCurrent_ >= adjustedMaxBytes || rowsInCurrent_ >= targetNumRows_;
+  }
+  return folly::Range(rows_.data() + firstRow, rowIdx_ - firstRow);
+}
+
+void Destination::selectRows(
+    uint64_t maxBytes,
+    const std::vector<vector_size_t>& sizes,
+    const RowVectorPtr& output) {
+  selectedRows_ = {};
+  if (!hasRowsLeft()) {
+    return;
+  }
+  selectedRows_ = nextRows(maxBytes, sizes);
+  if (!selectedRows_.empty()) {
+    createVectorStreamGroup(output);
+    VELOX_CHECK(current_->supportsAppendColumn());
+  }
+}
+
+bool Destination::needsFlush(uint64_t maxBytes) const {
+  if (rowsInCurrent_ == 0) {
+    return false;
+  }
+  const uint32_t adjustedMaxBytes = (maxBytes * targetSizePct_) / 100;
+  return eagerFlush_ || bytesInCurrent_ >= adjustedMaxBytes ||
+      rowsInCurrent_ >= targetNumRows_;
+}
+
 void Destination::createVectorStreamGroup(const RowVectorPtr& output) {
   if (current_ == nullptr || needsStreamTreeRecreation_) {
     if (current_ == nullptr) {
@@ -166,7 +276,7 @@ BlockingReason Destination::flush(
           stream.getIOBuf(bufferReleaseFn), nullptr, flushedRows),
       future);
 
-  recordEnqueued_(flushedBytes, flushedRows);
+  recordEnqueued_(flushedBytes, flushedRows, blocked);
 
   return blocked ? BlockingReason::kWaitForConsumer
                  : BlockingReason::kNotBlocked;
@@ -237,7 +347,14 @@ PartitionedOutput::PartitionedOutput(
           PartitionedOutput::minCompressionRatio(),
           operatorCtx_->driverCtx()
               ->queryConfig()
-              .minShuffleCompressionPageSizeBytes())) {
+              .minShuffleCompressionPageSizeBytes())),
+      passVectors_(
+          planNode->transportKind() == core::TransportKind::kInProcess),
+      appendColumns_(
+          !passVectors_ &&
+          serde_->kind() == serializer::presto::PrestoVectorSerde::name() &&
+          outputType_->size() > 0),
+      partitionedRows_(pool()) {
   if (!planNode->isPartitioned()) {
     VELOX_USER_CHECK_EQ(numDestinations_, 1);
   }
@@ -247,10 +364,22 @@ PartitionedOutput::PartitionedOutput(
   }
   VELOX_CHECK_NOT_NULL(
       manager, "PartitionedOutput requires an output buffer manager");
+  if (ctx->queryConfig().shuffleAdaptiveCompressionEnabled()) {
+    auto* prestoOptions =
+        dynamic_cast<serializer::presto::PrestoVectorSerde::PrestoOptions*>(
+            serdeOptions_.get());
+    VELOX_USER_CHECK_NOT_NULL(
+        prestoOptions,
+        "Adaptive shuffle compression is only supported by the Presto serde");
+    codecSelector_ =
+        std::make_shared<serializer::presto::AdaptiveCodecSelector>();
+    prestoOptions->codecSelector = codecSelector_;
+  }
 }
 
 void PartitionedOutput::initializeInput(RowVectorPtr input) {
   input_ = std::move(input);
+  outputCharged_ = false;
   if (outputType_->size() == 0) {
     output_ = std::make_shared<RowVector>(
         input_->pool(),
@@ -299,7 +428,10 @@ void PartitionedOutput::initializeDestinations() {
               serdeOptions_.get(),
               pool(),
               eagerFlush_,
-              [&](uint64_t bytes, uint64_t rows) {
+              [&](uint64_t bytes, uint64_t rows, bool blocked) {
+                if (codecSelector_ != nullptr) {
+                  codecSelector_->recordConsumerWait(blocked);
+                }
                 auto lockedStats = stats_.wlock();
                 lockedStats->addOutputVector(bytes, rows);
               }));
@@ -334,7 +466,7 @@ void PartitionedOutput::estimateRowSizes() {
     serde_->estimateSerializedSize(
         outputUnsafeRow_.get(), rows, sizePointers_.data());
   } else {
-    VELOX_CHECK_EQ(serde_->kind(), "Presto");
+    VELOX_CHECK(isPrestoSerde(*serde_), "{}", serde_->kind());
     serde_->estimateSerializedSize(
         output_.get(), rows, sizePointers_.data(), scratch_);
   }
@@ -346,51 +478,91 @@ void PartitionedOutput::addInput(RowVectorPtr input) {
   initializeSizeBuffers();
   estimateRowSizes();
 
-  for (auto& destination : destinations_) {
-    destination->beginBatch();
+  const auto numInput = input_->size();
+  const auto singlePartition = partitionRows();
+  if (singlePartition.has_value()) {
+    partitionedRows_.resize(numInput);
+    std::iota(partitionedRows_.begin(), partitionedRows_.end(), 0);
+    const folly::Range<const vector_size_t*> allRows(
+        partitionedRows_.data(), numInput);
+    for (auto i = 0; i < numDestinations_; ++i) {
+      destinations_[i]->beginBatch(
+          i == singlePartition.value()
+              ? allRows
+              : folly::Range<const vector_size_t*>());
+    }
+    return;
   }
+  scatterRows();
+}
 
-  auto numInput = input_->size();
+std::optional<uint32_t> PartitionedOutput::partitionRows() {
   if (numDestinations_ == 1) {
-    destinations_[0]->addRows(IndexRange{0, numInput});
-  } else {
-    auto singlePartition = partitionFunction_->partition(*input_, partitions_);
-    if (replicateNullsAndAny_) {
-      collectNullRows();
-
-      vector_size_t start = 0;
-      if (!replicatedAny_) {
-        for (auto& destination : destinations_) {
-          destination->addRow(0);
-        }
-        replicatedAny_ = true;
-        // Make sure not to replicate first row twice.
-        start = 1;
-      }
-      for (auto i = start; i < numInput; ++i) {
-        if (nullRows_.isValid(i)) {
-          for (auto& destination : destinations_) {
-            destination->addRow(i);
-          }
-        } else {
-          if (singlePartition.has_value()) {
-            destinations_[singlePartition.value()]->addRow(i);
-          } else {
-            destinations_[partitions_[i]]->addRow(i);
-          }
-        }
-      }
+    return 0;
+  }
+  const auto numInput = input_->size();
+  auto singlePartition = partitionFunction_->partition(*input_, partitions_);
+  if (!replicateNullsAndAny_) {
+    return singlePartition;
+  }
+
+  // Rows with null keys and the first row go to all destinations.
+  collectNullRows();
+  if (singlePartition.has_value()) {
+    partitions_.resize(numInput);
+    std::fill(partitions_.begin(), partitions_.end(), singlePartition.value());
+  }
+  nullRows_.applyToSelected([&](auto row) {
+    partitions_[row] = core::PartitionFunction::kAllPartitions;
+  });
+  if (!replicatedAny_ && numInput > 0) {
+    partitions_[0] = core::PartitionFunction::kAllPartitions;
+    replicatedAny_ = true;
+  }
+  return std::nullopt;
+}
+
+void PartitionedOutput::scatterRows() {
+  const auto numInput = input_->size();
+
+  // Counts the rows of each destination. The rows for all destinations are
+  // counted once and added to the count of each.
+  partitionOffsets_.assign(numDestinations_ + 1, 0);
+  vector_size_t numReplicatedRows = 0;
+  for (auto row = 0; row < numInput; ++row) {
+    const auto partition = partitions_[row];
+    if (FOLLY_UNLIKELY(partition == core::PartitionFunction::kAllPartitions)) {
+      ++numReplicatedRows;
     } else {
-      if (singlePartition.has_value()) {
-        destinations_[singlePartition.value()]->addRows(
-            IndexRange{0, numInput});
-      } else {
-        for (vector_size_t i = 0; i < numInput; ++i) {
-          destinations_[partitions_[i]]->addRow(i);
-        }
+      ++partitionOffsets_[partition + 1];
+    }
+  }
+  for (auto i = 0; i < numDestinations_; ++i) {
+    partitionOffsets_[i + 1] += partitionOffsets_[i] + numReplicatedRows;
+  }
+
+  // Places each row at the next free position of its destination, which keeps
+  // the rows of each destination in input order.
+  partitionedRows_.resize(partitionOffsets_[numDestinations_]);
+  partitionCursors_.assign(
+      partitionOffsets_.begin(), partitionOffsets_.end() - 1);
+  auto* rawRows = partitionedRows_.data();
+  for (auto row = 0; row < numInput; ++row) {
+    const auto partition = partitions_[row];
+    if (FOLLY_UNLIKELY(partition == core::PartitionFunction::kAllPartitions)) {
+      for (auto& cursor : partitionCursors_) {
+        rawRows[cursor++] = row;
       }
+    } else {
+      rawRows[partitionCursors_[partition]++] = row;
     }
   }
+
+  for (auto i = 0; i < numDestinations_; ++i) {
+    destinations_[i]->beginBatch(folly::Range<const vector_size_t*>(
+        rawRows + partitionOffsets_[i],
+        partitionOffsets_[i + 1] - partitionOffsets_[i]));
+  }
 }
 
 void PartitionedOutput::collectNullRows() {
@@ -442,20 +614,37 @@ RowVectorPtr PartitionedOutput::getOutput() {
 
   bool workLeft;
   do {
+    if (appendColumns_) {
+      workLeft =
+          advanceColumns(maxPageSize, *bufferManager, blockedDestination);
+      continue;
+    }
     workLeft = false;
     for (auto& destination : destinations_) {
       bool atEnd = false;
-      blockingReason_ = destination->advance(
-          maxPageSize,
-          rowSize_,
-          output_,
-          outputCompactRow_.get(),
-          outputUnsafeRow_.get(),
-          *bufferManager,
-          bufferReleaseFn_,
-          &atEnd,
-          &future_,
-          scratch_);
+      if (passVectors_) {
+        blockingReason_ = destination->advanceVector(
+            maxPageSize,
+            rowSize_,
+            output_,
+            operatorCtx_->task(),
+            *bufferManager,
+            &outputCharged_,
+            &atEnd,
+            &future_);
+      } else {
+        blockingReason_ = destination->advance(
+            maxPageSize,
+            rowSize_,
+            output_,
+            outputCompactRow_.get(),
+            outputUnsafeRow_.get(),
+            *bufferManager,
+            bufferReleaseFn_,
+            &atEnd,
+            &future_,
+            scratch_);
+      }
       if (blockingReason_ != BlockingReason::kNotBlocked) {
         blockedDestination = destination.get();
         workLeft = false;
@@ -507,6 +696,37 @@ RowVectorPtr PartitionedOutput::getOutput() {
   return nullptr;
 }
 
+bool PartitionedOutput::advanceColumns(
+    uint64_t maxPageSize,
+    DefaultOutputBufferManager& bufferManager,
+    detail::Destination*& blockedDestination) {
+  if (output_ == nullptr) {
+    return false;
+  }
+  for (auto& destination : destinations_) {
+    destination->selectRows(maxPageSize, rowSize_, output_);
+  }
+  for (auto column = 0; column < output_->childrenSize(); ++column) {
+    for (auto& destination : destinations_) {
+      destination->appendColumn(output_, column, scratch_);
+    }
+  }
+
+  bool workLeft = false;
+  for (auto& destination : destinations_) {
+    if (destination->needsFlush(maxPageSize)) {
+      blockingReason_ =
+          destination->flush(bufferManager, bufferReleaseFn_, &future_);
+      if (blockingReason_ != BlockingReason::kNotBlocked) {
+        blockedDestination = destination.get();
+        return false;
+      }
+    }
+    workLeft |= destination->hasRowsLeft();
+  }
+  return workLeft;
+}
+
 bool PartitionedOutput::isFinished() {
   return finished_;
 }
@@ -522,6 +742,22 @@ void PartitionedOutput::close() {
     lockedStats->addRuntimeStat(
         Operator::kShuffleCompressionKind,
         RuntimeCounter(static_cast<int64_t>(serdeOptions_->compressionKind)));
+    if (codecSelector_ != nullptr) {
+      using Codec = serializer::presto::AdaptiveCodecSelector::Codec;
+      const auto selectorStats = codecSelector_->stats();
+      for (auto i = 0; i < selectorStats.numPages.size(); ++i) {
+        if (selectorStats.numPages[i] == 0) {
+          continue;
+        }
+        lockedStats->addRuntimeStat(
+            fmt::format(
+                "{}.{}",
+                Operator::kShuffleAdaptiveCompressionPages,
+                serializer::presto::AdaptiveCodecSelector::toName(
+                    static_cast<Codec>(i))),
+            RuntimeCounter(selectorStats.numPages[i]));
+      }
+    }
   }
   destinations_.clear();
 }
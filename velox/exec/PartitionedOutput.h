@@ -20,6 +20,7 @@
 #include "velox/exec/Operator.h"
 #include "velox/row/CompactRow.h"
 #include "velox/row/UnsafeRowFast.h"
+#include "velox/serializers/AdaptiveCodecSelector.h"
 #include "velox/vector/VectorStream.h"
 
 namespace facebook::velox::exec {
@@ -28,7 +29,8 @@ namespace detail {
 class Destination {
  public:
   /// @param recordEnqueued Should be called to record each call to
-  /// DefaultOutputBufferManager::enqueue. Takes number of bytes and rows.
+  /// DefaultOutputBufferManager::enqueue. Takes number of bytes and rows and
+  /// whether the buffer manager is full.
   Destination(
       const std::string& taskId,
       int destination,
@@ -36,22 +38,19 @@ class Destination {
       VectorSerde::Options* options,
       memory::MemoryPool* pool,
       bool eagerFlush,
-      std::function<void(uint64_t bytes, uint64_t rows)> recordEnqueued);
+      std::function<void(uint64_t bytes, uint64_t rows, bool blocked)>
+          recordEnqueued);
 
-  /// Resets the destination before starting a new batch.
-  void beginBatch() {
-    rows_.clear();
+  /// Starts a new batch with the rows of the batch that go to 'this'. 'rows'
+  /// must stay valid until all of them are serialized.
+  void beginBatch(folly::Range<const vector_size_t*> rows) {
+    rows_ = rows;
     rowIdx_ = 0;
   }
 
-  void addRow(vector_size_t row) {
-    rows_.push_back(row);
-  }
-
-  void addRows(const IndexRange& rows) {
-    for (auto i = 0; i < rows.size; ++i) {
-      rows_.push_back(rows.begin + i);
-    }
+  /// Returns true if some rows of the batch are not serialized yet.
+  bool hasRowsLeft() const {
+    return rowIdx_ < rows_.size();
   }
 
   /// Serializes row from 'output' till either 'maxBytes' have been serialized
@@ -68,6 +67,45 @@ class Destination {
       ContinueFuture* future,
       Scratch& scratch);
 
+  /// Like advance() but enqueues the next rows as a VectorPage instead of
+  /// serializing them. Used by the in-process transport. The page wraps the
+  /// rows in 'output' if it has more than half of them. Otherwise the rows are
+  /// copied. The first page of any destination that wraps 'output' is charged
+  /// its retained size and sets '*outputCharged', so that 'output' is charged
+  /// once even if its rows are replicated to all destinations. 'producer' is
+  /// the task whose memory 'output' references.
+  BlockingReason advanceVector(
+      uint64_t maxBytes,
+      const std::vector<vector_size_t>& sizes,
+      const RowVectorPtr& output,
+      const std::shared_ptr<Task>& producer,
+      DefaultOutputBufferManager& bufferManager,
+      bool* outputCharged,
+      bool* atEnd,
+      ContinueFuture* future);
+
+  /// advance() in three steps for serializing the rows of many destinations
+  /// one column at a time. selectRows() selects the rows to serialize like
+  /// advance() and prepares the serializer, appendColumn() serializes a column
+  /// of the selected rows and needsFlush() returns true if the destination
+  /// should then be flushed. selectRows() selects no rows if the destination
+  /// has no rows left or should be flushed first.
+  void selectRows(
+      uint64_t maxBytes,
+      const std::vector<vector_size_t>& sizes,
+      const RowVectorPtr& output);
+
+  void appendColumn(
+      const RowVectorPtr& output,
+      column_index_t column,
+      Scratch& scratch) {
+    if (!selectedRows_.empty()) {
+      current_->appendColumn(output, column, selectedRows_, scratch);
+    }
+  }
+
+  bool needsFlush(uint64_t maxBytes) const;
+
   BlockingReason flush(
       DefaultOutputBufferManager& bufferManager,
       const std::function<void()>& bufferReleaseFn,
@@ -102,6 +140,13 @@ class Destination {
     targetNumRows_ = (10'000 * targetSizePct_) / 100;
   }
 
+  // Selects the next rows to serialize, up to 'maxBytes' or the target
+  // number of rows, and counts them in 'bytesInCurrent_' and
+  // 'rowsInCurrent_'. Returns no rows if 'this' is full.
+  folly::Range<const vector_size_t*> nextRows(
+      uint64_t maxBytes,
+      const std::vector<vector_size_t>& sizes);
+
   // Creates VectorStreamGroup if needed. May recreate the stream tree
   // after flush() to reinitialize the serializer.
   void createVectorStreamGroup(const RowVectorPtr& output);
@@ -117,17 +162,23 @@ class Destination {
   VectorSerde::Options* const serdeOptions_;
   memory::MemoryPool* const pool_;
   const bool eagerFlush_;
-  const std::function<void(uint64_t bytes, uint64_t rows)> recordEnqueued_;
+  const std::function<void(uint64_t bytes, uint64_t rows, bool blocked)>
+      recordEnqueued_;
 
   // Bytes serialized in 'current_'
   uint64_t bytesInCurrent_{0};
   // Number of rows serialized in 'current_'
   vector_size_t rowsInCurrent_{0};
-  raw_vector<vector_size_t> rows_;
+  // The rows of the current batch. Points into
+  // PartitionedOutput::partitionedRows_.
+  folly::Range<const vector_size_t*> rows_;
 
   // First index of 'rows_' that is not appended to 'current_'.
   vector_size_t rowIdx_{0};
 
+  // The rows selected by the last selectRows().
+  folly::Range<const vector_size_t*> selectedRows_;
+
   // The current stream where the input is serialized to. This is cleared on
   // every flush() call.
   std::unique_ptr<VectorStreamGroup> current_;
@@ -225,6 +276,25 @@ class PartitionedOutput : public Operator {
   // Collect all rows with null keys into nullRows_.
   void collectNullRows();
 
+  // Computes the partition of each input row in 'partitions_'. Returns the
+  // partition of all rows if they go to a single partition.
+  std::optional<uint32_t> partitionRows();
+
+  // Groups the input rows by partition in 'partitionedRows_' with a counting
+  // sort of 'partitions_' and begins the batch of each destination with its
+  // rows. Rows in core::PartitionFunction::kAllPartitions go to every
+  // destination.
+  void scatterRows();
+
+  // Serializes the rows of all the destinations one column at a time. Returns
+  // true if there is work left, i.e. rows to serialize or destinations to
+  // flush. Sets 'blockedDestination' to the first destination whose flush
+  // blocked.
+  bool advanceColumns(
+      uint64_t maxPageSize,
+      DefaultOutputBufferManager& bufferManager,
+      detail::Destination*& blockedDestination);
+
   // If compression in serde is enabled, this is the minimum compression that
   // must be achieved before starting to skip compression. Used for testing.
   inline static float minCompressionRatio_ = 0.8;
@@ -241,6 +311,15 @@ class PartitionedOutput : public Operator {
   const bool eagerFlush_;
   VectorSerde* const serde_;
   const std::unique_ptr<VectorSerde::Options> serdeOptions_;
+  // True if the rows are passed to the consumers as vectors, without
+  // serializing them. Set for the in-process transport.
+  const bool passVectors_;
+  // True if the destinations are serialized one column at a time. Requires a
+  // serde whose iterative serializer supports appendColumn().
+  const bool appendColumns_;
+  // Chooses the codec of each page if adaptive shuffle compression is
+  // enabled. Shared by the serializers of all the destinations.
+  serializer::presto::AdaptiveCodecSelectorPtr codecSelector_;
 
   BlockingReason blockingReason_{BlockingReason::kNotBlocked};
   ContinueFuture future_;
@@ -253,6 +332,9 @@ class PartitionedOutput : public Operator {
   std::vector<std::unique_ptr<detail::Destination>> destinations_;
   bool replicatedAny_{false};
   RowVectorPtr output_;
+  // True once a VectorPage that wraps 'output_' has been charged its retained
+  // size. Reset for each input.
+  bool outputCharged_{false};
   // This is only set with current 'output_' in case of compact row serde
   // format. It is used to accelerate serialized row size calculation and the
   // actual serialization processing.
@@ -268,6 +350,11 @@ class PartitionedOutput : public Operator {
   SelectivityVector rows_;
   SelectivityVector nullRows_;
   std::vector<uint32_t> partitions_;
+  // The input rows grouped by destination. The rows of destination 'i' are at
+  // ['partitionOffsets_[i]', 'partitionOffsets_[i + 1]').
+  raw_vector<vector_size_t> partitionedRows_;
+  std::vector<vector_size_t> partitionOffsets_;
+  std::vector<vector_size_t> partitionCursors_;
   std::vector<DecodedVector> decodedVectors_;
   Scratch scratch_;
 };
@@ -224,6 +224,21 @@ std::string PlanNodeStats::toString(
              succinctNanos(getOutputTiming.cpuNanos),
              succinctNanos(finishTiming.cpuNanos));
 
+  const auto perfCount = [&](std::string_view name) -> int64_t {
+    const auto it = customStats.find(std::string(name));
+    return it == customStats.end() ? 0 : it->second.sum;
+  };
+  if (const auto cycles = perfCount(OperatorStats::kPerfCycles); cycles > 0) {
+    out << ", IPC: "
+        << fmt::format(
+               "{:.2f}",
+               static_cast<double>(
+                   perfCount(OperatorStats::kPerfInstructions)) /
+                   cycles)
+        << ", Cache misses: " << perfCount(OperatorStats::kPerfCacheMisses)
+        << ", Branch misses: " << perfCount(OperatorStats::kPerfBranchMisses);
+  }
+
   if (includeRuntimeStats) {
     out << ", Runtime stats: (";
     for (const auto& [name, metric] : customStats) {
@@ -990,6 +990,120 @@ void RowContainer::clear() {
   rowColumnsStats_.resize(types_.size());
 }
 
+char* RowContainer::MovedRows::newRow(const char* row) const {
+  const auto it = std::lower_bound(
+      moves_.begin(),
+      moves_.end(),
+      row,
+      [](const auto& move, const char* row) { return move.first < row; });
+  VELOX_CHECK(
+      it != moves_.end() && it->first == row, "Row was not moved by compact()");
+  return it->second;
+}
+
+uint64_t RowContainer::compactionBytes() const {
+  uint64_t bytes = static_cast<uint64_t>(numRows_) *
+      (normalizedKeySize_ + fixedRowSize_);
+  std::vector<column_index_t> variableWidthColumns;
+  for (auto i = 0; i < types_.size(); ++i) {
+    if (!types_[i]->isFixedWidth()) {
+      variableWidthColumns.push_back(i);
+    }
+  }
+  if (variableWidthColumns.empty()) {
+    return bytes;
+  }
+  std::vector<char*> rows(1'000);
+  RowContainerIterator iter;
+  while (const auto numRows = listRows(&iter, rows.size(), rows.data())) {
+    for (auto i = 0; i < numRows; ++i) {
+      for (const auto column : variableWidthColumns) {
+        bytes += 4 + variableSizeAt(rows[i], column);
+      }
+    }
+  }
+  return bytes;
+}
+
+RowContainer::MovedRows RowContainer::compact() {
+  VELOX_CHECK(canCompact());
+  std::vector<char*> oldRows(numRows_);
+  RowContainerIterator iter;
+  size_t numListed = 0;
+  while (numListed < oldRows.size()) {
+    const auto numBatchRows = listRows(
+        &iter,
+        std::min<size_t>(oldRows.size() - numListed, 1'000),
+        oldRows.data() + numListed);
+    VELOX_CHECK_GT(numBatchRows, 0);
+    numListed += numBatchRows;
+  }
+
+  // Copies the rows, including any normalized keys, and their variable width
+  // values out of 'rows_' and 'stringAllocator_'. Variable width values are
+  // copied in the format of extractSerializedRows().
+  std::vector<column_index_t> variableWidthColumns;
+  for (auto i = 0; i < types_.size(); ++i) {
+    if (!types_[i]->isFixedWidth()) {
+      variableWidthColumns.push_back(i);
+    }
+  }
+  const int32_t rowBytes = normalizedKeySize_ + fixedRowSize_;
+  auto fixedData = AlignedBuffer::allocate<char>(
+      static_cast<uint64_t>(oldRows.size()) * rowBytes, pool());
+  auto* rawFixedData = fixedData->asMutable<char>();
+  uint64_t variableBytes{0};
+  for (const auto* row : oldRows) {
+    for (const auto column : variableWidthColumns) {
+      variableBytes += 4 + variableSizeAt(row, column);
+    }
+  }
+  auto variableData = AlignedBuffer::allocate<char>(variableBytes, pool());
+  auto* rawVariableData = variableData->asMutable<char>();
+  uint64_t offset{0};
+  for (auto i = 0; i < oldRows.size(); ++i) {
+    ::memcpy(
+        rawFixedData + static_cast<uint64_t>(i) * rowBytes,
+        oldRows[i] - normalizedKeySize_,
+        rowBytes);
+    for (const auto column : variableWidthColumns) {
+      offset +=
+          extractVariableSizeAt(oldRows[i], column, rawVariableData + offset);
+    }
+  }
+  VELOX_CHECK_EQ(offset, variableBytes);
+
+  rows_.clear();
+  stringAllocator_->clear();
+  firstFreeRow_ = nullptr;
+  numFreeRows_ = 0;
+  numRowsWithNormalizedKey_ = 0;
+
+  MovedRows movedRows;
+  movedRows.moves_.reserve(oldRows.size());
+  offset = 0;
+  for (auto i = 0; i < oldRows.size(); ++i) {
+    char* row = rows_.allocateFixed(rowBytes, alignment_) + normalizedKeySize_;
+    if (normalizedKeySize_) {
+      ++numRowsWithNormalizedKey_;
+    }
+    ::memcpy(
+        row - normalizedKeySize_,
+        rawFixedData + static_cast<uint64_t>(i) * rowBytes,
+        rowBytes);
+    if (rowSizeOffset_) {
+      variableRowSize(row) = 0;
+    }
+    RowSizeTracker tracker(row[rowSizeOffset_], *stringAllocator_);
+    for (const auto column : variableWidthColumns) {
+      offset += storeVariableSizeAt(rawVariableData + offset, row, column);
+    }
+    movedRows.moves_.emplace_back(oldRows[i], row);
+  }
+  std::sort(movedRows.moves_.begin(), movedRows.moves_.end());
+  return movedRows;
+}
+
 void RowContainer::setProbedFlag(char** rows, int32_t numRows) {
   const int32_t probedFlagByte = probedFlagOffset_ / 8;
   const uint8_t probedFlagMask = uint8_t{1} << (probedFlagOffset_ & 7);
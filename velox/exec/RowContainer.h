@@ -859,6 +859,53 @@ class RowContainer {
   /// Resets the state to be as after construction. Frees memory for payload.
   void clear();
 
+  /// The addresses of the rows that compact() has moved.
+  class MovedRows {
+   public:
+    /// Returns the address that 'row' has moved to. 'row' must have been a
+    /// live row of the container at the time of compact().
+    char* newRow(const char* row) const;
+
+    size_t size() const {
+      return moves_.size();
+    }
+
+   private:
+    friend class RowContainer;
+
+    // Pairs of old and new row addresses, sorted by old address.
+    std::vector<std::pair<const char*, char*>> moves_;
+  };
+
+  /// Returns true if compact() can move the rows of 'this'. Accumulators and
+  /// the next-row vectors of duplicate rows keep pointers into
+  /// stringAllocator() that compact() can not update, and so does the row
+  /// index of listRowsFast().
+  bool canCompact() const {
+    return mutable_ && accumulators_.empty() && !hasDuplicateRows_ &&
+        !useListRowIndex_;
+  }
+
+  /// Returns an estimate of the bytes that compact() frees: the erased rows
+  /// and the free blocks of stringAllocator().
+  uint64_t compactableBytes() const {
+    return numFreeRows_ * fixedRowSize_ + stringAllocator_->freeSpace();
+  }
+
+  /// Returns the bytes that compact() allocates from pool() before it frees
+  /// the old rows: a copy of the live rows and of their variable width values.
+  uint64_t compactionBytes() const;
+
+  /// Moves the live rows and their variable width values into new contiguous
+  /// memory and frees the old memory, so that the memory of erased rows and
+  /// of values freed from stringAllocator(), e.g. by eraseRows() or by
+  /// initializeRow() with 'reuse', goes back to the pool. Keeps the order of
+  /// the rows for listRows(). The caller must replace the row addresses it
+  /// keeps elsewhere, e.g. in a hash table, with the ones from the returned
+  /// MovedRows, and must not have other allocations in stringAllocator().
+  /// Requires canCompact().
+  MovedRows compact();
+
   int32_t compareRows(
       const char* left,
       const char* right,
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/SkewedHashPartitionFunction.h"
+
+#include "velox/common/EnumDefine.h"
+
+namespace facebook::velox::exec {
+namespace {
+// The minimum number of counters of the sketch used to detect heavy keys.
+constexpr uint32_t kMinSketchCapacity{32};
+} // namespace
+
+HeavyKeySketch::HeavyKeySketch(uint32_t capacity) : capacity_(capacity) {
+  VELOX_CHECK_GT(capacity_, 0);
+  counts_.reserve(capacity_);
+}
+
+void HeavyKeySketch::add(uint64_t hash) {
+  ++numAdded_;
+  auto it = counts_.find(hash);
+  if (it != counts_.end()) {
+    ++it->second;
+    return;
+  }
+  if (counts_.size() < capacity_) {
+    counts_.emplace(hash, 1);
+    return;
+  }
+  // Decrements all the counters for the new hash, which then has no counter.
+  // Each decrement offsets a previous increment, so this is amortized constant
+  // time.
+  for (auto countIt = counts_.begin(); countIt != counts_.end();) {
+    if (--countIt->second == 0) {
+      countIt = counts_.erase(countIt);
+    } else {
+      ++countIt;
+    }
+  }
+}
+
+folly::F14FastSet<uint64_t> HeavyKeySketch::heavyKeys(double minShare) const {
+  folly::F14FastSet<uint64_t> heavyKeys;
+  if (numAdded_ == 0) {
+    return heavyKeys;
+  }
+  for (const auto& [hash, count] : counts_) {
+    if (count >= minShare * numAdded_) {
+      heavyKeys.insert(hash);
+    }
+  }
+  return heavyKeys;
+}
+
+namespace {
+const auto& skewedHashPartitionModeNames() {
+  using Mode = SkewedHashPartitionFunction::Mode;
+  static const folly::F14FastMap<Mode, std::string_view> kNames = {
+      {Mode::kReplicate, "REPLICATE"},
+      {Mode::kSpread, "SPREAD"},
+  };
+  return kNames;
+}
+} // namespace
+
+VELOX_DEFINE_EMBEDDED_ENUM_NAME(
+    SkewedHashPartitionFunction,
+    Mode,
+    skewedHashPartitionModeNames)
+
+SkewedHashPartitionFunction::SkewedHashPartitionFunction(
+    bool localExchange,
+    int numPartitions,
+    const RowTypePtr& inputType,
+    const std::vector<column_index_t>& keyChannels,
+    Mode mode,
+    folly::F14FastSet<uint64_t> heavyKeys,
+    uint32_t sampleRows)
+    : hashFunction_(localExchange, numPartitions, inputType, keyChannels),
+      numPartitions_{numPartitions},
+      mode_{mode},
+      sampleRows_{sampleRows},
+      heavyKeys_{std::move(heavyKeys)} {
+  VELOX_CHECK_GT(numPartitions_, 0);
+  VELOX_CHECK(!keyChannels.empty(), "Skewed hash partitioning needs keys");
+  if (sampleRows_ > 0) {
+    sketch_ = std::make_unique<HeavyKeySketch>(
+        std::max<uint32_t>(kMinSketchCapacity, 4 * numPartitions_));
+  }
+}
+
+std::optional<uint32_t> SkewedHashPartitionFunction::partition(
+    const RowVector& input,
+    std::vector<uint32_t>& partitions) {
+  const auto singlePartition = hashFunction_.partition(input, partitions);
+  VELOX_CHECK(!singlePartition.has_value());
+
+  const auto numRows = input.size();
+  const auto& hashes = hashFunction_.hashes();
+  if (sketch_ != nullptr) {
+    addSample(hashes, numRows);
+  }
+  if (heavyKeys_.empty()) {
+    return std::nullopt;
+  }
+
+  for (auto row = 0; row < numRows; ++row) {
+    if (!heavyKeys_.contains(hashes[row])) {
+      continue;
+    }
+    if (mode_ == Mode::kReplicate) {
+      partitions[row] = kAllPartitions;
+    } else {
+      partitions[row] = nextPartition_;
+      if (++nextPartition_ == numPartitions_) {
+        nextPartition_ = 0;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+void SkewedHashPartitionFunction::addSample(
+    const raw_vector<uint64_t>& hashes,
+    vector_size_t numRows) {
+  const auto numSampleRows =
+      std::min<uint64_t>(numRows, sampleRows_ - sketch_->numAdded());
+  sketch_->add(hashes.data(), numSampleRows);
+  if (sketch_->numAdded() < sampleRows_) {
+    return;
+  }
+  // A key with at least an even share of the rows overloads its partition.
+  const auto detectedKeys = sketch_->heavyKeys(1.0 / numPartitions_);
+  heavyKeys_.insert(detectedKeys.begin(), detectedKeys.end());
+  sketch_.reset();
+}
+
+SkewedHashPartitionFunctionSpec::SkewedHashPartitionFunctionSpec(
+    RowTypePtr inputType,
+    std::vector<column_index_t> keyChannels,
+    SkewedHashPartitionFunction::Mode mode,
+    std::vector<uint64_t> heavyKeys,
+    uint32_t sampleRows)
+    : inputType_{std::move(inputType)},
+      keyChannels_{std::move(keyChannels)},
+      mode_{mode},
+      heavyKeys_{std::move(heavyKeys)},
+      sampleRows_{sampleRows} {
+  VELOX_USER_CHECK(
+      sampleRows_ == 0 || mode_ == SkewedHashPartitionFunction::Mode::kSpread,
+      "Heavy keys can only be sampled in SPREAD mode");
+}
+
+std::unique_ptr<core::PartitionFunction>
+SkewedHashPartitionFunctionSpec::create(
+    int numPartitions,
+    bool localExchange) const {
+  if (localExchange) {
+    VELOX_USER_CHECK(
+        mode_ == SkewedHashPartitionFunction::Mode::kSpread,
+        "Rows can't be replicated in a local exchange");
+  } else {
+    VELOX_USER_CHECK_EQ(
+        sampleRows_, 0, "Heavy keys can only be sampled in a local exchange");
+  }
+  return std::make_unique<SkewedHashPartitionFunction>(
+      localExchange,
+      numPartitions,
+      inputType_,
+      keyChannels_,
+      mode_,
+      folly::F14FastSet<uint64_t>(heavyKeys_.begin(), heavyKeys_.end()),
+      sampleRows_);
+}
+
+std::string SkewedHashPartitionFunctionSpec::toString() const {
+  std::ostringstream keys;
+  for (auto i = 0; i < keyChannels_.size(); ++i) {
+    if (i > 0) {
+      keys << ", ";
+    }
+    keys << inputType_->nameOf(keyChannels_[i]);
+  }
+
+  return fmt::format(
+      "SKEWED HASH({}) {} {} heavy keys{}",
+      keys.str(),
+      SkewedHashPartitionFunction::toName(mode_),
+      heavyKeys_.size(),
+      sampleRows_ > 0 ? fmt::format(" sample {} rows", sampleRows_) : "");
+}
+
+folly::dynamic SkewedHashPartitionFunctionSpec::serialize() const {
+  folly::dynamic obj = folly::dynamic::object;
+  obj["name"] = "SkewedHashPartitionFunctionSpec";
+  obj["inputType"] = inputType_->serialize();
+  obj["keyChannels"] = ISerializable::serialize(keyChannels_);
+  obj["mode"] = SkewedHashPartitionFunction::toName(mode_);
+  // Hashes are stored as signed integers since folly::dynamic can't hold
+  // unsigned 64 bit values.
+  folly::dynamic heavyKeys = folly::dynamic::array;
+  for (const auto hash : heavyKeys_) {
+    heavyKeys.push_back(static_cast<int64_t>(hash));
+  }
+  obj["heavyKeys"] = std::move(heavyKeys);
+  obj["sampleRows"] = sampleRows_;
+  return obj;
+}
+
+// static
+core::PartitionFunctionSpecPtr SkewedHashPartitionFunctionSpec::deserialize(
+    const folly::dynamic& obj,
+    void* context) {
+  std::vector<uint64_t> heavyKeys;
+  heavyKeys.reserve(obj["heavyKeys"].size());
+  for (const auto& hash : obj["heavyKeys"]) {
+    heavyKeys.push_back(static_cast<uint64_t>(hash.asInt()));
+  }
+  return std::make_shared<SkewedHashPartitionFunctionSpec>(
+      ISerializable::deserialize<RowType>(obj["inputType"]),
+      ISerializable::deserialize<std::vector<column_index_t>>(
+          obj["keyChannels"], context),
+      SkewedHashPartitionFunction::toMode(obj["mode"].asString()),
+      std::move(heavyKeys),
+      obj["sampleRows"].asInt());
+}
+} // namespace facebook::velox::exec
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/container/F14Map.h>
+#include <folly/container/F14Set.h>
+
+#include "velox/common/EnumDeclare.h"
+#include "velox/exec/HashPartitionFunction.h"
+
+namespace facebook::velox::exec {
+
+/// Finds the most frequent values in a stream of key hashes with the
+/// Misra-Gries algorithm, keeping at most 'capacity' counters. A hash with a
+/// share of more than 1 / (capacity + 1) of the added hashes is guaranteed to
+/// have a counter, whose count is underestimated by at most that share.
+class HeavyKeySketch {
+ public:
+  explicit HeavyKeySketch(uint32_t capacity);
+
+  void add(uint64_t hash);
+
+  void add(const uint64_t* hashes, vector_size_t numHashes) {
+    for (auto i = 0; i < numHashes; ++i) {
+      add(hashes[i]);
+    }
+  }
+
+  /// Returns the number of added hashes.
+  uint64_t numAdded() const {
+    return numAdded_;
+  }
+
+  /// Returns the hashes whose estimated share of the added hashes is at least
+  /// 'minShare'.
+  folly::F14FastSet<uint64_t> heavyKeys(double minShare) const;
+
+ private:
+  const uint32_t capacity_;
+  folly::F14FastMap<uint64_t, uint64_t> counts_;
+  uint64_t numAdded_{0};
+};
+
+/// Partitions rows by the hash of their keys like HashPartitionFunction,
+/// except for the rows with heavy keys, i.e. keys frequent enough to overload
+/// the partition they hash to. Used on both sides of a hash join where a few
+/// keys dominate. On the build side, the rows with heavy keys are replicated to
+/// all partitions. On the probe side, they are spread over all partitions
+/// round robin, so that each of them meets all the build rows with the same key
+/// in whichever partition it lands in. This is only correct for joins that do
+/// not output build rows on their own, i.e. inner, left, left semi and anti
+/// joins.
+///
+/// The heavy keys are identified by the hash of the partitioning keys, so that
+/// a hash collision with a heavy key only spreads a few more rows. The heavy
+/// keys are either given upfront, e.g. by the coordinator from the statistics
+/// of the join inputs, or detected from a sample of the input. Detection is
+/// only allowed on the probe side of a local exchange: the hash table of a join
+/// is shared by all the probe drivers of a task, so the build side of a local
+/// exchange keeps hash partitioning and the probe side can spread any key
+/// without coordinating with it.
+class SkewedHashPartitionFunction : public core::PartitionFunction {
+ public:
+  enum class Mode {
+    /// Replicates the rows with heavy keys to all partitions.
+    kReplicate,
+    /// Spreads the rows with heavy keys round robin over all partitions.
+    kSpread,
+  };
+
+  VELOX_DECLARE_EMBEDDED_ENUM_NAME(Mode);
+
+  /// If 'sampleRows' is not zero, adds the keys that have a share of at least
+  /// 1 / 'numPartitions' in the first 'sampleRows' input rows to 'heavyKeys'.
+  SkewedHashPartitionFunction(
+      bool localExchange,
+      int numPartitions,
+      const RowTypePtr& inputType,
+      const std::vector<column_index_t>& keyChannels,
+      Mode mode,
+      folly::F14FastSet<uint64_t> heavyKeys,
+      uint32_t sampleRows = 0);
+
+  std::optional<uint32_t> partition(
+      const RowVector& input,
+      std::vector<uint32_t>& partitions) override;
+
+  int numPartitions() const {
+    return numPartitions_;
+  }
+
+  const folly::F14FastSet<uint64_t>& heavyKeys() const {
+    return heavyKeys_;
+  }
+
+  /// Returns true if the heavy keys are still being sampled.
+  bool sampling() const {
+    return sketch_ != nullptr;
+  }
+
+ private:
+  // Adds the hashes of the first rows of the input to 'sketch_' until
+  // 'sampleRows_' are sampled, then adds the detected heavy keys to
+  // 'heavyKeys_'.
+  void addSample(const raw_vector<uint64_t>& hashes, vector_size_t numRows);
+
+  HashPartitionFunction hashFunction_;
+  const int numPartitions_;
+  const Mode mode_;
+  const uint32_t sampleRows_;
+  folly::F14FastSet<uint64_t> heavyKeys_;
+  // nullptr once 'sampleRows_' are sampled.
+  std::unique_ptr<HeavyKeySketch> sketch_;
+  // The partition of the next row with a heavy key in kSpread mode.
+  uint32_t nextPartition_{0};
+};
+
+/// Factory class to create SkewedHashPartitionFunction. 'heavyKeys' are the
+/// hashes of the heavy keys, which must be the same for both sides of the
+/// join. kReplicate mode is only allowed for a remote exchange since the hash
+/// table of a join is shared by the drivers of a task. A non-zero 'sampleRows'
+/// is only allowed in kSpread mode for a local exchange.
+class SkewedHashPartitionFunctionSpec : public core::PartitionFunctionSpec {
+ public:
+  SkewedHashPartitionFunctionSpec(
+      RowTypePtr inputType,
+      std::vector<column_index_t> keyChannels,
+      SkewedHashPartitionFunction::Mode mode,
+      std::vector<uint64_t> heavyKeys,
+      uint32_t sampleRows = 0);
+
+  std::unique_ptr<core::PartitionFunction> create(
+      int numPartitions,
+      bool localExchange) const override;
+
+  std::string toString() const override;
+
+  folly::dynamic serialize() const override;
+
+  static core::PartitionFunctionSpecPtr deserialize(
+      const folly::dynamic& obj,
+      void* context);
+
+ private:
+  const RowTypePtr inputType_;
+  const std::vector<column_index_t> keyChannels_;
+  const SkewedHashPartitionFunction::Mode mode_;
+  const std::vector<uint64_t> heavyKeys_;
+  const uint32_t sampleRows_;
+};
+} // namespace facebook::velox::exec
@@ -139,7 +139,10 @@ SpillState::SpillState(
     const std::optional<common::PrefixSortConfig>& prefixSortConfig,
     memory::MemoryPool* pool,
     exec::SpillStats* stats,
-    const std::string& fileCreateConfig)
+    const std::string& fileCreateConfig,
+    common::SpillDiskSet* diskSet,
+    SpillMemoryTier* memoryTier,
+    bool adaptiveCompression)
     : getSpillDirPathCb_(getSpillDirPathCb),
       updateAndCheckSpillLimitCb_(updateAndCheckSpillLimitCb),
       fileNamePrefix_(fileNamePrefix),
@@ -150,7 +153,10 @@ SpillState::SpillState(
       prefixSortConfig_(prefixSortConfig),
       fileCreateConfig_(fileCreateConfig),
       pool_(pool),
-      stats_(stats) {}
+      stats_(stats),
+      diskSet_(diskSet),
+      memoryTier_(memoryTier),
+      adaptiveCompression_(adaptiveCompression) {}
 
 std::vector<SpillSortKey> SpillState::makeSortingKeys(
     const std::vector<CompareFlags>& compareFlags) {
@@ -230,7 +236,10 @@ uint64_t SpillState::appendToPartition(
               fileCreateConfig_,
               updateAndCheckSpillLimitCb_,
               pool_,
-              stats_));
+              stats_,
+              diskSet_,
+              memoryTier_,
+              adaptiveCompression_));
     }
   });
 
@@ -362,15 +371,21 @@ SpillPartition::createUnorderedReader(
 
 std::unique_ptr<TreeOfLosers<SpillMergeStream>>
 SpillPartition::createOrderedReaderInternal(
-    uint64_t bufferSize,
+    const common::SpillConfig& spillConfig,
     memory::MemoryPool* pool,
     exec::SpillStats* spillStats) {
+  const auto bufferSize = spillConfig.mergeReadBufferSize(files_.size());
   std::vector<std::unique_ptr<SpillMergeStream>> streams;
   streams.reserve(files_.size());
   for (auto& fileInfo : files_) {
     streams.push_back(
         FileSpillMergeStream::create(
-            SpillReadFile::create(fileInfo, bufferSize, pool, spillStats)));
+            SpillReadFile::create(
+                fileInfo,
+                bufferSize,
+                pool,
+                spillStats,
+                spillConfig.readAheadExecutor())));
   }
   files_.clear();
   // Check if the partition is empty or not.
@@ -436,7 +451,11 @@ SpillFileInfo mergeSpillFiles(
     const common::UpdateAndCheckSpillLimitCB& updateAndCheckSpillLimitCb,
     const std::string& fileCreateConfig,
     uint64_t readBufferSize,
+    folly::Executor* readAheadExecutor,
     uint64_t writeBufferSize,
+    common::SpillDiskSet* diskSet,
+    SpillMemoryTier* memoryTier,
+    bool adaptiveCompression,
     SpillFileMergeParams& mergeParams,
     memory::MemoryPool* pool,
     exec::SpillStats* spillStats) {
@@ -446,7 +465,12 @@ SpillFileInfo mergeSpillFiles(
   for (const auto& fileInfo : files) {
     streams.push_back(
         FileSpillMergeStream::create(
-            SpillReadFile::create(fileInfo, readBufferSize, pool, spillStats)));
+            SpillReadFile::create(
+                fileInfo,
+                readBufferSize,
+                pool,
+                spillStats,
+                readAheadExecutor)));
   }
   const auto batchRows = estimateOutputBatchRows(
       streams, mergeParams.maxBatchRows, mergeParams.maxBatchBytes);
@@ -465,7 +489,10 @@ SpillFileInfo mergeSpillFiles(
       fileCreateConfig,
       updateAndCheckSpillLimitCb,
       pool,
-      spillStats);
+      spillStats,
+      diskSet,
+      memoryTier,
+      adaptiveCompression);
 
   while (mergeTree->next()) {
     VectorPtr tmpRowVector = std::move(mergeParams.rowVector);
@@ -505,8 +532,7 @@ SpillPartition::createOrderedReader(
   const auto numMaxMergeFiles = spillConfig.numMaxMergeFiles;
   VELOX_CHECK_NE(numMaxMergeFiles, 1);
   if (numMaxMergeFiles == 0 || files_.size() <= numMaxMergeFiles) {
-    return createOrderedReaderInternal(
-        spillConfig.readBufferSize, pool, spillStats);
+    return createOrderedReaderInternal(spillConfig, pool, spillStats);
   }
 
   SpillFileHeap orderedFiles(files_.begin(), files_.end());
@@ -530,8 +556,12 @@ SpillPartition::createOrderedReader(
         fmt::format("{}-merge-round-{}", mergeFilePathPrefix, round),
         spillConfig.updateAndCheckSpillLimitCb,
         spillConfig.fileCreateConfig,
-        spillConfig.readBufferSize,
+        spillConfig.mergeReadBufferSize(files.size()),
+        spillConfig.readAheadExecutor(),
         spillConfig.writeBufferSize,
+        spillConfig.diskSet,
+        spillMemoryTier(spillConfig),
+        spillConfig.adaptiveCompressionEnabled,
         mergeParams,
         pool,
         spillStats);
@@ -544,8 +574,7 @@ SpillPartition::createOrderedReader(
     files_.push_back(orderedFiles.top());
     orderedFiles.pop();
   }
-  return createOrderedReaderInternal(
-      spillConfig.readBufferSize, pool, spillStats);
+  return createOrderedReaderInternal(spillConfig, pool, spillStats);
 }
 
 IterableSpillPartitionSet::IterableSpillPartitionSet() {
@@ -521,12 +521,13 @@ class SpillPartition {
  private:
   /// Invoked to create an ordered stream reader from this spill partition.
   /// The created reader will take the ownership of the spill files.
-  /// 'bufferSize' specifies the read size from the storage. If the file
-  /// system supports async read mode, then reader allocates two buffers with
-  /// one buffer prefetch ahead. 'spillStats' is provided to collect the spill
-  /// stats when reading data from spilled files.
+  /// The read size from the storage and the read-ahead executor come from
+  /// 'spillConfig'. If the file system supports async read mode or read-ahead
+  /// is enabled, then reader allocates two buffers with one buffer prefetch
+  /// ahead. 'spillStats' is provided to collect the spill stats when reading
+  /// data from spilled files.
   std::unique_ptr<TreeOfLosers<SpillMergeStream>> createOrderedReaderInternal(
-      uint64_t bufferSize,
+      const common::SpillConfig& spillConfig,
       memory::MemoryPool* pool,
       exec::SpillStats* spillStats);
 
@@ -586,7 +587,11 @@ class SpillState {
   /// 'numSortKeys' is the number of leading columns on which the data is
   /// sorted, 0 if only hash partitioning is used. 'targetFileSize' is the
   /// target size of a single file.  'pool' owns the memory for state and
-  /// results. 'ioStats' is used to collect filesystem I/O stats.
+  /// results. 'ioStats' is used to collect filesystem I/O stats. If set,
+  /// 'diskSet' stripes the spill files across its directories. If set,
+  /// 'memoryTier' keeps the spill files in memory as long as it has capacity.
+  /// If 'adaptiveCompression' is true, the codec of each spilled page is chosen
+  /// adaptively instead of using 'compressionKind'.
   SpillState(
       const common::GetSpillDirectoryPathCB& getSpillDirectoryPath,
       const common::UpdateAndCheckSpillLimitCB& updateAndCheckSpillLimitCb,
@@ -598,7 +603,10 @@ class SpillState {
       const std::optional<common::PrefixSortConfig>& prefixSortConfig,
       memory::MemoryPool* pool,
       exec::SpillStats* stats,
-      const std::string& fileCreateConfig = {});
+      const std::string& fileCreateConfig = {},
+      common::SpillDiskSet* diskSet = nullptr,
+      SpillMemoryTier* memoryTier = nullptr,
+      bool adaptiveCompression = false);
 
   static std::vector<SpillSortKey> makeSortingKeys(
       const std::vector<CompareFlags>& compareFlags = {});
@@ -703,6 +711,9 @@ class SpillState {
   const std::string fileCreateConfig_;
   memory::MemoryPool* const pool_;
   exec::SpillStats* const stats_;
+  common::SpillDiskSet* const diskSet_;
+  SpillMemoryTier* const memoryTier_;
+  const bool adaptiveCompression_;
 
   // A set of spilled partition ids.
   SpillPartitionIdSet spilledPartitionIdSet_;
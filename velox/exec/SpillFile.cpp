@@ -16,6 +16,7 @@
 
 #include "velox/exec/SpillFile.h"
 #include "velox/common/base/RuntimeMetrics.h"
+#include "velox/common/file/FileSystems.h"
 #include "velox/serializers/SerializedPageFile.h"
 
 namespace facebook::velox::exec {
@@ -26,8 +27,46 @@ namespace {
 // nanosecond precision, we use this serde option to ensure the serializer
 // preserves precision.
 static const bool kDefaultUseLosslessTimestamp = true;
+
+// Opens 'fileInfo' for read from the spill memory tier if it is still in
+// memory, or from its file system otherwise.
+std::unique_ptr<ReadFile> openSpillFile(
+    const SpillFileInfo& fileInfo,
+    IoStats* ioStats) {
+  if (fileInfo.memoryFile != nullptr) {
+    auto file = fileInfo.memoryFile->openForRead();
+    if (file != nullptr) {
+      return file;
+    }
+  }
+  return filesystems::getFileSystem(fileInfo.path, nullptr)
+      ->openFileForRead(
+          fileInfo.path, filesystems::FileOptions{.stats = ioStats});
+}
 } // namespace
 
+// static
+std::unique_ptr<serializer::presto::PrestoVectorSerde::PrestoOptions>
+SpillWriter::makeSerdeOptions(
+    common::CompressionKind compressionKind,
+    SpillMemoryTier* memoryTier,
+    bool adaptiveCompression) {
+  auto options =
+      std::make_unique<serializer::presto::PrestoVectorSerde::PrestoOptions>(
+          kDefaultUseLosslessTimestamp,
+          memoryTier != nullptr &&
+                  compressionKind == common::CompressionKind_NONE
+              ? kMemoryTierKind
+              : compressionKind,
+          0.8,
+          /*_nullsFirst=*/true);
+  if (adaptiveCompression) {
+    options->codecSelector =
+        std::make_shared<serializer::presto::AdaptiveCodecSelector>();
+  }
+  return options;
+}
+
 SpillWriter::SpillWriter(
     const RowTypePtr& type,
     const std::vector<SpillSortKey>& sortingKeys,
@@ -38,25 +77,70 @@ SpillWriter::SpillWriter(
     const std::string& fileCreateConfig,
     const common::UpdateAndCheckSpillLimitCB& updateAndCheckSpillLimitCb,
     memory::MemoryPool* pool,
-    exec::SpillStats* stats)
+    exec::SpillStats* stats,
+    common::SpillDiskSet* diskSet,
+    SpillMemoryTier* memoryTier,
+    bool adaptiveCompression)
     : serializer::SerializedPageFileWriter(
           pathPrefix,
           targetFileSize,
           writeBufferSize,
           fileCreateConfig,
-          std::make_unique<
-              serializer::presto::PrestoVectorSerde::PrestoOptions>(
-              kDefaultUseLosslessTimestamp,
-              compressionKind,
-              0.8,
-              /*_nullsFirst=*/true),
+          makeSerdeOptions(compressionKind, memoryTier, adaptiveCompression),
           getNamedVectorSerde("Presto"),
           pool,
           &stats->ioStats),
       type_(type),
       sortingKeys_(sortingKeys),
       stats_(stats),
-      updateAndCheckLimitCb_(updateAndCheckSpillLimitCb) {}
+      updateAndCheckLimitCb_(updateAndCheckSpillLimitCb),
+      diskSet_(diskSet),
+      fileName_(pathPrefix.substr(pathPrefix.find_last_of('/') + 1)),
+      memoryTier_(memoryTier) {}
+
+SpillWriter::~SpillWriter() {
+  if (currentFileQueuedBytes_ != 0) {
+    diskSet_->removeQueuedBytes(fileDisks_.back(), currentFileQueuedBytes_);
+  }
+}
+
+std::string SpillWriter::nextFilePathPrefix() {
+  if (diskSet_ == nullptr) {
+    return serializer::SerializedPageFileWriter::nextFilePathPrefix();
+  }
+  const auto disk = diskSet_->pickDisk();
+  fileDisks_.push_back(disk);
+  return fmt::format(
+      "{}/{}-{}", diskSet_->directory(disk), fileName_, finishedFiles_.size());
+}
+
+std::unique_ptr<serializer::SerializedPageFile> SpillWriter::createFile(
+    uint32_t id,
+    const std::string& pathPrefix) {
+  if (memoryTier_ == nullptr) {
+    return serializer::SerializedPageFileWriter::createFile(id, pathPrefix);
+  }
+  auto path = serializer::SerializedPageFile::makePath(pathPrefix);
+  auto file = memoryTier_->createFile(
+      path,
+      filesystems::FileOptions{
+          .values =
+              {{filesystems::FileOptions::kFileCreateConfig.toString(),
+                fileCreateConfig_}},
+          .stats = ioStats_});
+  auto writeFile = file->openForWrite();
+  memoryFiles_.push_back(std::move(file));
+  return serializer::SerializedPageFile::create(
+      id, std::move(path), std::move(writeFile));
+}
+
+void SpillWriter::closeFile() {
+  if (currentFileQueuedBytes_ != 0) {
+    diskSet_->removeQueuedBytes(fileDisks_.back(), currentFileQueuedBytes_);
+    currentFileQueuedBytes_ = 0;
+  }
+  serializer::SerializedPageFileWriter::closeFile();
+}
 
 void SpillWriter::updateAppendStats(
     uint64_t numRows,
@@ -76,6 +160,17 @@ void SpillWriter::updateWriteStats(
   stats_->spillFlushTimeNanos.fetch_add(flushTimeNs, std::memory_order_relaxed);
   stats_->spillWriteTimeNanos.fetch_add(
       fileWriteTimeNs, std::memory_order_relaxed);
+  if (diskSet_ != nullptr) {
+    const auto disk = fileDisks_.back();
+    diskSet_->addQueuedBytes(disk, spilledBytes);
+    currentFileQueuedBytes_ += spilledBytes;
+    stats_->ioStats.addCounter(
+        common::SpillDiskSet::writeBytesStatName(disk),
+        RuntimeCounter(spilledBytes, RuntimeCounter::Unit::kBytes));
+    stats_->ioStats.addCounter(
+        common::SpillDiskSet::writeTimeStatName(disk),
+        RuntimeCounter(fileWriteTimeNs, RuntimeCounter::Unit::kNanos));
+  }
   updateGlobalSpillWriteStats(spilledBytes, flushTimeNs, fileWriteTimeNs);
   updateAndCheckLimitCb_(spilledBytes);
 }
@@ -91,9 +186,16 @@ void SpillWriter::updateFileStats(
 SpillFiles SpillWriter::finish() {
   const auto serializedPageFiles =
       serializer::SerializedPageFileWriter::finish();
+  if (diskSet_ != nullptr) {
+    VELOX_CHECK_EQ(serializedPageFiles.size(), fileDisks_.size());
+  }
+  if (memoryTier_ != nullptr) {
+    VELOX_CHECK_EQ(serializedPageFiles.size(), memoryFiles_.size());
+  }
   SpillFiles spillFiles;
   spillFiles.reserve(serializedPageFiles.size());
-  for (const auto& fileInfo : serializedPageFiles) {
+  for (auto i = 0; i < serializedPageFiles.size(); ++i) {
+    const auto& fileInfo = serializedPageFiles[i];
     spillFiles.push_back(
         SpillFileInfo{
             .id = fileInfo.id,
@@ -101,7 +203,12 @@ SpillFiles SpillWriter::finish() {
             .path = fileInfo.path,
             .size = fileInfo.size,
             .sortingKeys = sortingKeys_,
-            .compressionKind = serdeOptions_->compressionKind});
+            .compressionKind = serdeOptions_->compressionKind,
+            .disk = diskSet_ != nullptr
+                ? std::optional<uint32_t>(fileDisks_[i])
+                : std::nullopt,
+            .memoryFile =
+                memoryTier_ != nullptr ? memoryFiles_[i] : nullptr});
   }
   return spillFiles;
 }
@@ -138,31 +245,38 @@ std::unique_ptr<SpillReadFile> SpillReadFile::create(
     const SpillFileInfo& fileInfo,
     uint64_t bufferSize,
     memory::MemoryPool* pool,
-    exec::SpillStats* stats) {
+    exec::SpillStats* stats,
+    folly::Executor* readAheadExecutor) {
   return std::unique_ptr<SpillReadFile>(new SpillReadFile(
       fileInfo.id,
       fileInfo.path,
+      openSpillFile(fileInfo, &stats->ioStats),
       fileInfo.size,
       bufferSize,
       fileInfo.type,
       fileInfo.sortingKeys,
       fileInfo.compressionKind,
       pool,
-      stats));
+      stats,
+      readAheadExecutor,
+      fileInfo.disk));
 }
 
 SpillReadFile::SpillReadFile(
     uint32_t id,
     const std::string& path,
+    std::unique_ptr<ReadFile> file,
     uint64_t size,
     uint64_t bufferSize,
     const RowTypePtr& type,
     const std::vector<SpillSortKey>& sortingKeys,
     common::CompressionKind compressionKind,
     memory::MemoryPool* pool,
-    exec::SpillStats* stats)
+    exec::SpillStats* stats,
+    folly::Executor* readAheadExecutor,
+    std::optional<uint32_t> disk)
     : serializer::SerializedPageFileReader(
-          path,
+          std::move(file),
           bufferSize,
           type,
           getNamedVectorSerde("Presto"),
@@ -173,12 +287,13 @@ SpillReadFile::SpillReadFile(
               0.8,
               /*_nullsFirst=*/true),
           pool,
-          &stats->ioStats),
+          readAheadExecutor),
       id_(id),
       path_(path),
       size_(size),
       sortingKeys_(sortingKeys),
-      stats_(stats) {}
+      stats_(stats),
+      disk_(disk) {}
 
 void SpillReadFile::updateFinalStats() {
   VELOX_CHECK(input_->atEnd());
@@ -190,6 +305,14 @@ void SpillReadFile::updateFinalStats() {
       readStats.readBytes, std::memory_order_relaxed);
   stats_->spillReadTimeNanos.fetch_add(
       readStats.readTimeNs, std::memory_order_relaxed);
+  if (disk_.has_value()) {
+    stats_->ioStats.addCounter(
+        common::SpillDiskSet::readBytesStatName(disk_.value()),
+        RuntimeCounter(readStats.readBytes, RuntimeCounter::Unit::kBytes));
+    stats_->ioStats.addCounter(
+        common::SpillDiskSet::readTimeStatName(disk_.value()),
+        RuntimeCounter(readStats.readTimeNs, RuntimeCounter::Unit::kNanos));
+  }
 };
 
 void SpillReadFile::updateSerializationTimeStats(uint64_t timeNs) {
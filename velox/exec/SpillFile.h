@@ -24,6 +24,7 @@
 #include "velox/common/compression/Compression.h"
 #include "velox/common/file/File.h"
 #include "velox/common/file/FileInputStream.h"
+#include "velox/exec/SpillMemoryTier.h"
 #include "velox/exec/SpillStats.h"
 #include "velox/serializers/PrestoSerializer.h"
 #include "velox/serializers/SerializedPageFile.h"
@@ -43,6 +44,12 @@ struct SpillFileInfo {
   uint64_t size;
   std::vector<SpillSortKey> sortingKeys;
   common::CompressionKind compressionKind;
+  /// The disk of the spill disk set the file is on, if spill files are striped
+  /// across disks.
+  std::optional<uint32_t> disk{std::nullopt};
+  /// The in-memory file if the file is written to the spill memory tier. The
+  /// file is read from 'path' once it is demoted to disk.
+  std::shared_ptr<SpillMemoryFile> memoryFile{nullptr};
 };
 
 using SpillFiles = std::vector<SpillFileInfo>;
@@ -59,7 +66,13 @@ class SpillWriter : public serializer::SerializedPageFileWriter {
   /// write to file. 'fileOptions' specifies the file layout on remote storage
   /// which is storage system specific. 'pool' is used for buffering and
   /// constructing the result data read from 'this'. 'stats' is used to collect
-  /// the spill write stats.
+  /// the spill write stats. If 'diskSet' is set, each file is created in the
+  /// directory picked by 'diskSet' with the file name of 'pathPrefix'. If
+  /// 'memoryTier' is set, the files are kept in its memory until it runs out of
+  /// capacity. As the tier is meant to hold compressed data, kMemoryTierKind
+  /// compression is used if 'compressionKind' is CompressionKind_NONE. If
+  /// 'adaptiveCompression' is true, the codec of each page is chosen by an
+  /// AdaptiveCodecSelector instead.
   ///
   /// When writing sorted spill runs, the caller is responsible for buffering
   /// and sorting the data. write is called multiple times, followed by flush().
@@ -73,7 +86,15 @@ class SpillWriter : public serializer::SerializedPageFileWriter {
       const std::string& fileCreateConfig,
       const common::UpdateAndCheckSpillLimitCB& updateAndCheckSpillLimitCb,
       memory::MemoryPool* pool,
-      exec::SpillStats* stats);
+      exec::SpillStats* stats,
+      common::SpillDiskSet* diskSet = nullptr,
+      SpillMemoryTier* memoryTier = nullptr,
+      bool adaptiveCompression = false);
+
+  ~SpillWriter() override;
+
+  static constexpr common::CompressionKind kMemoryTierKind{
+      common::CompressionKind_LZ4};
 
   /// Finishes this file writer and returns the written spill files info.
   ///
@@ -85,6 +106,12 @@ class SpillWriter : public serializer::SerializedPageFileWriter {
   std::vector<uint32_t> testingSpilledFileIds() const;
 
  private:
+  static std::unique_ptr<serializer::presto::PrestoVectorSerde::PrestoOptions>
+  makeSerdeOptions(
+      common::CompressionKind compressionKind,
+      SpillMemoryTier* memoryTier,
+      bool adaptiveCompression);
+
   // Invoked to increment the number of spilled files and the file size.
   void updateFileStats(
       const serializer::SerializedPageFile::FileInfo& fileInfo) override;
@@ -99,6 +126,17 @@ class SpillWriter : public serializer::SerializedPageFileWriter {
       uint64_t flushTimeUs,
       uint64_t writeTimeUs) override;
 
+  // Releases the queued bytes of the current file from 'diskSet_'.
+  void closeFile() override;
+
+  // Picks the disk of the next file from 'diskSet_' if set.
+  std::string nextFilePathPrefix() override;
+
+  // Creates the file in 'memoryTier_' if set.
+  std::unique_ptr<serializer::SerializedPageFile> createFile(
+      uint32_t id,
+      const std::string& pathPrefix) override;
+
   const RowTypePtr type_;
 
   const std::vector<SpillSortKey> sortingKeys_;
@@ -108,10 +146,29 @@ class SpillWriter : public serializer::SerializedPageFileWriter {
   // Updates the aggregated bytes of this query, and throws if exceeds
   // the max bytes limit.
   const common::UpdateAndCheckSpillLimitCB updateAndCheckLimitCb_;
+
+  common::SpillDiskSet* const diskSet_;
+
+  // The file name part of 'pathPrefix_', used to create files in the
+  // directories of 'diskSet_'.
+  const std::string fileName_;
+
+  // The disk of each created file in creation order if 'diskSet_' is set.
+  std::vector<uint32_t> fileDisks_;
+
+  // The bytes written to the current file, queued on its disk.
+  uint64_t currentFileQueuedBytes_{0};
+
+  SpillMemoryTier* const memoryTier_;
+
+  // The file in 'memoryTier_' of each created file in creation order if
+  // 'memoryTier_' is set.
+  std::vector<std::shared_ptr<SpillMemoryFile>> memoryFiles_;
 };
 
 /// Represents a spill file for read which turns the serialized spilled data
-/// on disk back into a sequence of spilled row vectors.
+/// on disk back into a sequence of spilled row vectors. A file still in the
+/// spill memory tier is read from memory.
 ///
 /// NOTE: The class will not delete spill file upon destruction, so the user
 /// needs to remove the unused spill files at some point later. For example, a
@@ -119,11 +176,14 @@ class SpillWriter : public serializer::SerializedPageFileWriter {
 /// rmdir() call.
 class SpillReadFile : public serializer::SerializedPageFileReader {
  public:
+  /// If 'readAheadExecutor' is set, the next 'bufferSize' bytes of the file
+  /// are read on it while the current buffer is consumed.
   static std::unique_ptr<SpillReadFile> create(
       const SpillFileInfo& fileInfo,
       uint64_t bufferSize,
       memory::MemoryPool* pool,
-      exec::SpillStats* stats);
+      exec::SpillStats* stats,
+      folly::Executor* readAheadExecutor = nullptr);
 
   uint32_t id() const {
     return id_;
@@ -146,13 +206,16 @@ class SpillReadFile : public serializer::SerializedPageFileReader {
   SpillReadFile(
       uint32_t id,
       const std::string& path,
+      std::unique_ptr<ReadFile> file,
       uint64_t size,
       uint64_t bufferSize,
       const RowTypePtr& type,
       const std::vector<SpillSortKey>& sortingKeys,
       common::CompressionKind compressionKind,
       memory::MemoryPool* pool,
-      exec::SpillStats* stats);
+      exec::SpillStats* stats,
+      folly::Executor* readAheadExecutor,
+      std::optional<uint32_t> disk);
 
   // Records spill read stats at the end of read input.
   void updateFinalStats() override;
@@ -171,6 +234,9 @@ class SpillReadFile : public serializer::SerializedPageFileReader {
   const std::vector<SpillSortKey> sortingKeys_;
 
   exec::SpillStats* const stats_;
+
+  // The spill disk the file is on if spill files are striped across disks.
+  const std::optional<uint32_t> disk_;
 };
 
 } // namespace facebook::velox::exec
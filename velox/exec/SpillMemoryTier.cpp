@@ -0,0 +1,427 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/SpillMemoryTier.h"
+
+#include <vector>
+
+#include <fmt/format.h>
+#include <folly/ScopeGuard.h>
+#include <glog/logging.h>
+
+#include "velox/common/memory/Memory.h"
+
+namespace facebook::velox::exec {
+namespace {
+// The initial capacity of the in-memory content of a spill file.
+constexpr uint64_t kMinFileCapacity{64 << 10};
+
+std::unique_ptr<SpillMemoryTier>& instance() {
+  static std::unique_ptr<SpillMemoryTier> tier;
+  return tier;
+}
+} // namespace
+
+/// The write file handed to SerializedPageFile for a SpillMemoryFile.
+class SpillMemoryWriteFile : public WriteFile {
+ public:
+  explicit SpillMemoryWriteFile(std::shared_ptr<SpillMemoryFile> file)
+      : file_(std::move(file)) {}
+
+  void append(std::string_view data) override {
+    file_->append(data);
+  }
+
+  void append(std::unique_ptr<folly::IOBuf> data) override {
+    for (auto range : *data) {
+      file_->append(std::string_view(
+          reinterpret_cast<const char*>(range.data()), range.size()));
+    }
+  }
+
+  void flush() override {}
+
+  void close() override {
+    file_->finish();
+  }
+
+  uint64_t size() const override {
+    return file_->size();
+  }
+
+  const std::string getName() const override {
+    return file_->path();
+  }
+
+ private:
+  const std::shared_ptr<SpillMemoryFile> file_;
+};
+
+/// The read file over the in-memory content of a SpillMemoryFile. Keeps the
+/// content and its reservation alive until destroyed.
+class SpillMemoryReadFile : public InMemoryReadFile {
+ public:
+  explicit SpillMemoryReadFile(
+      std::shared_ptr<const SpillMemoryFile::Content> content)
+      : InMemoryReadFile(std::string_view(
+            content->data->as<char>(),
+            static_cast<size_t>(content->data->size()))),
+        content_(std::move(content)) {}
+
+ private:
+  const std::shared_ptr<const SpillMemoryFile::Content> content_;
+};
+
+SpillMemoryFile::Content::~Content() {
+  data.reset();
+  if (reservedBytes != 0) {
+    tier->release(reservedBytes);
+  }
+}
+
+SpillMemoryFile::SpillMemoryFile(
+    SpillMemoryTier* tier,
+    std::string path,
+    filesystems::FileOptions fileOptions)
+    : tier_(tier),
+      path_(std::move(path)),
+      fileOptions_(std::move(fileOptions)) {}
+
+SpillMemoryFile::~SpillMemoryFile() = default;
+
+bool SpillMemoryFile::inMemory() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return !onDisk_;
+}
+
+uint64_t SpillMemoryFile::size() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return size_;
+}
+
+std::unique_ptr<WriteFile> SpillMemoryFile::openForWrite() {
+  return std::make_unique<SpillMemoryWriteFile>(shared_from_this());
+}
+
+std::unique_ptr<ReadFile> SpillMemoryFile::openForRead() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(finished_, "Spill file {} is not finished", path_);
+  if (onDisk_) {
+    return nullptr;
+  }
+  if (content_ == nullptr) {
+    return std::make_unique<InMemoryReadFile>(std::string_view());
+  }
+  // The content is not modified after finish.
+  return std::make_unique<SpillMemoryReadFile>(content_);
+}
+
+void SpillMemoryFile::append(std::string_view data) {
+  if (data.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(!finished_, "Spill file {} is finished", path_);
+  const uint64_t newSize = size_ + data.size();
+  const uint64_t reservedBytes =
+      content_ == nullptr ? 0 : content_->reservedBytes;
+  if (!onDisk_ && newSize > reservedBytes) {
+    // Grows geometrically to amortize the copies, and falls back to the exact
+    // size if the geometric growth does not fit in the tier.
+    const uint64_t newCapacity =
+        std::max({newSize, 2 * reservedBytes, kMinFileCapacity});
+    uint64_t growBytes{0};
+    if (tier_->reserve(newCapacity - reservedBytes)) {
+      growBytes = newCapacity - reservedBytes;
+    } else if (
+        newCapacity != newSize && tier_->reserve(newSize - reservedBytes)) {
+      growBytes = newSize - reservedBytes;
+    }
+    if (growBytes == 0) {
+      writeToDiskLocked();
+      tier_->recordDiskFile();
+    } else {
+      if (content_ == nullptr) {
+        content_ = std::make_shared<Content>(tier_);
+        content_->data =
+            AlignedBuffer::allocate<char>(growBytes, tier_->pool());
+      } else {
+        AlignedBuffer::reallocate<char>(
+            &content_->data, reservedBytes + growBytes);
+      }
+      content_->reservedBytes += growBytes;
+      content_->data->setSize(size_);
+    }
+  }
+  if (onDisk_) {
+    diskFile_->append(data);
+  } else {
+    ::memcpy(
+        content_->data->asMutable<char>() + size_, data.data(), data.size());
+    content_->data->setSize(newSize);
+  }
+  size_ = newSize;
+}
+
+void SpillMemoryFile::finish() {
+  uint64_t reservedBytes{0};
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK(!finished_, "Spill file {} is finished", path_);
+    finished_ = true;
+    if (onDisk_) {
+      diskFile_->close();
+      diskFile_.reset();
+      return;
+    }
+    if (content_ != nullptr) {
+      reservedBytes = content_->reservedBytes;
+    }
+  }
+  tier_->addFinishedFile(shared_from_this(), reservedBytes);
+}
+
+std::optional<uint64_t> SpillMemoryFile::demote() {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(finished_);
+  if (onDisk_) {
+    return 0;
+  }
+  const auto demotedBytes = size_;
+  try {
+    writeToDiskLocked();
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Failed to demote spill file " << path_
+                 << " to disk, keeping it in memory: " << e.what();
+    diskFile_.reset();
+    try {
+      filesystems::getFileSystem(path_, nullptr)->remove(path_);
+    } catch (const std::exception&) {
+      // The partial file may not exist.
+    }
+    tier_->recordDemotionError();
+    return std::nullopt;
+  }
+  return demotedBytes;
+}
+
+void SpillMemoryFile::writeToDiskLocked() {
+  VELOX_CHECK(!onDisk_);
+  auto fs = filesystems::getFileSystem(path_, nullptr);
+  auto diskFile = fs->openFileForWrite(path_, fileOptions_);
+  if (size_ > 0) {
+    diskFile->append(std::string_view(content_->data->as<char>(), size_));
+  }
+  if (finished_) {
+    diskFile->close();
+  } else {
+    diskFile_ = std::move(diskFile);
+  }
+  // The read files opened before keep the content until they are destroyed.
+  content_.reset();
+  onDisk_ = true;
+}
+
+SpillMemoryTier::SpillMemoryTier(
+    uint64_t capacity,
+    std::shared_ptr<memory::MemoryPool> pool,
+    folly::Executor* executor)
+    : capacity_(capacity), pool_(std::move(pool)), executor_(executor) {
+  VELOX_CHECK_NOT_NULL(pool_);
+  VELOX_CHECK_EQ(pool_->kind(), memory::MemoryPool::Kind::kLeaf);
+}
+
+SpillMemoryTier::~SpillMemoryTier() {
+  std::unique_lock<std::mutex> l(mutex_);
+  demotionsDone_.wait(l, [&]() { return numPendingDemotions_ == 0; });
+  VELOX_DCHECK_EQ(
+      usedBytes_, 0, "Spill memory tier is destroyed with files in memory");
+}
+
+/*static*/
+void SpillMemoryTier::initialize(uint64_t capacity, folly::Executor* executor) {
+  VELOX_CHECK_NULL(
+      instance(), "Spill memory tier has already been initialized");
+  instance() = std::make_unique<SpillMemoryTier>(
+      capacity,
+      memory::memoryManager()->addLeafPool("__sys_spill_memory__"),
+      executor);
+}
+
+/*static*/
+SpillMemoryTier* SpillMemoryTier::getInstance() {
+  return instance().get();
+}
+
+/*static*/
+void SpillMemoryTier::testingReset() {
+  instance().reset();
+}
+
+std::shared_ptr<SpillMemoryFile> SpillMemoryTier::createFile(
+    const std::string& path,
+    const filesystems::FileOptions& fileOptions) {
+  return std::make_shared<SpillMemoryFile>(this, path, fileOptions);
+}
+
+uint64_t SpillMemoryTier::usedBytes() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return usedBytes_;
+}
+
+SpillMemoryTier::Stats SpillMemoryTier::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return stats_;
+}
+
+bool SpillMemoryTier::reserve(uint64_t bytes) {
+  // The files that failed to demote on this thread. Each is tried once per
+  // call and requeued for the next demotion.
+  std::vector<FinishedFile> failed;
+  SCOPE_EXIT {
+    requeueFailedFiles(std::move(failed));
+  };
+  for (;;) {
+    std::vector<FinishedFile> victims;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (usedBytes_ + bytes <= capacity_) {
+        usedBytes_ += bytes;
+        return true;
+      }
+      // Demotes one file at a time on this thread. Schedules enough files to
+      // make room on 'executor_', counting the ones already being demoted as
+      // free.
+      const auto needsVictim = [&]() {
+        if (executor_ == nullptr) {
+          return victims.empty();
+        }
+        return usedBytes_ + bytes > capacity_ + demotingBytes_;
+      };
+      while (needsVictim() && !finishedFiles_.empty()) {
+        auto victim = std::move(finishedFiles_.front());
+        finishedFiles_.pop_front();
+        if (victim.file.expired()) {
+          continue;
+        }
+        if (executor_ != nullptr) {
+          demotingBytes_ += victim.bytes;
+          ++numPendingDemotions_;
+        }
+        victims.push_back(std::move(victim));
+      }
+      if (victims.empty()) {
+        return false;
+      }
+    }
+    if (executor_ == nullptr) {
+      // Writes the victim to disk outside of the tier lock. This releases its
+      // reservation unless it is being read.
+      if (auto file = victims[0].file.lock()) {
+        if (!demote(*file)) {
+          failed.push_back(std::move(victims[0]));
+        }
+      }
+      continue;
+    }
+    for (auto& victim : victims) {
+      executor_->add([this, victim = std::move(victim)]() mutable {
+        const auto bytes = victim.bytes;
+        if (auto file = victim.file.lock()) {
+          if (!demote(*file)) {
+            requeueFailedFiles({std::move(victim)});
+          }
+        }
+        std::lock_guard<std::mutex> l(mutex_);
+        demotingBytes_ -= bytes;
+        if (--numPendingDemotions_ == 0) {
+          demotionsDone_.notify_all();
+        }
+      });
+    }
+    // The file that needs the room continues on disk instead of waiting.
+    return false;
+  }
+}
+
+bool SpillMemoryTier::demote(SpillMemoryFile& file) {
+  const auto demotedBytes = file.demote();
+  if (!demotedBytes.has_value()) {
+    return false;
+  }
+  if (demotedBytes.value() != 0) {
+    std::lock_guard<std::mutex> l(mutex_);
+    ++stats_.numDemotedFiles;
+    stats_.demotedBytes += demotedBytes.value();
+  }
+  return true;
+}
+
+void SpillMemoryTier::requeueFailedFiles(std::vector<FinishedFile> files) {
+  if (files.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  // The failed files were the oldest, so they go back in front in their
+  // order.
+  for (auto it = files.rbegin(); it != files.rend(); ++it) {
+    finishedFiles_.push_front(std::move(*it));
+  }
+}
+
+void SpillMemoryTier::release(uint64_t bytes) {
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK_GE(usedBytes_, bytes);
+  usedBytes_ -= bytes;
+}
+
+void SpillMemoryTier::addFinishedFile(
+    const std::shared_ptr<SpillMemoryFile>& file,
+    uint64_t bytes) {
+  std::lock_guard<std::mutex> l(mutex_);
+  while (!finishedFiles_.empty() && finishedFiles_.front().file.expired()) {
+    finishedFiles_.pop_front();
+  }
+  finishedFiles_.push_back({file, bytes});
+  ++stats_.numMemoryFiles;
+}
+
+void SpillMemoryTier::recordDemotionError() {
+  std::lock_guard<std::mutex> l(mutex_);
+  ++stats_.numDemotionErrors;
+}
+
+void SpillMemoryTier::recordDiskFile() {
+  std::lock_guard<std::mutex> l(mutex_);
+  ++stats_.numDiskFiles;
+}
+
+std::string SpillMemoryTier::Stats::toString() const {
+  return fmt::format(
+      "numMemoryFiles {} numDiskFiles {} numDemotedFiles {} demotedBytes {} "
+      "numDemotionErrors {}",
+      numMemoryFiles,
+      numDiskFiles,
+      numDemotedFiles,
+      demotedBytes,
+      numDemotionErrors);
+}
+
+SpillMemoryTier* spillMemoryTier(const common::SpillConfig& config) {
+  return config.memoryTierEnabled ? SpillMemoryTier::getInstance() : nullptr;
+}
+
+} // namespace facebook::velox::exec
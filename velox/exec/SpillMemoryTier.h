@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <folly/Executor.h>
+
+#include "velox/buffer/Buffer.h"
+#include "velox/common/base/SpillConfig.h"
+#include "velox/common/file/File.h"
+#include "velox/common/file/FileSystems.h"
+#include "velox/common/memory/MemoryPool.h"
+
+namespace facebook::velox::exec {
+
+class SpillMemoryTier;
+
+/// A spill file written to a SpillMemoryTier. Its serialized pages are kept in
+/// memory of the tier until the tier runs out of capacity, in which case the
+/// file is demoted to its disk 'path'. A file that does not fit while it is
+/// being written continues on disk. The memory stays charged to the tier until
+/// both the file and the read files over it are destroyed. Is thread safe.
+class SpillMemoryFile : public std::enable_shared_from_this<SpillMemoryFile> {
+ public:
+  SpillMemoryFile(
+      SpillMemoryTier* tier,
+      std::string path,
+      filesystems::FileOptions fileOptions);
+
+  ~SpillMemoryFile();
+
+  const std::string& path() const {
+    return path_;
+  }
+
+  /// Returns true if the file content is in memory.
+  bool inMemory() const;
+
+  /// Returns a write file that appends to this file. The file is finished when
+  /// the returned write file is closed.
+  std::unique_ptr<WriteFile> openForWrite();
+
+  /// Returns a read file over the in-memory content of a finished file, or
+  /// nullptr if the file is on disk and has to be read from 'path'. The read
+  /// file shares the content, so it stays valid if the file is demoted or
+  /// destroyed.
+  std::unique_ptr<ReadFile> openForRead() const;
+
+ private:
+  friend class SpillMemoryTier;
+  friend class SpillMemoryWriteFile;
+  friend class SpillMemoryReadFile;
+
+  // The in-memory file content and the bytes reserved for it from 'tier'.
+  // Releases the reservation when the last of the file and its read files
+  // drops it.
+  struct Content {
+    explicit Content(SpillMemoryTier* _tier) : tier(_tier) {}
+
+    ~Content();
+
+    SpillMemoryTier* const tier;
+    BufferPtr data;
+    uint64_t reservedBytes{0};
+  };
+
+  void append(std::string_view data);
+
+  void finish();
+
+  uint64_t size() const;
+
+  // Writes the in-memory content to 'path_' and drops it. Returns the number
+  // of demoted bytes, 0 if the file is already on disk, or std::nullopt if the
+  // write fails. A file that fails to demote stays in memory.
+  std::optional<uint64_t> demote();
+
+  // Opens 'path_' on disk, writes the in-memory content to it and drops the
+  // content. Closes the disk file if 'this' is finished.
+  void writeToDiskLocked();
+
+  SpillMemoryTier* const tier_;
+  const std::string path_;
+  const filesystems::FileOptions fileOptions_;
+
+  mutable std::mutex mutex_;
+  // The in-memory file content. nullptr once the file is on disk.
+  std::shared_ptr<Content> content_;
+  // The disk file being written if the file did not fit in memory.
+  std::unique_ptr<WriteFile> diskFile_;
+  bool onDisk_{false};
+  bool finished_{false};
+  uint64_t size_{0};
+};
+
+/// A process wide, memory tracked store for spill files that sits in front of
+/// the spill disks. Spill writers with the tier enabled keep their serialized
+/// spill files in memory up to 'capacity' bytes in total. The pages are
+/// compressed with the spill codec, or lz4 if it is none, except for the pages
+/// that adaptive compression leaves uncompressed. When the capacity is
+/// exhausted, the least recently finished files are demoted to disk to make
+/// room, and a file that still does not fit is written to disk. A file that
+/// fails to demote stays in memory and is retried on a later demotion. Spill
+/// files still in memory are restored without going through the file system.
+/// The memory is allocated from a dedicated leaf pool so that it shows up in
+/// the memory manager's usage apart from the query pools.
+///
+/// If the tier has an executor, the demotions run on it and the file that
+/// needed the room continues on disk, so that a spilling driver does not
+/// wait for the disk writes of other files. Otherwise the demotions run on
+/// the thread that needs the room.
+class SpillMemoryTier {
+ public:
+  SpillMemoryTier(
+      uint64_t capacity,
+      std::shared_ptr<memory::MemoryPool> pool,
+      folly::Executor* executor = nullptr);
+
+  /// Waits for the demotions in progress.
+  ~SpillMemoryTier();
+
+  /// Creates the process wide spill memory tier with 'capacity' bytes, using a
+  /// leaf pool of the process wide memory manager. Demotes files on
+  /// 'executor', e.g. the spill executor of the process, if not null.
+  static void initialize(
+      uint64_t capacity,
+      folly::Executor* executor = nullptr);
+
+  /// Returns the process wide spill memory tier, or nullptr if it is not
+  /// initialized.
+  static SpillMemoryTier* getInstance();
+
+  static void testingReset();
+
+  /// Creates a new spill file at 'path' which is kept in memory as long as the
+  /// tier has capacity. 'fileOptions' are used to create 'path' on disk.
+  std::shared_ptr<SpillMemoryFile> createFile(
+      const std::string& path,
+      const filesystems::FileOptions& fileOptions = {});
+
+  uint64_t capacity() const {
+    return capacity_;
+  }
+
+  /// Returns the bytes reserved by the files in memory and the read files over
+  /// them.
+  uint64_t usedBytes() const;
+
+  memory::MemoryPool* pool() const {
+    return pool_.get();
+  }
+
+  struct Stats {
+    /// The number of files finished in memory.
+    uint64_t numMemoryFiles{0};
+    /// The number of files that did not fit in memory and were written to
+    /// disk.
+    uint64_t numDiskFiles{0};
+    /// The number and bytes of files demoted from memory to disk.
+    uint64_t numDemotedFiles{0};
+    uint64_t demotedBytes{0};
+    /// The number of files that failed to demote and stayed in memory.
+    uint64_t numDemotionErrors{0};
+
+    bool operator==(const Stats& other) const = default;
+
+    std::string toString() const;
+  };
+
+  Stats stats() const;
+
+ private:
+  friend class SpillMemoryFile;
+
+  struct FinishedFile {
+    std::weak_ptr<SpillMemoryFile> file;
+    // The bytes reserved for the file at finish.
+    uint64_t bytes;
+  };
+
+  // Reserves 'bytes' of capacity, demoting finished files to disk to make room
+  // if needed. Returns false if 'bytes' don't fit after demoting all of them,
+  // or if the demotions are scheduled on 'executor_'.
+  bool reserve(uint64_t bytes);
+
+  void release(uint64_t bytes);
+
+  // Demotes 'file' and records the outcome in 'stats_'. Returns false if the
+  // write to disk fails.
+  bool demote(SpillMemoryFile& file);
+
+  // Puts 'files' that failed to demote back in front of 'finishedFiles_', so
+  // that the next demotion retries them first.
+  void requeueFailedFiles(std::vector<FinishedFile> files);
+
+  // Adds a file finished in memory with 'bytes' reserved as a candidate for
+  // demotion.
+  void addFinishedFile(
+      const std::shared_ptr<SpillMemoryFile>& file,
+      uint64_t bytes);
+
+  void recordDiskFile();
+
+  void recordDemotionError();
+
+  const uint64_t capacity_;
+  const std::shared_ptr<memory::MemoryPool> pool_;
+  folly::Executor* const executor_;
+
+  mutable std::mutex mutex_;
+  uint64_t usedBytes_{0};
+  // The files finished in memory in finish order. Demotion starts from the
+  // front. Files destroyed after finish are skipped and pruned.
+  std::deque<FinishedFile> finishedFiles_;
+  // The bytes of the files being demoted on 'executor_'. Counted as free
+  // when choosing more files to demote.
+  uint64_t demotingBytes_{0};
+  int32_t numPendingDemotions_{0};
+  std::condition_variable demotionsDone_;
+  Stats stats_;
+};
+
+/// Returns the spill memory tier to write the spill files with 'config' to, or
+/// nullptr if the tier is not enabled or initialized.
+SpillMemoryTier* spillMemoryTier(const common::SpillConfig& config);
+
+} // namespace facebook::velox::exec
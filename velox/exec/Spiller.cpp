@@ -64,7 +64,10 @@ SpillerBase::SpillerBase(
           spillConfig->prefixSortConfig,
           memory::spillMemoryPool(),
           spillStats,
-          spillConfig->fileCreateConfig) {
+          spillConfig->fileCreateConfig,
+          spillConfig->diskSet,
+          spillMemoryTier(*spillConfig),
+          spillConfig->adaptiveCompressionEnabled) {
   TestValue::adjust("facebook::velox::exec::SpillerBase", this);
 }
 
@@ -23,6 +23,16 @@
 
 namespace facebook::velox::exec {
 
+/// Shared by the morsels that a split is divided into, so that the task counts
+/// the split once in its split stats. Accessed under the task lock.
+struct SplitMorsels {
+  explicit SplitMorsels(int32_t _numMorsels) : numMorsels(_numMorsels) {}
+
+  const int32_t numMorsels;
+  int32_t numStarted{0};
+  int32_t numFinished{0};
+};
+
 struct Split {
   std::shared_ptr<velox::connector::ConnectorSplit> connectorSplit{nullptr};
   int32_t groupId{-1}; // Bucketed group id (-1 means 'none').
@@ -30,6 +40,9 @@ struct Split {
   /// Indicates if this is a barrier split.
   std::optional<BarrierSplit> barrier;
 
+  /// Set if this is a morsel of a larger split.
+  std::shared_ptr<SplitMorsels> morsels;
+
   Split() = default;
 
   explicit Split(
@@ -198,6 +198,10 @@ RowVectorPtr TableScan::getOutput() {
 
     checkPreload();
     if (needNewSplit_) {
+      if (driverCtx_->driver->pushdownFilters()->at(0).rlock()->limitReached) {
+        stopForLimit();
+        return nullptr;
+      }
       const auto hasNewSplit = getSplit();
       if (!hasNewSplit) {
         VELOX_CHECK(needNewSplit_);
@@ -217,10 +221,24 @@ RowVectorPtr TableScan::getOutput() {
 
     uint64_t ioTimeUs{0};
     std::optional<RowVectorPtr> dataOptional;
+    bool limitReached{false};
     {
       MicrosecondWallTimer timer(&ioTimeUs);
       auto lk = driverCtx_->driver->pushdownFilters()->at(0).rlock();
-      dataOptional = dataSource_->next(readBatchSize, blockingFuture_);
+      limitReached = lk->limitReached;
+      if (!limitReached) {
+        dataOptional = dataSource_->next(readBatchSize, blockingFuture_);
+      }
+    }
+    if (limitReached) {
+      // The rest of the split is skipped. Its stats are recorded as at the
+      // end of a split.
+      recordSplitStats();
+      driverCtx_->task->splitFinished(
+          true, currentSplitWeight_, currentSplitMorsels_);
+      needNewSplit_ = true;
+      stopForLimit();
+      return nullptr;
     }
 
     {
@@ -277,29 +295,13 @@ RowVectorPtr TableScan::getOutput() {
       }
     }
 
-    uint64_t currNumRawInputRows{0};
-    {
-      auto lockedStats = stats_.wlock();
-      if (numPreloadedSplits_ > 0) {
-        lockedStats->addRuntimeStat(
-            std::string(TableScan::kPreloadedSplits),
-            RuntimeCounter(numPreloadedSplits_));
-        numPreloadedSplits_ = 0;
-      }
-      if (numReadyPreloadedSplits_ > 0) {
-        lockedStats->addRuntimeStat(
-            std::string(TableScan::kReadyPreloadedSplits),
-            RuntimeCounter(numReadyPreloadedSplits_));
-        numReadyPreloadedSplits_ = 0;
-      }
-      copyConnectorRuntimeStatsLocked(dataSource_.get(), *lockedStats);
-      currNumRawInputRows = lockedStats->rawInputPositions;
-    }
+    const auto currNumRawInputRows = recordSplitStats();
     VELOX_CHECK_LE(rawInputRowsSinceLastSplit_, currNumRawInputRows);
     const bool emptySplit = currNumRawInputRows == rawInputRowsSinceLastSplit_;
     rawInputRowsSinceLastSplit_ = currNumRawInputRows;
 
-    driverCtx_->task->splitFinished(true, currentSplitWeight_);
+    driverCtx_->task->splitFinished(
+        true, currentSplitWeight_, currentSplitMorsels_);
     needNewSplit_ = true;
 
     // We only update scaled controller when we have finished a non-empty split.
@@ -314,6 +316,39 @@ RowVectorPtr TableScan::getOutput() {
   }
 }
 
+uint64_t TableScan::recordSplitStats() {
+  auto lockedStats = stats_.wlock();
+  if (numPreloadedSplits_ > 0) {
+    lockedStats->addRuntimeStat(
+        std::string(TableScan::kPreloadedSplits),
+        RuntimeCounter(numPreloadedSplits_));
+    numPreloadedSplits_ = 0;
+  }
+  if (numReadyPreloadedSplits_ > 0) {
+    lockedStats->addRuntimeStat(
+        std::string(TableScan::kReadyPreloadedSplits),
+        RuntimeCounter(numReadyPreloadedSplits_));
+    numReadyPreloadedSplits_ = 0;
+  }
+  lockedStats->rawInputPositions = dataSource_->getCompletedRows();
+  lockedStats->rawInputBytes = dataSource_->getCompletedBytes();
+  copyConnectorRuntimeStatsLocked(dataSource_.get(), *lockedStats);
+  return lockedStats->rawInputPositions;
+}
+
+void TableScan::stopForLimit() {
+  VELOX_CHECK(needNewSplit_);
+  noMoreSplits_ = true;
+  stats_.wlock()->addRuntimeStat(
+      std::string(TableScan::kStoppedByLimit), RuntimeCounter(1));
+  // No more splits are read, so the data source and its memory are released.
+  // Its stats are recorded at the end of each split.
+  if (dataSource_ != nullptr) {
+    dataSource_->cancel();
+    dataSource_.reset();
+  }
+}
+
 bool TableScan::getSplit() {
   // A point for test code injection.
   TestValue::adjust("facebook::velox::exec::TableScan::getSplit", this);
@@ -350,6 +385,7 @@ bool TableScan::getSplit() {
       RuntimeCounter(static_cast<int64_t>(split.connectorSplit->size())));
   const auto& connectorSplit = split.connectorSplit;
   currentSplitWeight_ = connectorSplit->splitWeight;
+  currentSplitMorsels_ = split.morsels;
   splitBatchSizeHint_ = connectorSplit->batchSizeHint;
   needNewSplit_ = false;
 
@@ -92,6 +92,10 @@ class TableScan : public SourceOperator {
   static constexpr std::string_view kDataSourceAddSplitWallNanos =
       "dataSourceAddSplitWallNanos";
 
+  /// Set to 1 if the scan stopped before reading all its splits because a
+  /// Limit downstream had enough rows. See Driver::pushdownLimit().
+  static constexpr std::string_view kStoppedByLimit = "stoppedByLimit";
+
   std::shared_ptr<ScaledScanController> testingScaledController() const {
     return scaledController_;
   }
@@ -113,6 +117,16 @@ class TableScan : public SourceOperator {
   // Returns true if a new split is fetched from the task otherwise false.
   bool getSplit();
 
+  // Adds the raw input, preload and connector runtime stats of the current
+  // split to the operator stats. Called when the split ends or is cut short by
+  // a limit. Returns the number of raw input rows read so far.
+  uint64_t recordSplitStats();
+
+  // Stops fetching splits because a Limit downstream has produced enough
+  // rows and releases 'dataSource_'. The operator finishes on the next
+  // isFinished() check.
+  void stopForLimit();
+
   // Sets 'maxPreloadSplits' and 'splitPreloader' if prefetching splits is
   // appropriate. The preloader will be applied to the 'first 'maxPreloadSplits'
   // of the Task's split queue for 'this' when getting splits.
@@ -158,6 +172,8 @@ class TableScan : public SourceOperator {
   ContinueFuture blockingFuture_{ContinueFuture::makeEmpty()};
   BlockingReason blockingReason_{BlockingReason::kNotBlocked};
   int64_t currentSplitWeight_{0};
+  // Set if the current split is a morsel of a larger split.
+  std::shared_ptr<SplitMorsels> currentSplitMorsels_;
   bool needNewSplit_ = true;
   std::shared_ptr<connector::ConnectorQueryCtx> connectorQueryCtx_;
   std::unique_ptr<connector::DataSource> dataSource_;
@@ -436,6 +436,7 @@ Task::Task(
       firstNodeNotSupportingBarrier_(
           planFragment_.firstNodeNotSupportingBarrier()),
       traceCtx_(maybeMakeTraceCtx()),
+      profiler_(TaskProfiler::create(taskId_, queryCtx_->queryConfig())),
       consumerSupplier_(std::move(consumerSupplier)),
       onError_(std::move(onError)),
       splitsStates_(buildSplitStates(planFragment_.planNode)) {
@@ -596,6 +597,20 @@ void Task::setSpillDiskConfig(
   spillDirectory_ = std::move(spillDiskOpts->spillDirPath);
   spillDirectoryCreated_ = spillDiskOpts->spillDirCreated;
   spillDirectoryCallback_ = std::move(spillDiskOpts->spillDirCreateCb);
+  if (spillDiskOpts->stripeDirPaths.empty()) {
+    return;
+  }
+  VELOX_USER_CHECK_NULL(
+      spillDirectoryCallback_,
+      "Spill directory callback can't be used with spill stripe directories");
+  spillStripeDirectories_ = std::move(spillDiskOpts->stripeDirPaths);
+  std::vector<std::string> directories{spillDirectory_};
+  directories.insert(
+      directories.end(),
+      spillStripeDirectories_.begin(),
+      spillStripeDirectories_.end());
+  spillDiskSet_ =
+      std::make_unique<common::SpillDiskSet>(std::move(directories));
 }
 
 Task::TaskList& Task::taskList() {
@@ -693,6 +708,10 @@ const std::string& Task::getOrCreateSpillDirectory() {
 
     auto fileSystem = filesystems::getFileSystem(spillDirectory_, nullptr);
     fileSystem->mkdir(spillDirectory_);
+    for (const auto& stripeDirectory : spillStripeDirectories_) {
+      filesystems::getFileSystem(stripeDirectory, nullptr)
+          ->mkdir(stripeDirectory);
+    }
   } catch (const std::exception& e) {
     VELOX_FAIL(
         "Failed to create spill directory '{}' for Task {}: {}",
@@ -718,6 +737,16 @@ void Task::removeSpillDirectoryIfExists() {
       LOG(ERROR) << "Failed to remove spill directory '" << spillDirectory_
                  << "' for Task " << taskId() << ": " << e.what();
     }
+    for (const auto& stripeDirectory : spillStripeDirectories_) {
+      try {
+        filesystems::getFileSystem(stripeDirectory, nullptr)
+            ->rmdir(stripeDirectory);
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "Failed to remove spill stripe directory '"
+                   << stripeDirectory << "' for Task " << taskId() << ": "
+                   << e.what();
+      }
+    }
   }
   TestValue::adjust(
       "facebook::velox::exec::Task::removeSpillDirectoryIfExists", this);
@@ -1952,6 +1981,7 @@ void Task::setSplitsStore(
   splitsStore = std::move(newSplitsStore);
   splitsStore->setTaskStats(taskStats_);
   splitsStore->setPreloadingSplits(preloadingSplits_);
+  splitsStore->setMorselBytes(queryCtx_->queryConfig().tableScanMorselBytes());
 }
 
 SplitsStore* Task::getOrCreateSplitsStoreLocked(
@@ -2244,13 +2274,25 @@ void Task::addScaledScanControllerLocked(
           queryCtx_->queryConfig().tableScanScaleUpMemoryUsageRatio()));
 }
 
-void Task::splitFinished(bool fromTableScan, int64_t splitWeight) {
+void Task::splitFinished(
+    bool fromTableScan,
+    int64_t splitWeight,
+    const std::shared_ptr<SplitMorsels>& morsels) {
   std::lock_guard<std::timed_mutex> l(mutex_);
+  if (fromTableScan) {
+    taskStats_.runningTableScanSplitWeights -= splitWeight;
+  }
+  if (morsels != nullptr) {
+    ++taskStats_.numFinishedMorsels;
+    // A divided split finishes with its last morsel.
+    if (++morsels->numFinished < morsels->numMorsels) {
+      return;
+    }
+  }
   ++taskStats_.numFinishedSplits;
   --taskStats_.numRunningSplits;
   if (fromTableScan) {
     --taskStats_.numRunningTableScanSplits;
-    taskStats_.runningTableScanSplitWeights -= splitWeight;
   }
 }
 
@@ -2958,6 +3000,8 @@ TaskStats Task::taskStats() const {
   TaskStats taskStats = taskStats_;
 
   taskStats.numTotalDrivers = drivers_.size();
+  taskStats.numLocalNumaDriverRuns = numLocalNumaDriverRuns_;
+  taskStats.numOffNodeNumaDriverRuns = numOffNodeNumaDriverRuns_;
 
   // Add stats of the drivers (their operators) that are still running.
   for (const auto& driver : drivers_) {
@@ -3126,6 +3170,10 @@ Task::DriverCounts Task::driverCounts() const {
 }
 
 void Task::onTaskCompletion() {
+  if (profiler_ != nullptr) {
+    profiler_->finish();
+  }
+
   listeners().withRLock([&](auto& listeners) {
     if (listeners.empty()) {
       return;
@@ -3391,7 +3439,10 @@ void Task::createLocalExchangeQueuesLocked(
   for (auto i = 0; i < numPartitions; ++i) {
     exchange.queues.emplace_back(
         std::make_shared<LocalExchangeQueue>(
-            exchange.memoryManager, exchange.vectorPool, i));
+            exchange.memoryManager,
+            exchange.vectorPool,
+            i,
+            queryCtx_->queryConfig().localExchangeQueueShards()));
   }
 
   const auto partitionNode =
@@ -3565,14 +3616,19 @@ void Task::leave(
     ThreadState& state,
     const std::function<void(StopReason)>& driverCb) {
   std::vector<ContinuePromise> threadFinishPromises;
+  std::vector<ContinuePromise> reclaimPromises;
   auto guard = folly::makeGuard([&]() {
     for (auto& promise : threadFinishPromises) {
       promise.setValue();
     }
+    for (auto& promise : reclaimPromises) {
+      promise.setValue();
+    }
   });
   StopReason reason;
   {
     std::lock_guard<std::timed_mutex> l(mutex_);
+    reclaimPromises = removeCooperativeReclaimDriverLocked(state);
     if (!state.isTerminated) {
       reason = shouldStopLocked();
       if (reason == StopReason::kTerminate) {
@@ -3608,10 +3664,14 @@ StopReason Task::enterSuspended(ThreadState& state) {
   VELOX_CHECK(state.isOnThread());
 
   std::vector<ContinuePromise> threadFinishPromises;
+  std::vector<ContinuePromise> reclaimPromises;
   auto guard = folly::makeGuard([&]() {
     for (auto& promise : threadFinishPromises) {
       promise.setValue();
     }
+    for (auto& promise : reclaimPromises) {
+      promise.setValue();
+    }
   });
 
   std::lock_guard<std::timed_mutex> l(mutex_);
@@ -3635,6 +3695,9 @@ StopReason Task::enterSuspended(ThreadState& state) {
     // thread counter in the task.
     return StopReason::kNone;
   }
+  // A suspended driver may wait for a memory arbitration that waits for the
+  // cooperative reclaim, so the reclaim does not wait for it.
+  reclaimPromises = removeCooperativeReclaimDriverLocked(state);
   if (--numThreads_ == 0) {
     threadFinishPromises = allThreadsFinishedLocked();
   }
@@ -3756,6 +3819,130 @@ bool Task::pauseRequested(ContinueFuture* future) {
   return true;
 }
 
+ContinueFuture Task::requestCooperativeReclaim(uint64_t targetBytes) {
+  std::lock_guard<std::timed_mutex> l(mutex_);
+  VELOX_CHECK(
+      !cooperativeReclaim_.has_value(),
+      "Task {} already has a cooperative reclaim request",
+      taskId_);
+  auto& reclaim = cooperativeReclaim_.emplace();
+  reclaim.targetBytes = targetBytes;
+  for (const auto& driver : drivers_) {
+    // A suspended driver is in a memory arbitration of its own and does not
+    // get to an operator boundary before that ends.
+    if (driver != nullptr && driver->state().isOnThread() &&
+        !driver->state().suspended()) {
+      reclaim.pendingDrivers.insert(&driver->state());
+    }
+  }
+  if (!isRunningLocked() || reclaim.pendingDrivers.empty()) {
+    return folly::makeSemiFuture();
+  }
+  reclaim.id = ++numCooperativeReclaims_;
+  cooperativeReclaimId_ = reclaim.id;
+  reclaim.promises.emplace_back("Task::requestCooperativeReclaim");
+  return reclaim.promises.back().getSemiFuture();
+}
+
+memory::MemoryReclaimer::Stats Task::finishCooperativeReclaim() {
+  ContinueFuture reclaimingFuture = ContinueFuture::makeEmpty();
+  {
+    std::lock_guard<std::timed_mutex> l(mutex_);
+    VELOX_CHECK(cooperativeReclaim_.has_value());
+    // No driver starts to reclaim after this.
+    cooperativeReclaimId_ = 0;
+    if (!cooperativeReclaim_->reclaimingDrivers.empty()) {
+      cooperativeReclaim_->reclaimingPromises.emplace_back(
+          "Task::finishCooperativeReclaim");
+      reclaimingFuture =
+          cooperativeReclaim_->reclaimingPromises.back().getSemiFuture();
+    }
+  }
+  // The drivers that are reclaiming free memory the caller may count on.
+  if (reclaimingFuture.valid()) {
+    reclaimingFuture.wait();
+  }
+
+  std::vector<ContinuePromise> promises;
+  memory::MemoryReclaimer::Stats stats;
+  {
+    std::lock_guard<std::timed_mutex> l(mutex_);
+    stats = cooperativeReclaim_->stats;
+    promises = std::move(cooperativeReclaim_->promises);
+    cooperativeReclaim_.reset();
+  }
+  for (auto& promise : promises) {
+    promise.setValue();
+  }
+  return stats;
+}
+
+void Task::reclaimCooperatively(Driver& driver, uint64_t reclaimId) {
+  uint64_t targetBytes;
+  {
+    std::lock_guard<std::timed_mutex> l(mutex_);
+    if (cooperativeReclaimId_ != reclaimId ||
+        cooperativeReclaim_->stats.reclaimedBytes >=
+            cooperativeReclaim_->targetBytes) {
+      return;
+    }
+    targetBytes = cooperativeReclaim_->targetBytes -
+        cooperativeReclaim_->stats.reclaimedBytes;
+    cooperativeReclaim_->reclaimingDrivers.insert(&driver.state());
+  }
+
+  memory::MemoryReclaimer::Stats stats;
+  SCOPE_EXIT {
+    std::vector<ContinuePromise> promises;
+    {
+      std::lock_guard<std::timed_mutex> l(mutex_);
+      // The request may have ended while 'driver' was suspended.
+      if (cooperativeReclaim_.has_value() &&
+          cooperativeReclaim_->id == reclaimId) {
+        auto& reclaim = *cooperativeReclaim_;
+        reclaim.stats += stats;
+        reclaim.pendingDrivers.erase(&driver.state());
+        reclaim.reclaimingDrivers.erase(&driver.state());
+        promises = cooperativeReclaimPromisesLocked();
+      }
+    }
+    for (auto& promise : promises) {
+      promise.setValue();
+    }
+  };
+  driver.reclaimCooperatively(targetBytes, stats);
+}
+
+std::vector<ContinuePromise> Task::removeCooperativeReclaimDriverLocked(
+    const ThreadState& state) {
+  if (!cooperativeReclaim_.has_value()) {
+    return {};
+  }
+  auto& reclaim = *cooperativeReclaim_;
+  if (reclaim.pendingDrivers.erase(&state) == 0 &&
+      reclaim.reclaimingDrivers.erase(&state) == 0) {
+    return {};
+  }
+  return cooperativeReclaimPromisesLocked();
+}
+
+std::vector<ContinuePromise> Task::cooperativeReclaimPromisesLocked() {
+  auto& reclaim = *cooperativeReclaim_;
+  std::vector<ContinuePromise> promises;
+  if (reclaim.reclaimingDrivers.empty()) {
+    promises = std::move(reclaim.reclaimingPromises);
+    reclaim.reclaimingPromises.clear();
+  }
+  if (reclaim.stats.reclaimedBytes >= reclaim.targetBytes ||
+      reclaim.pendingDrivers.empty()) {
+    for (auto& promise : reclaim.promises) {
+      promises.push_back(std::move(promise));
+    }
+    reclaim.promises.clear();
+  }
+  return promises;
+}
+
 void Task::createExchangeClientLocked(
     int32_t pipelineId,
     const core::PlanNodeId& planNodeId,
@@ -3866,6 +4053,24 @@ uint64_t Task::MemoryReclaimer::reclaimTask(
     uint64_t targetBytes,
     uint64_t maxWaitMs,
     memory::MemoryReclaimer::Stats& stats) {
+  // Lets the running drivers spill what they can without stopping the task,
+  // and pauses the task only for the remainder. A zero target reclaims all
+  // memory, which needs the task paused anyway.
+  uint64_t cooperativeReclaimedBytes{0};
+  const auto cooperativeWaitMs =
+      task->queryCtx()->queryConfig().cooperativeMemoryReclaimWaitMs();
+  if (cooperativeWaitMs > 0 && targetBytes > 0) {
+    task->requestCooperativeReclaim(targetBytes)
+        .wait(std::chrono::milliseconds(cooperativeWaitMs));
+    const auto cooperativeStats = task->finishCooperativeReclaim();
+    stats += cooperativeStats;
+    cooperativeReclaimedBytes = cooperativeStats.reclaimedBytes;
+    if (cooperativeReclaimedBytes >= targetBytes) {
+      return cooperativeReclaimedBytes;
+    }
+    targetBytes -= cooperativeReclaimedBytes;
+  }
+
   auto resumeGuard = folly::makeGuard([&]() {
     try {
       Task::resume(task);
@@ -3902,7 +4107,7 @@ uint64_t Task::MemoryReclaimer::reclaimTask(
 
   // Don't reclaim from a cancelled task as it will terminate soon.
   if (task->isCancelled()) {
-    return 0;
+    return cooperativeReclaimedBytes;
   }
 
   uint64_t reclaimedBytes{0};
@@ -3922,7 +4127,7 @@ uint64_t Task::MemoryReclaimer::reclaimTask(
     task->setError(std::current_exception());
     std::rethrow_exception(std::current_exception());
   }
-  return reclaimedBytes;
+  return cooperativeReclaimedBytes + reclaimedBytes;
 }
 
 void Task::MemoryReclaimer::abort(
@@ -26,6 +26,7 @@
 #include "velox/exec/MergeSource.h"
 #include "velox/exec/PartitionedOutputFactory.h"
 #include "velox/exec/ScaledScanController.h"
+#include "velox/exec/TaskProfiler.h"
 #include "velox/exec/TaskStats.h"
 #include "velox/exec/TaskStructs.h"
 #include "velox/exec/trace/TraceCtx.h"
@@ -147,6 +148,17 @@ class Task : public std::enable_shared_from_this<Task> {
     return uniqueRowIdPool_;
   }
 
+  /// Counts a driver run that a NUMA aware scheduler started on a CPU of the
+  /// node the driver is assigned to if 'local' is true, and on another CPU
+  /// otherwise.
+  void addNumaDriverRun(bool local) {
+    if (local) {
+      ++numLocalNumaDriverRuns_;
+    } else {
+      ++numOffNodeNumaDriverRuns_;
+    }
+  }
+
   /// Configured cpu slice time limit for drivers. 0 (meaning slicing/yield
   /// disabled) when task is under serial mode.
   uint64_t driverCpuTimeSliceLimitMs() const;
@@ -167,6 +179,12 @@ class Task : public std::enable_shared_from_this<Task> {
     return traceCtx_.get();
   }
 
+  /// Returns the profiler of the task, nullptr if the 'task_profile_dir' query
+  /// config is not set.
+  TaskProfiler* profiler() const {
+    return profiler_.get();
+  }
+
   /// Returns the output buffer manager for the transport named on this task's
   /// PartitionedOutputNode, or an empty weak_ptr if there is no partitioned
   /// output. Lock() and null-check before use.
@@ -500,7 +518,12 @@ class Task : public std::enable_shared_from_this<Task> {
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId);
 
-  void splitFinished(bool fromTableScan, int64_t splitWeight);
+  /// Called when a split finishes. 'morsels' is set if the split is a morsel
+  /// of a larger split, which is counted as finished with its last morsel.
+  void splitFinished(
+      bool fromTableScan,
+      int64_t splitWeight,
+      const std::shared_ptr<SplitMorsels>& morsels = nullptr);
 
   void multipleSplitsFinished(
       bool fromTableScan,
@@ -785,6 +808,30 @@ class Task : public std::enable_shared_from_this<Task> {
   /// task is resumed.
   bool pauseRequested(ContinueFuture* future = nullptr);
 
+  /// Asks the drivers of the task to reclaim 'targetBytes' in total from
+  /// their operators that support cooperative reclaim, each on its own thread
+  /// at its next operator boundary, while the task keeps running. The returned
+  /// future is realized when the drivers have reclaimed 'targetBytes' or each
+  /// driver that was running at the time of the request has had its turn,
+  /// gone off thread or been suspended. finishCooperativeReclaim() ends the
+  /// request.
+  ContinueFuture requestCooperativeReclaim(uint64_t targetBytes);
+
+  /// Ends the request of requestCooperativeReclaim() and returns the stats of
+  /// the reclaims of the drivers. Waits for the drivers that are reclaiming
+  /// and not suspended, so that the stats include their reclaimed bytes.
+  memory::MemoryReclaimer::Stats finishCooperativeReclaim();
+
+  /// Returns a non-zero number that identifies the pending request of
+  /// requestCooperativeReclaim(), or 0 if there is none.
+  uint64_t cooperativeReclaimId() const {
+    return cooperativeReclaimId_;
+  }
+
+  /// Invoked by 'driver' at an operator boundary to take part in the request
+  /// of requestCooperativeReclaim() with 'reclaimId'.
+  void reclaimCooperatively(Driver& driver, uint64_t reclaimId);
+
   std::timed_mutex& mutex() {
     return mutex_;
   }
@@ -802,6 +849,13 @@ class Task : public std::enable_shared_from_this<Task> {
     return spillDirectoryCallback_ != nullptr;
   }
 
+  /// Returns the disk set to stripe spill files across if the task has spill
+  /// stripe directories, otherwise nullptr. The directories are created by
+  /// getOrCreateSpillDirectory().
+  common::SpillDiskSet* spillDiskSet() const {
+    return spillDiskSet_.get();
+  }
+
   /// Returns the spill directory path. Ensures that the spill directory is
   /// created before returning. Is thread safe. Returns an empty string if
   /// either the spill directory is not specified during task creation or the
@@ -1122,6 +1176,16 @@ class Task : public std::enable_shared_from_this<Task> {
   // 'threadFinishPromises_' to fulfill.
   std::vector<ContinuePromise> allThreadsFinishedLocked();
 
+  // Invoked when the driver with 'state' goes off thread or is suspended.
+  // Removes the driver from the pending request of requestCooperativeReclaim()
+  // and returns the promises to fulfill.
+  std::vector<ContinuePromise> removeCooperativeReclaimDriverLocked(
+      const ThreadState& state);
+
+  // Returns the promises of the pending request of requestCooperativeReclaim()
+  // to fulfill after a driver is done with it.
+  std::vector<ContinuePromise> cooperativeReclaimPromisesLocked();
+
   StopReason shouldStopLocked();
 
   // Sets this to a terminal requested state and frees all resources
@@ -1247,6 +1311,8 @@ class Task : public std::enable_shared_from_this<Task> {
 
   const std::unique_ptr<trace::TraceCtx> traceCtx_;
 
+  const std::unique_ptr<TaskProfiler> profiler_;
+
   inline static std::atomic_uint64_t numCreatedTasks_;
 
   // Hook in the system wide task list.
@@ -1503,6 +1569,27 @@ class Task : public std::enable_shared_from_this<Task> {
   std::atomic_bool pauseRequested_{false};
   std::atomic_bool terminateRequested_{false};
 
+  // The state of a request of requestCooperativeReclaim().
+  struct CooperativeReclaim {
+    uint64_t id{0};
+    uint64_t targetBytes{0};
+    // The drivers that were running at the time of the request and have not
+    // taken part in it, gone off thread or been suspended yet.
+    folly::F14FastSet<const ThreadState*> pendingDrivers;
+    // The drivers that are reclaiming and not suspended.
+    folly::F14FastSet<const ThreadState*> reclaimingDrivers;
+    memory::MemoryReclaimer::Stats stats;
+    std::vector<ContinuePromise> promises;
+    // Fulfilled when 'reclaimingDrivers' becomes empty.
+    std::vector<ContinuePromise> reclaimingPromises;
+  };
+
+  // Identifies the pending request of requestCooperativeReclaim(), 0 if there
+  // is none. Read without 'mutex_' at each operator boundary.
+  std::atomic_uint64_t cooperativeReclaimId_{0};
+  uint64_t numCooperativeReclaims_{0};
+  std::optional<CooperativeReclaim> cooperativeReclaim_;
+
   // If true, indicate this task is under barrier processing.
   std::atomic_bool barrierRequested_{false};
   // The start time of the current processing barrier.
@@ -1514,6 +1601,9 @@ class Task : public std::enable_shared_from_this<Task> {
 
   std::atomic_int32_t toYield_ = 0;
   int32_t numThreads_ = 0;
+  // Counted by addNumaDriverRun() outside of 'mutex_'.
+  std::atomic_uint64_t numLocalNumaDriverRuns_{0};
+  std::atomic_uint64_t numOffNodeNumaDriverRuns_{0};
   // Microsecond real time when 'this' last went from no threads to
   // one thread running. Used to decide if continuous run should be
   // interrupted by yieldIfDue().
@@ -1531,6 +1621,12 @@ class Task : public std::enable_shared_from_this<Task> {
   // create the spill directory for this task. This callback returns
   // a path that will be into spillDirectory_
   std::function<std::string()> spillDirectoryCallback_;
+  // Additional spill directories on other disks, created and removed together
+  // with 'spillDirectory_'.
+  std::vector<std::string> spillStripeDirectories_;
+  // Stripes spill files across 'spillDirectory_' and
+  // 'spillStripeDirectories_'. Set if the latter is not empty.
+  std::unique_ptr<common::SpillDiskSet> spillDiskSet_;
 
   // Serializes spill directory creation and removal.
   mutable std::mutex spillDirCreateMutex_;
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/TaskAdmissionController.h"
+
+#include <algorithm>
+#include <chrono>
+#include <optional>
+
+#include <fmt/format.h>
+#include <folly/executors/ThreadPoolExecutor.h>
+#include <glog/logging.h>
+
+#include "velox/common/base/Counters.h"
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/base/StatsReporter.h"
+#include "velox/common/base/SuccinctPrinter.h"
+#include "velox/common/caching/SsdCache.h"
+#include "velox/common/memory/MemoryArbitrator.h"
+#include "velox/common/time/Timer.h"
+
+namespace facebook::velox::exec {
+namespace {
+// Returns the retriable error of a rejected task with 'message'.
+folly::exception_wrapper rejectedError(const std::string& message) {
+  RECORD_METRIC_VALUE(kMetricTaskAdmissionRejectedCount);
+  try {
+    VELOX_TASK_ADMISSION_REJECTED("{}", message);
+  } catch (const VeloxRuntimeError&) {
+    return folly::exception_wrapper(std::current_exception());
+  }
+  VELOX_UNREACHABLE();
+}
+} // namespace
+
+TaskAdmissionController::TaskAdmissionController(
+    Config config,
+    std::vector<LoadSource> sources)
+    : config_(config), sources_(std::move(sources)) {
+  VELOX_CHECK_GT(config_.maxLoad, 0);
+  VELOX_CHECK_GT(config_.checkIntervalMs, 0);
+  runner_.add("TaskAdmissionController", [this]() noexcept {
+    try {
+      checkQueue();
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Failed to check the task admission queue: " << e.what();
+    }
+    return std::chrono::milliseconds(config_.checkIntervalMs);
+  });
+}
+
+TaskAdmissionController::~TaskAdmissionController() {
+  runner_.stop();
+  std::deque<Waiter> queue;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    queue.swap(queue_);
+  }
+  for (auto& waiter : queue) {
+    waiter.promise.setException(rejectedError(fmt::format(
+        "Task {} rejected: the admission controller is destroyed",
+        waiter.taskId)));
+  }
+}
+
+ContinueFuture TaskAdmissionController::admit(const std::string& taskId) {
+  // The sources may take their own locks, so the load is sampled outside of
+  // 'mutex_'.
+  const auto currentLoad = load();
+  std::deque<Waiter> admitted;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    if (currentLoad >= config_.maxLoad) {
+      if (queue_.size() >= config_.maxQueuedTasks) {
+        return folly::makeSemiFuture<folly::Unit>(rejectedError(fmt::format(
+            "Task {} rejected: {} tasks are waiting for admission",
+            taskId,
+            queue_.size())));
+      }
+      queue_.push_back(
+          {taskId,
+           getCurrentTimeMs(),
+           ContinuePromise("TaskAdmissionController::admit")});
+      return queue_.back().promise.getSemiFuture();
+    }
+    // The tasks that wait since the last check go first.
+    admitted.swap(queue_);
+  }
+  for (auto& waiter : admitted) {
+    admitWaiter(waiter);
+  }
+  return folly::makeSemiFuture();
+}
+
+void TaskAdmissionController::checkQueue() {
+  // Admits the waiting tasks in arrival order while the load stays below
+  // 'maxLoad'.
+  double currentLoad{0};
+  for (;;) {
+    if (numQueued() == 0) {
+      return;
+    }
+    currentLoad = load();
+    if (currentLoad >= config_.maxLoad) {
+      break;
+    }
+    std::optional<Waiter> waiter;
+    {
+      std::lock_guard<std::mutex> l(mutex_);
+      if (queue_.empty()) {
+        return;
+      }
+      waiter.emplace(std::move(queue_.front()));
+      queue_.pop_front();
+    }
+    admitWaiter(*waiter);
+  }
+
+  std::vector<std::pair<ContinuePromise, folly::exception_wrapper>> rejected;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    const auto nowMs = getCurrentTimeMs();
+    // The tasks are in arrival order, so the ones that waited too long are
+    // first.
+    while (!queue_.empty() &&
+           nowMs - queue_.front().startTimeMs >= config_.maxQueueTimeMs) {
+      auto& waiter = queue_.front();
+      rejected.emplace_back(
+          std::move(waiter.promise),
+          rejectedError(fmt::format(
+              "Task {} rejected after waiting {} for admission at load {:.2f}",
+              waiter.taskId,
+              succinctMillis(nowMs - waiter.startTimeMs),
+              currentLoad)));
+      queue_.pop_front();
+    }
+  }
+  for (auto& [promise, error] : rejected) {
+    promise.setException(std::move(error));
+  }
+}
+
+// static
+void TaskAdmissionController::admitWaiter(Waiter& waiter) {
+  RECORD_HISTOGRAM_METRIC_VALUE(
+      kMetricTaskAdmissionQueuedTimeMs,
+      getCurrentTimeMs() - waiter.startTimeMs);
+  waiter.promise.setValue();
+}
+
+double TaskAdmissionController::load() {
+  double maxLoad = 0;
+  for (const auto& source : sources_) {
+    maxLoad = std::max(maxLoad, source());
+  }
+  RECORD_METRIC_VALUE(kMetricTaskAdmissionLoadPct, maxLoad * 100);
+  return maxLoad;
+}
+
+int32_t TaskAdmissionController::numQueued() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return queue_.size();
+}
+
+// static
+TaskAdmissionController::LoadSource TaskAdmissionController::levelLoad(
+    std::function<uint64_t()> value,
+    uint64_t limit) {
+  VELOX_CHECK_GT(limit, 0);
+  return [value = std::move(value), limit]() {
+    return static_cast<double>(value()) / limit;
+  };
+}
+
+// static
+TaskAdmissionController::LoadSource TaskAdmissionController::rateLoad(
+    std::function<uint64_t()> counter,
+    uint64_t maxPerSecond,
+    uint64_t minIntervalMs) {
+  VELOX_CHECK_GT(maxPerSecond, 0);
+  struct Rate {
+    std::mutex mutex;
+    uint64_t lastValue;
+    uint64_t lastTimeMs;
+    double load{0};
+  };
+  auto rate = std::make_shared<Rate>();
+  rate->lastValue = counter();
+  rate->lastTimeMs = getCurrentTimeMs();
+  return [counter = std::move(counter), maxPerSecond, minIntervalMs, rate]() {
+    std::lock_guard<std::mutex> l(rate->mutex);
+    const auto nowMs = getCurrentTimeMs();
+    const auto elapsedMs = nowMs - rate->lastTimeMs;
+    if (elapsedMs > 0 && elapsedMs >= minIntervalMs) {
+      const auto value = counter();
+      // The counter may be reset, e.g. when stats are cleared.
+      const auto delta = value > rate->lastValue ? value - rate->lastValue : 0;
+      rate->load = delta * 1'000.0 / elapsedMs / maxPerSecond;
+      rate->lastValue = value;
+      rate->lastTimeMs = nowMs;
+    }
+    return rate->load;
+  };
+}
+
+// static
+TaskAdmissionController::LoadSource
+TaskAdmissionController::arbitratorReclaimLoad(
+    memory::MemoryArbitrator* arbitrator,
+    uint64_t maxReclaimedBytesPerSecond) {
+  VELOX_CHECK_NOT_NULL(arbitrator);
+  return rateLoad(
+      [arbitrator]() { return arbitrator->stats().reclaimedUsedBytes; },
+      maxReclaimedBytesPerSecond);
+}
+
+// static
+TaskAdmissionController::LoadSource TaskAdmissionController::executorQueueLoad(
+    folly::ThreadPoolExecutor* executor,
+    uint64_t maxPendingTasks) {
+  VELOX_CHECK_NOT_NULL(executor);
+  return levelLoad(
+      [executor]() { return executor->getPendingTaskCount(); },
+      maxPendingTasks);
+}
+
+// static
+TaskAdmissionController::LoadSource
+TaskAdmissionController::ssdCacheEvictionLoad(
+    cache::SsdCache* ssdCache,
+    uint64_t maxEvictedRegionsPerSecond) {
+  VELOX_CHECK_NOT_NULL(ssdCache);
+  return rateLoad(
+      [ssdCache]() -> uint64_t { return ssdCache->stats().regionsEvicted; },
+      maxEvictedRegionsPerSecond);
+}
+} // namespace facebook::velox::exec
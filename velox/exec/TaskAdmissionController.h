@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <folly/executors/ThreadedRepeatingFunctionRunner.h>
+
+#include "velox/common/future/VeloxPromise.h"
+
+namespace folly {
+class ThreadPoolExecutor;
+} // namespace folly
+
+namespace facebook::velox::cache {
+class SsdCache;
+} // namespace facebook::velox::cache
+
+namespace facebook::velox::memory {
+class MemoryArbitrator;
+} // namespace facebook::velox::memory
+
+namespace facebook::velox::exec {
+
+/// Worker level admission control of new tasks by the load of the worker. The
+/// load is the maximum of the loads of a set of sources, e.g. the rate at
+/// which the memory arbitrator reclaims memory, the depth of the driver
+/// executor queue and the rate of SSD cache evictions, each of which is 1 when
+/// the source is at its limit. The code that creates the tasks of the worker
+/// calls admit() and creates a task once the returned future is fulfilled.
+/// The future is fulfilled right away if the load is below 'maxLoad', after
+/// those of the tasks that are waiting. Otherwise the task waits in FIFO
+/// order, and a background thread checks the load every 'checkIntervalMs' and
+/// lets the waiting tasks through while it is below 'maxLoad'. The load is
+/// sampled without holding the lock of the waiting tasks, since the sources
+/// may be slow or take their own locks. The future of a task that waits longer
+/// than 'maxQueueTimeMs', or that finds 'maxQueuedTasks' tasks waiting, fails
+/// with a retriable TASK_ADMISSION_REJECTED error so that the scheduler can
+/// place the task elsewhere. No thread of the caller waits for admission.
+///
+/// The load is reported in the velox.task_admission_load_pct metric, the wait
+/// times in velox.task_admission_queued_time_ms and the rejections in
+/// velox.task_admission_rejected_count.
+class TaskAdmissionController {
+ public:
+  /// Returns the load of a source relative to its limit.
+  using LoadSource = std::function<double()>;
+
+  struct Config {
+    /// The load from which new tasks wait.
+    double maxLoad{1};
+
+    /// The max time a new task waits before it is rejected.
+    uint64_t maxQueueTimeMs{30'000};
+
+    /// The max number of waiting tasks. More new tasks are rejected.
+    uint32_t maxQueuedTasks{1'000};
+
+    /// The interval at which waiting tasks check the load.
+    uint64_t checkIntervalMs{100};
+  };
+
+  TaskAdmissionController(Config config, std::vector<LoadSource> sources);
+
+  /// Rejects the waiting tasks.
+  ~TaskAdmissionController();
+
+  /// Returns a future that is fulfilled when the task with 'taskId' may be
+  /// created, or fails with a retriable TASK_ADMISSION_REJECTED error if the
+  /// task is rejected. Does not wait.
+  ContinueFuture admit(const std::string& taskId);
+
+  /// Returns the current load and records it in the load metric.
+  double load();
+
+  /// Returns the number of waiting tasks.
+  int32_t numQueued() const;
+
+  /// Returns a source whose load is 'value()' relative to 'limit'.
+  static LoadSource levelLoad(std::function<uint64_t()> value, uint64_t limit);
+
+  /// Returns a source whose load is the rate of increase per second of the
+  /// cumulative 'counter()' relative to 'maxPerSecond'. The rate is measured
+  /// over intervals of at least 'minIntervalMs'.
+  static LoadSource rateLoad(
+      std::function<uint64_t()> counter,
+      uint64_t maxPerSecond,
+      uint64_t minIntervalMs = 1'000);
+
+  /// Returns a source whose load is the bytes per second that 'arbitrator'
+  /// reclaims from running queries relative to 'maxReclaimedBytesPerSecond'.
+  static LoadSource arbitratorReclaimLoad(
+      memory::MemoryArbitrator* arbitrator,
+      uint64_t maxReclaimedBytesPerSecond);
+
+  /// Returns a source whose load is the number of queued tasks of 'executor'
+  /// relative to 'maxPendingTasks'.
+  static LoadSource executorQueueLoad(
+      folly::ThreadPoolExecutor* executor,
+      uint64_t maxPendingTasks);
+
+  /// Returns a source whose load is the regions per second that 'ssdCache'
+  /// evicts to make space for new entries relative to
+  /// 'maxEvictedRegionsPerSecond'.
+  static LoadSource ssdCacheEvictionLoad(
+      cache::SsdCache* ssdCache,
+      uint64_t maxEvictedRegionsPerSecond);
+
+ private:
+  struct Waiter {
+    std::string taskId;
+    uint64_t startTimeMs;
+    ContinuePromise promise;
+  };
+
+  // Admits the waiting tasks while the load is below 'maxLoad'. Rejects the
+  // tasks that waited too long otherwise. Runs every 'checkIntervalMs' on
+  // 'runner_'.
+  void checkQueue();
+
+  // Fulfills the promise of 'waiter' and records its wait time.
+  static void admitWaiter(Waiter& waiter);
+
+  const Config config_;
+  const std::vector<LoadSource> sources_;
+
+  mutable std::mutex mutex_;
+  // The waiting tasks in arrival order.
+  std::deque<Waiter> queue_;
+
+  folly::ThreadedRepeatingFunctionRunner runner_;
+};
+} // namespace facebook::velox::exec
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/TaskProfiler.h"
+
+#include <algorithm>
+
+#include <fmt/format.h>
+#include <glog/logging.h>
+
+#include "velox/common/file/File.h"
+#include "velox/common/file/FileSystems.h"
+#include "velox/exec/Operator.h"
+
+namespace facebook::velox::exec {
+namespace {
+// Task ids may be URIs, so the characters that separate path components are
+// replaced in file names.
+std::string fileNamePrefix(const std::string& taskId) {
+  std::string prefix = taskId;
+  std::replace(prefix.begin(), prefix.end(), '/', '_');
+  std::replace(prefix.begin(), prefix.end(), ':', '_');
+  return prefix;
+}
+} // namespace
+
+// static
+std::unique_ptr<TaskProfiler> TaskProfiler::create(
+    const std::string& taskId,
+    const core::QueryConfig& config) {
+  auto dir = config.taskProfileDir();
+  if (dir.empty()) {
+    return nullptr;
+  }
+  return std::make_unique<TaskProfiler>(
+      taskId, std::move(dir), config.taskProfileSamplingIntervalUs());
+}
+
+TaskProfiler::TaskProfiler(
+    std::string taskId,
+    std::string dir,
+    uint64_t samplingIntervalUs)
+    : taskId_(std::move(taskId)), dir_(std::move(dir)) {
+  cpuSampled_ = cpu_.start(samplingIntervalUs);
+  if (!cpuSampled_) {
+    LOG_FIRST_N(WARNING, 1)
+        << "Task CPU profiles are not sampled: the velox_stack_sampler_enabled "
+        << "flag is not set or another SIGPROF handler is installed";
+  }
+}
+
+void TaskProfiler::addOperatorMemory(int32_t pipelineId, const Operator& op) {
+  const int32_t labelIds[] = {
+      memory_.labelId(pipelineLabel(pipelineId)),
+      memory_.labelId(operatorLabel(op))};
+  memory_.record(labelIds, 2, op.pool()->peakBytes());
+}
+
+void TaskProfiler::finish() {
+  if (finished_.exchange(true)) {
+    return;
+  }
+  cpu_.stop();
+  if (cpu_.numDropped() > 0) {
+    LOG(WARNING) << "Task " << taskId_ << " profile dropped "
+                 << cpu_.numDropped() << " CPU samples";
+  }
+  try {
+    auto fs = filesystems::getFileSystem(dir_, nullptr);
+    fs->mkdir(dir_);
+    const auto write = [&](const std::string& fileName,
+                           const std::string& content) {
+      auto file = fs->openFileForWrite(fmt::format("{}/{}", dir_, fileName));
+      file->append(content);
+      file->close();
+    };
+    if (cpuSampled_) {
+      write(cpuProfileFileName(taskId_), cpu_.folded());
+    }
+    write(memoryProfileFileName(taskId_), memory_.folded());
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Failed to write the profile of task " << taskId_ << " to "
+               << dir_ << ": " << e.what();
+  }
+}
+
+// static
+std::string TaskProfiler::cpuProfileFileName(const std::string& taskId) {
+  return fmt::format("{}.cpu.folded", fileNamePrefix(taskId));
+}
+
+// static
+std::string TaskProfiler::memoryProfileFileName(const std::string& taskId) {
+  return fmt::format("{}.memory.folded", fileNamePrefix(taskId));
+}
+
+// static
+std::string TaskProfiler::pipelineLabel(int32_t pipelineId) {
+  return fmt::format("Pipeline[{}]", pipelineId);
+}
+
+// static
+std::string TaskProfiler::operatorLabel(const Operator& op) {
+  return fmt::format("{}[{}]", op.operatorType(), op.planNodeId());
+}
+} // namespace facebook::velox::exec
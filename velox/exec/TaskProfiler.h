@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "velox/common/process/StackSampler.h"
+#include "velox/core/QueryConfig.h"
+
+namespace facebook::velox::exec {
+
+class Operator;
+
+/// CPU and memory profile of a task, enabled by the 'task_profile_dir' query
+/// config. The drivers of the task enter a frame of the CPU sampler for their
+/// pipeline and for each operator call, and expression evaluation enters a
+/// frame for each expression, so that the CPU samples attribute the time to
+/// the pipeline, operator and expression tree it was spent in. The memory
+/// profile has the peak memory of the memory pool of each operator. When the
+/// task completes, the profiles are written to '<task id>.cpu.folded' and
+/// '<task id>.memory.folded' in the folded stacks format that flame graph
+/// tools read. The CPU profile is only written if the process enables
+/// sampling with the 'velox_stack_sampler_enabled' flag, see StackSampler.
+class TaskProfiler {
+ public:
+  /// Returns a started profiler for the task with 'taskId' if 'config' enables
+  /// profiling, nullptr otherwise.
+  static std::unique_ptr<TaskProfiler> create(
+      const std::string& taskId,
+      const core::QueryConfig& config);
+
+  TaskProfiler(
+      std::string taskId,
+      std::string dir,
+      uint64_t samplingIntervalUs);
+
+  /// The sampler of the frames that the drivers of the task enter, nullptr if
+  /// the CPU profile is not sampled.
+  process::StackSampler* cpuSampler() {
+    return cpuSampled_ ? &cpu_ : nullptr;
+  }
+
+  /// Adds the peak memory of 'op' of pipeline 'pipelineId' to the memory
+  /// profile. Called when the driver of 'op' closes its operators.
+  void addOperatorMemory(int32_t pipelineId, const Operator& op);
+
+  /// Stops sampling and writes the profiles. Only the first call has an
+  /// effect. Called when the task completes.
+  void finish();
+
+  /// Returns the file names of the profiles of the task with 'taskId'.
+  static std::string cpuProfileFileName(const std::string& taskId);
+  static std::string memoryProfileFileName(const std::string& taskId);
+
+  /// Returns the frame labels of a pipeline and an operator.
+  static std::string pipelineLabel(int32_t pipelineId);
+  static std::string operatorLabel(const Operator& op);
+
+ private:
+  const std::string taskId_;
+  const std::string dir_;
+
+  process::StackSampler cpu_;
+  process::StackSampler memory_;
+  bool cpuSampled_{false};
+  std::atomic_bool finished_{false};
+};
+} // namespace facebook::velox::exec
@@ -67,6 +67,12 @@ struct TaskStats {
   int64_t runningTableScanSplitWeights{0};
   int64_t queuedTableScanSplitWeights{0};
 
+  /// The number of morsels that table scan splits are divided into and the
+  /// number of them that finished. A divided split is counted once in the
+  /// split stats above. See 'table_scan_morsel_bytes'.
+  int32_t numTotalMorsels{0};
+  int32_t numFinishedMorsels{0};
+
   /// The subscript is given by each Operator's
   /// DriverCtx::pipelineId. This is a sum total reflecting fully
   /// processed Splits for Drivers of this pipeline.
@@ -123,6 +129,15 @@ struct TaskStats {
   /// The longest still running operator call's duration in ms.
   size_t longestRunningOpCallMs{0};
 
+  /// The number of driver runs that an exec::NumaDriverScheduler started on a
+  /// CPU of the NUMA node the driver is assigned to, and on a CPU of another
+  /// node. The threads of a node only run on other nodes if binding them to
+  /// the CPUs of their node failed, so a nonzero off node count means that the
+  /// binding failed. These count where the drivers ran, not where their
+  /// memory is.
+  uint64_t numLocalNumaDriverRuns{0};
+  uint64_t numOffNodeNumaDriverRuns{0};
+
   /// The total memory reclamation count.
   uint32_t memoryReclaimCount{0};
   /// The total memory reclamation time.
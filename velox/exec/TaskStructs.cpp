@@ -52,6 +52,9 @@ ContinueFuture SplitsStore::makeFuture() {
 Split SplitsStore::getSplit(
     int maxPreloadSplits,
     const ConnectorSplitPreloadFunc& preload) {
+  if (morselBytes_ > 0) {
+    divideIntoMorsels(std::max(maxPreloadSplits, 1));
+  }
   int readySplitIndex = -1;
   if (maxPreloadSplits > 0) {
     for (int i = 0, end = std::min<size_t>(maxPreloadSplits, splits_.size());
@@ -79,11 +82,18 @@ Split SplitsStore::getSplit(
   VELOX_CHECK(!splits_.empty());
   auto split = std::move(splits_[readySplitIndex]);
   splits_.erase(splits_.begin() + readySplitIndex);
-  --taskStats_->numQueuedSplits;
-  ++taskStats_->numRunningSplits;
+  // A divided split starts running with its first morsel.
+  const bool splitStarted =
+      split.morsels == nullptr || split.morsels->numStarted++ == 0;
+  if (splitStarted) {
+    --taskStats_->numQueuedSplits;
+    ++taskStats_->numRunningSplits;
+  }
   if (!remoteSplit_ && split.connectorSplit) {
-    --taskStats_->numQueuedTableScanSplits;
-    ++taskStats_->numRunningTableScanSplits;
+    if (splitStarted) {
+      --taskStats_->numQueuedTableScanSplits;
+      ++taskStats_->numRunningTableScanSplits;
+    }
     taskStats_->queuedTableScanSplitWeights -=
         split.connectorSplit->splitWeight;
     taskStats_->runningTableScanSplitWeights +=
@@ -96,6 +106,38 @@ Split SplitsStore::getSplit(
   return split;
 }
 
+void SplitsStore::divideIntoMorsels(int numSplits) {
+  for (size_t i = 0; i < std::min<size_t>(numSplits, splits_.size());) {
+    const auto& split = splits_[i];
+    if (split.isBarrier() || !split.hasConnectorSplit() ||
+        split.connectorSplit->dataSource != nullptr) {
+      ++i;
+      continue;
+    }
+    auto morsels = split.connectorSplit->splitIntoMorsels(morselBytes_);
+    if (morsels.empty()) {
+      ++i;
+      continue;
+    }
+    auto splitMorsels = std::make_shared<SplitMorsels>(morsels.size());
+    std::vector<Split> morselSplits;
+    morselSplits.reserve(morsels.size());
+    for (auto& morsel : morsels) {
+      morselSplits.emplace_back(std::move(morsel), split.groupId);
+      morselSplits.back().morsels = splitMorsels;
+    }
+    splits_.erase(splits_.begin() + i);
+    splits_.insert(
+        splits_.begin() + i,
+        std::make_move_iterator(morselSplits.begin()),
+        std::make_move_iterator(morselSplits.end()));
+    i += morselSplits.size();
+    // The morsels replace the split, which is still counted once in the split
+    // stats. Their weights add up to its weight.
+    taskStats_->numTotalMorsels += morselSplits.size();
+  }
+}
+
 bool SplitsStore::tryGetBarrier(
     std::optional<uint32_t> driverId,
     Split& split) {
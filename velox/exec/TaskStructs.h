@@ -146,6 +146,16 @@ class SplitsStore {
     preloadingSplits_ = &preloadingSplits;
   }
 
+  /// Sets the size of the morsels that the splits of a table scan are divided
+  /// into before they are preloaded or handed out, so that the drivers share
+  /// the work of large splits. 0 means splits are not divided. Ignored for
+  /// remote splits.
+  void setMorselBytes(uint64_t morselBytes) {
+    if (!remoteSplit_) {
+      morselBytes_ = morselBytes;
+    }
+  }
+
  protected:
   Split getSplit(
       int maxPreloadSplits,
@@ -155,10 +165,15 @@ class SplitsStore {
 
   bool tryGetBarrier(std::optional<uint32_t> driverId, Split& split);
 
+  // Replaces the splits among the first 'numSplits' that are not preloaded
+  // with their morsels.
+  void divideIntoMorsels(int numSplits);
+
   const bool remoteSplit_;
   TaskStats* taskStats_{};
   folly::F14FastSet<std::shared_ptr<connector::ConnectorSplit>>*
       preloadingSplits_{};
+  uint64_t morselBytes_{0};
 
   // Arrived (added), but not distributed yet, splits.
   std::deque<Split> splits_;
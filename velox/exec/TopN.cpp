@@ -39,7 +39,10 @@ TopN::TopN(
           topNNode->sortingOrders(),
           data_.get()),
       topRows_(comparator_),
-      decodedVectors_(outputType_->children().size()) {
+      decodedVectors_(outputType_->children().size()),
+      pushdownThreshold_(canPushdownThreshold(*topNNode)),
+      thresholdAscending_(topNNode->sortingOrders()[0].isAscending()),
+      thresholdNullsFirst_(topNNode->sortingOrders()[0].isNullsFirst()) {
   const auto numColumns{outputType_->children().size()};
   const auto numSortingKeys{topNNode->sortingKeys().size()};
   sortingKeyColumns_.reserve(numSortingKeys);
@@ -58,6 +61,24 @@ TopN::TopN(
   }
 }
 
+void TopN::initialize() {
+  Operator::initialize();
+  if (!pushdownThreshold_) {
+    return;
+  }
+  // Dropping rows at the scan is only the same as dropping them here if the
+  // operators in between filter and project rows one by one. E.g. without
+  // the rows of its probe side, an outer join emits the unmatched build rows
+  // with null keys, and a Limit lets other rows through.
+  const auto operators = operatorCtx_->driver()->operators();
+  for (size_t i = 1; i < operators.size() && operators[i] != this; ++i) {
+    if (operators[i]->operatorType() != OperatorType::kFilterProject) {
+      pushdownThreshold_ = false;
+      return;
+    }
+  }
+}
+
 void TopN::addInput(RowVectorPtr input) {
   for (const auto col : sortingKeyColumns_) {
     decodedVectors_[col].decode(*input->childAt(col));
@@ -105,6 +126,98 @@ void TopN::addInput(RowVectorPtr input) {
       }
     }
   }
+
+  if (pushdownThreshold_ && topRows_.size() == count_) {
+    pushdownThreshold();
+  }
+}
+
+bool TopN::canPushdownThreshold(const core::TopNNode& topNNode) const {
+  if (count_ == 0 ||
+      !operatorCtx_->driverCtx()
+           ->queryConfig()
+           .topNDynamicFilterPushdownEnabled()) {
+    return false;
+  }
+  const auto channel =
+      exprToChannel(topNNode.sortingKeys()[0].get(), outputType_);
+  switch (outputType_->childAt(channel)->kind()) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::TIMESTAMP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+template <typename T>
+void TopN::pushdownThreshold(const char* row) {
+  using Threshold =
+      std::conditional_t<std::is_same_v<T, Timestamp>, Timestamp, int64_t>;
+  const Threshold value = RowContainer::valueAt<T>(
+      row, data_->columnAt(sortingKeyColumns_[0]).offset());
+  if (lastThreshold_.has_value() &&
+      std::get<Threshold>(lastThreshold_.value()) == value) {
+    return;
+  }
+  lastThreshold_ = value;
+
+  // Nulls sort before all values if nulls first, so they are never worse
+  // than the threshold.
+  common::FilterPtr filter;
+  if constexpr (std::is_same_v<T, Timestamp>) {
+    filter = thresholdAscending_
+        ? std::make_shared<common::TimestampRange>(
+              Timestamp::min(), value, thresholdNullsFirst_)
+        : std::make_shared<common::TimestampRange>(
+              value, Timestamp::max(), thresholdNullsFirst_);
+  } else {
+    filter = thresholdAscending_
+        ? std::make_shared<common::BigintRange>(
+              std::numeric_limits<T>::min(), value, thresholdNullsFirst_)
+        : std::make_shared<common::BigintRange>(
+              value, std::numeric_limits<T>::max(), thresholdNullsFirst_);
+  }
+
+  // The filter is merged with the one already on the scan column, so a
+  // threshold from a driver that has seen fewer rows does not loosen it.
+  const auto numFilters = operatorCtx_->driver()->pushdownFilters(
+      this,
+      {sortingKeyColumns_[0]},
+      [&](column_index_t /*channel*/, common::FilterPtr& pushed) {
+        pushed = filter;
+        return true;
+      });
+  if (numFilters > 0) {
+    addRuntimeStat(
+        std::string(kDynamicFilterUpdates), RuntimeCounter(numFilters));
+  }
+}
+
+void TopN::pushdownThreshold() {
+  const char* row = topRows_.top();
+  const auto channel = sortingKeyColumns_[0];
+  if (RowContainer::isNullAt(row, data_->columnAt(channel))) {
+    // The N-th row has a null first key. No range on the key excludes rows.
+    return;
+  }
+  switch (outputType_->childAt(channel)->kind()) {
+    case TypeKind::TINYINT:
+      return pushdownThreshold<int8_t>(row);
+    case TypeKind::SMALLINT:
+      return pushdownThreshold<int16_t>(row);
+    case TypeKind::INTEGER:
+      return pushdownThreshold<int32_t>(row);
+    case TypeKind::BIGINT:
+      return pushdownThreshold<int64_t>(row);
+    case TypeKind::TIMESTAMP:
+      return pushdownThreshold<Timestamp>(row);
+    default:
+      VELOX_UNREACHABLE();
+  }
 }
 
 RowVectorPtr TopN::getOutput() {
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <variant>
+
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
 
@@ -31,6 +33,8 @@ class TopN : public Operator {
     return !noMoreInput_;
   }
 
+  void initialize() override;
+
   void addInput(RowVectorPtr input) override;
 
   RowVectorPtr getOutput() override;
@@ -43,7 +47,27 @@ class TopN : public Operator {
 
   bool isFinished() override;
 
+  /// Number of times the TopN pushed a tighter bound on its first sorting
+  /// key into the table scan. Only reported when
+  /// QueryConfig::topNDynamicFilterPushdownEnabled() is set.
+  static constexpr std::string_view kDynamicFilterUpdates =
+      "dynamicFilterUpdates";
+
  private:
+  // Returns true if a range filter on the first sorting key can be pushed
+  // into the table scan for 'topNNode'.
+  bool canPushdownThreshold(const core::TopNNode& topNNode) const;
+
+  // Once 'topRows_' holds 'count_' rows, pushes a range filter that only
+  // passes values of the first sorting key that are not worse than the
+  // current N-th value. Such rows cannot be in the top N of this or any other
+  // driver of the pipeline, so the scan can skip them, and whole row groups
+  // whose stats do not overlap the range.
+  void pushdownThreshold();
+
+  template <typename T>
+  void pushdownThreshold(const char* row);
+
   const int32_t count_;
 
   bool finished_ = false;
@@ -68,5 +92,16 @@ class TopN : public Operator {
 
   std::vector<DecodedVector> decodedVectors_;
   vector_size_t outputBatchSize_;
+
+  // True if the threshold of the first sorting key is pushed down as a
+  // dynamic filter. Cleared in initialize() unless only FilterProjects are
+  // between the source of the pipeline and 'this'.
+  bool pushdownThreshold_;
+  const bool thresholdAscending_;
+  const bool thresholdNullsFirst_;
+
+  // The last value of the first sorting key pushed down as a threshold.
+  // Avoids pushing the same filter again when the N-th row did not change.
+  std::optional<std::variant<int64_t, Timestamp>> lastThreshold_;
 };
 } // namespace facebook::velox::exec
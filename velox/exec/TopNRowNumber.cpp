@@ -15,8 +15,11 @@
  */
 #include "velox/exec/TopNRowNumber.h"
 
+#include "velox/common/testutil/TestValue.h"
 #include "velox/exec/OperatorType.h"
 
+using facebook::velox::common::testutil::TestValue;
+
 namespace facebook::velox::exec {
 
 namespace {
@@ -155,6 +158,9 @@ TopNRowNumber::TopNRowNumber(
           driverCtx->queryConfig().abandonPartialTopNRowNumberMinRows()),
       abandonPartialMinPct_(
           driverCtx->queryConfig().abandonPartialTopNRowNumberMinPct()),
+      memoryCompactionEnabled_(
+          driverCtx->queryConfig()
+              .topNRowNumberMemoryCompactionReclaimEnabled()),
       data_(
           std::make_unique<RowContainer>(
               slice(inputType_->children(), 0, spillCompareFlags_.size()),
@@ -969,7 +975,7 @@ void TopNRowNumber::close() {
 }
 
 void TopNRowNumber::reclaim(
-    uint64_t /*targetBytes*/,
+    uint64_t targetBytes,
     memory::MemoryReclaimer::Stats& stats) {
   VELOX_CHECK(canReclaim());
   VELOX_CHECK(!nonReclaimableSection_);
@@ -996,6 +1002,10 @@ void TopNRowNumber::reclaim(
     return;
   }
 
+  if (memoryCompactionEnabled_ && compact(targetBytes)) {
+    return;
+  }
+
   spill();
 }
 
@@ -1077,6 +1087,39 @@ void TopNRowNumber::spill() {
   pool()->release();
 }
 
+bool TopNRowNumber::compact(uint64_t targetBytes) {
+  // Evictions leave erased rows and freed strings behind in 'data_'. Moving
+  // the remaining rows is cheaper than spilling them if that frees enough.
+  if (targetBytes == 0 || !data_->canCompact() ||
+      data_->compactableBytes() < targetBytes) {
+    return false;
+  }
+  // The copy of the live rows is allocated before the old rows are freed.
+  // Reclaiming must not grow the reservation, so the copy has to fit in what
+  // is reserved already.
+  if (data_->compactionBytes() > pool()->availableReservation()) {
+    return false;
+  }
+
+  const auto reservedBytes = pool()->reservedBytes();
+  const auto movedRows = data_->compact();
+  if (table_ != nullptr) {
+    RowContainerIterator iter;
+    std::vector<char*> partitions(kPartitionBatchSize);
+    while (const auto numPartitions = table_->rows()->listRows(
+               &iter, partitions.size(), partitions.data())) {
+      for (auto i = 0; i < numPartitions; ++i) {
+        partitionAt(partitions[i]).moveRows(movedRows);
+      }
+    }
+  } else {
+    singlePartition_->moveRows(movedRows);
+  }
+  TestValue::adjust("facebook::velox::exec::TopNRowNumber::compact", this);
+  pool()->release();
+  return pool()->reservedBytes() + targetBytes <= reservedBytes;
+}
+
 void TopNRowNumber::setupSpiller() {
   VELOX_CHECK_NULL(spiller_);
   VELOX_CHECK(spillConfig_.has_value());
@@ -1164,4 +1207,12 @@ bool TopNRowNumber::TopRows::isDuplicate(
   return false;
 }
 
+void TopNRowNumber::TopRows::moveRows(
+    const RowContainer::MovedRows& movedRows) {
+  // The rows keep their values, so the order of the queue does not change.
+  for (char*& row : PriorityQueueVector(rows)) {
+    row = movedRows.newRow(row);
+  }
+}
+
 } // namespace facebook::velox::exec
@@ -162,6 +162,10 @@ class TopNRowNumber : public Operator {
         const std::vector<DecodedVector>& decodedVectors,
         vector_size_t index);
 
+    // Replaces the rows of the partition with their new addresses after
+    // RowContainer::compact().
+    void moveRows(const RowContainer::MovedRows& movedRows);
+
     TopRows(HashStringAllocator* allocator, RowComparator& comparator)
         : rows{{comparator}, StlAllocator<char*>(allocator)},
           tempTopRankRows(StlAllocator<char*>(allocator)),
@@ -227,6 +231,12 @@ class TopNRowNumber : public Operator {
   // Sorts, spills and clears all of 'data_'. Clears 'table_'.
   void spill();
 
+  // Compacts 'data_' if that frees at least 'targetBytes' and the temporary
+  // copy of its live rows fits in the unused reservation of the operator.
+  // Returns true if the memory reservation of the operator went down by
+  // 'targetBytes'.
+  bool compact(uint64_t targetBytes);
+
   void setupSpiller();
 
   template <core::TopNRowNumberNode::RankFunction TRank>
@@ -310,6 +320,8 @@ class TopNRowNumber : public Operator {
 
   const int32_t abandonPartialMinPct_;
 
+  const bool memoryCompactionEnabled_;
+
   // True if this operator runs a 'partial' stage without sufficient reduction
   // in cardinality. In this case, it becomes a pass-through.
   bool abandonedPartial_{false};
@@ -18,11 +18,13 @@
 
 #include "velox/core/QueryConfig.h"
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
+#include "velox/exec/DefaultOutputBufferManager.h"
 #include "velox/exec/Exchange.h"
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/LocalExchangeSource.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
 #include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
 #include "velox/functions/prestosql/registration/RegistrationFunctions.h"
 #include "velox/parse/TypeResolver.h"
@@ -324,6 +326,98 @@ class ExchangeBenchmark : public VectorTestBase {
     };
   }
 
+  // Partitions 'vectors' into 'numPartitions' in a single task and drains its
+  // output buffers without deserializing the pages, so that the time is spent
+  // in PartitionedOutput also for thousands of partitions.
+  void runPartitioned(
+      std::vector<RowVectorPtr>& vectors,
+      int32_t numPartitions,
+      int64_t& wallUs,
+      PlanNodeStats& partitionedOutputStats) {
+    core::PlanNodeId partitionedOutputId;
+    std::shared_ptr<Task> task;
+    std::string taskId;
+
+    BENCHMARK_SUSPEND {
+      assert(!vectors.empty());
+      configSettings_[core::QueryConfig::kMaxPartitionedOutputBufferSize] =
+          fmt::format("{}", FLAGS_exchange_buffer_mb << 20);
+      auto plan = exec::test::PlanBuilder()
+                      .values(vectors, true)
+                      .partitionedOutput({"c0"}, numPartitions)
+                      .capturePlanNodeId(partitionedOutputId)
+                      .planNode();
+      taskId = makeTaskId(++iteration_, "partition", 0);
+      task = makeTask(taskId, plan, 0);
+    };
+
+    const auto startUs = getCurrentTimeMicro();
+    task->start(FLAGS_task_width);
+
+    // Keeps one outstanding request per destination. The callbacks run on the
+    // producer threads when a request is not satisfied right away.
+    auto bufferManager = DefaultOutputBufferManager::getInstanceRef();
+    std::mutex mutex;
+    std::vector<int64_t> sequences(numPartitions, 0);
+    std::vector<bool> pending(numPartitions, false);
+    std::vector<bool> finished(numPartitions, false);
+    int32_t numFinished = 0;
+    while (true) {
+      bool waiting = true;
+      for (auto destination = 0; destination < numPartitions; ++destination) {
+        int64_t sequence;
+        {
+          std::lock_guard<std::mutex> l(mutex);
+          if (finished[destination] || pending[destination]) {
+            continue;
+          }
+          pending[destination] = true;
+          sequence = sequences[destination];
+        }
+        waiting = false;
+        bufferManager->getData(
+            taskId,
+            destination,
+            FLAGS_exchange_buffer_mb << 20,
+            sequence,
+            [&, destination](
+                std::vector<std::unique_ptr<folly::IOBuf>> pages,
+                int64_t /*inSequence*/,
+                std::vector<int64_t> /*remainingBytes*/) {
+              std::lock_guard<std::mutex> l(mutex);
+              pending[destination] = false;
+              for (const auto& page : pages) {
+                if (page == nullptr) {
+                  finished[destination] = true;
+                  ++numFinished;
+                  break;
+                }
+                ++sequences[destination];
+              }
+            });
+      }
+      {
+        std::lock_guard<std::mutex> l(mutex);
+        if (numFinished == numPartitions) {
+          break;
+        }
+      }
+      if (waiting) {
+        std::this_thread::yield();
+      }
+    }
+    for (auto destination = 0; destination < numPartitions; ++destination) {
+      bufferManager->deleteResults(taskId, destination);
+    }
+    VELOX_CHECK(waitForTaskCompletion(task.get()));
+    wallUs = getCurrentTimeMicro() - startUs;
+
+    BENCHMARK_SUSPEND {
+      const auto planStats = toPlanStats(task->taskStats());
+      partitionedOutputStats += planStats.at(partitionedOutputId);
+    };
+  }
+
  private:
   static constexpr int64_t kMaxMemory = 6UL << 30; // 6GB
 
@@ -508,6 +602,24 @@ void runBenchmarks() {
     return 1;
   });
 
+  // PartitionedOutput alone, from a few to thousands of partitions.
+  const std::vector<int32_t> kNumPartitions = {10, 100, 4'096};
+  std::vector<int64_t> partitionedWallUs(kNumPartitions.size());
+  std::vector<PlanNodeStats> partitionedOutputStats(kNumPartitions.size());
+  for (auto i = 0; i < kNumPartitions.size(); ++i) {
+    folly::addBenchmark(
+        __FILE__,
+        fmt::format("partitionFlat10kTo{}", kNumPartitions[i]),
+        [&, i]() {
+          bm->runPartitioned(
+              flat10k,
+              kNumPartitions[i],
+              partitionedWallUs[i],
+              partitionedOutputStats[i]);
+          return 1;
+        });
+  }
+
   int64_t localPartitionWallUs;
   PlanNodeStats localPartitionStatsFlat10K;
   LocalPartitionWaitStats localPartitionWaitStats;
@@ -564,6 +676,15 @@ void runBenchmarks() {
             << std::endl;
   std::cout << "Exchange: " << exchangeStatsStruct1K.toString() << std::endl;
 
+  for (auto i = 0; i < kNumPartitions.size(); ++i) {
+    std::cout << "---------------------------Flat10K to " << kNumPartitions[i]
+              << " partitions---------------------------" << std::endl;
+    std::cout << "Wall Time (ms): " << succinctMicros(partitionedWallUs[i])
+              << std::endl;
+    std::cout << "PartitionOutput: " << partitionedOutputStats[i].toString()
+              << std::endl;
+  }
+
   std::cout
       << "--------------------------------LocalFlat10K-------------------------------"
       << std::endl;
@@ -16,6 +16,7 @@
 #include <folly/Benchmark.h>
 #include <folly/init/Init.h>
 
+#include "velox/buffer/BufferArena.h"
 #include "velox/common/memory/Memory.h"
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
 #include "velox/exec/PlanNodeStats.h"
@@ -235,27 +236,34 @@ class FilterProjectBenchmark : public VectorTestBase {
     test->baseline = makeFilterProjectPlan(1, 80, test->rows);
     test->plan95 = makeFilterProjectPlan(4, 95, test->rows);
     test->plan50 = makeFilterProjectPlan(4, 50, test->rows);
-    folly::addBenchmark(
-        __FILE__, name + "_base", [plan = &test->baseline, this]() {
-          run(*plan);
-          return 1;
-        });
-    folly::addBenchmark(
-        __FILE__, name + "_95^4", [plan = &test->plan95, this]() {
-          run(*plan);
-          return 1;
-        });
-    folly::addBenchmark(
-        __FILE__, name + "_50^4", [plan = &test->plan50, this]() {
-          run(*plan);
-          return 1;
-        });
+    // Each plan is run without and with the arena for expression vectors. The
+    // arena runs are reported relative to the runs without.
+    const std::vector<std::pair<std::string, core::PlanNodePtr*>> plans = {
+        {"_base", &test->baseline},
+        {"_95^4", &test->plan95},
+        {"_50^4", &test->plan50}};
+    for (const auto& [suffix, plan] : plans) {
+      folly::addBenchmark(__FILE__, name + suffix, [plan = plan, this]() {
+        run(*plan);
+        return 1;
+      });
+      folly::addBenchmark(
+          __FILE__, "%" + name + suffix + "_arena", [plan = plan, this]() {
+            run(*plan, true);
+            return 1;
+          });
+    }
     cases_.push_back(std::move(test));
   }
 
-  int64_t run(std::shared_ptr<const core::PlanNode> plan) {
+  int64_t run(std::shared_ptr<const core::PlanNode> plan, bool arena = false) {
     auto start = getCurrentTimeMicro();
-    auto result = exec::test::AssertQueryBuilder(plan).copyResults(pool_.get());
+    auto result =
+        exec::test::AssertQueryBuilder(plan)
+            .config(
+                core::QueryConfig::kExprBatchArenaChunkSize,
+                arena ? std::to_string(BufferArena::kDefaultChunkSize) : "0")
+            .copyResults(pool_.get());
     auto elapsedMicros = getCurrentTimeMicro() - start;
     return elapsedMicros;
   }
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/init/Init.h>
+#include <thread>
+
+#include "velox/exec/LocalPartition.h"
+#include "velox/exec/Task.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+/// Measures the throughput of local exchange queues with many producer and
+/// consumer threads exchanging small and large batches. Each producer enqueues
+/// round robin into one queue per consumer and all the queues share one memory
+/// manager, as in a LocalPartition. Compares a single locked queue with
+/// sharded queues.
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+namespace {
+
+// The number of batches enqueued by all producers in one iteration.
+constexpr int32_t kNumBatches = 200'000;
+
+class LocalExchangeQueueBenchmark : public test::VectorTestBase {
+ public:
+  LocalExchangeQueueBenchmark()
+      : executor_(std::make_unique<folly::CPUThreadPoolExecutor>(1)) {
+    core::PlanFragment planFragment{std::make_shared<core::ValuesNode>(
+        "0", std::vector<RowVectorPtr>{})};
+    task_ = Task::create(
+        "LocalExchangeQueueBenchmark",
+        std::move(planFragment),
+        0,
+        core::QueryCtx::create(executor_.get()),
+        Task::ExecutionMode::kParallel);
+  }
+
+  void run(
+      int32_t numProducers,
+      int32_t numConsumers,
+      vector_size_t batchRows,
+      int32_t numShards) {
+    folly::BenchmarkSuspender suspender;
+    const auto data = makeRowVector({makeFlatVector<int64_t>(
+        batchRows, [](auto row) { return row; })});
+    const int64_t dataBytes = data->retainedSize();
+    auto memoryManager =
+        std::make_shared<LocalExchangeMemoryManager>(32L << 20);
+    auto vectorPool = std::make_shared<LocalExchangeVectorPool>(0);
+    std::vector<std::shared_ptr<LocalExchangeQueue>> queues;
+    for (auto i = 0; i < numConsumers; ++i) {
+      queues.push_back(
+          std::make_shared<LocalExchangeQueue>(
+              memoryManager, vectorPool, i, numShards));
+      for (auto j = 0; j < numProducers; ++j) {
+        queues.back()->addProducer();
+      }
+      queues.back()->noMoreProducers();
+    }
+    std::vector<std::unique_ptr<DriverCtx>> driverCtxs;
+    for (auto i = 0; i < numProducers; ++i) {
+      driverCtxs.push_back(std::make_unique<DriverCtx>(task_, i, 0, 0, 0));
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(numProducers + numConsumers);
+    suspender.dismiss();
+
+    for (auto i = 0; i < numConsumers; ++i) {
+      threads.emplace_back([&, i]() {
+        auto& queue = *queues[i];
+        for (;;) {
+          ContinueFuture future;
+          RowVectorPtr output;
+          bool drained{false};
+          if (queue.next(&future, pool(), &output, drained) !=
+              BlockingReason::kNotBlocked) {
+            future.wait();
+            continue;
+          }
+          if (output == nullptr) {
+            break;
+          }
+        }
+      });
+    }
+    for (auto i = 0; i < numProducers; ++i) {
+      threads.emplace_back([&, i]() {
+        ScopedDriverThreadContext driverThreadCtx(driverCtxs[i].get());
+        for (auto batch = 0; batch < kNumBatches / numProducers; ++batch) {
+          ContinueFuture future;
+          if (queues[(i + batch) % numConsumers]->enqueue(
+                  data, dataBytes, &future) != BlockingReason::kNotBlocked) {
+            future.wait();
+          }
+        }
+        for (auto& queue : queues) {
+          queue->noMoreData();
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+ private:
+  const std::unique_ptr<folly::CPUThreadPoolExecutor> executor_;
+  std::shared_ptr<Task> task_;
+};
+
+std::unique_ptr<LocalExchangeQueueBenchmark> benchmark;
+
+void addBenchmarks() {
+  const int32_t maxShards = std::thread::hardware_concurrency();
+  for (const auto& [numProducers, numConsumers] :
+       std::vector<std::pair<int32_t, int32_t>>{
+           {4, 4}, {16, 16}, {64, 16}, {64, 64}}) {
+    for (const vector_size_t batchRows : {16, 1'024}) {
+      for (const int32_t numShards :
+           {1, std::min(numProducers, std::max(maxShards, 1))}) {
+        folly::addBenchmark(
+            __FILE__,
+            fmt::format(
+                "producers_{}_consumers_{}_rows_{}_shards_{}",
+                numProducers,
+                numConsumers,
+                batchRows,
+                numShards),
+            [=]() {
+              benchmark->run(numProducers, numConsumers, batchRows, numShards);
+              return 1;
+            });
+      }
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::Init init{&argc, &argv};
+  memory::MemoryManager::initialize(memory::MemoryManager::Options{});
+  benchmark = std::make_unique<LocalExchangeQueueBenchmark>();
+  addBenchmarks();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include "velox/common/file/FileSystems.h"
+#include "velox/common/testutil/TempDirectoryPath.h"
+#include "velox/exec/HashJoinBridge.h"
+#include "velox/exec/RowContainer.h"
+#include "velox/exec/SpillFile.h"
+#include "velox/serializers/PrestoSerializer.h"
+#include "velox/vector/fuzzer/VectorFuzzer.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+/// Measures a spill round trip of the rows of a RowContainer: writing them to
+/// a spill file and restoring them into a new RowContainer. Compares the
+/// columnar format, which extracts vectors and stores them back column by
+/// column, with the row format, which copies the container's row layout.
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+namespace {
+
+constexpr int32_t kNumRows = 100'000;
+constexpr int32_t kBatchRows = 1'000;
+
+class RowSpillBenchmark : public test::VectorTestBase {
+ public:
+  RowSpillBenchmark()
+      : rowType_(
+            ROW({"k0", "k1", "d0", "d1", "d2"},
+                {BIGINT(), VARCHAR(), INTEGER(), DOUBLE(), VARCHAR()})),
+        tempDir_(common::testutil::TempDirectoryPath::create()) {
+    VectorFuzzer::Options opts;
+    opts.vectorSize = kNumRows;
+    opts.nullRatio = 0.1;
+    opts.stringLength = 20;
+    VectorFuzzer fuzzer(opts, pool());
+    const auto data = fuzzer.fuzzInputFlatRow(rowType_);
+
+    source_ = makeContainer();
+    std::vector<DecodedVector> decoded(rowType_->size());
+    storeColumns(data, decoded, *source_);
+    rows_.resize(kNumRows);
+    RowContainerIterator iter;
+    source_->listRows(&iter, kNumRows, rows_.data());
+  }
+
+  void columnar() {
+    const auto files =
+        spill(rowType_, [&](folly::Range<char**> rows, RowVectorPtr& batch) {
+          for (auto i = 0; i < rowType_->size(); ++i) {
+            source_->extractColumn(
+                rows.data(), rows.size(), i, batch->childAt(i));
+          }
+        });
+    auto target = makeContainer();
+    std::vector<DecodedVector> decoded(rowType_->size());
+    restore(files, [&](const RowVectorPtr& batch) {
+      storeColumns(batch, decoded, *target);
+    });
+  }
+
+  void row() {
+    const auto files = spill(
+        hashJoinTableRowSpillType(),
+        [&](folly::Range<char**> rows, RowVectorPtr& batch) {
+          source_->extractSerializedRows(rows, batch->childAt(0));
+        });
+    auto target = makeContainer();
+    restore(files, [&](const RowVectorPtr& batch) {
+      const auto& serialized = *batch->childAt(0)->asFlatVector<StringView>();
+      for (auto i = 0; i < batch->size(); ++i) {
+        target->storeSerializedRow(serialized, i, target->newRow());
+      }
+    });
+  }
+
+ private:
+  std::unique_ptr<RowContainer> makeContainer() {
+    return std::make_unique<RowContainer>(
+        std::vector<TypePtr>{BIGINT(), VARCHAR()},
+        std::vector<TypePtr>{INTEGER(), DOUBLE(), VARCHAR()},
+        pool());
+  }
+
+  void storeColumns(
+      const RowVectorPtr& input,
+      std::vector<DecodedVector>& decoded,
+      RowContainer& container) {
+    const SelectivityVector allRows(input->size());
+    for (auto i = 0; i < input->childrenSize(); ++i) {
+      decoded[i].decode(*input->childAt(i), allRows);
+    }
+    for (auto row = 0; row < input->size(); ++row) {
+      char* newRow = container.newRow();
+      for (auto i = 0; i < decoded.size(); ++i) {
+        container.store(decoded[i], row, newRow, i);
+      }
+    }
+  }
+
+  SpillFiles spill(
+      const RowTypePtr& type,
+      const std::function<void(folly::Range<char**>, RowVectorPtr&)>&
+          extract) {
+    SpillWriter writer(
+        type,
+        {},
+        common::CompressionKind_NONE,
+        fmt::format("{}/spill", tempDir_->getPath()),
+        std::numeric_limits<uint64_t>::max(),
+        1 << 20,
+        "",
+        [](uint64_t /*unused*/) {},
+        pool(),
+        &stats_);
+    for (auto offset = 0; offset < rows_.size(); offset += kBatchRows) {
+      const auto numRows =
+          std::min<int32_t>(kBatchRows, rows_.size() - offset);
+      auto batch = BaseVector::create<RowVector>(type, numRows, pool());
+      extract(folly::Range<char**>(rows_.data() + offset, numRows), batch);
+      IndexRange range{0, numRows};
+      writer.write(batch, folly::Range<IndexRange*>(&range, 1));
+    }
+    return writer.finish();
+  }
+
+  void restore(
+      const SpillFiles& files,
+      const std::function<void(const RowVectorPtr&)>& store) {
+    for (const auto& file : files) {
+      auto reader = SpillReadFile::create(file, 1 << 20, pool(), &stats_);
+      RowVectorPtr batch;
+      while (reader->nextBatch(batch)) {
+        store(batch);
+      }
+      filesystems::getFileSystem(file.path, nullptr)->remove(file.path);
+    }
+  }
+
+  const RowTypePtr rowType_;
+  const std::shared_ptr<common::testutil::TempDirectoryPath> tempDir_;
+  std::unique_ptr<RowContainer> source_;
+  std::vector<char*> rows_;
+  SpillStats stats_;
+};
+
+std::unique_ptr<RowSpillBenchmark> benchmark;
+
+BENCHMARK(columnarSpillRestore) {
+  benchmark->columnar();
+}
+
+BENCHMARK_RELATIVE(rowSpillRestore) {
+  benchmark->row();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::Init init{&argc, &argv};
+  memory::MemoryManager::initialize(memory::MemoryManager::Options{});
+  filesystems::registerLocalFileSystem();
+  serializer::presto::PrestoVectorSerde::registerNamedVectorSerde();
+  benchmark = std::make_unique<RowSpillBenchmark>();
+  folly::runBenchmarks();
+  benchmark.reset();
+  return 0;
+}
@@ -32,6 +32,7 @@
 #include "velox/exec/HashAggregation.h"
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/PrefixSort.h"
+#include "velox/exec/Spiller.h"
 #include "velox/exec/StreamingAggregation.h"
 #include "velox/exec/Values.h"
 #include "velox/exec/prefixsort/PrefixSortEncoder.h"
@@ -4142,6 +4143,118 @@ DEBUG_ONLY_TEST_F(AggregationTest, reclaimFromAggregation) {
   }
 }
 
+DEBUG_ONLY_TEST_F(AggregationTest, reclaimCooperativelyFromAggregation) {
+  const int numInputs = 8;
+  std::vector<RowVectorPtr> vectors =
+      createVectors(numInputs, rowType_, fuzzerOpts_);
+  createDuckDbTable(vectors);
+
+  std::atomic_int inputCount{0};
+  std::thread::id driverThreadId;
+  std::thread arbitrationThread;
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::Driver::runInternal::addInput",
+      std::function<void(exec::Operator*)>(([&](exec::Operator* op) {
+        if (op->operatorCtx()->operatorType() != "Aggregation") {
+          return;
+        }
+        if (++inputCount != numInputs / 2) {
+          return;
+        }
+        driverThreadId = std::this_thread::get_id();
+        arbitrationThread =
+            std::thread([]() { memory::testingRunArbitration(); });
+        // The driver spills at its next operator boundary once the arbitration
+        // asks the task to reclaim.
+        auto* task = op->operatorCtx()->task().get();
+        while (task->cooperativeReclaimId() == 0) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+      })));
+
+  std::atomic_bool firstSpill{true};
+  std::thread::id spillThreadId;
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::SpillerBase",
+      std::function<void(SpillerBase*)>([&](SpillerBase* /*unused*/) {
+        if (firstSpill.exchange(false)) {
+          spillThreadId = std::this_thread::get_id();
+        }
+      }));
+
+  const auto spillDirectory = TempDirectoryPath::create();
+  core::PlanNodeId aggrNodeId;
+  auto task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .spillDirectory(spillDirectory->getPath())
+          .config(core::QueryConfig::kSpillEnabled, true)
+          .config(core::QueryConfig::kAggregationSpillEnabled, true)
+          .config(core::QueryConfig::kCooperativeMemoryReclaimWaitMs, "60000")
+          .plan(
+              PlanBuilder()
+                  .values(vectors)
+                  .singleAggregation({"c0", "c1"}, {"array_agg(c2)"})
+                  .capturePlanNodeId(aggrNodeId)
+                  .planNode())
+          .assertResults(
+              "SELECT c0, c1, array_agg(c2) FROM tmp GROUP BY c0, c1");
+  arbitrationThread.join();
+  // The driver spilled on its own thread rather than the arbitration.
+  ASSERT_FALSE(firstSpill);
+  ASSERT_EQ(spillThreadId, driverThreadId);
+  ASSERT_GT(
+      exec::toPlanStats(task->taskStats()).at(aggrNodeId).spilledBytes, 0);
+  task.reset();
+  waitForAllTasksToBeDeleted();
+}
+
+DEBUG_ONLY_TEST_F(AggregationTest, reclaimCooperativelyFromSuspendedDriver) {
+  const int numInputs = 8;
+  std::vector<RowVectorPtr> vectors =
+      createVectors(numInputs, rowType_, fuzzerOpts_);
+  createDuckDbTable(vectors);
+
+  std::atomic_int inputCount{0};
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::Driver::runInternal::addInput",
+      std::function<void(exec::Operator*)>(([&](exec::Operator* op) {
+        if (op->operatorCtx()->operatorType() != "Aggregation") {
+          return;
+        }
+        if (++inputCount != numInputs / 2) {
+          return;
+        }
+        auto task = op->operatorCtx()->task();
+        auto reclaimFuture = task->requestCooperativeReclaim(1);
+        ASSERT_FALSE(reclaimFuture.isReady());
+        {
+          // The only pending driver is suspended, e.g. in an arbitration of
+          // its own, so the request does not wait for it.
+          TestSuspendedSection suspendedSection(op->operatorCtx()->driver());
+          ASSERT_TRUE(reclaimFuture.isReady());
+        }
+        ASSERT_EQ(task->finishCooperativeReclaim().reclaimedBytes, 0);
+      })));
+
+  core::PlanNodeId aggrNodeId;
+  auto task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .config(core::QueryConfig::kCooperativeMemoryReclaimWaitMs, "60000")
+          .plan(
+              PlanBuilder()
+                  .values(vectors)
+                  .singleAggregation({"c0", "c1"}, {"array_agg(c2)"})
+                  .capturePlanNodeId(aggrNodeId)
+                  .planNode())
+          .assertResults(
+              "SELECT c0, c1, array_agg(c2) FROM tmp GROUP BY c0, c1");
+  ASSERT_EQ(inputCount, numInputs);
+  ASSERT_EQ(
+      exec::toPlanStats(task->taskStats()).at(aggrNodeId).spilledBytes, 0);
+  task.reset();
+  waitForAllTasksToBeDeleted();
+}
+
 DEBUG_ONLY_TEST_F(AggregationTest, reclaimFromDistinctAggregation) {
   const int numInputs = 32;
   std::vector<RowVectorPtr> vectors =
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/DriverScheduler.h"
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/synchronization/Baton.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/process/ProcessBase.h"
+#include "velox/exec/Task.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
+
+namespace facebook::velox::exec::test {
+namespace {
+
+class DriverSchedulerTest : public OperatorTestBase {
+ protected:
+  std::vector<RowVectorPtr> makeVectors(int32_t numVectors) {
+    std::vector<RowVectorPtr> vectors;
+    for (auto i = 0; i < numVectors; ++i) {
+      vectors.push_back(makeRowVector(
+          {makeFlatVector<int64_t>(1'000, [i](auto row) { return i + row; })}));
+    }
+    return vectors;
+  }
+
+  // Returns a task of a query with 'weight' for scheduling drivers directly.
+  std::shared_ptr<Task> makeTask(
+      const std::string& taskId,
+      folly::Executor* scheduler,
+      int32_t weight = 1) {
+    return Task::create(
+        taskId,
+        core::PlanFragment{PlanBuilder().values(makeVectors(1)).planNode()},
+        0,
+        core::QueryCtx::create(
+            scheduler,
+            core::QueryConfig(
+                {{core::QueryConfig::kDriverSchedulingWeight,
+                  std::to_string(weight)}})),
+        Task::ExecutionMode::kParallel,
+        [](RowVectorPtr, bool, ContinueFuture*) {
+          return BlockingReason::kNotBlocked;
+        });
+  }
+
+  // Schedules a driver of 'task' that uses 'cpuNanos' of CPU time per run and
+  // is scheduled again after each run while 'keepRunning' returns true. Counts
+  // the runs in 'numRuns' and increments 'numFinished' after the last run.
+  static void scheduleDriver(
+      MultiLevelDriverScheduler& scheduler,
+      const std::shared_ptr<Task>& task,
+      uint64_t cpuNanos,
+      std::function<bool()> keepRunning,
+      std::atomic_int32_t& numRuns,
+      std::atomic_int32_t& numFinished) {
+    scheduler.schedule(
+        task,
+        DriverCtx(task, 0, 0, 0, 0),
+        [&scheduler, task, cpuNanos, keepRunning, &numRuns, &numFinished]() {
+          const auto startNanos = process::threadCpuNanos();
+          while (process::threadCpuNanos() - startNanos < cpuNanos) {
+          }
+          ++numRuns;
+          if (keepRunning()) {
+            scheduleDriver(
+                scheduler, task, cpuNanos, keepRunning, numRuns, numFinished);
+          } else {
+            ++numFinished;
+          }
+        });
+  }
+
+  static void waitForFinished(
+      const std::atomic_int32_t& numFinished,
+      int32_t numDrivers) {
+    while (numFinished < numDrivers) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1)); // NOLINT
+    }
+  }
+
+  std::unique_ptr<folly::CPUThreadPoolExecutor> executor_{
+      std::make_unique<folly::CPUThreadPoolExecutor>(4)};
+};
+
+TEST_F(DriverSchedulerTest, functions) {
+  MultiLevelDriverScheduler scheduler(executor_.get());
+  ASSERT_EQ(scheduler.numLevels(), 5);
+
+  folly::Baton<> baton;
+  scheduler.add([&]() { baton.post(); });
+  baton.wait();
+
+  // Lets the closures added by 'scheduler' finish before it goes away.
+  executor_->join();
+  // Functions do not count as driver runs.
+  const auto stats = scheduler.stats();
+  for (auto level = 0; level < scheduler.numLevels(); ++level) {
+    ASSERT_EQ(stats.numRuns[level], 0);
+  }
+}
+
+TEST_F(DriverSchedulerTest, queries) {
+  MultiLevelDriverScheduler scheduler(executor_.get());
+  const auto vectors = makeVectors(10);
+  createDuckDbTable(vectors);
+
+  const auto plan = PlanBuilder()
+                        .values(vectors, /*parallelizable=*/true)
+                        .project({"c0 % 7 AS k", "c0"})
+                        .singleAggregation({"k"}, {"sum(c0)"})
+                        .planNode();
+  for (const auto weight : {"1", "3"}) {
+    auto queryCtx = core::QueryCtx::create(
+        &scheduler,
+        core::QueryConfig(
+            {{core::QueryConfig::kDriverSchedulingWeight, weight}}));
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .queryCtx(queryCtx)
+        .maxDrivers(4)
+        .assertResults("SELECT c0 % 7, sum(c0) FROM tmp GROUP BY 1");
+  }
+
+  executor_->join();
+  // All drivers run at the first level since the queries are short.
+  const auto stats = scheduler.stats();
+  ASSERT_GT(stats.numRuns[0], 0);
+  for (auto level = 1; level < scheduler.numLevels(); ++level) {
+    ASSERT_EQ(stats.numRuns[level], 0);
+  }
+}
+
+TEST_F(DriverSchedulerTest, levels) {
+  // The drivers of a task go to the second level once it has used any CPU.
+  MultiLevelDriverScheduler scheduler(
+      executor_.get(), {.levelThresholdNanos = {1}});
+  ASSERT_EQ(scheduler.numLevels(), 2);
+
+  // The consumer blocks the driver on the first batch until 'promise' is
+  // fulfilled.
+  ContinuePromise promise("DriverSchedulerTest::levels");
+  folly::Baton<> consumerBlocked;
+  bool blocked{false};
+  auto task = Task::create(
+      "levels",
+      core::PlanFragment{PlanBuilder().values(makeVectors(2)).planNode()},
+      0,
+      core::QueryCtx::create(&scheduler),
+      Task::ExecutionMode::kParallel,
+      [&](RowVectorPtr vector, bool /*drained*/, ContinueFuture* future) {
+        if (vector == nullptr || blocked) {
+          return BlockingReason::kNotBlocked;
+        }
+        blocked = true;
+        *future = promise.getSemiFuture();
+        consumerBlocked.post();
+        return BlockingReason::kWaitForConsumer;
+      });
+  task->start(1);
+  consumerBlocked.wait();
+
+  // Waits for the first run to be charged to the task.
+  while (scheduler.stats().numRuns[0] == 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1)); // NOLINT
+  }
+  promise.setValue();
+  ASSERT_TRUE(waitForTaskCompletion(task.get()));
+  task.reset();
+
+  executor_->join();
+  const auto stats = scheduler.stats();
+  ASSERT_EQ(stats.numRuns[0], 1);
+  ASSERT_GE(stats.numRuns[1], 1);
+}
+
+TEST_F(DriverSchedulerTest, weights) {
+  // One thread runs the drivers of two queries with weights 1 and 3 that are
+  // always ready to run.
+  folly::CPUThreadPoolExecutor executor(1);
+  MultiLevelDriverScheduler scheduler(
+      &executor, {.levelThresholdNanos = {1'000'000'000'000}});
+  auto lightTask = makeTask("light", &scheduler, 1);
+  auto heavyTask = makeTask("heavy", &scheduler, 3);
+
+  constexpr int32_t kNumRuns = 400;
+  std::atomic_int32_t numLightRuns{0};
+  std::atomic_int32_t numHeavyRuns{0};
+  std::atomic_int32_t numFinished{0};
+  const auto keepRunning = [&]() {
+    return numLightRuns + numHeavyRuns < kNumRuns;
+  };
+  // Holds the thread until the drivers of both queries are queued.
+  folly::Baton<> start;
+  executor.add([&]() { start.wait(); });
+  for (auto i = 0; i < 2; ++i) {
+    scheduleDriver(
+        scheduler,
+        lightTask,
+        1'000'000,
+        keepRunning,
+        numLightRuns,
+        numFinished);
+    scheduleDriver(
+        scheduler,
+        heavyTask,
+        1'000'000,
+        keepRunning,
+        numHeavyRuns,
+        numFinished);
+  }
+  start.post();
+  waitForFinished(numFinished, 4);
+  executor.join();
+
+  // The queries share the CPU in proportion to their weights.
+  const auto ratio = static_cast<double>(numHeavyRuns) / numLightRuns;
+  ASSERT_GT(ratio, 2) << numHeavyRuns << " vs. " << numLightRuns;
+  ASSERT_LT(ratio, 4.5) << numHeavyRuns << " vs. " << numLightRuns;
+}
+
+TEST_F(DriverSchedulerTest, shortQueryFirst) {
+  // A task goes to the second level after 5ms of CPU time.
+  folly::CPUThreadPoolExecutor executor(1);
+  MultiLevelDriverScheduler scheduler(
+      &executor, {.levelThresholdNanos = {5'000'000}});
+  auto longTask = makeTask("long", &scheduler);
+  auto shortTask = makeTask("short", &scheduler);
+
+  // The long task runs 1ms at a time until the short one, which starts after
+  // 20 runs of the long one, is done. The short one runs 0.1ms at a time and
+  // stays at the first level.
+  constexpr int32_t kNumLongRunsAlone = 20;
+  constexpr int32_t kNumShortRuns = 10;
+  std::atomic_int32_t numLongRuns{0};
+  std::atomic_int32_t numShortRuns{0};
+  std::atomic_int32_t numFinished{0};
+  scheduleDriver(
+      scheduler,
+      longTask,
+      1'000'000,
+      [&]() {
+        if (numLongRuns == kNumLongRunsAlone) {
+          scheduleDriver(
+              scheduler,
+              shortTask,
+              100'000,
+              [&]() { return numShortRuns < kNumShortRuns; },
+              numShortRuns,
+              numFinished);
+        }
+        return numShortRuns < kNumShortRuns;
+      },
+      numLongRuns,
+      numFinished);
+  waitForFinished(numFinished, 2);
+  executor.join();
+
+  // The short query does not take turns with the long one, which has moved to
+  // the second level.
+  ASSERT_EQ(numShortRuns, kNumShortRuns);
+  ASSERT_LE(numLongRuns - kNumLongRunsAlone, 3);
+  const auto stats = scheduler.stats();
+  ASSERT_GE(stats.numRuns[0], kNumShortRuns);
+  ASSERT_GE(stats.numRuns[1], kNumLongRunsAlone - 10);
+  ASSERT_EQ(stats.numRuns[0] + stats.numRuns[1], numLongRuns + numShortRuns);
+}
+
+TEST_F(DriverSchedulerTest, invalidOptions) {
+  VELOX_ASSERT_THROW(
+      MultiLevelDriverScheduler(
+          executor_.get(), {.levelThresholdNanos = {10, 10}}),
+      "(10 vs. 10)");
+  VELOX_ASSERT_THROW(
+      MultiLevelDriverScheduler(executor_.get(), {.levelShareRatio = 0.5}),
+      "(0.5 vs. 1)");
+}
+} // namespace
+} // namespace facebook::velox::exec::test
@@ -13,6 +13,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
@@ -479,5 +480,261 @@ TEST_F(FilterProjectTest, lazyDereference) {
   }
 }
 
+TEST_F(FilterProjectTest, lazySubfieldPushdown) {
+  constexpr vector_size_t kSize = 1'000;
+  auto vector = makeRowVector({
+      makeRowVector(
+          {"a", "b", "c"},
+          {
+              makeFlatVector<int64_t>(kSize, [](auto row) { return row; }),
+              makeRowVector(
+                  {"x", "y"},
+                  {
+                      makeFlatVector<int64_t>(
+                          kSize, [](auto row) { return row * 2; }),
+                      makeFlatVector<std::string>(
+                          kSize,
+                          [](auto row) { return fmt::format("y{}", row); }),
+                  }),
+              makeArrayVector<int64_t>(
+                  kSize,
+                  [](auto row) { return row % 5; },
+                  [](auto row, auto index) { return row + index; }),
+          }),
+      makeFlatVector<int64_t>(kSize, [](auto row) { return row % 7; }),
+  });
+  auto file = TempFilePath::create();
+  writeToFile(file->getPath(), vector);
+
+  // Runs 'projections' over a scan of 'file' with the pushdown on and off and
+  // checks that the results are the same. Returns true if any lazy column
+  // accepted the pushed down subfields.
+  const auto runQuery = [&](const std::vector<std::string>& projections) {
+    auto expected = test::AssertQueryBuilder(test::PlanBuilder()
+                                                 .values({vector})
+                                                 .filter("c1 < 5")
+                                                 .project(projections)
+                                                 .planNode())
+                        .copyResults(pool());
+    core::PlanNodeId projectId;
+    auto plan = test::PlanBuilder()
+                    .tableScan(vector->rowType())
+                    .filter("c1 < 5")
+                    .project(projections)
+                    .capturePlanNodeId(projectId)
+                    .planNode();
+    const auto scan = [&](bool enabled) {
+      std::shared_ptr<Task> task;
+      auto result = test::AssertQueryBuilder(plan)
+                        .split(makeHiveConnectorSplit(file->getPath()))
+                        .config(
+                            core::QueryConfig::kLazySubfieldPushdownEnabled,
+                            enabled ? "true" : "false")
+                        .copyResults(pool(), task);
+      const auto& customStats =
+          toPlanStats(task->taskStats()).at(projectId).customStats;
+      return std::make_pair(
+          result,
+          customStats.count(std::string(
+              FilterProject::kLazySubfieldPushdownColumns)) > 0);
+    };
+    const auto [disabledResult, disabledPushdown] = scan(false);
+    EXPECT_FALSE(disabledPushdown);
+    velox::test::assertEqualVectors(expected, disabledResult);
+    const auto [enabledResult, enabledPushdown] = scan(true);
+    velox::test::assertEqualVectors(disabledResult, enabledResult);
+    return enabledPushdown;
+  };
+
+  EXPECT_TRUE(runQuery({"c0.a + c1", "c0.b.x"}));
+  EXPECT_TRUE(runQuery({"cardinality(c0.c)", "c0.b.y"}));
+
+  // 'c0' is also referenced as a whole, so nothing is pushed down.
+  EXPECT_FALSE(runQuery({"c0.a + c1", "c0"}));
+  EXPECT_FALSE(runQuery({"c0.a + c1", "c0 IS NULL"}));
+
+  // The loader does not read the members that no subfield reaches and returns
+  // nulls for them.
+  CursorParameters params;
+  params.copyResult = false;
+  params.serialExecution = true;
+  params.planNode =
+      test::PlanBuilder().tableScan(vector->rowType()).planNode();
+  auto cursor = TaskCursor::create(params);
+  for (auto i = 0; i < 2; ++i) {
+    cursor->task()->addSplit(
+        "0", exec::Split(makeHiveConnectorSplit(file->getPath())));
+  }
+  cursor->task()->noMoreSplits("0");
+  ASSERT_TRUE(cursor->moveNext());
+  auto* lazy = cursor->current()->childAt(0)->asChecked<LazyVector>();
+  ASSERT_FALSE(lazy->isLoaded());
+  ASSERT_TRUE(lazy->pushdownSubfields(
+      {common::Subfield("c0.a"), common::Subfield("c0.b.x")}));
+  auto loaded = lazy->loadedVectorShared();
+  ASSERT_EQ(loaded->size(), kSize);
+  auto* expectedRow = vector->childAt(0)->asChecked<RowVector>();
+  auto* loadedRow = loaded->asChecked<RowVector>();
+  velox::test::assertEqualVectors(
+      expectedRow->childAt(0), loadedRow->childAt(0));
+  auto* loadedB = loadedRow->childAt(1)->asChecked<RowVector>();
+  velox::test::assertEqualVectors(
+      expectedRow->childAt(1)->asChecked<RowVector>()->childAt(0),
+      loadedB->childAt(0));
+  for (auto i = 0; i < kSize; ++i) {
+    ASSERT_TRUE(loadedB->childAt(1)->isNullAt(i)) << i;
+    ASSERT_TRUE(loadedRow->childAt(2)->isNullAt(i)) << i;
+  }
+
+  // An already loaded vector does not take the hint.
+  ASSERT_FALSE(lazy->pushdownSubfields({common::Subfield("c0.a")}));
+
+  // The pruning is only for the load. The next split reads all the members.
+  ASSERT_TRUE(cursor->moveNext());
+  velox::test::assertEqualVectors(
+      vector->childAt(0),
+      BaseVector::loadedVectorShared(cursor->current()->childAt(0)));
+  ASSERT_FALSE(cursor->moveNext());
+}
+
+TEST_F(FilterProjectTest, parallelProjectSlices) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 4; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<std::string>(
+            10'000,
+            [i](auto row) { return fmt::format("key{}-{}", i, row * 7); }),
+        makeFlatVector<int64_t>(10'000, [](auto row) { return row; }),
+    }));
+  }
+
+  // Runs the projections and returns the number of parallel slices reported
+  // by the operator, or 0 if the projections were evaluated serially.
+  const auto runQuery = [&](const std::vector<std::string>& projections,
+                            const std::unordered_map<std::string, std::string>&
+                                config) {
+    auto expected = test::AssertQueryBuilder(test::PlanBuilder()
+                                                 .values(vectors)
+                                                 .filter("c1 % 3 <> 0")
+                                                 .project(projections)
+                                                 .planNode())
+                        .copyResults(pool());
+    core::PlanNodeId projectId;
+    auto plan = test::PlanBuilder()
+                    .values(vectors)
+                    .filter("c1 % 3 <> 0")
+                    .project(projections)
+                    .capturePlanNodeId(projectId)
+                    .planNode();
+    auto task =
+        test::AssertQueryBuilder(plan).configs(config).assertResults(expected);
+    const auto& customStats =
+        toPlanStats(task->taskStats()).at(projectId).customStats;
+    auto it = customStats.find(std::string(FilterProject::kParallelProjectSlices));
+    return it == customStats.end() ? 0 : it->second.max;
+  };
+
+  const std::vector<std::string> regexProjections = {
+      "regexp_extract(c0, '([a-z]+)([0-9]+)-([0-9]+)', 3)", "c1 * 2"};
+  EXPECT_EQ(runQuery(regexProjections, {}), 0);
+  EXPECT_EQ(
+      runQuery(
+          regexProjections,
+          {{core::QueryConfig::kExprParallelSlices, "4"},
+           {core::QueryConfig::kExprParallelSliceMinRows, "1000"}}),
+      4);
+  // Slices are limited by the minimum number of rows per slice.
+  EXPECT_EQ(
+      runQuery(
+          regexProjections,
+          {{core::QueryConfig::kExprParallelSlices, "8"},
+           {core::QueryConfig::kExprParallelSliceMinRows, "2000"}}),
+      3);
+
+  // Cheap projections are sliced only once their observed CPU time per row
+  // exceeds the threshold.
+  const std::vector<std::string> cheapProjections = {"c1 + 1", "length(c0)"};
+  EXPECT_EQ(
+      runQuery(
+          cheapProjections,
+          {{core::QueryConfig::kExprParallelSlices, "4"},
+           {core::QueryConfig::kExprParallelSliceMinRows, "1000"},
+           {core::QueryConfig::kExprParallelSliceMinCpuNanosPerRow,
+            "1000000000"}}),
+      0);
+  EXPECT_EQ(
+      runQuery(
+          cheapProjections,
+          {{core::QueryConfig::kExprParallelSlices, "4"},
+           {core::QueryConfig::kExprParallelSliceMinRows, "1000"},
+           {core::QueryConfig::kExprParallelSliceMinCpuNanosPerRow, "0"}}),
+      4);
+
+  // Errors in any slice are propagated.
+  VELOX_ASSERT_THROW(
+      test::AssertQueryBuilder(
+          test::PlanBuilder()
+              .values(vectors)
+              .project({"regexp_like(c0, 'key')", "c1 / (c1 - 9000)"})
+              .planNode())
+          .config(core::QueryConfig::kExprParallelSlices, "4")
+          .config(core::QueryConfig::kExprParallelSliceMinRows, "1000")
+          .copyResults(pool()),
+      "division by zero");
+}
+
+TEST_F(FilterProjectTest, batchArena) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 50; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [i](auto row) { return i * 1'000 + row; }, nullEvery(7)),
+        makeFlatVector<std::string>(
+            1'000, [](auto row) { return fmt::format("s{}", row); }),
+    }));
+  }
+
+  // The results of the projections end up in the output, which the query
+  // holds until it finishes.
+  core::PlanNodeId projectId;
+  const auto plan = test::PlanBuilder()
+                        .values(vectors)
+                        .filter("c0 % 3 <> 0")
+                        .project(
+                            {"c0 + 1 AS a",
+                             "c0 * 2 > 100 AS b",
+                             "if(c0 % 2 = 0, c1, concat(c1, 'x')) AS c",
+                             "cast(c0 AS decimal(20, 2)) AS d"})
+                        .capturePlanNodeId(projectId)
+                        .planNode();
+  const auto expected = test::AssertQueryBuilder(plan).copyResults(pool());
+  for (const auto* chunkSize : {"4096", "65536", "1048576"}) {
+    SCOPED_TRACE(chunkSize);
+    auto task =
+        test::AssertQueryBuilder(plan)
+            .config(core::QueryConfig::kExprBatchArenaChunkSize, chunkSize)
+            .assertResults(expected);
+
+    // The output does not keep memory of the arena, so each batch reuses
+    // the chunks of the previous one.
+    const auto& customStats =
+        toPlanStats(task->taskStats()).at(projectId).customStats;
+    const auto it = customStats.find(
+        std::string(FilterProject::kVectorArenaChunkAllocations));
+    ASSERT_NE(it, customStats.end());
+    ASSERT_LE(it->second.sum, 2);
+  }
+
+  // The arena is only for FilterProject. Other users of an ExecCtx, e.g.
+  // join filters, would put its buffers in their output.
+  auto queryCtx = core::QueryCtx::create(
+      nullptr,
+      core::QueryConfig(
+          {{core::QueryConfig::kExprBatchArenaChunkSize, "1048576"}}));
+  core::ExecCtx execCtx(pool(), queryCtx.get());
+  ASSERT_NE(execCtx.vectorPool(), nullptr);
+  ASSERT_EQ(execCtx.vectorPool()->arena(), nullptr);
+}
+
 } // namespace
 } // namespace facebook::velox::exec
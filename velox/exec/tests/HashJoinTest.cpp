@@ -134,6 +134,40 @@ TEST_P(MultiThreadedHashJoinTest, testJoinWithSpillenabledCancellation) {
       .run();
 }
 
+TEST_P(MultiThreadedHashJoinTest, rowFormatSpill) {
+  struct {
+    core::JoinType joinType;
+    std::vector<std::string> outputLayout;
+    std::string referenceQuery;
+  } testSettings[] = {
+      {core::JoinType::kInner,
+       {"t_k1", "t_v1", "u_k1", "u_v1"},
+       "SELECT t_k1, t_v1, u_k1, u_v1 FROM t, u WHERE t_k1 = u_k1"},
+      {core::JoinType::kRight,
+       {"t_k1", "t_v1", "u_k1", "u_v1"},
+       "SELECT t_k1, t_v1, u_k1, u_v1 FROM t RIGHT JOIN u ON t_k1 = u_k1"},
+      {core::JoinType::kLeftSemiFilter,
+       {"t_k1", "t_v1"},
+       "SELECT t_k1, t_v1 FROM t WHERE t_k1 IN (SELECT u_k1 FROM u)"}};
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(core::JoinTypeName::toName(testData.joinType));
+    HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+        .numDrivers(numDrivers_)
+        .parallelizeJoinBuildRows(parallelBuildSideRowsEnabled_)
+        .probeType(probeType_)
+        .probeKeys({"t_k1"})
+        .probeVectors(100, 5)
+        .buildType(buildType_)
+        .buildKeys({"u_k1"})
+        .buildVectors(100, 5)
+        .joinType(testData.joinType)
+        .joinOutputLayout(testData.outputLayout)
+        .config(core::QueryConfig::kSpillRowFormatEnabled, "true")
+        .referenceQuery(testData.referenceQuery)
+        .run();
+  }
+}
+
 TEST_P(MultiThreadedHashJoinTest, emptyBuild) {
   const std::vector<bool> finishOnEmptys = {false, true};
   for (const auto finishOnEmpty : finishOnEmptys) {
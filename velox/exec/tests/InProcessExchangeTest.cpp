@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/InProcessExchange.h"
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/HashPartitionFunction.h"
+#include "velox/exec/OutputTransportRegistry.h"
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/Task.h"
+#include "velox/exec/tests/utils/LocalExchangeSource.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
+
+namespace facebook::velox::exec::test {
+namespace {
+
+class InProcessExchangeTest : public OperatorTestBase {
+ protected:
+  static constexpr int kNumPartitions{2};
+
+  void SetUp() override {
+    OperatorTestBase::SetUp();
+    ExchangeSource::factories().clear();
+    ExchangeSource::registerFactory(createLocalExchangeSource);
+    InProcessOutputBufferManager::registerTransport();
+  }
+
+  void TearDown() override {
+    OutputTransportRegistry::unregisterAll();
+    OperatorTestBase::TearDown();
+  }
+
+  std::vector<RowVectorPtr> makeVectors() {
+    std::vector<RowVectorPtr> vectors;
+    for (auto i = 0; i < 5; ++i) {
+      vectors.push_back(makeRowVector({
+          makeFlatVector<int64_t>(1'000, [i](auto row) { return i + row; }),
+          makeFlatVector<std::string>(
+              1'000, [](auto row) { return fmt::format("string {}", row); }),
+      }));
+    }
+    return vectors;
+  }
+
+  std::shared_ptr<Task> startProducer(
+      const std::string& taskId,
+      const std::vector<RowVectorPtr>& vectors,
+      const std::shared_ptr<core::QueryCtx>& queryCtx,
+      bool replicateNullsAndAny = false) {
+    auto plan = PlanBuilder()
+                    .values(vectors)
+                    .partitionedOutput(
+                        {"c0"},
+                        kNumPartitions,
+                        replicateNullsAndAny,
+                        /*outputLayout=*/{},
+                        "Presto",
+                        std::string{core::TransportKind::kInProcess})
+                    .planFragment();
+    auto task = Task::create(
+        taskId,
+        std::move(plan),
+        0,
+        queryCtx,
+        Task::ExecutionMode::kParallel,
+        exec::Consumer{});
+    task->start(1);
+    return task;
+  }
+
+  // Starts a task per destination of 'producerId' that collects the vectors
+  // its Exchange returns into 'results'.
+  std::vector<std::shared_ptr<Task>> startConsumers(
+      const std::string& producerId,
+      const RowTypePtr& rowType,
+      const std::shared_ptr<core::QueryCtx>& queryCtx,
+      std::vector<RowVectorPtr>& results) {
+    std::vector<std::shared_ptr<Task>> tasks;
+    for (auto i = 0; i < kNumPartitions; ++i) {
+      auto plan = PlanBuilder().exchange(rowType, "Presto").planFragment();
+      auto task = Task::create(
+          fmt::format("{}-consumer-{}", producerId, i),
+          std::move(plan),
+          i,
+          queryCtx,
+          Task::ExecutionMode::kParallel,
+          [&](RowVectorPtr vector, bool /*drained*/, ContinueFuture*) {
+            if (vector != nullptr) {
+              std::lock_guard<std::mutex> l(mutex_);
+              results.push_back(std::move(vector));
+            }
+            return BlockingReason::kNotBlocked;
+          });
+      task->start(1);
+      task->addSplit(
+          "0", Split(std::make_shared<RemoteConnectorSplit>(producerId)));
+      task->noMoreSplits("0");
+      tasks.push_back(std::move(task));
+    }
+    return tasks;
+  }
+
+  static int64_t numInProcessPages(const std::shared_ptr<Task>& task) {
+    const auto stats = toPlanStats(task->taskStats());
+    const auto& customStats = stats.at("0").customStats;
+    const auto it = customStats.find("inProcessExchangeSource.numPages");
+    return it == customStats.end() ? 0 : it->second.sum;
+  }
+
+  std::mutex mutex_;
+};
+
+TEST_F(InProcessExchangeTest, sameQuery) {
+  const auto vectors = makeVectors();
+  const auto rowType = asRowType(vectors[0]->type());
+  auto queryCtx = core::QueryCtx::create(driverExecutor_.get());
+
+  const std::string producerId{"in-process://same-query-producer"};
+  auto producer = startProducer(producerId, vectors, queryCtx);
+  std::vector<RowVectorPtr> results;
+  auto consumers = startConsumers(producerId, rowType, queryCtx, results);
+
+  ASSERT_TRUE(waitForTaskCompletion(producer.get()));
+  for (const auto& consumer : consumers) {
+    ASSERT_TRUE(waitForTaskCompletion(consumer.get()));
+    ASSERT_GT(numInProcessPages(consumer), 0);
+  }
+
+  // A page with most of the rows of an input wraps them in dictionaries. The
+  // rows of the smaller pages are copied.
+  ASSERT_FALSE(results.empty());
+  int32_t numWrapped = 0;
+  for (const auto& result : results) {
+    const auto encoding = result->childAt(0)->encoding();
+    if (encoding == VectorEncoding::Simple::DICTIONARY) {
+      ++numWrapped;
+    } else {
+      ASSERT_EQ(encoding, VectorEncoding::Simple::FLAT);
+    }
+    for (const auto& child : result->children()) {
+      ASSERT_EQ(child->encoding(), encoding);
+    }
+    ASSERT_EQ(result->pool()->root(), queryCtx->pool());
+  }
+  ASSERT_LE(numWrapped, vectors.size());
+  assertEqualResults(vectors, results);
+
+  // A wrapped page is charged the retained size of the whole input.
+  uint64_t minRetainedSize = std::numeric_limits<uint64_t>::max();
+  for (const auto& vector : vectors) {
+    minRetainedSize = std::min(minRetainedSize, vector->retainedSize());
+  }
+  const auto producerStats = toPlanStats(producer->taskStats()).at("1");
+  ASSERT_GE(producerStats.outputBytes, numWrapped * minRetainedSize);
+}
+
+TEST_F(InProcessExchangeTest, chargeReplicatedInputOnce) {
+  // The keys are null, so all rows are replicated to every partition and each
+  // destination wraps the whole input. The null rows are much smaller than
+  // the retained size of their vectors.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 3; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [](auto row) { return row; }, nullEvery(1)),
+        makeFlatVector<std::string>(
+            1'000,
+            [](auto row) { return fmt::format("string {}", row); },
+            nullEvery(1)),
+    }));
+  }
+  const auto rowType = asRowType(vectors[0]->type());
+  auto queryCtx = core::QueryCtx::create(driverExecutor_.get());
+
+  const std::string producerId{"in-process://replicated-producer"};
+  auto producer = startProducer(producerId, vectors, queryCtx, true);
+  std::vector<RowVectorPtr> results;
+  auto consumers = startConsumers(producerId, rowType, queryCtx, results);
+  ASSERT_TRUE(waitForTaskCompletion(producer.get()));
+  for (const auto& consumer : consumers) {
+    ASSERT_TRUE(waitForTaskCompletion(consumer.get()));
+  }
+  vector_size_t numRows = 0;
+  for (const auto& result : results) {
+    numRows += result->size();
+  }
+  ASSERT_EQ(numRows, kNumPartitions * 3'000);
+
+  // Each input is charged its retained size once, not once per destination.
+  uint64_t retainedSize = 0;
+  for (const auto& vector : vectors) {
+    retainedSize += vector->retainedSize();
+  }
+  const auto producerStats = toPlanStats(producer->taskStats()).at("1");
+  ASSERT_GE(producerStats.outputBytes, retainedSize);
+  ASSERT_LT(producerStats.outputBytes, kNumPartitions * retainedSize);
+}
+
+TEST_F(InProcessExchangeTest, copySmallPages) {
+  // Finds a key in another partition than 0.
+  const auto keys = makeRowVector(
+      {makeFlatVector<int64_t>(1'000, [](auto row) { return row; })});
+  std::vector<uint32_t> partitions;
+  HashPartitionFunction(false, kNumPartitions, asRowType(keys->type()), {0})
+      .partition(*keys, partitions);
+  int64_t otherKey = 1;
+  while (partitions[otherKey] == partitions[0]) {
+    ++otherKey;
+  }
+
+  // Each input has one row for the other partition.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 3; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return row == 0 ? otherKey : 0; }),
+        makeFlatVector<std::string>(
+            1'000, [](auto row) { return fmt::format("string {}", row); }),
+    }));
+  }
+  const auto rowType = asRowType(vectors[0]->type());
+  auto queryCtx = core::QueryCtx::create(driverExecutor_.get());
+
+  const std::string producerId{"in-process://copy-small-pages-producer"};
+  auto producer = startProducer(producerId, vectors, queryCtx);
+  std::vector<RowVectorPtr> results;
+  auto consumers = startConsumers(producerId, rowType, queryCtx, results);
+  ASSERT_TRUE(waitForTaskCompletion(producer.get()));
+  for (const auto& consumer : consumers) {
+    ASSERT_TRUE(waitForTaskCompletion(consumer.get()));
+  }
+
+  // The single rows are copied instead of keeping their inputs alive.
+  int32_t numCopied = 0;
+  for (const auto& result : results) {
+    if (result->size() == 1) {
+      ASSERT_EQ(result->childAt(0)->encoding(), VectorEncoding::Simple::FLAT);
+      ++numCopied;
+    }
+  }
+  ASSERT_EQ(numCopied, vectors.size());
+  assertEqualResults(vectors, results);
+}
+
+TEST_F(InProcessExchangeTest, otherQuery) {
+  const auto vectors = makeVectors();
+  const auto rowType = asRowType(vectors[0]->type());
+  auto producerQueryCtx = core::QueryCtx::create(driverExecutor_.get());
+  auto consumerQueryCtx = core::QueryCtx::create(driverExecutor_.get());
+
+  const std::string producerId{"in-process://other-query-producer"};
+  auto producer = startProducer(producerId, vectors, producerQueryCtx);
+  std::vector<RowVectorPtr> results;
+  auto consumers =
+      startConsumers(producerId, rowType, consumerQueryCtx, results);
+
+  ASSERT_TRUE(waitForTaskCompletion(producer.get()));
+  for (const auto& consumer : consumers) {
+    ASSERT_TRUE(waitForTaskCompletion(consumer.get()));
+  }
+
+  // The vectors are copied into the memory of the consumers.
+  ASSERT_FALSE(results.empty());
+  for (const auto& result : results) {
+    ASSERT_EQ(result->pool()->root(), consumerQueryCtx->pool());
+    for (const auto& child : result->children()) {
+      ASSERT_EQ(child->encoding(), VectorEncoding::Simple::FLAT);
+    }
+  }
+  assertEqualResults(vectors, results);
+}
+
+TEST_F(InProcessExchangeTest, vectorPage) {
+  auto vector = makeRowVector({makeFlatVector<int32_t>({1, 2, 3})});
+  VectorPage page(vector, 100, nullptr);
+  ASSERT_EQ(page.size(), 100);
+  ASSERT_EQ(page.numRows(), 3);
+  VELOX_ASSERT_UNSUPPORTED_THROW(
+      page.prepareStreamForDeserialize(), "VectorPage is not serialized");
+
+  auto copy = VectorPage::fromIOBuf(page.getIOBuf());
+  ASSERT_EQ(copy->vector(), vector);
+  ASSERT_EQ(copy->size(), 100);
+
+  VELOX_ASSERT_THROW(
+      VectorPage::fromIOBuf(folly::IOBuf::copyBuffer("not a vector page")),
+      "IOBuf does not carry a VectorPage");
+}
+} // namespace
+} // namespace facebook::velox::exec::test
@@ -17,6 +17,7 @@
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
 #include "velox/exec/OperatorType.h"
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/SkewedHashPartitionFunction.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -1209,6 +1210,193 @@ TEST_F(LocalPartitionTest, vectorPool) {
   ASSERT_FALSE(vectorPool.pop());
 }
 
+TEST_F(LocalPartitionTest, shardedQueue) {
+  const auto data = makeRowVector({makeFlatSequence<int64_t>(0, 10)});
+  core::PlanFragment planFragment{
+      PlanBuilder().values({data}).planNode()};
+  auto task = Task::create(
+      "shardedQueue",
+      std::move(planFragment),
+      0,
+      core::QueryCtx::create(driverExecutor_.get()),
+      Task::ExecutionMode::kParallel);
+  constexpr int kNumProducers = 3;
+  std::vector<std::unique_ptr<DriverCtx>> producerCtxs;
+  for (auto i = 0; i < kNumProducers; ++i) {
+    producerCtxs.push_back(std::make_unique<DriverCtx>(task, i, 0, 0, 0));
+  }
+
+  const int64_t vectorBytes = data->retainedSize();
+  auto memoryManager =
+      std::make_shared<LocalExchangeMemoryManager>(4 * vectorBytes);
+  LocalExchangeQueue queue(
+      memoryManager,
+      std::make_shared<LocalExchangeVectorPool>(0),
+      0,
+      /*numShards=*/2);
+  for (auto i = 0; i < kNumProducers; ++i) {
+    queue.addProducer();
+  }
+  queue.noMoreProducers();
+
+  RowVectorPtr output;
+  bool drained{false};
+  ContinueFuture consumerFuture;
+  ASSERT_EQ(
+      queue.next(&consumerFuture, pool(), &output, drained),
+      BlockingReason::kWaitForProducer);
+  ASSERT_FALSE(consumerFuture.isReady());
+
+  // Each producer enqueues its own copies of 'data' in order. The 4th vector
+  // reaches the buffer limit and blocks its producer.
+  constexpr int kVectorsPerProducer = 2;
+  std::vector<RowVectorPtr> producerVectors[kNumProducers];
+  std::vector<ContinueFuture> producerFutures;
+  for (auto round = 0; round < kVectorsPerProducer; ++round) {
+    for (auto producer = 0; producer < kNumProducers; ++producer) {
+      ScopedDriverThreadContext driverThreadCtx(producerCtxs[producer].get());
+      auto vector = makeRowVector({makeFlatSequence<int64_t>(0, 10)});
+      producerVectors[producer].push_back(vector);
+      ContinueFuture future;
+      const auto reason = queue.enqueue(vector, vectorBytes, &future);
+      if (memoryManager->bufferedBytes() >= 4 * vectorBytes) {
+        ASSERT_EQ(reason, BlockingReason::kWaitForConsumer);
+        producerFutures.push_back(std::move(future));
+      } else {
+        ASSERT_EQ(reason, BlockingReason::kNotBlocked);
+      }
+    }
+  }
+  ASSERT_TRUE(consumerFuture.isReady());
+  ASSERT_EQ(producerFutures.size(), 3);
+
+  // The vectors of each producer come out in the order they were enqueued.
+  std::vector<int> nextVector(kNumProducers, 0);
+  for (auto i = 0; i < kNumProducers * kVectorsPerProducer; ++i) {
+    ContinueFuture future;
+    ASSERT_EQ(
+        queue.next(&future, pool(), &output, drained),
+        BlockingReason::kNotBlocked);
+    ASSERT_NE(output, nullptr);
+    bool found{false};
+    for (auto producer = 0; producer < kNumProducers; ++producer) {
+      if (nextVector[producer] < kVectorsPerProducer &&
+          output == producerVectors[producer][nextVector[producer]]) {
+        ++nextVector[producer];
+        found = true;
+        break;
+      }
+    }
+    ASSERT_TRUE(found);
+  }
+  ASSERT_EQ(memoryManager->bufferedBytes(), 0);
+  for (auto& future : producerFutures) {
+    ASSERT_TRUE(future.isReady());
+  }
+
+  ASSERT_EQ(
+      queue.next(&consumerFuture, pool(), &output, drained),
+      BlockingReason::kWaitForProducer);
+  for (auto i = 0; i < kNumProducers; ++i) {
+    queue.noMoreData();
+  }
+  ASSERT_TRUE(consumerFuture.isReady());
+  ASSERT_EQ(
+      queue.next(&consumerFuture, pool(), &output, drained),
+      BlockingReason::kNotBlocked);
+  ASSERT_EQ(output, nullptr);
+  ASSERT_TRUE(queue.isFinished());
+}
+
+TEST_P(LocalPartitionTestParametrized, shardedQueues) {
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 30; ++i) {
+    vectors.push_back(
+        makeRowVector({makeFlatSequence<int32_t>(i * 100, 100)}));
+  }
+  createDuckDbTable(vectors);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto valuesNode = [&](int start, int end) {
+    return PlanBuilder(planNodeIdGenerator)
+        .values(
+            std::vector<RowVectorPtr>(
+                vectors.begin() + start, vectors.begin() + end))
+        .planNode();
+  };
+
+  for (const auto& keys :
+       {std::vector<std::string>{}, std::vector<std::string>{"c0"}}) {
+    SCOPED_TRACE(fmt::format("keys: {}", folly::join(",", keys)));
+    auto plan = PlanBuilder(planNodeIdGenerator)
+                    .localPartition(
+                        keys,
+                        {valuesNode(0, 10),
+                         valuesNode(10, 20),
+                         valuesNode(20, 30)})
+                    .partialAggregation({}, {"count(1)", "sum(c0)"})
+                    .localGather()
+                    .finalAggregation()
+                    .planNode();
+
+    AssertQueryBuilder queryBuilder(plan, duckDbQueryRunner_);
+    applyTestParameters(queryBuilder);
+    queryBuilder.maxDrivers(4)
+        .config(core::QueryConfig::kLocalExchangeQueueShards, "3")
+        .config(core::QueryConfig::kMaxLocalExchangeBufferSize, "100")
+        .assertResults("SELECT count(1), sum(c0) FROM tmp");
+  }
+}
+
+TEST_F(LocalPartitionTest, skewedHashJoin) {
+  // Every other probe row has the heavy key 7.
+  std::vector<RowVectorPtr> probeVectors;
+  for (auto i = 0; i < 20; ++i) {
+    probeVectors.push_back(
+        makeRowVector({makeFlatVector<int32_t>(100, [&](auto row) {
+          return row % 2 == 0 ? 7 : (i * 100 + row) % 50;
+        })}));
+  }
+  const auto buildVector = makeRowVector(
+      {"u0", "u1"},
+      {makeFlatSequence<int32_t>(0, 50), makeFlatSequence<int64_t>(0, 50)});
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", {buildVector});
+
+  // The probe side spreads the rows with heavy keys found in the first 100
+  // rows of each driver over all the probe drivers.
+  const auto partitionFunctionSpec =
+      std::make_shared<SkewedHashPartitionFunctionSpec>(
+          asRowType(probeVectors[0]->type()),
+          std::vector<column_index_t>{0},
+          SkewedHashPartitionFunction::Mode::kSpread,
+          std::vector<uint64_t>{},
+          100);
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto plan =
+      PlanBuilder(planNodeIdGenerator)
+          .values(probeVectors)
+          .addNode([&](std::string id, core::PlanNodePtr source) {
+            return std::make_shared<core::LocalPartitionNode>(
+                id,
+                core::LocalPartitionNode::Type::kRepartition,
+                false,
+                partitionFunctionSpec,
+                std::vector<core::PlanNodePtr>{std::move(source)});
+          })
+          .hashJoin(
+              {"c0"},
+              {"u0"},
+              PlanBuilder(planNodeIdGenerator).values({buildVector}).planNode(),
+              "",
+              {"c0", "u1"})
+          .planNode();
+
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .maxDrivers(4)
+      .assertResults("SELECT c0, u1 FROM t, u WHERE c0 = u0");
+}
+
 TEST_F(LocalPartitionTest, barrier) {
   const auto rowType = ROW({"c0"}, {BIGINT()});
   std::vector<RowVectorPtr> vectors;
@@ -57,9 +57,11 @@ class MultiFragmentTest : public HiveConnectorTestBase,
     params.emplace_back("Presto", common::CompressionKind_NONE);
     params.emplace_back("CompactRow", common::CompressionKind_NONE);
     params.emplace_back("UnsafeRow", common::CompressionKind_NONE);
+    params.emplace_back("PrestoEncoded", common::CompressionKind_NONE);
     params.emplace_back("Presto", common::CompressionKind_LZ4);
     params.emplace_back("CompactRow", common::CompressionKind_LZ4);
     params.emplace_back("UnsafeRow", common::CompressionKind_LZ4);
+    params.emplace_back("PrestoEncoded", common::CompressionKind_LZ4);
     return params;
   }
 
@@ -2922,7 +2924,8 @@ TEST_P(MultiFragmentTest, mergeSmallBatchesInExchange) {
     ASSERT_EQ(numPages, stats.customStats.at("numReceivedPages").sum);
   };
 
-  if (GetParam().serdeKind == "Presto") {
+  if (GetParam().serdeKind == "Presto" ||
+      GetParam().serdeKind == "PrestoEncoded") {
     test(1, 1'000);
     test(1'000, 56);
     test(10'000, 7);
@@ -3453,7 +3456,8 @@ TEST_P(MultiFragmentTest, batchBytes) {
   // The fix prevents INT32_MAX overflow by controlling the merge size, but
   // fine-grained batch control requires deeper changes to PrestoVectorSerde.
 
-  if (GetParam().serdeKind == "Presto") {
+  if (GetParam().serdeKind == "Presto" ||
+      GetParam().serdeKind == "PrestoEncoded") {
     // Current implementation merges all pages and processes in one batch
     // The key improvement is preventing overflow, not fine-grained batching
     test(100, 100, 1, 1); // Expect single batch with all data
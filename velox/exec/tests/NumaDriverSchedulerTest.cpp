@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/NumaDriverScheduler.h"
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/Task.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
+
+namespace facebook::velox::exec::test {
+namespace {
+
+class NumaDriverSchedulerTest : public OperatorTestBase {
+ protected:
+  std::vector<RowVectorPtr> makeVectors(int32_t numVectors) {
+    std::vector<RowVectorPtr> vectors;
+    for (auto i = 0; i < numVectors; ++i) {
+      vectors.push_back(makeRowVector(
+          {makeFlatVector<int64_t>(1'000, [i](auto row) { return i + row; })}));
+    }
+    return vectors;
+  }
+
+  std::shared_ptr<Task> makeTask(const std::string& taskId) {
+    return Task::create(
+        taskId,
+        core::PlanFragment{PlanBuilder().values(makeVectors(1)).planNode()},
+        0,
+        core::QueryCtx::create(driverExecutor_.get()),
+        Task::ExecutionMode::kParallel);
+  }
+};
+
+TEST_F(NumaDriverSchedulerTest, nodeOf) {
+  NumaDriverScheduler scheduler(
+      {.nodeCpus = {{0}, {1}}, .numThreadsPerNode = 1});
+  ASSERT_EQ(scheduler.numNodes(), 2);
+
+  auto task1 = makeTask("task1");
+  auto task2 = makeTask("task2");
+  auto task3 = makeTask("task3");
+  // Tasks go to the nodes round robin.
+  ASSERT_EQ(scheduler.nodeOf(task1, kUngroupedGroupId), 0);
+  ASSERT_EQ(scheduler.nodeOf(task2, kUngroupedGroupId), 1);
+  ASSERT_EQ(scheduler.nodeOf(task1, kUngroupedGroupId), 0);
+  ASSERT_EQ(scheduler.nodeOf(task3, kUngroupedGroupId), 0);
+
+  // Split groups go to consecutive nodes from the node of the task.
+  for (uint32_t group = 0; group < 4; ++group) {
+    ASSERT_EQ(scheduler.nodeOf(task1, group), group % 2);
+    ASSERT_EQ(scheduler.nodeOf(task2, group), (group + 1) % 2);
+  }
+
+  // The drivers of 'task1', which started while no other task was alive,
+  // are spread over the nodes. The drivers of the other tasks are not.
+  for (auto driverId = 0; driverId < 4; ++driverId) {
+    ASSERT_EQ(
+        scheduler.nodeOf(task1, kUngroupedGroupId, driverId), driverId % 2);
+    ASSERT_EQ(scheduler.nodeOf(task2, kUngroupedGroupId, driverId), 1);
+    ASSERT_EQ(scheduler.nodeOf(task3, kUngroupedGroupId, driverId), 0);
+  }
+
+  // A task that starts after the others are gone is spread again.
+  task1.reset();
+  task2.reset();
+  task3.reset();
+  auto task4 = makeTask("task4");
+  ASSERT_EQ(scheduler.nodeOf(task4, kUngroupedGroupId, 0), 1);
+  ASSERT_EQ(scheduler.nodeOf(task4, kUngroupedGroupId, 1), 0);
+}
+
+TEST_F(NumaDriverSchedulerTest, queries) {
+  NumaDriverScheduler scheduler;
+  const auto vectors = makeVectors(10);
+  createDuckDbTable(vectors);
+
+  const auto plan = PlanBuilder()
+                        .values(vectors, /*parallelizable=*/true)
+                        .project({"c0 % 7 AS k", "c0"})
+                        .singleAggregation({"k"}, {"sum(c0)"})
+                        .planNode();
+  for (auto i = 0; i < 2 * scheduler.numNodes(); ++i) {
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .queryCtx(core::QueryCtx::create(&scheduler))
+            .maxDrivers(4)
+            .assertResults("SELECT c0 % 7, sum(c0) FROM tmp GROUP BY 1");
+#ifdef __linux__
+    // The threads of each node are bound to its CPUs.
+    const auto stats = task->taskStats();
+    ASSERT_GT(stats.numLocalNumaDriverRuns, 0);
+    ASSERT_EQ(stats.numOffNodeNumaDriverRuns, 0);
+#endif
+  }
+
+  uint64_t numRuns{0};
+  for (const auto nodeRuns : scheduler.stats().numRuns) {
+    ASSERT_GT(nodeRuns, 0);
+    numRuns += nodeRuns;
+  }
+  ASSERT_GT(numRuns, 0);
+}
+
+TEST_F(NumaDriverSchedulerTest, invalidOptions) {
+  VELOX_ASSERT_THROW(
+      NumaDriverScheduler({.nodeCpus = {{0}, {}}}), "NUMA node 1 has no CPUs");
+  VELOX_ASSERT_THROW(
+      NumaDriverScheduler({.nodeCpus = {{0, 1}, {1}}}),
+      "CPU 1 is in more than one NUMA node");
+  VELOX_ASSERT_THROW(
+      NumaDriverScheduler({.nodeCpus = {{0}}, .numThreadsPerNode = -1}),
+      "(-1 vs. 0)");
+}
+} // namespace
+} // namespace facebook::velox::exec::test
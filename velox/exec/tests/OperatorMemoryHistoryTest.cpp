@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/OperatorMemoryHistory.h"
+
+#include "velox/exec/OperatorType.h"
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+
+namespace facebook::velox::exec::test {
+namespace {
+
+class OperatorMemoryHistoryTest : public OperatorTestBase {
+ protected:
+  void TearDown() override {
+    OperatorMemoryHistory::setInstance(nullptr);
+    OperatorTestBase::TearDown();
+  }
+
+  std::vector<RowVectorPtr> makeVectors(int32_t numVectors) {
+    std::vector<RowVectorPtr> vectors;
+    for (auto i = 0; i < numVectors; ++i) {
+      vectors.push_back(makeRowVector({
+          makeFlatVector<int64_t>(1'000, [i](auto row) { return i - row; }),
+          makeFlatVector<std::string>(
+              1'000, [](auto row) { return fmt::format("string {}", row); }),
+      }));
+    }
+    return vectors;
+  }
+
+  static int64_t customStat(
+      const std::shared_ptr<Task>& task,
+      const core::PlanNodeId& nodeId,
+      std::string_view name) {
+    const auto stats = toPlanStats(task->taskStats());
+    const auto& customStats = stats.at(nodeId).customStats;
+    const auto it = customStats.find(std::string(name));
+    return it == customStats.end() ? 0 : it->second.sum;
+  }
+};
+
+TEST_F(OperatorMemoryHistoryTest, inputSizeBucket) {
+  ASSERT_EQ(OperatorMemoryHistory::inputSizeBucket(0), 0);
+  ASSERT_EQ(OperatorMemoryHistory::inputSizeBucket(1), 0);
+  ASSERT_EQ(OperatorMemoryHistory::inputSizeBucket(1'023), 9);
+  ASSERT_EQ(OperatorMemoryHistory::inputSizeBucket(1'024), 10);
+  ASSERT_EQ(OperatorMemoryHistory::inputSizeBucket(1ULL << 40), 40);
+}
+
+TEST_F(OperatorMemoryHistoryTest, fingerprint) {
+  const auto vectors = makeVectors(1);
+  const auto plan =
+      PlanBuilder().values(vectors).orderBy({"c0"}, false).planNode();
+  const auto otherPlan =
+      PlanBuilder().values(vectors).orderBy({"c1"}, false).planNode();
+
+  const auto fingerprint =
+      OperatorMemoryHistory::fingerprint(OperatorType::kOrderBy, *plan);
+  ASSERT_EQ(
+      fingerprint,
+      OperatorMemoryHistory::fingerprint(OperatorType::kOrderBy, *plan));
+  ASSERT_NE(
+      fingerprint,
+      OperatorMemoryHistory::fingerprint(OperatorType::kOrderBy, *otherPlan));
+  ASSERT_NE(
+      fingerprint,
+      OperatorMemoryHistory::fingerprint(OperatorType::kHashBuild, *plan));
+}
+
+TEST_F(OperatorMemoryHistoryTest, file) {
+  const auto directory = TempDirectoryPath::create();
+  const auto path = directory->getPath() + "/history";
+  const OperatorMemoryHistory::Key key{"OrderBy-1", 10};
+  const OperatorMemoryHistory::Key otherKey{"OrderBy-1", 11};
+  {
+    FileOperatorMemoryHistory history(path);
+    ASSERT_FALSE(history.peakBytes(key).has_value());
+
+    history.record(key, 800);
+    ASSERT_EQ(history.peakBytes(key), 800);
+    // A higher peak replaces the recorded one.
+    history.record(key, 1'600);
+    ASSERT_EQ(history.peakBytes(key), 1'600);
+    // A lower peak decays the recorded one.
+    history.record(key, 100);
+    ASSERT_EQ(history.peakBytes(key), 1'400);
+    history.record(otherKey, 5'000);
+  }
+
+  // The destructor writes the file.
+  FileOperatorMemoryHistory history(path);
+  ASSERT_EQ(history.peakBytes(key), 1'400);
+  ASSERT_EQ(history.peakBytes(otherKey), 5'000);
+  ASSERT_FALSE(history.peakBytes({"OrderBy-2", 10}).has_value());
+}
+
+TEST_F(OperatorMemoryHistoryTest, reserve) {
+  const auto directory = TempDirectoryPath::create();
+  auto history = std::make_shared<FileOperatorMemoryHistory>(
+      directory->getPath() + "/history");
+  OperatorMemoryHistory::setInstance(history);
+
+  const auto vectors = makeVectors(10);
+  core::PlanNodeId orderById;
+  const auto plan = PlanBuilder()
+                        .values(vectors)
+                        .orderBy({"c0"}, false)
+                        .capturePlanNodeId(orderById)
+                        .planNode();
+  const auto fingerprint =
+      OperatorMemoryHistory::fingerprint(OperatorType::kOrderBy, *plan);
+
+  // The first run finds no history and records its peak.
+  std::shared_ptr<Task> task;
+  AssertQueryBuilder(plan).copyResults(pool(), task);
+  ASSERT_EQ(
+      customStat(task, orderById, OperatorMemoryReserver::kNumReservations), 0);
+  bool recorded = false;
+  for (auto bucket = 0; bucket < 64; ++bucket) {
+    const auto peakBytes = history->peakBytes({fingerprint, bucket});
+    if (peakBytes.has_value()) {
+      ASSERT_GT(peakBytes.value(), 0);
+      recorded = true;
+    }
+  }
+  ASSERT_TRUE(recorded);
+
+  // Makes the past runs look heavy, so that the next run reserves memory as
+  // soon as its input reaches each bucket.
+  constexpr uint64_t kPeakBytes{64 << 20};
+  for (auto bucket = 0; bucket < 64; ++bucket) {
+    history->record({fingerprint, bucket}, kPeakBytes);
+  }
+  AssertQueryBuilder(plan).copyResults(pool(), task);
+  ASSERT_EQ(
+      customStat(task, orderById, OperatorMemoryReserver::kNumReservations), 1);
+  ASSERT_GT(
+      customStat(task, orderById, OperatorMemoryReserver::kReservedBytes), 0);
+
+  // The query config turns the history off.
+  AssertQueryBuilder(plan)
+      .config(core::QueryConfig::kOperatorMemoryHistoryEnabled, "false")
+      .copyResults(pool(), task);
+  ASSERT_EQ(
+      customStat(task, orderById, OperatorMemoryReserver::kNumReservations), 0);
+}
+} // namespace
+} // namespace facebook::velox::exec::test
@@ -1324,6 +1324,53 @@ DEBUG_ONLY_TEST_F(OrderByTest, reclaimFromOrderBy) {
   waitForAllTasksToBeDeleted();
 }
 
+DEBUG_ONLY_TEST_F(OrderByTest, reclaimCooperatively) {
+  std::vector<RowVectorPtr> vectors = createVectors(8, rowType_, fuzzerOpts_);
+  createDuckDbTable(vectors);
+  std::atomic_int numInputs{0};
+  ContinueFuture reclaimFuture = ContinueFuture::makeEmpty();
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::Driver::runInternal::addInput",
+      std::function<void(Operator*)>(([&](Operator* op) {
+        if (op->operatorType() != "OrderBy") {
+          return;
+        }
+        if (++numInputs != 5) {
+          return;
+        }
+        // The driver spills the OrderBy at its next operator boundary.
+        reclaimFuture =
+            op->operatorCtx()->task()->requestCooperativeReclaim(1);
+      })));
+
+  const auto spillDirectory = TempDirectoryPath::create();
+  core::PlanNodeId orderById;
+  auto task =
+      AssertQueryBuilder(duckDbQueryRunner_)
+          .spillDirectory(spillDirectory->getPath())
+          .config(core::QueryConfig::kSpillEnabled, true)
+          .config(core::QueryConfig::kOrderBySpillEnabled, true)
+          .plan(
+              PlanBuilder()
+                  .values(vectors)
+                  .orderBy({"c0 ASC NULLS LAST"}, false)
+                  .capturePlanNodeId(orderById)
+                  .planNode())
+          .assertResults("SELECT * FROM tmp ORDER BY c0 ASC NULLS LAST");
+  ASSERT_TRUE(reclaimFuture.valid());
+  ASSERT_TRUE(reclaimFuture.isReady());
+  auto reclaimStats = task->finishCooperativeReclaim();
+  ASSERT_GT(reclaimStats.reclaimedBytes, 0);
+  ASSERT_GT(toPlanStats(task->taskStats()).at(orderById).spilledBytes, 0);
+
+  // A finished task has no drivers to reclaim from.
+  ASSERT_TRUE(task->requestCooperativeReclaim(1).isReady());
+  reclaimStats = task->finishCooperativeReclaim();
+  ASSERT_EQ(reclaimStats.reclaimedBytes, 0);
+  task.reset();
+  waitForAllTasksToBeDeleted();
+}
+
 DEBUG_ONLY_TEST_F(OrderByTest, reclaimFromEmptyOrderBy) {
   const std::vector<RowVectorPtr> vectors =
       createVectors(8, rowType_, fuzzerOpts_);
@@ -16,10 +16,13 @@
 #include "velox/exec/PartitionedOutput.h"
 #include <gtest/gtest.h>
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/HashPartitionFunction.h"
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/SkewedHashPartitionFunction.h"
 #include "velox/exec/Task.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/serializers/PrestoSerializerDeserializationUtils.h"
 
 namespace facebook::velox::exec::test {
 
@@ -282,6 +285,175 @@ TEST_P(PartitionedOutputTest, multipleFlushCycles) {
       static_cast<int64_t>(VectorSerde::kindByName(GetParam())));
 }
 
+TEST_P(PartitionedOutputTest, replicateHeavyKeys) {
+  auto input = makeRowVector(
+      {"p1", "v1"},
+      {makeFlatVector<int32_t>({7, 1, 7, 2}),
+       makeFlatVector<std::string>({"a", "b", "c", "d"})});
+  auto heavyKey = makeRowVector({makeFlatVector<int32_t>({7})});
+  HashPartitionFunction hashFunction(
+      false, 2, asRowType(heavyKey->type()), {0});
+  std::vector<uint32_t> partitions;
+  hashFunction.partition(*heavyKey, partitions);
+
+  // The rows with the heavy key 7 go to both partitions.
+  core::PlanNodeId partitionNodeId;
+  auto plan =
+      PlanBuilder()
+          .values({input}, false, 13)
+          .partitionedOutput(
+              {"p1"},
+              2,
+              false,
+              std::make_shared<SkewedHashPartitionFunctionSpec>(
+                  asRowType(input->type()),
+                  std::vector<column_index_t>{0},
+                  SkewedHashPartitionFunction::Mode::kReplicate,
+                  std::vector<uint64_t>{hashFunction.hashes()[0]}),
+              std::vector<std::string>{"v1"},
+              GetParam())
+          .capturePlanNodeId(partitionNodeId)
+          .planNode();
+
+  auto taskId = "local://test-partitioned-output-replicate-heavy-keys-0";
+  auto task = Task::create(
+      taskId,
+      core::PlanFragment{plan},
+      0,
+      createQueryContext({}),
+      Task::ExecutionMode::kParallel);
+  task->start(1);
+
+  const auto partition0 = getAllData(taskId, 0);
+  const auto partition1 = getAllData(taskId, 1);
+  ASSERT_FALSE(partition0.empty());
+  ASSERT_FALSE(partition1.empty());
+
+  ASSERT_TRUE(waitForTaskCompletion(
+      task.get(),
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::seconds(10))
+          .count()));
+
+  const auto planStats = toPlanStats(task->taskStats());
+  ASSERT_EQ(planStats.at(partitionNodeId).inputRows, 13 * 4);
+  ASSERT_EQ(planStats.at(partitionNodeId).outputRows, 13 * (2 * 2 + 2));
+}
+
+TEST_P(PartitionedOutputTest, adaptiveCompression) {
+  if (GetParam() != "Presto") {
+    GTEST_SKIP() << "Adaptive compression is only supported by Presto serde";
+  }
+  auto input = makeRowVector(
+      {"p1", "v1"},
+      {makeFlatVector<int32_t>(1'000, [](auto row) { return row % 2; }),
+       makeFlatVector<std::string>(
+           1'000, [](auto row) { return std::string(100, 'a' + row % 3); })});
+
+  core::PlanNodeId partitionNodeId;
+  auto plan = PlanBuilder()
+                  .values({input}, false, 10)
+                  .partitionedOutput(
+                      {"p1"}, 2, std::vector<std::string>{"v1"}, GetParam())
+                  .capturePlanNodeId(partitionNodeId)
+                  .planNode();
+
+  auto taskId = "local://test-partitioned-output-adaptive-compression-0";
+  auto task = Task::create(
+      taskId,
+      core::PlanFragment{plan},
+      0,
+      createQueryContext(
+          {{core::QueryConfig::kShuffleAdaptiveCompressionEnabled, "true"}}),
+      Task::ExecutionMode::kParallel);
+  task->start(1);
+
+  for (auto destination = 0; destination < 2; ++destination) {
+    auto pages = getAllData(taskId, destination);
+    ASSERT_FALSE(pages.empty());
+    for (auto& page : pages) {
+      page->coalesce();
+      // The codec marker follows the number of rows and records the codec.
+      const auto codecMarker = static_cast<int8_t>(page->data()[4]);
+      ASSERT_TRUE(
+          serializer::presto::detail::codecKind(codecMarker).has_value());
+    }
+  }
+
+  ASSERT_TRUE(waitForTaskCompletion(
+      task.get(),
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::seconds(10))
+          .count()));
+
+  const auto planStats = toPlanStats(task->taskStats());
+  const auto& customStats = planStats.at(partitionNodeId).customStats;
+  ASSERT_EQ(
+      customStats.count(
+          fmt::format("{}.NONE", Operator::kShuffleAdaptiveCompressionPages)),
+      0);
+  int64_t numCompressedPages{0};
+  for (const auto* codec : {"LZ4", "ZSTD_FAST", "ZSTD"}) {
+    auto it = customStats.find(fmt::format(
+        "{}.{}", Operator::kShuffleAdaptiveCompressionPages, codec));
+    if (it != customStats.end()) {
+      numCompressedPages += it->second.sum;
+    }
+  }
+  ASSERT_GT(numCompressedPages, 0);
+}
+
+TEST_P(PartitionedOutputTest, scatterToManyPartitions) {
+  // Null keys and the first row go to all partitions.
+  constexpr int32_t kNumPartitions = 100;
+  constexpr int32_t kNumRows = 1'000;
+  auto input = makeRowVector(
+      {"p1", "v1"},
+      {makeFlatVector<int32_t>(
+           kNumRows, [](auto row) { return row; }, nullEvery(97)),
+       makeFlatVector<std::string>(
+           kNumRows, [](auto row) { return std::string(row % 20, 'x'); })});
+  const int32_t numNullRows = (kNumRows + 96) / 97;
+
+  core::PlanNodeId partitionNodeId;
+  auto plan = PlanBuilder()
+                  .values({input}, false, 3)
+                  .partitionedOutput(
+                      {"p1"},
+                      kNumPartitions,
+                      true,
+                      std::vector<std::string>{"p1", "v1"},
+                      GetParam())
+                  .capturePlanNodeId(partitionNodeId)
+                  .planNode();
+
+  auto taskId = "local://test-partitioned-output-scatter-0";
+  auto task = Task::create(
+      taskId,
+      core::PlanFragment{plan},
+      0,
+      createQueryContext({}),
+      Task::ExecutionMode::kParallel);
+  task->start(1);
+
+  for (auto destination = 0; destination < kNumPartitions; ++destination) {
+    ASSERT_FALSE(getAllData(taskId, destination).empty());
+  }
+
+  ASSERT_TRUE(waitForTaskCompletion(
+      task.get(),
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::seconds(10))
+          .count()));
+
+  // The first row has a null key, so no other row is replicated.
+  const auto planStats = toPlanStats(task->taskStats());
+  ASSERT_EQ(planStats.at(partitionNodeId).inputRows, 3 * kNumRows);
+  ASSERT_EQ(
+      planStats.at(partitionNodeId).outputRows,
+      3 * (kNumRows + (kNumPartitions - 1) * numNullRows));
+}
+
 VELOX_INSTANTIATE_TEST_SUITE_P(
     PartitionedOutputTest,
     PartitionedOutputTest,
@@ -31,4 +31,19 @@ TEST(PlanNodeStatsTest, exprStatsTotal) {
   EXPECT_EQ(total.expressionStats["foo"], stats.expressionStats["foo"]);
 }
 
+TEST(PlanNodeStatsTest, perfCounters) {
+  PlanNodeStats stats;
+  ASSERT_EQ(stats.toString().find("IPC"), std::string::npos);
+
+  stats.customStats.emplace(OperatorStats::kPerfCycles, RuntimeMetric(200));
+  stats.customStats.emplace(
+      OperatorStats::kPerfInstructions, RuntimeMetric(300));
+  stats.customStats.emplace(OperatorStats::kPerfCacheMisses, RuntimeMetric(7));
+  stats.customStats.emplace(OperatorStats::kPerfBranchMisses, RuntimeMetric(3));
+  ASSERT_NE(
+      stats.toString().find(", IPC: 1.50, Cache misses: 7, Branch misses: 3"),
+      std::string::npos)
+      << stats.toString();
+}
+
 } // namespace facebook::velox::exec::test
@@ -2152,6 +2152,90 @@ TEST_F(RowContainerTest, extractSerializedRow) {
   }
 }
 
+TEST_F(RowContainerTest, compact) {
+  VectorFuzzer fuzzer(
+      {
+          .vectorSize = 1'000,
+          .nullRatio = 0.1,
+          .stringLength = 100,
+      },
+      pool());
+  const auto rowType =
+      ROW({BIGINT(), VARCHAR(), ARRAY(VARCHAR()), MAP(INTEGER(), VARCHAR())});
+  const auto data = fuzzer.fuzzInputRow(rowType);
+
+  // The rows have normalized keys.
+  auto rowContainerPtr = makeRowContainer(
+      {BIGINT()},
+      {VARCHAR(), ARRAY(VARCHAR()), MAP(INTEGER(), VARCHAR())},
+      /*isJoinBuild=*/false);
+  auto& rowContainer = *rowContainerPtr;
+  ASSERT_TRUE(rowContainer.canCompact());
+  auto rows = store(rowContainer, data);
+
+  // Erases every other row.
+  std::vector<char*> erased;
+  std::vector<char*> remaining;
+  std::vector<vector_size_t> remainingIndices;
+  for (auto i = 0; i < rows.size(); ++i) {
+    if (i % 2 == 0) {
+      erased.push_back(rows[i]);
+    } else {
+      remaining.push_back(rows[i]);
+      remainingIndices.push_back(i);
+    }
+  }
+  rowContainer.eraseRows(folly::Range(erased.data(), erased.size()));
+  const auto compactableBytes = rowContainer.compactableBytes();
+  ASSERT_GT(compactableBytes, 0);
+  const auto allocatedBytes = rowContainer.allocatedBytes();
+  // The copy holds the remaining rows and their strings.
+  ASSERT_GT(
+      rowContainer.compactionBytes(),
+      remaining.size() * rowContainer.fixedRowSize());
+
+  const auto movedRows = rowContainer.compact();
+  ASSERT_EQ(movedRows.size(), remaining.size());
+  ASSERT_LT(rowContainer.allocatedBytes(), allocatedBytes);
+  ASSERT_LT(rowContainer.compactableBytes(), compactableBytes);
+  ASSERT_EQ(rowContainer.numRows(), remaining.size());
+  RowContainerTestHelper(&rowContainer).checkConsistency();
+
+  // The rows keep their order.
+  std::vector<char*> newRows(remaining.size());
+  RowContainerIterator iter;
+  ASSERT_EQ(
+      rowContainer.listRows(&iter, newRows.size(), newRows.data()),
+      newRows.size());
+  for (auto i = 0; i < remaining.size(); ++i) {
+    ASSERT_EQ(movedRows.newRow(remaining[i]), newRows[i]);
+  }
+  VELOX_ASSERT_THROW(
+      movedRows.newRow(erased[0]), "Row was not moved by compact()");
+
+  auto copy = BaseVector::create<RowVector>(
+      rowType, static_cast<vector_size_t>(newRows.size()), pool());
+  for (auto i = 0; i < copy->childrenSize(); ++i) {
+    rowContainer.extractColumn(
+        newRows.data(), copy->size(), i, copy->childAt(i));
+  }
+  assertEqualVectors(
+      wrapInDictionary(makeIndices(remainingIndices), data), copy);
+
+  // New rows go into the compacted container.
+  auto* newRow = rowContainer.newRow();
+  ASSERT_EQ(rowContainer.numRows(), remaining.size() + 1);
+  ASSERT_EQ(std::count(newRows.begin(), newRows.end(), newRow), 0);
+}
+
+TEST_F(RowContainerTest, compactWithListRowIndex) {
+  // The row index of listRowsFast() can not be moved.
+  auto rowContainer = makeRowContainer(
+      {BIGINT()}, {VARCHAR()}, /*isJoinBuild=*/false, /*useListRowIndex=*/true);
+  ASSERT_FALSE(rowContainer->canCompact());
+  VELOX_ASSERT_THROW(rowContainer->compact(), "");
+}
+
 DEBUG_ONLY_TEST_F(RowContainerTest, eraseAfterOomStoringString) {
   auto rowContainer = makeRowContainer({VARCHAR()}, {});
 
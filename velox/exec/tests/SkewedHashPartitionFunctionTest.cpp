@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/SkewedHashPartitionFunction.h"
+
+#include <gtest/gtest.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+using namespace facebook;
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+class SkewedHashPartitionFunctionTest : public velox::test::VectorTestBase,
+                                        public testing::Test {
+ protected:
+  using Mode = SkewedHashPartitionFunction::Mode;
+
+  static void SetUpTestCase() {
+    memory::MemoryManager::testingSetInstance(memory::MemoryManager::Options{});
+  }
+
+  // Makes 'numRows' rows of which every other row has the heavy key 7 and the
+  // others have distinct keys.
+  RowVectorPtr makeSkewedInput(vector_size_t numRows) {
+    return makeRowVector({makeFlatVector<int64_t>(
+        numRows, [](auto row) { return row % 2 == 0 ? 7 : 1'000 + row; })});
+  }
+
+  // Returns the hash of the heavy key of makeSkewedInput().
+  uint64_t heavyKeyHash() {
+    const auto input = makeRowVector({makeFlatVector<int64_t>({7})});
+    HashPartitionFunction function(false, 4, asRowType(input->type()), {0});
+    std::vector<uint32_t> partitions;
+    function.partition(*input, partitions);
+    return function.hashes()[0];
+  }
+};
+
+TEST_F(SkewedHashPartitionFunctionTest, sketch) {
+  HeavyKeySketch sketch(64);
+  ASSERT_TRUE(sketch.heavyKeys(0.1).empty());
+  for (auto i = 0; i < 1'000; ++i) {
+    sketch.add(i % 3 == 0 ? 1 : 100 + i);
+    sketch.add(i % 5 == 0 ? 2 : 10'000 + i);
+  }
+  ASSERT_EQ(sketch.numAdded(), 2'000);
+  // Key 1 has a share of 1/6 and key 2 of 1/10. The counts are underestimated
+  // by at most 2'000 / 65.
+  ASSERT_EQ(sketch.heavyKeys(0.12), (folly::F14FastSet<uint64_t>{1}));
+  ASSERT_EQ(sketch.heavyKeys(0.05), (folly::F14FastSet<uint64_t>{1, 2}));
+  ASSERT_TRUE(sketch.heavyKeys(0.2).empty());
+}
+
+TEST_F(SkewedHashPartitionFunctionTest, noHeavyKeys) {
+  const auto input = makeSkewedInput(1'000);
+  const auto rowType = asRowType(input->type());
+  for (const bool localExchange : {false, true}) {
+    HashPartitionFunction hashFunction(localExchange, 4, rowType, {0});
+    SkewedHashPartitionFunction skewedFunction(
+        localExchange, 4, rowType, {0}, Mode::kReplicate, {});
+    std::vector<uint32_t> expected;
+    hashFunction.partition(*input, expected);
+    std::vector<uint32_t> partitions;
+    ASSERT_FALSE(skewedFunction.partition(*input, partitions).has_value());
+    ASSERT_EQ(partitions, expected);
+  }
+}
+
+TEST_F(SkewedHashPartitionFunctionTest, replicate) {
+  const auto input = makeSkewedInput(1'000);
+  const auto rowType = asRowType(input->type());
+  HashPartitionFunction hashFunction(false, 4, rowType, {0});
+  SkewedHashPartitionFunction skewedFunction(
+      false, 4, rowType, {0}, Mode::kReplicate, {heavyKeyHash()});
+  std::vector<uint32_t> expected;
+  hashFunction.partition(*input, expected);
+  std::vector<uint32_t> partitions;
+  skewedFunction.partition(*input, partitions);
+  for (auto row = 0; row < input->size(); ++row) {
+    if (row % 2 == 0) {
+      ASSERT_EQ(partitions[row], core::PartitionFunction::kAllPartitions);
+    } else {
+      ASSERT_EQ(partitions[row], expected[row]);
+    }
+  }
+}
+
+TEST_F(SkewedHashPartitionFunctionTest, spread) {
+  const auto input = makeSkewedInput(1'000);
+  const auto rowType = asRowType(input->type());
+  HashPartitionFunction hashFunction(true, 4, rowType, {0});
+  SkewedHashPartitionFunction skewedFunction(
+      true, 4, rowType, {0}, Mode::kSpread, {heavyKeyHash()});
+  std::vector<uint32_t> expected;
+  hashFunction.partition(*input, expected);
+  std::vector<uint32_t> partitions;
+  skewedFunction.partition(*input, partitions);
+  std::vector<int32_t> numHeavyRows(4);
+  for (auto row = 0; row < input->size(); ++row) {
+    if (row % 2 == 0) {
+      ASSERT_LT(partitions[row], 4);
+      ++numHeavyRows[partitions[row]];
+    } else {
+      ASSERT_EQ(partitions[row], expected[row]);
+    }
+  }
+  ASSERT_EQ(numHeavyRows, std::vector<int32_t>(4, 125));
+}
+
+TEST_F(SkewedHashPartitionFunctionTest, sample) {
+  const auto input = makeSkewedInput(100);
+  const auto rowType = asRowType(input->type());
+  SkewedHashPartitionFunction function(
+      true, 4, rowType, {0}, Mode::kSpread, {}, 150);
+  std::vector<uint32_t> partitions;
+
+  // The heavy key is not known until 150 rows are sampled.
+  ASSERT_TRUE(function.sampling());
+  function.partition(*input, partitions);
+  ASSERT_TRUE(function.sampling());
+  ASSERT_TRUE(function.heavyKeys().empty());
+  folly::F14FastSet<uint32_t> heavyKeyPartitions;
+  for (auto row = 0; row < input->size(); row += 2) {
+    heavyKeyPartitions.insert(partitions[row]);
+  }
+  ASSERT_EQ(heavyKeyPartitions.size(), 1);
+
+  function.partition(*input, partitions);
+  ASSERT_FALSE(function.sampling());
+  ASSERT_EQ(
+      function.heavyKeys(), (folly::F14FastSet<uint64_t>{heavyKeyHash()}));
+
+  function.partition(*input, partitions);
+  heavyKeyPartitions.clear();
+  for (auto row = 0; row < input->size(); row += 2) {
+    heavyKeyPartitions.insert(partitions[row]);
+  }
+  ASSERT_EQ(heavyKeyPartitions.size(), 4);
+}
+
+TEST_F(SkewedHashPartitionFunctionTest, spec) {
+  const auto rowType = ROW({"c0", "c1"}, {BIGINT(), VARCHAR()});
+  const SkewedHashPartitionFunctionSpec replicateSpec(
+      rowType,
+      {1, 0},
+      Mode::kReplicate,
+      {1, std::numeric_limits<uint64_t>::max()});
+  ASSERT_EQ(
+      replicateSpec.toString(), "SKEWED HASH(c1, c0) REPLICATE 2 heavy keys");
+  auto copy = SkewedHashPartitionFunctionSpec::deserialize(
+      replicateSpec.serialize(), pool());
+  ASSERT_EQ(copy->toString(), replicateSpec.toString());
+  ASSERT_EQ(copy->serialize(), replicateSpec.serialize());
+  const auto function = copy->create(8, false);
+  const auto* skewedFunction =
+      dynamic_cast<SkewedHashPartitionFunction*>(function.get());
+  ASSERT_NE(skewedFunction, nullptr);
+  ASSERT_EQ(skewedFunction->numPartitions(), 8);
+  ASSERT_EQ(
+      skewedFunction->heavyKeys(),
+      (folly::F14FastSet<uint64_t>{1, std::numeric_limits<uint64_t>::max()}));
+  VELOX_ASSERT_THROW(
+      replicateSpec.create(8, true),
+      "Rows can't be replicated in a local exchange");
+
+  const SkewedHashPartitionFunctionSpec sampleSpec(
+      rowType, {0}, Mode::kSpread, {}, 1'000);
+  ASSERT_EQ(
+      sampleSpec.toString(),
+      "SKEWED HASH(c0) SPREAD 0 heavy keys sample 1000 rows");
+  copy = SkewedHashPartitionFunctionSpec::deserialize(
+      sampleSpec.serialize(), pool());
+  ASSERT_EQ(copy->toString(), sampleSpec.toString());
+  ASSERT_NE(copy->create(8, true), nullptr);
+  VELOX_ASSERT_THROW(
+      sampleSpec.create(8, false),
+      "Heavy keys can only be sampled in a local exchange");
+  VELOX_ASSERT_THROW(
+      SkewedHashPartitionFunctionSpec(rowType, {0}, Mode::kReplicate, {}, 10),
+      "Heavy keys can only be sampled in SPREAD mode");
+}
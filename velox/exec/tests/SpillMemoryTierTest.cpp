@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/exec/SpillMemoryTier.h"
+
+#include <folly/executors/ManualExecutor.h>
+#include <gtest/gtest.h>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/file/FileSystems.h"
+#include "velox/common/testutil/TempDirectoryPath.h"
+#include "velox/exec/Spill.h"
+#include "velox/serializers/PrestoSerializer.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+namespace facebook::velox::exec::test {
+namespace {
+
+class SpillMemoryTierTest : public testing::Test,
+                            public velox::test::VectorTestBase {
+ protected:
+  static void SetUpTestCase() {
+    memory::MemoryManager::testingSetInstance(memory::MemoryManager::Options{});
+    if (!isRegisteredNamedVectorSerde("Presto")) {
+      serializer::presto::PrestoVectorSerde::registerNamedVectorSerde();
+    }
+  }
+
+  void SetUp() override {
+    filesystems::registerLocalFileSystem();
+    tempDir_ = common::testutil::TempDirectoryPath::create();
+  }
+
+  std::unique_ptr<SpillMemoryTier> makeTier(
+      uint64_t capacity,
+      folly::Executor* executor = nullptr) {
+    return std::make_unique<SpillMemoryTier>(
+        capacity, memory::memoryManager()->addLeafPool(), executor);
+  }
+
+  std::string filePath(const std::string& name) const {
+    return fmt::format("{}/{}", tempDir_->getPath(), name);
+  }
+
+  bool existsOnDisk(const std::string& path) const {
+    return filesystems::getFileSystem(path, nullptr)->exists(path);
+  }
+
+  // Writes 'size' bytes of 'c' to 'file' in 'numAppends' appends and
+  // finishes it.
+  static void
+  writeFile(SpillMemoryFile& file, char c, uint64_t size, int numAppends = 4) {
+    auto writeFile = file.openForWrite();
+    const std::string data(size / numAppends, c);
+    for (auto i = 0; i < numAppends; ++i) {
+      writeFile->append(data);
+    }
+    ASSERT_EQ(writeFile->size(), size);
+    writeFile->close();
+  }
+
+  static std::string readFile(std::unique_ptr<ReadFile> file) {
+    return file->pread(0, file->size());
+  }
+
+  std::string readFromDisk(const std::string& path) const {
+    return readFile(
+        filesystems::getFileSystem(path, nullptr)->openFileForRead(path));
+  }
+
+  std::shared_ptr<common::testutil::TempDirectoryPath> tempDir_;
+};
+
+TEST_F(SpillMemoryTierTest, inMemory) {
+  auto tier = makeTier(1 << 20);
+  auto file = tier->createFile(filePath("file"));
+  writeFile(*file, 'a', 200 << 10);
+  ASSERT_TRUE(file->inMemory());
+  ASSERT_FALSE(existsOnDisk(file->path()));
+  ASSERT_GE(tier->usedBytes(), 200 << 10);
+  ASSERT_LE(tier->usedBytes(), tier->capacity());
+  ASSERT_GE(tier->pool()->usedBytes(), 200 << 10);
+  ASSERT_EQ(readFile(file->openForRead()), std::string(200 << 10, 'a'));
+  ASSERT_EQ(tier->stats().numMemoryFiles, 1);
+
+  file.reset();
+  ASSERT_EQ(tier->usedBytes(), 0);
+  ASSERT_EQ(tier->pool()->usedBytes(), 0);
+}
+
+TEST_F(SpillMemoryTierTest, demoteOldestFiles) {
+  auto tier = makeTier(256 << 10);
+  auto first = tier->createFile(filePath("first"));
+  writeFile(*first, 'a', 100 << 10);
+  auto second = tier->createFile(filePath("second"));
+  writeFile(*second, 'b', 100 << 10);
+  ASSERT_TRUE(first->inMemory());
+  ASSERT_TRUE(second->inMemory());
+
+  // The third file needs the space of the first one, which is finished first.
+  auto third = tier->createFile(filePath("third"));
+  writeFile(*third, 'c', 100 << 10);
+  ASSERT_FALSE(first->inMemory());
+  ASSERT_TRUE(second->inMemory());
+  ASSERT_TRUE(third->inMemory());
+  ASSERT_EQ(first->openForRead(), nullptr);
+  ASSERT_EQ(readFromDisk(first->path()), std::string(100 << 10, 'a'));
+  ASSERT_FALSE(existsOnDisk(second->path()));
+
+  const auto stats = tier->stats();
+  ASSERT_EQ(stats.numMemoryFiles, 3);
+  ASSERT_EQ(stats.numDemotedFiles, 1);
+  ASSERT_EQ(stats.demotedBytes, 100 << 10);
+  ASSERT_EQ(stats.numDiskFiles, 0);
+}
+
+TEST_F(SpillMemoryTierTest, demoteOnExecutor) {
+  folly::ManualExecutor executor;
+  auto tier = makeTier(256 << 10, &executor);
+  auto first = tier->createFile(filePath("first"));
+  writeFile(*first, 'a', 100 << 10);
+  auto second = tier->createFile(filePath("second"));
+  writeFile(*second, 'b', 100 << 10);
+
+  // The third file does not wait for the first one to be demoted and goes to
+  // disk.
+  auto third = tier->createFile(filePath("third"));
+  writeFile(*third, 'c', 100 << 10);
+  ASSERT_FALSE(third->inMemory());
+  ASSERT_TRUE(first->inMemory());
+  ASSERT_EQ(tier->stats().numDemotedFiles, 0);
+
+  executor.drain();
+  ASSERT_FALSE(first->inMemory());
+  ASSERT_TRUE(second->inMemory());
+  ASSERT_EQ(readFromDisk(first->path()), std::string(100 << 10, 'a'));
+  ASSERT_EQ(tier->stats().numDemotedFiles, 1);
+
+  // The next file fits in the room made by the demotion.
+  auto fourth = tier->createFile(filePath("fourth"));
+  writeFile(*fourth, 'd', 100 << 10);
+  ASSERT_TRUE(fourth->inMemory());
+  ASSERT_EQ(tier->stats().numDiskFiles, 1);
+}
+
+TEST_F(SpillMemoryTierTest, readFileKeepsMemory) {
+  auto tier = makeTier(256 << 10);
+  auto first = tier->createFile(filePath("first"));
+  writeFile(*first, 'a', 100 << 10);
+  auto reader = first->openForRead();
+  const auto usedBytes = tier->usedBytes();
+
+  // The content read from memory stays charged while it is read, even if
+  // the file is demoted or destroyed.
+  auto second = tier->createFile(filePath("second"));
+  writeFile(*second, 'b', 100 << 10);
+  auto third = tier->createFile(filePath("third"));
+  writeFile(*third, 'c', 100 << 10);
+  // Demoting the first file makes no room while it is read, so the second one
+  // is demoted too.
+  ASSERT_FALSE(first->inMemory());
+  ASSERT_FALSE(second->inMemory());
+  ASSERT_TRUE(third->inMemory());
+  ASSERT_EQ(tier->stats().numDemotedFiles, 2);
+  ASSERT_LE(tier->usedBytes(), tier->capacity());
+  first.reset();
+  second.reset();
+  third.reset();
+  ASSERT_EQ(tier->usedBytes(), usedBytes);
+  ASSERT_GE(tier->pool()->usedBytes(), usedBytes);
+  ASSERT_EQ(readFile(std::move(reader)), std::string(100 << 10, 'a'));
+  ASSERT_EQ(tier->usedBytes(), 0);
+  ASSERT_EQ(tier->pool()->usedBytes(), 0);
+}
+
+TEST_F(SpillMemoryTierTest, demotionError) {
+  auto tier = makeTier(256 << 10);
+  // The directory of the first file does not exist, so it fails to demote.
+  auto first = tier->createFile(filePath("missing/first"));
+  writeFile(*first, 'a', 100 << 10);
+  auto second = tier->createFile(filePath("second"));
+  writeFile(*second, 'b', 100 << 10);
+
+  // The third file demotes the second one after the first one fails.
+  auto third = tier->createFile(filePath("third"));
+  writeFile(*third, 'c', 100 << 10);
+  ASSERT_TRUE(first->inMemory());
+  ASSERT_FALSE(second->inMemory());
+  ASSERT_TRUE(third->inMemory());
+  ASSERT_EQ(readFile(first->openForRead()), std::string(100 << 10, 'a'));
+  ASSERT_FALSE(existsOnDisk(first->path()));
+  auto stats = tier->stats();
+  ASSERT_EQ(stats.numDemotionErrors, 1);
+  ASSERT_EQ(stats.numDemotedFiles, 1);
+
+  // The first file is retried on the next demotion, which now succeeds.
+  filesystems::getFileSystem(first->path(), nullptr)
+      ->mkdir(filePath("missing"));
+  auto fourth = tier->createFile(filePath("fourth"));
+  writeFile(*fourth, 'd', 100 << 10);
+  ASSERT_FALSE(first->inMemory());
+  ASSERT_TRUE(third->inMemory());
+  ASSERT_TRUE(fourth->inMemory());
+  ASSERT_EQ(readFromDisk(first->path()), std::string(100 << 10, 'a'));
+  stats = tier->stats();
+  ASSERT_EQ(stats.numDemotionErrors, 1);
+  ASSERT_EQ(stats.numDemotedFiles, 2);
+}
+
+TEST_F(SpillMemoryTierTest, fileDoesNotFit) {
+  auto tier = makeTier(128 << 10);
+  auto file = tier->createFile(filePath("file"));
+  writeFile(*file, 'a', 400 << 10, 8);
+  ASSERT_FALSE(file->inMemory());
+  ASSERT_EQ(tier->usedBytes(), 0);
+  ASSERT_EQ(file->openForRead(), nullptr);
+  ASSERT_EQ(readFromDisk(file->path()), std::string(400 << 10, 'a'));
+  ASSERT_EQ(tier->stats().numDiskFiles, 1);
+  ASSERT_EQ(tier->stats().numMemoryFiles, 0);
+}
+
+TEST_F(SpillMemoryTierTest, destroyedFilesAreNotDemoted) {
+  auto tier = makeTier(128 << 10);
+  auto file = tier->createFile(filePath("file"));
+  writeFile(*file, 'a', 100 << 10);
+  file.reset();
+  ASSERT_EQ(tier->usedBytes(), 0);
+
+  auto other = tier->createFile(filePath("other"));
+  writeFile(*other, 'b', 100 << 10);
+  ASSERT_TRUE(other->inMemory());
+  ASSERT_FALSE(existsOnDisk(filePath("file")));
+  ASSERT_EQ(tier->stats().numDemotedFiles, 0);
+}
+
+TEST_F(SpillMemoryTierTest, spillState) {
+  SpillStats stats;
+  for (const uint64_t capacity : {64UL << 20, 64UL << 10}) {
+    SCOPED_TRACE(fmt::format("capacity {}", capacity));
+    auto tier = makeTier(capacity);
+    const auto spillDir = tempDir_->getPath();
+    SpillState state(
+        [&]() -> const std::string& { return spillDir; },
+        [](uint64_t) {},
+        fmt::format("test-{}", capacity),
+        SpillState::makeSortingKeys(std::vector<CompareFlags>(1)),
+        1'000'000'000,
+        0,
+        common::CompressionKind_NONE,
+        std::nullopt,
+        pool(),
+        &stats,
+        "",
+        nullptr,
+        tier.get());
+    const SpillPartitionId partitionId{0};
+    state.setPartitionSpilled(partitionId);
+
+    constexpr int32_t kNumFiles = 4;
+    constexpr int32_t kNumRows = 10'000;
+    for (auto i = 0; i < kNumFiles; ++i) {
+      state.appendToPartition(
+          partitionId,
+          makeRowVector({makeFlatVector<int64_t>(
+              kNumRows, [&](auto row) { return i * kNumRows + row; })}));
+      state.finishFile(partitionId);
+    }
+    const auto files = state.finish(partitionId);
+    ASSERT_EQ(files.size(), kNumFiles);
+
+    int64_t numRows{0};
+    for (const auto& file : files) {
+      ASSERT_EQ(file.compressionKind, SpillWriter::kMemoryTierKind);
+      ASSERT_NE(file.memoryFile, nullptr);
+      ASSERT_EQ(file.memoryFile->inMemory(), !existsOnDisk(file.path));
+      auto reader = SpillReadFile::create(file, 1 << 20, pool(), &stats);
+      RowVectorPtr batch;
+      while (reader->nextBatch(batch)) {
+        numRows += batch->size();
+      }
+    }
+    ASSERT_EQ(numRows, kNumFiles * kNumRows);
+    if (capacity == 64UL << 20) {
+      ASSERT_EQ(tier->stats().numMemoryFiles, kNumFiles);
+      ASSERT_EQ(tier->stats().numDemotedFiles, 0);
+    } else {
+      const auto tierStats = tier->stats();
+      ASSERT_GT(tierStats.numDemotedFiles + tierStats.numDiskFiles, 0);
+    }
+  }
+}
+
+TEST_F(SpillMemoryTierTest, spillConfig) {
+  common::SpillConfig config;
+  ASSERT_EQ(spillMemoryTier(config), nullptr);
+  config.memoryTierEnabled = true;
+  ASSERT_EQ(spillMemoryTier(config), nullptr);
+
+  SpillMemoryTier::initialize(1 << 20);
+  ASSERT_NE(SpillMemoryTier::getInstance(), nullptr);
+  ASSERT_EQ(spillMemoryTier(config), SpillMemoryTier::getInstance());
+  VELOX_ASSERT_THROW(
+      SpillMemoryTier::initialize(1 << 20),
+      "Spill memory tier has already been initialized");
+  config.memoryTierEnabled = false;
+  ASSERT_EQ(spillMemoryTier(config), nullptr);
+  SpillMemoryTier::testingReset();
+}
+
+} // namespace
+} // namespace facebook::velox::exec::test
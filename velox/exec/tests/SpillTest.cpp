@@ -1520,6 +1520,73 @@ TEST_P(SpillTest, validatePerSpillWriteSize) {
       "Spill bytes will overflow");
 }
 
+TEST_P(SpillTest, stripeAcrossDisks) {
+  std::vector<std::shared_ptr<TempDirectoryPath>> diskDirs;
+  std::vector<std::string> directories;
+  for (auto i = 0; i < 3; ++i) {
+    diskDirs.push_back(TempDirectoryPath::create());
+    directories.push_back(diskDirs.back()->getPath());
+  }
+  common::SpillDiskSet diskSet(directories, /*minFreeBytes=*/0);
+  SpillState state(
+      [&]() -> const std::string& { return directories[0]; },
+      updateSpilledBytesCb_,
+      "test",
+      SpillState::makeSortingKeys(std::vector<CompareFlags>(1)),
+      kGB,
+      0,
+      compressionKind_,
+      std::nullopt,
+      pool(),
+      &spillStats_,
+      "",
+      &diskSet);
+  const SpillPartitionId partitionId{0};
+  state.setPartitionSpilled(partitionId);
+
+  constexpr int32_t kNumFiles = 6;
+  constexpr int32_t kNumRows = 100;
+  for (auto i = 0; i < kNumFiles; ++i) {
+    state.appendToPartition(
+        partitionId,
+        makeRowVector({makeFlatVector<int64_t>(
+            kNumRows, [&](auto row) { return i * kNumRows + row; })}));
+    // No bytes are queued when a file is created, so ties are broken round
+    // robin and the i-th file goes to disk i % 3.
+    ASSERT_GT(diskSet.queuedBytes(i % directories.size()), 0);
+    state.finishFile(partitionId);
+    ASSERT_EQ(diskSet.queuedBytes(i % directories.size()), 0);
+  }
+  const auto files = state.finish(partitionId);
+  ASSERT_EQ(files.size(), kNumFiles);
+
+  std::vector<int32_t> numDiskFiles(directories.size());
+  int64_t numRows{0};
+  for (const auto& file : files) {
+    ASSERT_TRUE(file.disk.has_value());
+    ASSERT_EQ(file.path.rfind(directories[file.disk.value()] + "/", 0), 0)
+        << file.path;
+    ++numDiskFiles[file.disk.value()];
+    auto reader = SpillReadFile::create(file, 1 << 20, pool(), &spillStats_);
+    RowVectorPtr batch;
+    while (reader->nextBatch(batch)) {
+      numRows += batch->size();
+    }
+  }
+  ASSERT_EQ(numRows, kNumFiles * kNumRows);
+  for (auto count : numDiskFiles) {
+    ASSERT_EQ(count, kNumFiles / directories.size());
+  }
+
+  const auto ioStats = spillStats_.ioStats.stats();
+  for (auto disk = 0; disk < directories.size(); ++disk) {
+    ASSERT_GT(
+        ioStats.at(common::SpillDiskSet::writeBytesStatName(disk)).sum, 0);
+    ASSERT_GT(
+        ioStats.at(common::SpillDiskSet::readBytesStatName(disk)).sum, 0);
+  }
+}
+
 namespace {
 SpillFiles makeFakeSpillFiles(int32_t numFiles) {
   auto tempDir = TempDirectoryPath::create();
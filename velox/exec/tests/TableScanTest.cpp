@@ -46,6 +46,7 @@
 #include "velox/exec/Exchange.h"
 #include "velox/exec/PlanNodeStats.h"
 #include "velox/exec/TableScan.h"
+#include "velox/exec/TopN.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -2043,6 +2044,60 @@ TEST_F(TableScanTest, splitOffsetAndLength) {
       "SELECT * FROM tmp LIMIT 0");
 }
 
+TEST_F(TableScanTest, morsels) {
+  // One large file with many stripes and a few small ones.
+  auto largeVectors = makeVectors(20, 1'000);
+  auto writeConfig = std::make_shared<dwrf::Config>();
+  writeConfig->set<uint64_t>(dwrf::Config::STRIPE_SIZE, 1'024);
+  auto largeFile = TempFilePath::create();
+  writeToFile(largeFile->getPath(), largeVectors, writeConfig);
+  const auto largeFileSize = fs::file_size(largeFile->getPath());
+
+  auto smallFiles = makeFilePaths(5);
+  auto smallVectors = makeVectors(5, 100);
+  for (auto i = 0; i < smallFiles.size(); ++i) {
+    writeToFile(smallFiles[i]->getPath(), smallVectors[i]);
+  }
+
+  std::vector<RowVectorPtr> allVectors = largeVectors;
+  allVectors.insert(
+      allVectors.end(), smallVectors.begin(), smallVectors.end());
+  createDuckDbTable(allVectors);
+
+  for (const auto numPreloadSplits : {0, 2}) {
+    SCOPED_TRACE(fmt::format("numPreloadSplits {}", numPreloadSplits));
+    std::vector<std::shared_ptr<connector::ConnectorSplit>> splits;
+    splits.push_back(
+        makeHiveConnectorSplit(largeFile->getPath(), 0, largeFileSize));
+    for (const auto& file : smallFiles) {
+      splits.push_back(makeHiveConnectorSplit(file->getPath()));
+    }
+
+    auto task =
+        AssertQueryBuilder(tableScanNode(), duckDbQueryRunner_)
+            .splits(splits)
+            .maxDrivers(4)
+            .config(
+                core::QueryConfig::kTableScanMorselBytes,
+                std::to_string(largeFileSize / 8))
+            .config(
+                core::QueryConfig::kMaxSplitPreloadPerDriver,
+                std::to_string(numPreloadSplits))
+            .assertResults("SELECT * FROM tmp");
+
+    // The large split is read as morsels. The task counts the original
+    // splits and reports the morsels separately.
+    ASSERT_GT(getTableScanStats(task).numSplits, splits.size() + 4);
+    const auto taskStats = task->taskStats();
+    ASSERT_EQ(taskStats.numTotalSplits, splits.size());
+    ASSERT_EQ(taskStats.numFinishedSplits, splits.size());
+    ASSERT_EQ(taskStats.numRunningSplits, 0);
+    ASSERT_EQ(taskStats.numQueuedSplits, 0);
+    ASSERT_GT(taskStats.numTotalMorsels, 4);
+    ASSERT_EQ(taskStats.numFinishedMorsels, taskStats.numTotalMorsels);
+  }
+}
+
 TEST_F(TableScanTest, fileNotFound) {
   auto assertMissingFile = [&](bool ignoreMissingFiles) {
     auto split =
@@ -3179,6 +3234,154 @@ TEST_F(TableScanTest, filterPushdown) {
       "SELECT count(*) FROM tmp");
 }
 
+TEST_F(TableScanTest, limitPushdown) {
+  auto filePaths = makeFilePaths(20);
+  auto vectors = makeVectors(20, 100);
+  for (int32_t i = 0; i < vectors.size(); ++i) {
+    writeToFile(filePaths[i]->getPath(), vectors[i]);
+  }
+
+  core::PlanNodeId scanId;
+  auto plan = PlanBuilder()
+                  .tableScan(rowType_)
+                  .capturePlanNodeId(scanId)
+                  .limit(0, 10, true)
+                  .planNode();
+  std::shared_ptr<Task> task;
+  auto result = AssertQueryBuilder(plan)
+                    .splits(makeHiveConnectorSplits(filePaths))
+                    .config(QueryConfig::kLimitPushdownEnabled, "true")
+                    .config(QueryConfig::kMaxSplitPreloadPerDriver, "0")
+                    .maxDrivers(4)
+                    .copyResults(pool(), task);
+  // Each driver outputs at most the limit. Once together they have output
+  // enough rows, the scans of the remaining drivers stop.
+  ASSERT_GE(result->size(), 10);
+  ASSERT_LE(result->size(), 40);
+  ASSERT_LT(
+      toPlanStats(task->taskStats()).at(scanId).rawInputRows, 20 * 100);
+}
+
+TEST_F(TableScanTest, limitPushdownMidSplit) {
+  auto filePath = TempFilePath::create();
+  writeToFile(filePath->getPath(), makeVectors(1, 1'000));
+
+  // The limit is reached after the first batch of the only split. The scan
+  // stops in the middle of the split and still reports its stats.
+  core::PlanNodeId scanId;
+  auto plan = PlanBuilder()
+                  .tableScan(rowType_)
+                  .capturePlanNodeId(scanId)
+                  .limit(0, 10, true)
+                  .planNode();
+  std::shared_ptr<Task> task;
+  auto result = AssertQueryBuilder(plan)
+                    .split(makeHiveConnectorSplit(filePath->getPath()))
+                    .config(QueryConfig::kLimitPushdownEnabled, "true")
+                    .config(QueryConfig::kMaxOutputBatchRows, "100")
+                    .copyResults(pool(), task);
+  ASSERT_EQ(result->size(), 10);
+  const auto scanStats = toPlanStats(task->taskStats()).at(scanId);
+  ASSERT_EQ(
+      scanStats.customStats.at(std::string(TableScan::kStoppedByLimit)).sum,
+      1);
+  ASSERT_EQ(scanStats.customStats.at("fileFormat.dwrf").sum, 1);
+  ASSERT_GT(scanStats.rawInputRows, 0);
+  ASSERT_LT(scanStats.rawInputRows, 1'000);
+}
+
+TEST_F(TableScanTest, topNDynamicFilter) {
+  // Each file holds a disjoint, increasing range of values. File 9 also has
+  // nulls.
+  auto rowType = ROW({"c0"}, {BIGINT()});
+  auto filePaths = makeFilePaths(10);
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < filePaths.size(); ++i) {
+    vectors.push_back(makeRowVector({makeFlatVector<int64_t>(
+        1'000,
+        [&](auto row) { return i * 1'000 + (row * 7) % 1'000; },
+        i == 9 ? nullEvery(100) : nullptr)}));
+    writeToFile(filePaths[i]->getPath(), vectors.back());
+  }
+  createDuckDbTable(vectors);
+
+  for (const auto& order :
+       {"ASC NULLS LAST",
+        "ASC NULLS FIRST",
+        "DESC NULLS LAST",
+        "DESC NULLS FIRST"}) {
+    SCOPED_TRACE(order);
+    core::PlanNodeId topNId;
+    auto plan = PlanBuilder()
+                    .tableScan(rowType)
+                    .topN({fmt::format("c0 {}", order)}, 10, false)
+                    .capturePlanNodeId(topNId)
+                    .planNode();
+    auto task =
+        AssertQueryBuilder(plan, duckDbQueryRunner_)
+            .splits(makeHiveConnectorSplits(filePaths))
+            .config(QueryConfig::kTopNDynamicFilterPushdownEnabled, "true")
+            .assertResults(fmt::format(
+                "SELECT c0 FROM tmp ORDER BY c0 {} LIMIT 10", order));
+    ASSERT_GT(
+        toPlanStats(task->taskStats())
+            .at(topNId)
+            .customStats.at(std::string(TopN::kDynamicFilterUpdates))
+            .sum,
+        0);
+    if (std::string_view(order) == "ASC NULLS LAST") {
+      // The top 10 are all in the first file. The threshold filter skips all
+      // others by their statistics.
+      ASSERT_LT(getTableScanStats(task).rawInputRows, 10'000);
+    }
+  }
+}
+
+TEST_F(TableScanTest, topNDynamicFilterOverOuterJoin) {
+  auto filePaths = makeFilePaths(10);
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < filePaths.size(); ++i) {
+    vectors.push_back(makeRowVector({makeFlatVector<int64_t>(
+        1'000, [&](auto row) { return i * 1'000 + (row * 7) % 1'000; })}));
+    writeToFile(filePaths[i]->getPath(), vectors.back());
+  }
+  createDuckDbTable(vectors);
+  auto build = makeRowVector(
+      {"u0"}, {makeFlatVector<int64_t>(10'000, [](auto row) { return row; })});
+  createDuckDbTable("u", {build});
+
+  // Every build row matches a probe row. If the threshold dropped probe rows
+  // at the scan, the join would emit their build rows with a null 'c0', which
+  // sort first.
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  auto buildPlan = PlanBuilder(planNodeIdGenerator).values({build}).planNode();
+  core::PlanNodeId topNId;
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .tableScan(ROW({"c0"}, {BIGINT()}))
+                  .hashJoin(
+                      {"c0"},
+                      {"u0"},
+                      buildPlan,
+                      "",
+                      {"c0", "u0"},
+                      core::JoinType::kRight)
+                  .topN({"c0 ASC NULLS FIRST"}, 10, false)
+                  .capturePlanNodeId(topNId)
+                  .planNode();
+  auto task =
+      AssertQueryBuilder(plan, duckDbQueryRunner_)
+          .splits(makeHiveConnectorSplits(filePaths))
+          .config(QueryConfig::kTopNDynamicFilterPushdownEnabled, "true")
+          .assertResults(
+              "SELECT c0, u0 FROM tmp RIGHT JOIN u ON c0 = u0 "
+              "ORDER BY c0 NULLS FIRST LIMIT 10");
+  ASSERT_EQ(
+      toPlanStats(task->taskStats())
+          .at(topNId)
+          .customStats.count(std::string(TopN::kDynamicFilterUpdates)),
+      0);
+}
+
 TEST_F(TableScanTest, path) {
   auto rowType = ROW({"a"}, {BIGINT()});
   auto filePath = makeFilePaths(1)[0];
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/TaskAdmissionController.h"
+
+#include <atomic>
+#include <thread>
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+namespace facebook::velox::exec::test {
+namespace {
+
+class TaskAdmissionControllerTest : public OperatorTestBase {
+ protected:
+  std::shared_ptr<TaskAdmissionController> makeController(
+      uint64_t maxQueueTimeMs,
+      uint32_t maxQueuedTasks = 100) {
+    TaskAdmissionController::Config config;
+    config.maxQueueTimeMs = maxQueueTimeMs;
+    config.maxQueuedTasks = maxQueuedTasks;
+    config.checkIntervalMs = 10;
+    return std::make_shared<TaskAdmissionController>(
+        config,
+        std::vector<TaskAdmissionController::LoadSource>{
+            [this]() { return load_.load(); },
+            [this]() { return otherLoad_.load(); }});
+  }
+
+  std::atomic<double> load_{0};
+  std::atomic<double> otherLoad_{0};
+};
+
+TEST_F(TaskAdmissionControllerTest, load) {
+  auto controller = makeController(1'000);
+  ASSERT_EQ(controller->load(), 0);
+  load_ = 0.5;
+  otherLoad_ = 0.8;
+  ASSERT_EQ(controller->load(), 0.8);
+  otherLoad_ = 0.1;
+  ASSERT_EQ(controller->load(), 0.5);
+}
+
+TEST_F(TaskAdmissionControllerTest, admit) {
+  auto controller = makeController(60'000);
+  ASSERT_TRUE(controller->admit("t0").isReady());
+  ASSERT_EQ(controller->numQueued(), 0);
+
+  otherLoad_ = 1;
+  std::vector<ContinueFuture> futures;
+  for (auto i = 0; i < 3; ++i) {
+    futures.push_back(controller->admit(fmt::format("t{}", i + 1)));
+  }
+  ASSERT_EQ(controller->numQueued(), 3);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  for (const auto& future : futures) {
+    ASSERT_FALSE(future.isReady());
+  }
+
+  // A new task that finds the load low is admitted right away, after the
+  // queued ones.
+  otherLoad_ = 0.5;
+  ASSERT_TRUE(controller->admit("t4").isReady());
+  for (const auto& future : futures) {
+    ASSERT_TRUE(future.hasValue());
+  }
+  ASSERT_EQ(controller->numQueued(), 0);
+
+  // The background check admits all the queued tasks once the load drops.
+  otherLoad_ = 1;
+  futures.clear();
+  for (auto i = 0; i < 10; ++i) {
+    futures.push_back(controller->admit(fmt::format("t{}", i + 5)));
+  }
+  ASSERT_EQ(controller->numQueued(), 10);
+  otherLoad_ = 0.5;
+  futures.back().wait();
+  for (const auto& future : futures) {
+    ASSERT_TRUE(future.hasValue());
+  }
+  ASSERT_EQ(controller->numQueued(), 0);
+}
+
+TEST_F(TaskAdmissionControllerTest, queueTimeout) {
+  auto controller = makeController(50);
+  load_ = 2;
+  auto future = controller->admit("t0");
+  ASSERT_FALSE(future.isReady());
+  VELOX_ASSERT_RUNTIME_THROW_CODE(
+      std::move(future).get(),
+      error_code::kTaskAdmissionRejected,
+      "Task t0 rejected after waiting");
+  ASSERT_EQ(controller->numQueued(), 0);
+
+  load_ = 0;
+  ASSERT_TRUE(controller->admit("t1").isReady());
+}
+
+TEST_F(TaskAdmissionControllerTest, queueFull) {
+  auto controller = makeController(60'000, 1);
+  load_ = 2;
+  auto queued = controller->admit("t0");
+  auto rejected = controller->admit("t1");
+  ASSERT_TRUE(rejected.isReady());
+  try {
+    std::move(rejected).get();
+    FAIL() << "Expected the task to be rejected";
+  } catch (const VeloxRuntimeError& e) {
+    ASSERT_EQ(e.errorCode(), error_code::kTaskAdmissionRejected);
+    ASSERT_TRUE(e.isRetriable());
+  }
+  load_ = 0;
+  queued.wait();
+  ASSERT_TRUE(queued.hasValue());
+}
+
+TEST_F(TaskAdmissionControllerTest, destroy) {
+  auto controller = makeController(60'000);
+  load_ = 2;
+  auto future = controller->admit("t0");
+  controller.reset();
+  VELOX_ASSERT_RUNTIME_THROW_CODE(
+      std::move(future).get(),
+      error_code::kTaskAdmissionRejected,
+      "Task t0 rejected: the admission controller is destroyed");
+}
+
+TEST_F(TaskAdmissionControllerTest, levelLoad) {
+  std::atomic_uint64_t value{0};
+  auto source = TaskAdmissionController::levelLoad(
+      [&]() -> uint64_t { return value; }, 200);
+  ASSERT_EQ(source(), 0);
+  value = 100;
+  ASSERT_EQ(source(), 0.5);
+  value = 400;
+  ASSERT_EQ(source(), 2);
+}
+
+TEST_F(TaskAdmissionControllerTest, rateLoad) {
+  std::atomic_uint64_t counter{1'000};
+  auto source = TaskAdmissionController::rateLoad(
+      [&]() -> uint64_t { return counter; }, 1'000, 100);
+  ASSERT_EQ(source(), 0);
+
+  counter += 10'000;
+  // The rate is not measured before the min interval.
+  ASSERT_EQ(source(), 0);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  const auto load = source();
+  ASSERT_GT(load, 0);
+  ASSERT_LE(load, 50);
+
+  // The load stays until the next measurement.
+  ASSERT_EQ(source(), load);
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  ASSERT_EQ(source(), 0);
+
+  // A reset counter has no load.
+  counter = 0;
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  ASSERT_EQ(source(), 0);
+}
+
+TEST_F(TaskAdmissionControllerTest, deferTaskCreate) {
+  auto controller = makeController(60'000);
+  const auto plan = PlanBuilder()
+                        .values({makeRowVector({makeFlatVector<int32_t>(
+                            10, [](auto row) { return row; })})})
+                        .planFragment();
+
+  // The task is created on an executor thread once it is admitted.
+  load_ = 2;
+  auto taskFuture =
+      controller->admit("deferred")
+          .via(driverExecutor_.get())
+          .thenValue([&](auto&& /*unused*/) {
+            return Task::create(
+                "deferred",
+                plan,
+                0,
+                core::QueryCtx::create(driverExecutor_.get()),
+                Task::ExecutionMode::kSerial);
+          });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_FALSE(taskFuture.isReady());
+
+  load_ = 0;
+  auto task = std::move(taskFuture).get();
+  ASSERT_EQ(task->taskId(), "deferred");
+}
+} // namespace
+} // namespace facebook::velox::exec::test
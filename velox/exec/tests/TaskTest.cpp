@@ -37,6 +37,10 @@
 #include "velox/exec/tests/utils/QueryAssertions.h"
 #include "velox/vector/fuzzer/VectorFuzzer.h"
 
+#include <gflags/gflags.h>
+
+DECLARE_bool(velox_stack_sampler_enabled);
+
 using namespace facebook::velox;
 using namespace facebook::velox::common::testutil;
 
@@ -2391,6 +2395,64 @@ TEST_F(TaskTest, spillDirNotCreated) {
   ASSERT_FALSE(fs->exists(tmpDirectoryPath));
 }
 
+TEST_F(TaskTest, profile) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_velox_stack_sampler_enabled = true;
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector(
+        {makeFlatVector<int64_t>(10'000, [i](auto row) { return i + row; })}));
+  }
+  core::PlanNodeId aggregationId;
+  // Uses enough CPU time for many samples at the min interval.
+  const auto plan = PlanBuilder()
+                        .values(vectors, false, 100)
+                        .project({"c0 % 10 AS k", "c0 * 3 + 1 AS p"})
+                        .singleAggregation({"k"}, {"sum(p)"})
+                        .capturePlanNodeId(aggregationId)
+                        .planNode();
+
+  const auto profileDir = TempDirectoryPath::create();
+  std::string taskId;
+  {
+    std::shared_ptr<Task> task;
+    AssertQueryBuilder(plan)
+        .config(core::QueryConfig::kTaskProfileDir, profileDir->getPath())
+        .config(core::QueryConfig::kTaskProfileSamplingIntervalUs, "1000")
+        .copyResults(pool(), task);
+    taskId = task->taskId();
+  }
+  // The profiles are written when the task completes.
+  waitForAllTasksToBeDeleted();
+
+  auto fs = filesystems::getFileSystem(profileDir->getPath(), nullptr);
+  const auto readProfile = [&](const std::string& fileName) {
+    auto file = fs->openFileForRead(
+        fmt::format("{}/{}", profileDir->getPath(), fileName));
+    return file->pread(0, file->size());
+  };
+
+  // The samples are all in the pipeline.
+  std::istringstream cpuProfile(
+      readProfile(TaskProfiler::cpuProfileFileName(taskId)));
+  std::string line;
+  int32_t numStacks{0};
+  while (std::getline(cpuProfile, line)) {
+    ASSERT_TRUE(line.starts_with("Pipeline[0]")) << line;
+    ++numStacks;
+  }
+  ASSERT_GT(numStacks, 0);
+
+  // The memory profile has the peak memory of each operator.
+  const auto memoryProfile =
+      readProfile(TaskProfiler::memoryProfileFileName(taskId));
+  ASSERT_NE(
+      memoryProfile.find(
+          fmt::format("Pipeline[0];Aggregation[{}] ", aggregationId)),
+      std::string::npos)
+      << memoryProfile;
+}
+
 DEBUG_ONLY_TEST_F(TaskTest, resumeAfterTaskFinish) {
   auto probeVector = makeRowVector(
       {"t_c0"}, {makeFlatVector<int32_t>(10, [](auto row) { return row; })});
@@ -607,6 +607,71 @@ DEBUG_ONLY_TEST_P(MultiTopNRowNumberTest, memoryUsageCheckAfterReclaim) {
   ASSERT_GT(stats.spilledPartitions, 0);
 }
 
+DEBUG_ONLY_TEST_P(MultiTopNRowNumberTest, memoryCompactionReclaim) {
+  std::atomic_int inputCount{0};
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::Driver::runInternal::addInput",
+      std::function<void(exec::Operator*)>(([&](exec::Operator* op) {
+        if (op->operatorCtx()->operatorType() != "TopNRowNumber") {
+          return;
+        }
+        if (++inputCount != 5) {
+          return;
+        }
+        // Compaction copies the live rows into the unused reservation.
+        ASSERT_TRUE(op->pool()->maybeReserve(8 << 20));
+        memory::ScopedMemoryArbitrationContext arbitrationCtx(op->pool());
+        memory::MemoryReclaimer::Stats stats;
+        op->reclaim(1, stats);
+      })));
+  std::atomic_int numCompactions{0};
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::TopNRowNumber::compact",
+      std::function<void(exec::Operator*)>(
+          ([&](exec::Operator* /*op*/) { ++numCompactions; })));
+
+  // Each row ranks ahead of the rows of its partition in the previous
+  // batches, so these are evicted and leave their strings behind.
+  const vector_size_t size = 10'000;
+  auto data = split(
+      makeRowVector(
+          {"d", "s", "p"},
+          {
+              makeFlatVector<std::string>(
+                  size,
+                  [](auto row) {
+                    return std::string(
+                        20 + (row * 7'919) % 200, 'a' + row % 26);
+                  }),
+              makeFlatVector<int64_t>(
+                  size, [](auto row) { return size - row; }),
+              makeFlatVector<int64_t>(size, [](auto row) { return row % 100; }),
+          }),
+      10);
+  createDuckDbTable(data);
+
+  const auto spillDirectory = TempDirectoryPath::create();
+  core::PlanNodeId topNRowNumberId;
+  auto plan = PlanBuilder()
+                  .values(data)
+                  .topNRank(functionName_, {"p"}, {"s"}, 10, true)
+                  .capturePlanNodeId(topNRowNumberId)
+                  .planNode();
+  const auto sql = fmt::format(
+      "SELECT * FROM (SELECT *, {}() over (partition by p order by s) as rn FROM tmp) "
+      " WHERE rn <= 10",
+      functionName_);
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .config(core::QueryConfig::kSpillEnabled, "true")
+      .config(core::QueryConfig::kTopNRowNumberSpillEnabled, "true")
+      .config(
+          core::QueryConfig::kTopNRowNumberMemoryCompactionReclaimEnabled,
+          "true")
+      .spillDirectory(spillDirectory->getPath())
+      .assertResults(sql);
+  ASSERT_EQ(numCompactions, 1);
+}
+
 // This test verifies that TopNRowNumber operator can be closed twice which
 // might be triggered by memory pool abort.
 DEBUG_ONLY_TEST_P(MultiTopNRowNumberTest, doubleClose) {
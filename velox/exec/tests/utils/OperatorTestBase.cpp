@@ -27,6 +27,7 @@
 #include "velox/parse/ExpressionsParser.h"
 #include "velox/parse/TypeResolver.h"
 #include "velox/serializers/CompactRowSerializer.h"
+#include "velox/serializers/PrestoEncodedSerializer.h"
 #include "velox/serializers/PrestoSerializer.h"
 #include "velox/serializers/UnsafeRowSerializer.h"
 #include "velox/vector/tests/utils/VectorMaker.h"
@@ -129,6 +130,9 @@ void OperatorTestBase::SetUp() {
   if (!isRegisteredNamedVectorSerde("Presto")) {
     serializer::presto::PrestoVectorSerde::registerNamedVectorSerde();
   }
+  if (!isRegisteredNamedVectorSerde("PrestoEncoded")) {
+    serializer::presto::PrestoEncodedVectorSerde::registerNamedVectorSerde();
+  }
   if (!isRegisteredNamedVectorSerde("CompactRow")) {
     serializer::CompactRowVectorSerde::registerNamedVectorSerde();
   }
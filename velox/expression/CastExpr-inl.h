@@ -21,6 +21,7 @@
 #include "velox/expression/CastExpr.h"
 #include "velox/expression/StringWriter.h"
 #include "velox/functions/lib/string/StringCore.h"
+#include "velox/type/FastStringConversion.h"
 #include "velox/type/Type.h"
 #include "velox/vector/SelectivityVector.h"
 
@@ -608,6 +609,34 @@ VectorPtr CastExpr::applyDecimalToPrimitiveCast(
   }
 }
 
+template <typename T, typename TParse>
+const SelectivityVector* CastExpr::applyFastStringCast(
+    const SelectivityVector& rows,
+    const BaseVector& input,
+    FlatVector<T>* result,
+    LocalSelectivityVector& remainingHolder,
+    TParse&& parse) {
+  if (hooks_->getPolicy() != PrestoCastPolicy || !input.isFlatEncoding()) {
+    return &rows;
+  }
+  const auto* strings = input.asUnchecked<FlatVector<StringView>>();
+  const auto* rawStrings = strings->rawValues();
+  const auto* rawNulls = strings->rawNulls();
+  auto* remaining = remainingHolder.get(rows);
+  rows.applyToSelected([&](vector_size_t row) {
+    if (rawNulls && bits::isBitNull(rawNulls, row)) {
+      return;
+    }
+    const auto& value = rawStrings[row];
+    if (const auto parsed = parse(value.data(), value.size())) {
+      result->set(row, parsed.value());
+      remaining->setValid(row, false);
+    }
+  });
+  remaining->updateBounds();
+  return remaining;
+}
+
 template <TypeKind ToKind, TypeKind FromKind>
 void CastExpr::applyCastPrimitives(
     const SelectivityVector& rows,
@@ -619,27 +648,69 @@ void CastExpr::applyCastPrimitives(
   auto* resultFlatVector = result->as<FlatVector<To>>();
   auto* inputSimpleVector = input.as<SimpleVector<From>>();
 
+  // Rows in canonical form are converted in a batch. The rest, including all
+  // invalid rows, go through the per-row kernel.
+  LocalSelectivityVector remainingHolder(context);
+  const SelectivityVector* castRows = &rows;
+  if constexpr (
+      FromKind == TypeKind::VARCHAR &&
+      (ToKind == TypeKind::TINYINT || ToKind == TypeKind::SMALLINT ||
+       ToKind == TypeKind::INTEGER || ToKind == TypeKind::BIGINT)) {
+    castRows = applyFastStringCast(
+        rows,
+        input,
+        resultFlatVector,
+        remainingHolder,
+        [](const char* data, size_t size) {
+          return util::fast::parseInteger<To>(data, size);
+        });
+  } else if constexpr (
+      FromKind == TypeKind::VARCHAR && ToKind == TypeKind::TIMESTAMP) {
+    const auto* timeZone = hooks_->timestampToStringOptions().timeZone;
+    castRows = applyFastStringCast(
+        rows,
+        input,
+        resultFlatVector,
+        remainingHolder,
+        [&](const char* data, size_t size) -> std::optional<Timestamp> {
+          auto timestamp = util::fast::parseTimestamp(data, size);
+          if (timestamp.has_value() && timeZone != nullptr) {
+            try {
+              timestamp->toGMT(*timeZone);
+            } catch (const std::exception&) {
+              // Times that do not exist in 'timeZone' are reported by the
+              // regular cast.
+              return std::nullopt;
+            }
+          }
+          return timestamp;
+        });
+  }
+  if (!castRows->hasSelections()) {
+    return;
+  }
+
   switch (hooks_->getPolicy()) {
     case LegacyCastPolicy:
-      applyToSelectedNoThrowLocal(context, rows, result, [&](int row) {
+      applyToSelectedNoThrowLocal(context, *castRows, result, [&](int row) {
         applyCastKernel<ToKind, FromKind, util::LegacyCastPolicy>(
             row, context, inputSimpleVector, resultFlatVector);
       });
       break;
     case PrestoCastPolicy:
-      applyToSelectedNoThrowLocal(context, rows, result, [&](int row) {
+      applyToSelectedNoThrowLocal(context, *castRows, result, [&](int row) {
         applyCastKernel<ToKind, FromKind, util::PrestoCastPolicy>(
             row, context, inputSimpleVector, resultFlatVector);
       });
       break;
     case SparkCastPolicy:
-      applyToSelectedNoThrowLocal(context, rows, result, [&](int row) {
+      applyToSelectedNoThrowLocal(context, *castRows, result, [&](int row) {
         applyCastKernel<ToKind, FromKind, util::SparkCastPolicy>(
             row, context, inputSimpleVector, resultFlatVector);
       });
       break;
     case SparkTryCastPolicy:
-      applyToSelectedNoThrowLocal(context, rows, result, [&](int row) {
+      applyToSelectedNoThrowLocal(context, *castRows, result, [&](int row) {
         applyCastKernel<ToKind, FromKind, util::SparkTryCastPolicy>(
             row, context, inputSimpleVector, resultFlatVector);
       });
@@ -202,7 +202,16 @@ VectorPtr CastExpr::castToDate(
   switch (fromType->kind()) {
     case TypeKind::VARCHAR: {
       auto* inputVector = input.as<SimpleVector<StringView>>();
-      applyToSelectedNoThrowLocal(context, rows, castResult, [&](int row) {
+      LocalSelectivityVector remainingHolder(context);
+      const auto* castRows = applyFastStringCast(
+          rows,
+          input,
+          resultFlatVector,
+          remainingHolder,
+          [](const char* data, size_t size) {
+            return util::fast::parseDate(data, size);
+          });
+      applyToSelectedNoThrowLocal(context, *castRows, castResult, [&](int row) {
         bool wrapException = true;
         try {
           const auto result =
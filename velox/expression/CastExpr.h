@@ -279,6 +279,20 @@ class CastExpr : public SpecialForm {
       const BaseVector& input,
       VectorPtr& result);
 
+  /// Converts the rows of a flat VARCHAR 'input' that 'parse' accepts and
+  /// writes them to 'result'. 'parse' takes the string data and size and
+  /// returns std::optional<T>, which is std::nullopt for rows left to the
+  /// regular cast. Returns the rows that were not converted, which are
+  /// allocated in 'remainingHolder'. Only applies with the Presto cast policy,
+  /// otherwise returns 'rows'.
+  template <typename T, typename TParse>
+  const SelectivityVector* applyFastStringCast(
+      const SelectivityVector& rows,
+      const BaseVector& input,
+      FlatVector<T>* result,
+      LocalSelectivityVector& remainingHolder,
+      TParse&& parse);
+
   template <typename FromNativeType>
   VectorPtr applyDecimalToVarcharCast(
       const SelectivityVector& rows,
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/expression/DictionaryResultCache.h"
+
+#include "velox/common/base/BitUtil.h"
+
+namespace facebook::velox::exec {
+
+// static
+uint64_t DictionaryResultCache::hashValues(const BaseVector& base) {
+  uint64_t hash = base.size();
+  for (vector_size_t i = 0; i < base.size(); ++i) {
+    hash = bits::hashMix(hash, base.hashValueAt(i));
+  }
+  return hash;
+}
+
+// static
+bool DictionaryResultCache::equalValues(
+    const BaseVector& left,
+    const BaseVector& right) {
+  if (left.size() != right.size() || !left.type()->equivalent(*right.type())) {
+    return false;
+  }
+  for (vector_size_t i = 0; i < left.size(); ++i) {
+    if (!left.equalValueAt(&right, i, i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::optional<DictionaryResultCache::Entry> DictionaryResultCache::take(
+    const Expr* expr,
+    const BaseVector& base) {
+  ++numLookups_;
+  auto it = entries_.find(Key{expr, hashValues(base)});
+  if (it == entries_.end() || !equalValues(*it->second->entry.base, base)) {
+    return std::nullopt;
+  }
+  ++numHits_;
+  auto entry = std::move(it->second->entry);
+  evict(it->second);
+  return entry;
+}
+
+void DictionaryResultCache::put(const Expr* expr, Entry entry) {
+  VELOX_CHECK_NOT_NULL(entry.base);
+  VELOX_CHECK_NOT_NULL(entry.results);
+  VELOX_CHECK_NOT_NULL(entry.rows);
+  const Key key{expr, hashValues(*entry.base)};
+  if (auto it = entries_.find(key); it != entries_.end()) {
+    evict(it->second);
+  }
+  const auto entryBytes =
+      entry.base->retainedSize() + entry.results->retainedSize();
+  if (entryBytes > maxBytes_) {
+    return;
+  }
+  while (bytes_ + entryBytes > maxBytes_) {
+    evict(std::prev(lru_.end()));
+  }
+  lru_.push_front(CachedEntry{key, std::move(entry), entryBytes});
+  entries_[key] = lru_.begin();
+  bytes_ += entryBytes;
+}
+
+void DictionaryResultCache::evict(std::list<CachedEntry>::iterator it) {
+  bytes_ -= it->bytes;
+  entries_.erase(it->key);
+  lru_.erase(it);
+}
+
+void DictionaryResultCache::clear() {
+  lru_.clear();
+  entries_.clear();
+  bytes_ = 0;
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <list>
+#include <optional>
+
+#include <folly/container/F14Map.h>
+
+#include "velox/vector/BaseVector.h"
+#include "velox/vector/SelectivityVector.h"
+
+namespace facebook::velox::exec {
+
+class Expr;
+
+/// Bounded LRU cache of expression results over dictionary base vectors, keyed
+/// by the values of the base vector rather than its identity. Expr memoizes
+/// results only while the same base vector instance recurs. Readers produce a
+/// new base vector for every stripe or row group even if the dictionary is the
+/// same, so without this cache the memoized results are lost at every stripe
+/// boundary. Only used for deterministic functions flagged as expensive and
+/// for casts from VARCHAR.
+///
+/// Owned by an ExprSet. Not thread-safe.
+class DictionaryResultCache {
+ public:
+  /// Memoized state of one Expr for one dictionary.
+  struct Entry {
+    /// The dictionary values the results were computed for.
+    VectorPtr base;
+    /// Results for the rows of 'base' selected in 'rows'.
+    VectorPtr results;
+    std::unique_ptr<SelectivityVector> rows;
+  };
+
+  /// @param maxBytes Upper bound on the retained size of all entries.
+  /// @param maxDictionarySize Dictionaries with more values are not cached.
+  DictionaryResultCache(uint64_t maxBytes, vector_size_t maxDictionarySize)
+      : maxBytes_(maxBytes), maxDictionarySize_(maxDictionarySize) {}
+
+  /// Returns true if results over 'base' may be cached.
+  bool accepts(const BaseVector& base) const {
+    return base.size() <= maxDictionarySize_;
+  }
+
+  /// Removes and returns the entry of 'expr' for a dictionary with the same
+  /// values as 'base'. Returns std::nullopt if there is none.
+  std::optional<Entry> take(const Expr* expr, const BaseVector& base);
+
+  /// Adds 'entry' for 'expr'. Evicts the least recently used entries if the
+  /// cache exceeds its size limit. 'entry' is dropped if it alone exceeds the
+  /// limit.
+  void put(const Expr* expr, Entry entry);
+
+  void clear();
+
+  uint64_t bytes() const {
+    return bytes_;
+  }
+
+  size_t numEntries() const {
+    return entries_.size();
+  }
+
+  uint64_t numHits() const {
+    return numHits_;
+  }
+
+  uint64_t numLookups() const {
+    return numLookups_;
+  }
+
+ private:
+  using Key = std::pair<const Expr*, uint64_t>;
+
+  struct CachedEntry {
+    Key key;
+    Entry entry;
+    uint64_t bytes;
+  };
+
+  static uint64_t hashValues(const BaseVector& base);
+
+  static bool equalValues(const BaseVector& left, const BaseVector& right);
+
+  void evict(std::list<CachedEntry>::iterator it);
+
+  const uint64_t maxBytes_;
+  const vector_size_t maxDictionarySize_;
+
+  // Most recently used first.
+  std::list<CachedEntry> lru_;
+  folly::F14FastMap<Key, std::list<CachedEntry>::iterator> entries_;
+  uint64_t bytes_{0};
+  uint64_t numHits_{0};
+  uint64_t numLookups_{0};
+};
+
+} // namespace facebook::velox::exec
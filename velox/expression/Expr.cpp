@@ -778,11 +778,22 @@ std::shared_ptr<const ExceptionContextProperties> onExceptionProperties(
 }
 } // namespace
 
+int32_t Expr::profileLabelId(process::StackSampler* sampler) {
+  if (sampler != profileSampler_) {
+    profileLabelId_ = sampler->labelId(name_);
+    profileSampler_ = sampler;
+  }
+  return profileLabelId_;
+}
+
 void Expr::evalFlatNoNulls(
     const SelectivityVector& rows,
     EvalCtx& context,
     VectorPtr& result,
     const ExprSet* parentExprSet) {
+  auto* sampler = process::ScopedProfileFrame::currentSampler();
+  process::ScopedProfileFrame profileFrame(
+      sampler, sampler ? profileLabelId(sampler) : 0);
   if (shouldEvaluateSharedSubexp(context)) {
     evaluateSharedSubexpr(
         rows,
@@ -858,6 +869,10 @@ void Expr::eval(
     return;
   }
 
+  auto* sampler = process::ScopedProfileFrame::currentSampler();
+  process::ScopedProfileFrame profileFrame(
+      sampler, sampler ? profileLabelId(sampler) : 0);
+
   // Make sure to include current expression in the error message in case of
   // an exception.
   ExprExceptionContext exprExceptionContext{this, context.row(), parentExprSet};
@@ -1298,30 +1313,49 @@ void Expr::evalWithMemo(
 
   if (base.get() != baseOfDictionaryRawPtr_ ||
       baseOfDictionaryWeakPtr_.expired()) {
+    auto* resultCache = dictionaryResultCache(context);
+    if (resultCache != nullptr && baseOfDictionary_ != nullptr &&
+        dictionaryCache_ != nullptr && cachedDictionaryIndices_ != nullptr &&
+        resultCache->accepts(*baseOfDictionary_)) {
+      resultCache->put(
+          this,
+          {std::move(baseOfDictionary_),
+           std::move(dictionaryCache_),
+           std::move(cachedDictionaryIndices_)});
+    }
     baseOfDictionaryRepeats_ = 0;
     baseOfDictionaryWeakPtr_.reset();
     baseOfDictionaryRawPtr_ = nullptr;
     context.releaseVector(baseOfDictionary_);
     context.releaseVector(dictionaryCache_);
 
-    evalWithNulls(rows, context, result);
+    if (resultCache == nullptr || !resultCache->accepts(*base)) {
+      evalWithNulls(rows, context, result);
+      baseOfDictionaryWeakPtr_ = base;
+      baseOfDictionaryRawPtr_ = base.get();
+      return;
+    }
+
     baseOfDictionaryWeakPtr_ = base;
     baseOfDictionaryRawPtr_ = base.get();
-    return;
-  }
-
-  if (baseOfDictionaryRepeats_ == 0) {
-    evalWithNulls(rows, context, result);
+    auto entry = resultCache->take(this, *base);
+    if (!entry.has_value()) {
+      // Memoize from the first batch so that the results can be put in the
+      // cache when the base changes, even if it never repeats.
+      evalWithNulls(rows, context, result);
+      memoizeFirstResult(rows, base, result, context);
+      return;
+    }
 
-    ++baseOfDictionaryRepeats_;
+    // An earlier base vector had the same values. Continue from its results.
+    baseOfDictionaryRepeats_ = 1;
     baseOfDictionary_ = base;
-    dictionaryCache_ = result;
-    if (!cachedDictionaryIndices_) {
-      cachedDictionaryIndices_ =
-          context.execCtx()->getSelectivityVector(rows.end());
-    }
-    *cachedDictionaryIndices_ = rows;
-    context.deselectErrors(*cachedDictionaryIndices_);
+    dictionaryCache_ = std::move(entry->results);
+    cachedDictionaryIndices_ = std::move(entry->rows);
+    context.exprSet()->addToMemo(this);
+  } else if (baseOfDictionaryRepeats_ == 0) {
+    evalWithNulls(rows, context, result);
+    memoizeFirstResult(rows, base, result, context);
     return;
   }
 
@@ -1384,6 +1418,38 @@ void Expr::evalWithMemo(
   context.releaseVector(base);
 }
 
+void Expr::memoizeFirstResult(
+    const SelectivityVector& rows,
+    const VectorPtr& base,
+    const VectorPtr& result,
+    EvalCtx& context) {
+  ++baseOfDictionaryRepeats_;
+  baseOfDictionary_ = base;
+  dictionaryCache_ = result;
+  if (!cachedDictionaryIndices_) {
+    cachedDictionaryIndices_ =
+        context.execCtx()->getSelectivityVector(rows.end());
+  }
+  *cachedDictionaryIndices_ = rows;
+  context.deselectErrors(*cachedDictionaryIndices_);
+}
+
+DictionaryResultCache* Expr::dictionaryResultCache(
+    const EvalCtx& context) const {
+  if (context.exprSet() == nullptr) {
+    return nullptr;
+  }
+  // Casts from strings parse every row, like the expensive functions.
+  const bool parsingCast = isCast() && inputs_.size() == 1 &&
+      inputs_[0]->type()->kind() == TypeKind::VARCHAR;
+  const bool expensiveFunction =
+      vectorFunction_ != nullptr && vectorFunctionMetadata_.expensive;
+  if (!parsingCast && !expensiveFunction) {
+    return nullptr;
+  }
+  return context.exprSet()->dictionaryResultCache();
+}
+
 void Expr::setAllNulls(
     const SelectivityVector& rows,
     EvalCtx& context,
@@ -2090,6 +2156,12 @@ ExprSet::ExprSet(
           execCtx->queryCtx()
               ->queryConfig()
               .exprAdaptiveCpuSamplingMaxOverheadPct()) {
+  const auto& queryConfig = execCtx->queryCtx()->queryConfig();
+  if (const auto maxBytes = queryConfig.exprDictionaryResultCacheMaxBytes();
+      maxBytes > 0) {
+    dictionaryResultCache_ = std::make_unique<DictionaryResultCache>(
+        maxBytes, queryConfig.exprDictionaryResultCacheMaxDictionarySize());
+  }
   exprs_ = compileExpressions(sources, execCtx, this, enableConstantFolding);
   if (lazyDereference_) {
     validateLazyDereference(exprs_);
@@ -2402,12 +2474,18 @@ void ExprSet::clear() {
     memo->clearMemo();
   }
   memoizingExprs_.clear();
+  if (dictionaryResultCache_) {
+    dictionaryResultCache_->clear();
+  }
 }
 
 void ExprSet::clearCache() {
   for (auto& expr : exprs_) {
     expr->clearCache();
   }
+  if (dictionaryResultCache_) {
+    dictionaryResultCache_->clear();
+  }
 }
 
 void ExprSetSimplified::eval(
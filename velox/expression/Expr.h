@@ -21,9 +21,11 @@
 
 #include <folly/container/F14Map.h>
 
+#include "velox/common/process/StackSampler.h"
 #include "velox/common/time/CpuWallTimer.h"
 #include "velox/core/ExpressionEvaluator.h"
 #include "velox/exec/trace/TraceWriter.h"
+#include "velox/expression/DictionaryResultCache.h"
 #include "velox/expression/EvalCtx.h"
 #include "velox/expression/ExprStats.h"
 #include "velox/expression/VectorFunction.h"
@@ -515,6 +517,19 @@ class Expr {
       EvalCtx& context,
       VectorPtr& result);
 
+  // Remembers 'result' for 'rows' of dictionary base vector 'base' after the
+  // first evaluation over 'base'.
+  void memoizeFirstResult(
+      const SelectivityVector& rows,
+      const VectorPtr& base,
+      const VectorPtr& result,
+      EvalCtx& context);
+
+  // Returns the cross-batch dictionary result cache if 'this' calls an
+  // expensive function or casts from VARCHAR and the cache is enabled, nullptr
+  // otherwise.
+  DictionaryResultCache* dictionaryResultCache(const EvalCtx& context) const;
+
   void evalWithNulls(
       const SelectivityVector& rows,
       EvalCtx& context,
@@ -598,6 +613,9 @@ class Expr {
       EvalCtx& context,
       VectorPtr& result);
 
+  // Returns the id of the frame label of 'this' in 'sampler'.
+  int32_t profileLabelId(process::StackSampler* sampler);
+
  protected:
   void appendInputs(std::stringstream& stream) const;
 
@@ -709,6 +727,11 @@ class Expr {
 
   bool isMultiplyReferenced_ = false;
 
+  // The task profile sampler that 'this' last ran under and the id of the
+  // label of 'this' in it.
+  process::StackSampler* profileSampler_{nullptr};
+  int32_t profileLabelId_{0};
+
   std::vector<VectorPtr> inputValues_;
 
   /// Represents a set of inputs referenced by 'distinctFields_' that are
@@ -903,6 +926,12 @@ class ExprSet {
     memoizingExprs_.insert(expr);
   }
 
+  /// Returns the cache of results over dictionaries that outlives a change of
+  /// dictionary base vector, or nullptr if the cache is disabled.
+  DictionaryResultCache* dictionaryResultCache() const {
+    return dictionaryResultCache_.get();
+  }
+
   /// Sets up expression-level tracers on all expressions in this set.
   void maybeSetupTracers(const Operator& op, const trace::TraceCtx& traceCtx);
 
@@ -945,6 +974,10 @@ class ExprSet {
 
   // Exprs which retain memoized state, e.g. from running over dictionaries.
   std::unordered_set<Expr*> memoizingExprs_;
+
+  // Results of expensive functions over earlier dictionary base vectors.
+  // nullptr if disabled.
+  std::unique_ptr<DictionaryResultCache> dictionaryResultCache_;
   core::ExecCtx* const execCtx_;
   const bool lazyDereference_;
 
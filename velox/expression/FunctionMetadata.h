@@ -49,6 +49,13 @@ struct VectorFunctionMetadata {
   /// The owner/team responsible for this function. Used for logging and
   /// attribution.
   std::string_view owner{""};
+
+  /// True if evaluating the function costs much more CPU per row than typical
+  /// arithmetic or comparison, e.g. regular expressions or geospatial
+  /// predicates. FilterProject may split the rows of projections that contain
+  /// such functions into slices evaluated in parallel. See
+  /// 'expression.parallel_slices' query config.
+  bool expensive{false};
 };
 
 class VectorFunctionMetadataBuilder {
@@ -78,6 +85,11 @@ class VectorFunctionMetadataBuilder {
     return *this;
   }
 
+  VectorFunctionMetadataBuilder& expensive(bool expensive) {
+    metadata_.expensive = expensive;
+    return *this;
+  }
+
   const VectorFunctionMetadata& build() const {
     return metadata_;
   }
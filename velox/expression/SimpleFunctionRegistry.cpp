@@ -134,7 +134,8 @@ SimpleFunctionRegistry::getFunctionSignaturesAndMetadata(
             .defaultNullBehavior =
                 functions[0]->getMetadata().defaultNullBehavior(),
             .companionFunction = false,
-            .owner = functions[0]->getMetadata().owner()};
+            .owner = functions[0]->getMetadata().owner(),
+            .expensive = functions[0]->getMetadata().isExpensive()};
         result.emplace_back(
             std::pair<VectorFunctionMetadata, const FunctionSignature*>{
                 metadata, &signature});
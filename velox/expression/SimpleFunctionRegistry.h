@@ -147,7 +147,8 @@ class SimpleFunctionRegistry {
           functionEntry_.getMetadata().isDeterministic(),
           functionEntry_.getMetadata().defaultNullBehavior(),
           false,
-          functionEntry_.getMetadata().owner()};
+          functionEntry_.getMetadata().owner(),
+          functionEntry_.getMetadata().isExpensive()};
     }
 
    private:
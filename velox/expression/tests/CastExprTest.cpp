@@ -777,6 +777,57 @@ TEST_F(CastExprTest, stringToTimestamp) {
   testCast<std::string, Timestamp>("timestamp", input, expected);
 }
 
+TEST_F(CastExprTest, canonicalAndNonCanonicalStrings) {
+  // Canonical strings are converted in a batch. Other rows, including invalid
+  // ones, fall back to the per-row cast in the same vector.
+  testTryCast<std::string, int64_t>(
+      "bigint",
+      {"123456789012",
+       " 42 ",
+       "-9223372036854775808",
+       "abc",
+       "-0",
+       std::nullopt,
+       "12345678901234567890"},
+      {123456789012,
+       42,
+       std::numeric_limits<int64_t>::min(),
+       std::nullopt,
+       0,
+       std::nullopt,
+       std::nullopt});
+  testTryCast<std::string, int8_t>(
+      "tinyint",
+      {"127", "128", "-128", "-129"},
+      {127, std::nullopt, -128, std::nullopt});
+  testTryCast<std::string, int32_t>(
+      "date",
+      {"2024-02-29", "2023-02-29", " 2024-02-29 ", "1969-12-31", "x"},
+      {19'782, std::nullopt, 19'782, -1, std::nullopt},
+      VARCHAR(),
+      DATE());
+  testTryCast<std::string, Timestamp>(
+      "timestamp",
+      {"2000-01-01 12:21:56",
+       "2000-01-01 12:21:56.123",
+       "2000-01-01",
+       "2000-01-01 25:00:00",
+       "1970-01-01 00:00"},
+      {Timestamp(946729316, 0),
+       Timestamp(946729316, 123'000'000),
+       Timestamp(946684800, 0),
+       std::nullopt,
+       Timestamp(0, 0)});
+  testInvalidCast<std::string>(
+      "bigint", {"1", "2", "1a"}, "Cannot cast VARCHAR '1a' to BIGINT.");
+
+  setTimezone("America/Los_Angeles");
+  testCast<std::string, Timestamp>(
+      "timestamp",
+      {"2000-01-01 12:21:56", "2000-01-01 12:21:56 +00:00"},
+      {Timestamp(946758116, 0), Timestamp(946729316, 0)});
+}
+
 TEST_F(CastExprTest, timestampToString) {
   setLegacyCast(false);
   testCast<Timestamp, std::string>(
@@ -2576,6 +2576,111 @@ TEST_F(ExprTest, memo) {
   VELOX_CHECK_EQ(base.use_count(), 1);
 }
 
+TEST_F(ExprTest, dictionaryResultCache) {
+  // Verify that results of expensive functions over a dictionary are reused
+  // for a later base vector with the same values, e.g. a string dictionary
+  // that is read again for every stripe.
+  queryCtx_->testingOverrideConfigUnsafe({
+      {core::QueryConfig::kExprDictionaryResultCacheMaxBytes,
+       std::to_string(1 << 20)},
+  });
+
+  auto makeBase = [&](const std::string& prefix) {
+    return makeFlatVector<std::string>(
+        100, [&](auto row) { return fmt::format("{}{}", prefix, row); });
+  };
+  auto indices = makeIndices(200, [](auto row) { return row % 100; });
+  auto expected =
+      makeFlatVector<bool>(200, [](auto row) { return row % 100 % 10 == 7; });
+
+  auto rowType = ROW({"c0"}, {VARCHAR()});
+  auto exprSet = compileExpression("regexp_like(c0, '7$')", rowType);
+  auto* resultCache = exprSet->dictionaryResultCache();
+  ASSERT_NE(resultCache, nullptr);
+
+  auto [result, stats] = evaluateWithStats(
+      exprSet.get(),
+      makeRowVector({wrapInDictionary(indices, 200, makeBase("a"))}));
+  assertEqualVectors(expected, result);
+  ASSERT_EQ(stats["regexp_like"].numProcessedRows, 100);
+
+  // A new base vector with the same values is served from the cache.
+  std::tie(result, stats) = evaluateWithStats(
+      exprSet.get(),
+      makeRowVector({wrapInDictionary(indices, 200, makeBase("a"))}));
+  assertEqualVectors(expected, result);
+  ASSERT_EQ(stats["regexp_like"].numProcessedRows, 100);
+  ASSERT_EQ(resultCache->numHits(), 1);
+
+  // A base vector with different values is evaluated.
+  std::tie(result, stats) = evaluateWithStats(
+      exprSet.get(),
+      makeRowVector({wrapInDictionary(indices, 200, makeBase("b"))}));
+  assertEqualVectors(expected, result);
+  ASSERT_EQ(stats["regexp_like"].numProcessedRows, 200);
+  ASSERT_EQ(resultCache->numHits(), 1);
+
+  // The results for both dictionaries are retained.
+  std::tie(result, stats) = evaluateWithStats(
+      exprSet.get(),
+      makeRowVector({wrapInDictionary(indices, 200, makeBase("a"))}));
+  assertEqualVectors(expected, result);
+  ASSERT_EQ(stats["regexp_like"].numProcessedRows, 200);
+  ASSERT_EQ(resultCache->numHits(), 2);
+  ASSERT_EQ(resultCache->numEntries(), 1);
+
+  exprSet->clear();
+  ASSERT_EQ(resultCache->numEntries(), 0);
+  ASSERT_EQ(resultCache->bytes(), 0);
+}
+
+TEST_F(ExprTest, dictionaryResultCacheParsing) {
+  // Verify that casts from VARCHAR and the URL, JSON and date parsing
+  // functions use the dictionary result cache.
+  queryCtx_->testingOverrideConfigUnsafe({
+      {core::QueryConfig::kExprDictionaryResultCacheMaxBytes,
+       std::to_string(1 << 20)},
+  });
+
+  auto indices = makeIndices(200, [](auto row) { return row % 100; });
+  auto makeInput = [&]() {
+    return makeRowVector({wrapInDictionary(
+        indices,
+        200,
+        makeFlatVector<std::string>(100, [](auto row) {
+          return fmt::format("2024-{:02}-{:02}", row % 12 + 1, row % 28 + 1);
+        }))});
+  };
+
+  auto rowType = ROW({"c0"}, {VARCHAR()});
+  for (const auto* sql :
+       {"cast(c0 as date)",
+        "try_cast(c0 as timestamp)",
+        "url_extract_path(c0)",
+        "json_extract_scalar(c0, '$')",
+        "parse_datetime(c0, 'yyyy-MM-dd')",
+        "date_parse(c0, '%Y-%m-%d')"}) {
+    SCOPED_TRACE(sql);
+    auto exprSet = compileExpression(sql, rowType);
+    auto* resultCache = exprSet->dictionaryResultCache();
+    ASSERT_NE(resultCache, nullptr);
+    auto expected = evaluateWithStats(exprSet.get(), makeInput()).first;
+    auto result = evaluateWithStats(exprSet.get(), makeInput()).first;
+    assertEqualVectors(expected, result);
+    ASSERT_EQ(resultCache->numHits(), 1);
+  }
+
+  // Cheap functions are not cached.
+  for (const auto* sql :
+       {"upper(c0)", "url_encode(c0)", "from_iso8601_date(c0)"}) {
+    SCOPED_TRACE(sql);
+    auto exprSet = compileExpression(sql, rowType);
+    evaluateWithStats(exprSet.get(), makeInput());
+    evaluateWithStats(exprSet.get(), makeInput());
+    ASSERT_EQ(exprSet->dictionaryResultCache()->numHits(), 0);
+  }
+}
+
 // This test triggers the situation when peelEncodings() produces an empty
 // selectivity vector, which if passed to evalWithMemo() causes the latter to
 // produce null Expr::dictionaryCache_, which leads to a crash in evaluation
@@ -115,6 +115,14 @@ DEFINE_bool(
 
 DEFINE_bool(velox_memory_use_hugepages, true, "Use explicit huge pages");
 
+// Used in common/process/StackSampler.cpp
+DEFINE_bool(
+    velox_stack_sampler_enabled,
+    false,
+    "If true, StackSampler may install a SIGPROF handler and a process wide "
+    "ITIMER_PROF timer, e.g. for the CPU profiles of tasks that set "
+    "'task_profile_dir'. The timer interrupts every thread of the process.");
+
 DEFINE_int32(
     cache_prefetch_min_pct,
     80,
@@ -1603,6 +1603,10 @@ template <typename T>
 struct DateParseFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
+  // Interprets the MySQL format for every row, and builds it for every row if
+  // it is not constant.
+  static constexpr bool is_expensive = true;
+
   std::shared_ptr<DateTimeFormatter> format_;
 
   // By default, assume 0 (GMT).
@@ -1730,6 +1734,10 @@ template <typename T>
 struct ParseDateTimeFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
+  // Interprets the Joda format for every row, and builds it for every row if
+  // it is not constant.
+  static constexpr bool is_expensive = true;
+
   std::shared_ptr<DateTimeFormatter> format_;
   const tz::TimeZone* sessionTimeZone_{tz::locateZone(0)}; // GMT
   bool isConstFormat_ = false;
@@ -930,9 +930,10 @@ VELOX_DECLARE_VECTOR_FUNCTION(
     JsonFormatFunction::signatures(),
     std::make_unique<JsonFormatFunction>());
 
-VELOX_DECLARE_STATEFUL_VECTOR_FUNCTION(
+VELOX_DECLARE_STATEFUL_VECTOR_FUNCTION_WITH_METADATA(
     udf_json_extract,
     JsonExtractFunction::signatures(),
+    exec::VectorFunctionMetadataBuilder().expensive(true).build(),
     [](const std::string& /*name*/,
        const std::vector<exec::VectorFunctionArg>&,
        const velox::core::QueryConfig&) {
@@ -948,9 +949,10 @@ VELOX_DECLARE_STATEFUL_VECTOR_FUNCTION(
       return std::make_shared<JsonArrayGetFunction>();
     });
 
-VELOX_DECLARE_STATEFUL_VECTOR_FUNCTION(
+VELOX_DECLARE_STATEFUL_VECTOR_FUNCTION_WITH_METADATA(
     udf_json_parse,
     JsonParseFunction::signatures(),
+    exec::VectorFunctionMetadataBuilder().expensive(true).build(),
     [](const std::string& /*name*/,
        const std::vector<exec::VectorFunctionArg>&,
        const velox::core::QueryConfig&) {
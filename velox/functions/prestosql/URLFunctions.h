@@ -239,6 +239,9 @@ template <typename T>
 struct UrlExtractProtocolFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
+  // Validates and splits the whole URL on every row.
+  static constexpr bool is_expensive = true;
+
   // Results refer to strings in the first argument.
   static constexpr int32_t reuse_strings_from_arg = 0;
 
@@ -263,6 +266,9 @@ template <typename T>
 struct UrlExtractFragmentFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
+  // Validates and splits the whole URL on every row.
+  static constexpr bool is_expensive = true;
+
   // Results refer to strings in the first argument.
   static constexpr int32_t reuse_strings_from_arg = 0;
 
@@ -290,6 +296,9 @@ template <typename T>
 struct UrlExtractHostFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
+  // Validates and splits the whole URL on every row.
+  static constexpr bool is_expensive = true;
+
   // Results refer to strings in the first argument.
   static constexpr int32_t reuse_strings_from_arg = 0;
 
@@ -317,6 +326,9 @@ template <typename T>
 struct UrlExtractPortFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
+  // Validates and splits the whole URL on every row.
+  static constexpr bool is_expensive = true;
+
   FOLLY_ALWAYS_INLINE bool call(int64_t& result, const arg_type<Varchar>& url) {
     URI uri;
     if (!parseUri(url, uri)) {
@@ -339,6 +351,9 @@ template <typename T>
 struct UrlExtractPathFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
+  // Validates and splits the whole URL on every row.
+  static constexpr bool is_expensive = true;
+
   // Input is always ASCII, but result may or may not be ASCII.
 
   // Results refer to strings in the first argument.
@@ -366,6 +381,9 @@ template <typename T>
 struct UrlExtractQueryFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
+  // Validates and splits the whole URL on every row.
+  static constexpr bool is_expensive = true;
+
   // Results refer to strings in the first argument.
   static constexpr int32_t reuse_strings_from_arg = 0;
 
@@ -393,6 +411,10 @@ template <typename T>
 struct UrlExtractParameterFunction {
   VELOX_DEFINE_FUNCTION_TYPES(T);
 
+  // Validates and splits the whole URL, then scans its query for 'param', on
+  // every row.
+  static constexpr bool is_expensive = true;
+
   // Results refer to strings in the first argument.
   static constexpr int32_t reuse_strings_from_arg = 0;
 
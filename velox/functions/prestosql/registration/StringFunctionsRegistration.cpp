@@ -221,14 +221,23 @@ void registerStringFunctions(const std::string& prefix) {
   VELOX_REGISTER_VECTOR_FUNCTION(udf_from_utf8, prefix + "from_utf8");
 
   // Regex functions
+  const auto regexMetadata =
+      exec::VectorFunctionMetadataBuilder().expensive(true).build();
   exec::registerStatefulVectorFunction(
-      prefix + "regexp_extract", re2ExtractSignatures(), makeRegexExtract);
+      prefix + "regexp_extract",
+      re2ExtractSignatures(),
+      makeRegexExtract,
+      regexMetadata);
   exec::registerStatefulVectorFunction(
       prefix + "regexp_extract_all",
       re2ExtractAllSignatures(),
-      makeRe2ExtractAll);
+      makeRe2ExtractAll,
+      regexMetadata);
   exec::registerStatefulVectorFunction(
-      prefix + "regexp_like", re2SearchSignatures(), makeRe2Search);
+      prefix + "regexp_like",
+      re2SearchSignatures(),
+      makeRe2Search,
+      regexMetadata);
 
   registerFunction<StrLPosFunction, int64_t, Varchar, Varchar>(
       {prefix + "strpos"});
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/serializers/AdaptiveCodecSelector.h"
+
+#include "velox/common/EnumDefine.h"
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::serializer::presto {
+namespace {
+// The weight of the latest measurement in the moving averages.
+constexpr double kEstimateWeight{0.25};
+constexpr double kConsumerWaitWeight{0.125};
+
+const auto& codecNames() {
+  using Codec = AdaptiveCodecSelector::Codec;
+  static const folly::F14FastMap<Codec, std::string_view> kNames = {
+      {Codec::kNone, "NONE"},
+      {Codec::kLz4, "LZ4"},
+      {Codec::kZstdFast, "ZSTD_FAST"},
+      {Codec::kZstd, "ZSTD"},
+  };
+  return kNames;
+}
+} // namespace
+
+VELOX_DEFINE_EMBEDDED_ENUM_NAME(AdaptiveCodecSelector, Codec, codecNames)
+
+AdaptiveCodecSelector::AdaptiveCodecSelector(Options options)
+    : options_(options) {
+  VELOX_CHECK_GT(options_.sampleInterval, 0);
+}
+
+bool AdaptiveCodecSelector::startPage() {
+  std::lock_guard<std::mutex> l(mutex_);
+  const bool sample = numStartedPages_++ % options_.sampleInterval == 0;
+  if (sample) {
+    ++stats_.numSampledPages;
+  }
+  return sample;
+}
+
+AdaptiveCodecSelector::Codec AdaptiveCodecSelector::chooseCodec(
+    float minCompressionRatio) {
+  std::lock_guard<std::mutex> l(mutex_);
+  const bool preferRatio =
+      consumerWaitShare_ >= options_.minConsumerWaitShare;
+  auto best = Codec::kNone;
+  for (auto i = 1; i < kNumCodecs; ++i) {
+    const auto& estimate = estimates_[i];
+    if (!estimate.measured || estimate.ratio > minCompressionRatio) {
+      continue;
+    }
+    if (best == Codec::kNone) {
+      best = static_cast<Codec>(i);
+      continue;
+    }
+    const auto& bestEstimate = estimates_[static_cast<int32_t>(best)];
+    if (preferRatio ? estimate.ratio < bestEstimate.ratio
+                    : estimate.nanosPerByte < bestEstimate.nanosPerByte) {
+      best = static_cast<Codec>(i);
+    }
+  }
+  ++stats_.numPages[static_cast<int32_t>(best)];
+  return best;
+}
+
+void AdaptiveCodecSelector::recordCompression(
+    Codec codec,
+    uint64_t uncompressedBytes,
+    uint64_t compressedBytes,
+    uint64_t nanos) {
+  VELOX_CHECK(codec != Codec::kNone);
+  if (uncompressedBytes == 0) {
+    return;
+  }
+  const double ratio = static_cast<double>(compressedBytes) / uncompressedBytes;
+  const double nanosPerByte = static_cast<double>(nanos) / uncompressedBytes;
+  std::lock_guard<std::mutex> l(mutex_);
+  auto& estimate = estimates_[static_cast<int32_t>(codec)];
+  if (!estimate.measured) {
+    estimate.measured = true;
+    estimate.ratio = ratio;
+    estimate.nanosPerByte = nanosPerByte;
+    return;
+  }
+  estimate.ratio += kEstimateWeight * (ratio - estimate.ratio);
+  estimate.nanosPerByte +=
+      kEstimateWeight * (nanosPerByte - estimate.nanosPerByte);
+}
+
+void AdaptiveCodecSelector::recordConsumerWait(bool waited) {
+  std::lock_guard<std::mutex> l(mutex_);
+  consumerWaitShare_ +=
+      kConsumerWaitWeight * ((waited ? 1.0 : 0.0) - consumerWaitShare_);
+}
+
+bool AdaptiveCodecSelector::consumerBound() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return consumerWaitShare_ >= options_.minConsumerWaitShare;
+}
+
+AdaptiveCodecSelector::Stats AdaptiveCodecSelector::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return stats_;
+}
+
+std::unique_ptr<folly::compression::Codec> AdaptiveCodecSelector::makeCodec(
+    Codec codec) const {
+  switch (codec) {
+    case Codec::kNone:
+      return folly::compression::getCodec(
+          folly::compression::CodecType::NO_COMPRESSION);
+    case Codec::kLz4:
+      return folly::compression::getCodec(folly::compression::CodecType::LZ4);
+    case Codec::kZstdFast:
+      return folly::compression::getCodec(
+          folly::compression::CodecType::ZSTD, options_.zstdFastLevel);
+    case Codec::kZstd:
+      return folly::compression::getCodec(
+          folly::compression::CodecType::ZSTD, options_.zstdLevel);
+  }
+  VELOX_UNREACHABLE();
+}
+
+// static
+common::CompressionKind AdaptiveCodecSelector::compressionKind(Codec codec) {
+  switch (codec) {
+    case Codec::kNone:
+      return common::CompressionKind::CompressionKind_NONE;
+    case Codec::kLz4:
+      return common::CompressionKind::CompressionKind_LZ4;
+    case Codec::kZstdFast:
+    case Codec::kZstd:
+      return common::CompressionKind::CompressionKind_ZSTD;
+  }
+  VELOX_UNREACHABLE();
+}
+} // namespace facebook::velox::serializer::presto
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/compression/Compression.h>
+
+#include <array>
+#include <mutex>
+
+#include "velox/common/EnumDeclare.h"
+#include "velox/common/compression/Compression.h"
+
+namespace facebook::velox::serializer::presto {
+
+/// Chooses the codec of each page written by the serializers of
+/// PrestoVectorSerde among no compression, LZ4 and ZSTD at a fast and a strong
+/// level. Every 'sampleInterval' pages, a page is compressed with all the
+/// codecs to measure their compression ratio and speed. The other pages use the
+/// cheapest codec that compresses to 'minCompressionRatio', or the one with the
+/// best ratio while the consumer of the pages is the bottleneck, e.g. while a
+/// PartitionedOutput waits for its output buffer to drain. Pages that no codec
+/// compresses enough are not compressed.
+///
+/// The codec of each page is recorded in its header, so that readers decode any
+/// mix of codecs. One selector is shared by the serializers of a producer, e.g.
+/// all the destinations of a PartitionedOutput, since a serializer only writes
+/// a few pages. Thread safe.
+class AdaptiveCodecSelector {
+ public:
+  /// The codecs to choose from, in increasing order of ratio and CPU cost.
+  enum class Codec : int8_t {
+    kNone = 0,
+    kLz4 = 1,
+    kZstdFast = 2,
+    kZstd = 3,
+  };
+
+  VELOX_DECLARE_EMBEDDED_ENUM_NAME(Codec);
+
+  static constexpr int32_t kNumCodecs{4};
+
+  struct Options {
+    /// Compresses every 'sampleInterval'th page with all the codecs, starting
+    /// with the first page.
+    int32_t sampleInterval{32};
+
+    /// The ZSTD levels of kZstdFast and kZstd.
+    int32_t zstdFastLevel{1};
+    int32_t zstdLevel{7};
+
+    /// The share of the recent pages after which the producer waited for the
+    /// consumer above which the consumer is considered the bottleneck.
+    double minConsumerWaitShare{0.25};
+  };
+
+  struct Stats {
+    /// The number of pages written with each codec, indexed by Codec.
+    std::array<uint64_t, kNumCodecs> numPages{};
+    uint64_t numSampledPages{0};
+  };
+
+  explicit AdaptiveCodecSelector(Options options);
+
+  AdaptiveCodecSelector() : AdaptiveCodecSelector(Options{}) {}
+
+  /// Starts a new page. Returns true if the page should be compressed with all
+  /// the codecs and each compression recorded with recordCompression() before
+  /// calling chooseCodec().
+  bool startPage();
+
+  /// Returns the codec for the current page.
+  Codec chooseCodec(float minCompressionRatio);
+
+  /// Records that 'codec' compressed 'uncompressedBytes' into
+  /// 'compressedBytes' in 'nanos'.
+  void recordCompression(
+      Codec codec,
+      uint64_t uncompressedBytes,
+      uint64_t compressedBytes,
+      uint64_t nanos);
+
+  /// Records whether the producer of the pages waited for their consumer, e.g.
+  /// on a full output buffer, after producing a page.
+  void recordConsumerWait(bool waited);
+
+  /// Returns true if the consumer of the pages is the bottleneck, in which
+  /// case pages are compressed with the best ratio.
+  bool consumerBound() const;
+
+  Stats stats() const;
+
+  /// Returns a new folly codec for 'codec'. Folly codecs are not thread safe,
+  /// so each serializer makes its own.
+  std::unique_ptr<folly::compression::Codec> makeCodec(Codec codec) const;
+
+  /// Returns the kind recorded in the header of the pages compressed with
+  /// 'codec'. Both ZSTD levels decompress with the same codec.
+  static common::CompressionKind compressionKind(Codec codec);
+
+ private:
+  // A moving average of the compression ratio and CPU cost of a codec.
+  struct Estimate {
+    bool measured{false};
+    double ratio{1};
+    double nanosPerByte{0};
+  };
+
+  const Options options_;
+
+  mutable std::mutex mutex_;
+  uint64_t numStartedPages_{0};
+  std::array<Estimate, kNumCodecs> estimates_;
+  // Moving average of the share of the pages after which the producer waited
+  // for the consumer.
+  double consumerWaitShare_{0};
+  Stats stats_;
+};
+
+using AdaptiveCodecSelectorPtr = std::shared_ptr<AdaptiveCodecSelector>;
+} // namespace facebook::velox::serializer::presto
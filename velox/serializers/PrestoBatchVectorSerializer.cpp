@@ -73,8 +73,28 @@ void PrestoBatchVectorSerializer::serialize(
     }
   }
 
-  flushStreams(
-      streams, numRows, arena, *codec_, opts_.minCompressionRatio, stream);
+  if (opts_.codecSelector != nullptr) {
+    const auto [size, compressedSize] = flushAdaptive(
+        streams,
+        numRows,
+        arena,
+        *opts_.codecSelector,
+        opts_.minCompressionRatio,
+        stream);
+    if (compressedSize < size) {
+      stats_.compressionInputBytes += size;
+      stats_.compressedBytes += compressedSize;
+    } else {
+      stats_.compressionSkippedBytes += size;
+    }
+  } else {
+    const auto [size, compressedSize] = flushStreams(
+        streams, numRows, arena, *codec_, opts_.minCompressionRatio, stream);
+    if (needCompression(*codec_)) {
+      stats_.compressionInputBytes += size;
+      stats_.compressedBytes += compressedSize;
+    }
+  }
 }
 
 void PrestoBatchVectorSerializer::estimateSerializedSizeImpl(
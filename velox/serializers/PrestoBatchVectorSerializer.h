@@ -43,6 +43,11 @@ class PrestoBatchVectorSerializer : public BatchVectorSerializer {
     estimateSerializedSizeImpl(vector, ranges, sizes, scratch);
   }
 
+  /// Returns the compression stats of the pages written so far.
+  const CompressionStats& compressionStats() const {
+    return stats_;
+  }
+
  private:
   void estimateSerializedSizeImpl(
       const VectorPtr& vector,
@@ -56,5 +61,6 @@ class PrestoBatchVectorSerializer : public BatchVectorSerializer {
   // Used to protect against concurrent calls to serailize which can lead to
   // concurrency bugs.
   std::atomic_bool inUse{false};
+  CompressionStats stats_;
 };
 } // namespace facebook::velox::serializer::presto::detail
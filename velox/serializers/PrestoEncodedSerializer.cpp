@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/serializers/PrestoEncodedSerializer.h"
+
+#include "velox/serializers/PrestoIterativeVectorSerializer.h"
+#include "velox/serializers/PrestoSerializerSerializationUtils.h"
+
+namespace facebook::velox::serializer::presto {
+
+std::unique_ptr<IterativeVectorSerializer>
+PrestoEncodedVectorSerde::createIterativeSerializer(
+    RowTypePtr type,
+    int32_t numRows,
+    StreamArena* streamArena,
+    const Options* options) {
+  const auto prestoOptions = detail::toPrestoOptions(options);
+  return std::make_unique<detail::PrestoEncodedIterativeVectorSerializer>(
+      streamArena,
+      std::make_unique<detail::PrestoIterativeVectorSerializer>(
+          type, numRows, streamArena, prestoOptions),
+      std::make_unique<detail::PrestoBatchVectorSerializer>(
+          streamArena->pool(), prestoOptions));
+}
+
+// static
+void PrestoEncodedVectorSerde::registerNamedVectorSerde() {
+  detail::initBitsToMapOnce();
+  velox::registerNamedVectorSerde(
+      kSerdeKind, std::make_unique<PrestoEncodedVectorSerde>());
+}
+
+// static
+void PrestoEncodedVectorSerde::tryRegisterNamedVectorSerde() {
+  if (!velox::isRegisteredNamedVectorSerde(kSerdeKind)) {
+    detail::initBitsToMapOnce();
+    velox::registerNamedVectorSerde(
+        kSerdeKind, std::make_unique<PrestoEncodedVectorSerde>());
+  }
+}
+
+namespace detail {
+namespace {
+bool hasEncodedColumns(const RowVector& vector) {
+  for (const auto& child : vector.children()) {
+    const auto encoding = child->encoding();
+    if (encoding == VectorEncoding::Simple::DICTIONARY ||
+        encoding == VectorEncoding::Simple::CONSTANT) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void addBytes(
+    std::unordered_map<std::string, RuntimeCounter>& stats,
+    std::string_view name,
+    int64_t bytes) {
+  if (bytes == 0) {
+    return;
+  }
+  auto [it, inserted] = stats.emplace(
+      std::string(name), RuntimeCounter(bytes, RuntimeCounter::Unit::kBytes));
+  if (!inserted) {
+    it->second.value += bytes;
+  }
+}
+} // namespace
+
+PrestoEncodedIterativeVectorSerializer::PrestoEncodedIterativeVectorSerializer(
+    StreamArena* streamArena,
+    std::unique_ptr<IterativeVectorSerializer> flatSerializer,
+    std::unique_ptr<PrestoBatchVectorSerializer> batchSerializer)
+    : streamArena_(streamArena),
+      flatSerializer_(std::move(flatSerializer)),
+      batchSerializer_(std::move(batchSerializer)) {
+  VELOX_CHECK_NOT_NULL(flatSerializer_);
+  VELOX_CHECK_NOT_NULL(batchSerializer_);
+}
+
+void PrestoEncodedIterativeVectorSerializer::append(
+    const RowVectorPtr& vector,
+    const folly::Range<const IndexRange*>& ranges,
+    Scratch& scratch) {
+  if (rangesTotalSize(ranges) == 0) {
+    return;
+  }
+  if (!hasEncodedColumns(*vector)) {
+    flatSerializer_->append(vector, ranges, scratch);
+    hasFlatRows_ = true;
+    return;
+  }
+  flushFlatRows();
+  batchSerializer_->serialize(vector, ranges, scratch, pages());
+}
+
+void PrestoEncodedIterativeVectorSerializer::append(
+    const RowVectorPtr& vector,
+    const folly::Range<const vector_size_t*>& rows,
+    Scratch& scratch) {
+  if (rows.empty()) {
+    return;
+  }
+  if (!hasEncodedColumns(*vector)) {
+    flatSerializer_->append(vector, rows, scratch);
+    hasFlatRows_ = true;
+    return;
+  }
+  // Coalesces runs of consecutive rows into ranges.
+  ScratchPtr<IndexRange> rangesHolder(scratch);
+  auto* ranges = rangesHolder.get(rows.size());
+  int32_t numRanges = 0;
+  for (const auto row : rows) {
+    if (numRanges > 0 &&
+        ranges[numRanges - 1].begin + ranges[numRanges - 1].size == row) {
+      ++ranges[numRanges - 1].size;
+    } else {
+      ranges[numRanges++] = IndexRange{row, 1};
+    }
+  }
+  append(vector, folly::Range<const IndexRange*>(ranges, numRanges), scratch);
+}
+
+IOBufOutputStream* PrestoEncodedIterativeVectorSerializer::pages() {
+  if (pages_ == nullptr) {
+    pages_ =
+        std::make_unique<IOBufOutputStream>(*streamArena_->pool(), &listener_);
+  }
+  return pages_.get();
+}
+
+void PrestoEncodedIterativeVectorSerializer::flushFlatRows() {
+  if (!hasFlatRows_) {
+    return;
+  }
+  flatSerializer_->flush(pages());
+  flatSerializer_->clear();
+  hasFlatRows_ = false;
+}
+
+size_t PrestoEncodedIterativeVectorSerializer::maxSerializedSize() const {
+  size_t size = pages_ == nullptr ? 0 : static_cast<size_t>(pages_->tellp());
+  if (hasFlatRows_) {
+    size += flatSerializer_->maxSerializedSize();
+  }
+  return size;
+}
+
+void PrestoEncodedIterativeVectorSerializer::flush(OutputStream* out) {
+  flushFlatRows();
+  if (pages_ == nullptr) {
+    return;
+  }
+  const auto iobuf = pages_->getIOBuf();
+  for (const auto& range : *iobuf) {
+    out->write(reinterpret_cast<const char*>(range.data()), range.size());
+  }
+  pages_.reset();
+}
+
+void PrestoEncodedIterativeVectorSerializer::clear() {
+  pages_.reset();
+  flatSerializer_->clear();
+  hasFlatRows_ = false;
+}
+
+std::unordered_map<std::string, RuntimeCounter>
+PrestoEncodedIterativeVectorSerializer::runtimeStats() {
+  auto stats = flatSerializer_->runtimeStats();
+  const auto& batchStats = batchSerializer_->compressionStats();
+  addBytes(stats, kCompressionInputBytes, batchStats.compressionInputBytes);
+  addBytes(stats, kCompressedBytes, batchStats.compressedBytes);
+  addBytes(
+      stats, kCompressionSkippedBytes, batchStats.compressionSkippedBytes);
+  return stats;
+}
+} // namespace detail
+} // namespace facebook::velox::serializer::presto
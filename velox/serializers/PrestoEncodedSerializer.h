@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/serializers/PrestoBatchVectorSerializer.h"
+#include "velox/serializers/PrestoSerializer.h"
+
+namespace facebook::velox::serializer::presto {
+
+/// A serde for shuffles that keeps the dictionary and constant encodings of
+/// the columns on the wire, e.g. of the low cardinality columns produced by
+/// table scans. The iterative serializer writes the rows appended from each
+/// input vector with dictionary or constant columns as a separate PrestoPage
+/// whose columns use the DICTIONARY and RLE encodings of the PrestoPage format,
+/// as BatchVectorSerializer of PrestoVectorSerde does. Dictionaries are
+/// flattened when they do not make the page smaller unless
+/// 'preserveEncodings' is set in the options. The rows appended from vectors
+/// with only flat columns are accumulated into one page, as PrestoVectorSerde
+/// does, so that small batches are compressed together.
+///
+/// The pages are deserialized by PrestoVectorSerde, which returns
+/// DictionaryVector and ConstantVector columns for these encodings when
+/// deserializing a page into a new result, i.e. with a zero 'resultOffset'.
+/// The pages are compatible with PrestoVectorSerde, so either serde can read
+/// the pages written by the other.
+class PrestoEncodedVectorSerde : public PrestoVectorSerde {
+ public:
+  PrestoEncodedVectorSerde() : PrestoVectorSerde(kSerdeKind) {}
+
+  std::unique_ptr<IterativeVectorSerializer> createIterativeSerializer(
+      RowTypePtr type,
+      int32_t numRows,
+      StreamArena* streamArena,
+      const Options* options) override;
+
+  bool preservesEncodings() const override {
+    return true;
+  }
+
+  /// Registers this serde in the named serde registry under kSerdeKind.
+  /// Throws if a serde with the same name is already registered.
+  static void registerNamedVectorSerde();
+
+  /// Registers this serde in the named serde registry under kSerdeKind only
+  /// if not already registered. No-op if a serde with the same name exists.
+  static void tryRegisterNamedVectorSerde();
+
+  /// Returns the name of this serde kind.
+  static const std::string& name() {
+    return kSerdeKind;
+  }
+
+ private:
+  inline static const std::string kSerdeKind{"PrestoEncoded"};
+};
+
+namespace detail {
+
+/// Serializes the rows appended from each vector with dictionary or constant
+/// columns into a separate PrestoPage with 'batchSerializer' and accumulates
+/// the rows of vectors with only flat columns in 'flatSerializer'. The pages
+/// are buffered until flush().
+class PrestoEncodedIterativeVectorSerializer
+    : public IterativeVectorSerializer {
+ public:
+  PrestoEncodedIterativeVectorSerializer(
+      StreamArena* streamArena,
+      std::unique_ptr<IterativeVectorSerializer> flatSerializer,
+      std::unique_ptr<PrestoBatchVectorSerializer> batchSerializer);
+
+  void append(
+      const RowVectorPtr& vector,
+      const folly::Range<const IndexRange*>& ranges,
+      Scratch& scratch) override;
+
+  void append(
+      const RowVectorPtr& vector,
+      const folly::Range<const vector_size_t*>& rows,
+      Scratch& scratch) override;
+
+  size_t maxSerializedSize() const override;
+
+  void flush(OutputStream* out) override;
+
+  void clear() override;
+
+  /// Returns the compression stats of the pages of both serializers.
+  std::unordered_map<std::string, RuntimeCounter> runtimeStats() override;
+
+ private:
+  // Returns 'pages_', creating it if needed.
+  IOBufOutputStream* pages();
+
+  // Writes the rows accumulated in 'flatSerializer_' as a page to 'pages_'.
+  // Keeps the pages in the order of the appends.
+  void flushFlatRows();
+
+  StreamArena* const streamArena_;
+  const std::unique_ptr<IterativeVectorSerializer> flatSerializer_;
+  const std::unique_ptr<PrestoBatchVectorSerializer> batchSerializer_;
+  // Computes the checksums of the pages in 'pages_'.
+  PrestoOutputStreamListener listener_;
+  // The pages written so far. Created on the first page.
+  std::unique_ptr<IOBufOutputStream> pages_;
+  // True if 'flatSerializer_' has rows not yet written to 'pages_'.
+  bool hasFlatRows_{false};
+};
+} // namespace detail
+} // namespace facebook::velox::serializer::presto
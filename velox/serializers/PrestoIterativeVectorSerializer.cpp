@@ -65,15 +65,32 @@ void PrestoIterativeVectorSerializer::append(
   }
 }
 
+void PrestoIterativeVectorSerializer::appendColumn(
+    const RowVectorPtr& vector,
+    column_index_t column,
+    const folly::Range<const vector_size_t*>& rows,
+    Scratch& scratch) {
+  if (rows.empty()) {
+    return;
+  }
+  if (column == 0) {
+    numRows_ += rows.size();
+  }
+  serializeColumn(vector->childAt(column), rows, &streams_[column], scratch);
+}
+
 size_t PrestoIterativeVectorSerializer::maxSerializedSize() const {
   size_t dataSize = 4; // streams_.size()
   for (auto& stream : streams_) {
     dataSize += const_cast<VectorStream&>(stream).serializedSize();
   }
 
-  auto compressedSize = needCompression(*codec_)
-      ? codec_->maxCompressedLength(dataSize)
-      : dataSize;
+  // A page compressed with 'opts_.codecSelector' is never larger than the
+  // uncompressed page.
+  const bool compressed =
+      opts_.codecSelector == nullptr && needCompression(*codec_);
+  auto compressedSize =
+      compressed ? codec_->maxCompressedLength(dataSize) : dataSize;
   return kHeaderSize + compressedSize;
 }
 
@@ -82,7 +99,7 @@ size_t PrestoIterativeVectorSerializer::maxSerializedSize() const {
 // checksum(8) | data
 void PrestoIterativeVectorSerializer::flush(OutputStream* out) {
   constexpr int32_t kMaxCompressionAttemptsToSkip = 30;
-  if (!needCompression(*codec_)) {
+  if (opts_.codecSelector == nullptr && !needCompression(*codec_)) {
     flushStreams(
         streams_,
         numRows_,
@@ -101,6 +118,8 @@ void PrestoIterativeVectorSerializer::flush(OutputStream* out) {
       auto [size, ignore] = flushStreams(
           streams_, numRows_, *streamArena_, *noCompressionCodec, 1, out);
       stats_.compressionSkippedBytes += size;
+    } else if (opts_.codecSelector != nullptr) {
+      flushWithCodecSelector(out);
     } else if (numCompressionToSkip_ > 0) {
       auto [size, ignore] = flushStreams(
           streams_, numRows_, *streamArena_, *noCompressionCodec, 1, out);
@@ -125,6 +144,23 @@ void PrestoIterativeVectorSerializer::flush(OutputStream* out) {
   }
 }
 
+void PrestoIterativeVectorSerializer::flushWithCodecSelector(
+    OutputStream* out) {
+  auto [size, compressedSize] = flushAdaptive(
+      streams_,
+      numRows_,
+      *streamArena_,
+      *opts_.codecSelector,
+      opts_.minCompressionRatio,
+      out);
+  if (compressedSize < size) {
+    stats_.compressionInputBytes += size;
+    stats_.compressedBytes += compressedSize;
+  } else {
+    stats_.compressionSkippedBytes += size;
+  }
+}
+
 std::unordered_map<std::string, RuntimeCounter>
 PrestoIterativeVectorSerializer::runtimeStats() {
   std::unordered_map<std::string, RuntimeCounter> map;
@@ -39,6 +39,16 @@ class PrestoIterativeVectorSerializer : public IterativeVectorSerializer {
       const folly::Range<const vector_size_t*>& rows,
       Scratch& scratch) override;
 
+  bool supportsAppendColumn() const override {
+    return true;
+  }
+
+  void appendColumn(
+      const RowVectorPtr& vector,
+      column_index_t column,
+      const folly::Range<const vector_size_t*>& rows,
+      Scratch& scratch) override;
+
   size_t maxSerializedSize() const override;
 
   // The SerializedPage layout is:
@@ -51,6 +61,9 @@ class PrestoIterativeVectorSerializer : public IterativeVectorSerializer {
   void clear() override;
 
  private:
+  // Flushes with the codec chosen by 'opts_.codecSelector'.
+  void flushWithCodecSelector(OutputStream* out);
+
   const PrestoVectorSerde::PrestoOptions opts_;
   StreamArena* const streamArena_;
   const std::unique_ptr<folly::compression::Codec> codec_;
@@ -78,7 +78,9 @@ int64_t computeChecksum(
 
   return checksum;
 }
+} // namespace
 
+namespace detail {
 PrestoVectorSerde::PrestoOptions toPrestoOptions(
     const VectorSerde::Options* options) {
   if (options == nullptr) {
@@ -94,7 +96,7 @@ PrestoVectorSerde::PrestoOptions toPrestoOptions(
       "useLosslessTimestamp and useMicrosecondPrecision are mutually exclusive");
   return *prestoOptions;
 }
-} // namespace
+} // namespace detail
 
 void PrestoVectorSerde::estimateSerializedSize(
     const BaseVector* vector,
@@ -120,7 +122,7 @@ PrestoVectorSerde::createIterativeSerializer(
     int32_t numRows,
     StreamArena* streamArena,
     const Options* options) {
-  const auto prestoOptions = toPrestoOptions(options);
+  const auto prestoOptions = detail::toPrestoOptions(options);
   return std::make_unique<detail::PrestoIterativeVectorSerializer>(
       type, numRows, streamArena, prestoOptions);
 }
@@ -128,7 +130,7 @@ PrestoVectorSerde::createIterativeSerializer(
 std::unique_ptr<BatchVectorSerializer> PrestoVectorSerde::createBatchSerializer(
     memory::MemoryPool* pool,
     const Options* options) {
-  const auto prestoOptions = toPrestoOptions(options);
+  const auto prestoOptions = detail::toPrestoOptions(options);
   return std::make_unique<detail::PrestoBatchVectorSerializer>(
       pool, prestoOptions);
 }
@@ -140,9 +142,7 @@ void PrestoVectorSerde::deserialize(
     RowVectorPtr* result,
     vector_size_t resultOffset,
     const Options* options) {
-  const auto prestoOptions = toPrestoOptions(options);
-  const auto codec =
-      common::compressionKindToCodec(prestoOptions.compressionKind);
+  const auto prestoOptions = detail::toPrestoOptions(options);
   auto maybeHeader = detail::PrestoHeader::read(source);
   VELOX_CHECK(
       maybeHeader.hasValue(),
@@ -190,6 +190,10 @@ void PrestoVectorSerde::deserialize(
     source->readBytes(compressBuf->writableData(), header.compressedSize);
     compressBuf->append(header.compressedSize);
 
+    // Pages written with an AdaptiveCodecSelector record their codec.
+    const auto codec = common::compressionKindToCodec(
+        detail::codecKind(header.pageCodecMarker)
+            .value_or(prestoOptions.compressionKind));
     // Process chained uncompressed results IOBufs.
     auto uncompress =
         codec->uncompress(compressBuf.get(), header.uncompressedSize);
@@ -206,7 +210,7 @@ void PrestoVectorSerde::deserializeSingleColumn(
     TypePtr type,
     VectorPtr* result,
     const Options* options) {
-  const auto prestoOptions = toPrestoOptions(options);
+  const auto prestoOptions = detail::toPrestoOptions(options);
   VELOX_CHECK_EQ(
       prestoOptions.compressionKind,
       common::CompressionKind::CompressionKind_NONE);
@@ -233,7 +237,7 @@ void PrestoVectorSerde::serializeSingleColumn(
     const Options* opts,
     memory::MemoryPool* pool,
     std::ostream* output) {
-  const auto prestoOptions = toPrestoOptions(opts);
+  const auto prestoOptions = detail::toPrestoOptions(opts);
   VELOX_USER_CHECK_EQ(
       prestoOptions.compressionKind,
       common::CompressionKind::CompressionKind_NONE);
@@ -282,7 +286,7 @@ void PrestoVectorSerde::tryRegisterNamedVectorSerde() {
     std::string_view source,
     std::vector<Token>& out,
     const Options* options) {
-  const auto prestoOptions = toPrestoOptions(options);
+  const auto prestoOptions = detail::toPrestoOptions(options);
 
   VELOX_RETURN_IF(
       prestoOptions.useLosslessTimestamp,
@@ -19,6 +19,7 @@
 
 #include "velox/common/base/Crc.h"
 #include "velox/common/compression/Compression.h"
+#include "velox/serializers/AdaptiveCodecSelector.h"
 #include "velox/serializers/PrestoVectorLexer.h"
 #include "velox/vector/VectorStream.h"
 
@@ -86,6 +87,13 @@ class PrestoVectorSerde : public VectorSerde {
     /// affect the encoding of the input vectors. This is only relevant when
     /// using BatchVectorSerializer.
     bool preserveEncodings{false};
+
+    /// If set, chooses the codec of each serialized page and records it in
+    /// the page header. 'compressionKind' is then only used to read the pages
+    /// that do not record their codec. Readers of the pages must support
+    /// per-page codecs, so this is only for exchanges between Velox workers
+    /// and for spilling.
+    AdaptiveCodecSelectorPtr codecSelector;
   };
 
   PrestoVectorSerde() : VectorSerde(kSerdeKind) {}
@@ -208,6 +216,11 @@ class PrestoVectorSerde : public VectorSerde {
     return kSerdeKind;
   }
 
+ protected:
+  /// Used by serdes that write Presto pages in a different way, e.g.
+  /// PrestoEncodedVectorSerde, and are registered under their own 'kind'.
+  explicit PrestoVectorSerde(std::string kind) : VectorSerde(std::move(kind)) {}
+
  private:
   inline static const std::string kSerdeKind{"Presto"};
 };
@@ -33,6 +33,16 @@ inline bool isChecksumBitSet(int8_t codec) {
   return (codec & kCheckSumBitMask) == kCheckSumBitMask;
 }
 
+// Returns the kind of the codec recorded in the header of a compressed page or
+// std::nullopt if the page does not record its codec.
+inline std::optional<common::CompressionKind> codecKind(int8_t codec) {
+  const auto kind = (codec & kCodecKindMask) >> kCodecKindShift;
+  if (kind == 0) {
+    return std::nullopt;
+  }
+  return static_cast<common::CompressionKind>(kind);
+}
+
 void readTopColumns(
     ByteInputStream& source,
     const RowTypePtr& type,
@@ -17,6 +17,7 @@
 #include <folly/IPAddressV6.h>
 
 #include "velox/common/memory/ByteStream.h"
+#include "velox/common/time/Timer.h"
 #include "velox/functions/prestosql/types/IPPrefixType.h"
 #include "velox/serializers/PrestoSerializer.h"
 #include "velox/serializers/VectorStream.h"
@@ -30,6 +31,12 @@ namespace facebook::velox::serializer::presto::detail {
 constexpr int8_t kCompressedBitMask = 1;
 constexpr int8_t kEncryptedBitMask = 2;
 constexpr int8_t kCheckSumBitMask = 4;
+// The CompressionKind of a compressed page written with an
+// AdaptiveCodecSelector is stored in the upper bits of the codec marker. These
+// bits are zero in the pages written by Presto, whose codec is given by the
+// serde options.
+constexpr int8_t kCodecKindShift = 4;
+constexpr int8_t kCodecKindMask = 0x70;
 // uncompressed size comes after the number of rows and the codec
 constexpr int32_t kSizeInBytesOffset{4 + 1};
 // There header for a page is:
@@ -57,6 +64,11 @@ static inline const std::string_view kDictionary{"DICTIONARY"};
 
 void initBitsToMapOnce();
 
+/// Returns the Presto options in 'options', or the defaults if null. Throws if
+/// 'options' are not PrestoOptions.
+PrestoVectorSerde::PrestoOptions toPrestoOptions(
+    const VectorSerde::Options* options);
+
 FOLLY_ALWAYS_INLINE std::array<int8_t, ipaddress::kIPPrefixBytes>
 toJavaIPPrefixType(int128_t currentIpBytes, int8_t prefix) {
   std::array<int8_t, ipaddress::kIPPrefixBytes> byteArray{{0}};
@@ -356,6 +368,96 @@ inline FlushSizes flushStreams(
   }
 }
 
+// Writes a page compressed with the codec chosen by 'selector' and records the
+// codec in the page header. Sampled pages are compressed with all the codecs to
+// update the estimates of 'selector'.
+template <typename Allocator>
+inline FlushSizes flushAdaptive(
+    std::vector<VectorStream, Allocator>& streams,
+    int32_t numRows,
+    const StreamArena& arena,
+    AdaptiveCodecSelector& selector,
+    float minCompressionRatio,
+    OutputStream* output) {
+  using Codec = AdaptiveCodecSelector::Codec;
+  auto listener = dynamic_cast<PrestoOutputStreamListener*>(output->listener());
+  char codecMask = 0;
+  if (listener) {
+    // Reset and pause CRC computation.
+    listener->reset();
+    listener->pause();
+    codecMask |= kCheckSumBitMask;
+  }
+
+  writeInt32(output, numRows);
+
+  IOBufOutputStream out(*(arena.pool()), nullptr, arena.size());
+  writeInt32(&out, streams.size());
+
+  for (auto& stream : streams) {
+    stream.flush(&out);
+  }
+
+  const int32_t uncompressedSize = out.tellp();
+  auto iobuf = out.getIOBuf();
+
+  const auto compress = [&](Codec codec) {
+    const auto follyCodec = selector.makeCodec(codec);
+    VELOX_CHECK_LE(
+        uncompressedSize,
+        follyCodec->maxUncompressedLength(),
+        "UncompressedSize exceeds limit");
+    uint64_t nanos{0};
+    std::unique_ptr<folly::IOBuf> compressed;
+    {
+      NanosecondCPUTimer timer(&nanos);
+      compressed = follyCodec->compress(iobuf.get());
+    }
+    selector.recordCompression(
+        codec, uncompressedSize, compressed->computeChainDataLength(), nanos);
+    return compressed;
+  };
+
+  std::array<std::unique_ptr<folly::IOBuf>, AdaptiveCodecSelector::kNumCodecs>
+      compressedBuffers;
+  if (selector.startPage()) {
+    for (auto i = 1; i < AdaptiveCodecSelector::kNumCodecs; ++i) {
+      compressedBuffers[i] = compress(static_cast<Codec>(i));
+    }
+  }
+
+  const auto codec = selector.chooseCodec(minCompressionRatio);
+  if (codec != Codec::kNone) {
+    auto& compressedBuffer = compressedBuffers[static_cast<int32_t>(codec)];
+    if (compressedBuffer == nullptr) {
+      compressedBuffer = compress(codec);
+    }
+    const int32_t compressedSize = compressedBuffer->computeChainDataLength();
+    if (compressedSize <= uncompressedSize * minCompressionRatio) {
+      codecMask |= kCompressedBitMask |
+          (AdaptiveCodecSelector::compressionKind(codec) << kCodecKindShift);
+      flushSerialization(
+          numRows,
+          uncompressedSize,
+          compressedSize,
+          codecMask,
+          compressedBuffer,
+          output,
+          listener);
+      return {uncompressedSize, compressedSize};
+    }
+  }
+  flushSerialization(
+      numRows,
+      uncompressedSize,
+      uncompressedSize,
+      codecMask,
+      iobuf,
+      output,
+      listener);
+  return {uncompressedSize, uncompressedSize};
+}
+
 void serializeColumn(
     const VectorPtr& vector,
     const folly::Range<const IndexRange*>& ranges,
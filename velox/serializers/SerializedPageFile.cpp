@@ -29,12 +29,24 @@ std::unique_ptr<SerializedPageFile> SerializedPageFile::create(
       new SerializedPageFile(id, pathPrefix, fileCreateConfig, ioStats));
 }
 
+std::unique_ptr<SerializedPageFile> SerializedPageFile::create(
+    uint32_t id,
+    std::string path,
+    std::unique_ptr<WriteFile> file) {
+  return std::unique_ptr<SerializedPageFile>(
+      new SerializedPageFile(id, std::move(path), std::move(file)));
+}
+
+std::string SerializedPageFile::makePath(const std::string& pathPrefix) {
+  return fmt::format("{}-{}", pathPrefix, ordinalCounter_++);
+}
+
 SerializedPageFile::SerializedPageFile(
     uint32_t id,
     const std::string& pathPrefix,
     const std::string& fileCreateConfig,
     IoStats* ioStats)
-    : id_(id), path_(fmt::format("{}-{}", pathPrefix, ordinalCounter_++)) {
+    : id_(id), path_(makePath(pathPrefix)) {
   auto fs = filesystems::getFileSystem(path_, nullptr);
   file_ = fs->openFileForWrite(
       path_,
@@ -45,6 +57,14 @@ SerializedPageFile::SerializedPageFile(
           .stats = ioStats});
 }
 
+SerializedPageFile::SerializedPageFile(
+    uint32_t id,
+    std::string path,
+    std::unique_ptr<WriteFile> file)
+    : id_(id), path_(std::move(path)), file_(std::move(file)) {
+  VELOX_CHECK_NOT_NULL(file_);
+}
+
 void SerializedPageFile::finish() {
   VELOX_CHECK_NOT_NULL(file_);
   size_ = file_->size();
@@ -88,15 +108,22 @@ SerializedPageFile* SerializedPageFileWriter::ensureFile() {
     closeFile();
   }
   if (currentFile_ == nullptr) {
-    currentFile_ = SerializedPageFile::create(
-        nextFileId_++,
-        fmt::format("{}-{}", pathPrefix_, finishedFiles_.size()),
-        fileCreateConfig_,
-        ioStats_);
+    currentFile_ = createFile(nextFileId_++, nextFilePathPrefix());
   }
   return currentFile_.get();
 }
 
+std::unique_ptr<SerializedPageFile> SerializedPageFileWriter::createFile(
+    uint32_t id,
+    const std::string& pathPrefix) {
+  return SerializedPageFile::create(
+      id, pathPrefix, fileCreateConfig_, ioStats_);
+}
+
+std::string SerializedPageFileWriter::nextFilePathPrefix() {
+  return fmt::format("{}-{}", pathPrefix_, finishedFiles_.size());
+}
+
 void SerializedPageFileWriter::closeFile() {
   if (currentFile_ == nullptr) {
     return;
@@ -190,17 +217,36 @@ SerializedPageFileReader::SerializedPageFileReader(
     VectorSerde* serde,
     std::unique_ptr<VectorSerde::Options> readOptions,
     memory::MemoryPool* pool,
-    IoStats* ioStats)
+    IoStats* ioStats,
+    folly::Executor* readAheadExecutor)
+    : SerializedPageFileReader(
+          filesystems::getFileSystem(path, nullptr)
+              ->openFileForRead(
+                  path, filesystems::FileOptions{.stats = ioStats}),
+          bufferSize,
+          type,
+          serde,
+          std::move(readOptions),
+          pool,
+          readAheadExecutor) {}
+
+SerializedPageFileReader::SerializedPageFileReader(
+    std::unique_ptr<ReadFile> file,
+    uint64_t bufferSize,
+    const RowTypePtr& type,
+    VectorSerde* serde,
+    std::unique_ptr<VectorSerde::Options> readOptions,
+    memory::MemoryPool* pool,
+    folly::Executor* readAheadExecutor)
     : readOptions_(std::move(readOptions)),
       pool_(pool),
       serde_(serde),
-      type_(type) {
-  auto fs = filesystems::getFileSystem(path, nullptr);
-  auto file =
-      fs->openFileForRead(path, filesystems::FileOptions{.stats = ioStats});
-  input_ = std::make_unique<common::FileInputStream>(
-      std::move(file), bufferSize, pool_);
-}
+      type_(type),
+      input_(std::make_unique<common::FileInputStream>(
+          std::move(file),
+          bufferSize,
+          pool_,
+          readAheadExecutor)) {}
 
 bool SerializedPageFileReader::nextBatch(RowVectorPtr& rowVector) {
   if (input_->atEnd()) {
@@ -41,6 +41,14 @@ class SerializedPageFile {
       const std::string& fileCreateConfig,
       IoStats* ioStats);
 
+  /// Creates a file with 'path' that writes to 'file' instead of a file
+  /// opened on the file system of 'path'.
+  static std::unique_ptr<SerializedPageFile>
+  create(uint32_t id, std::string path, std::unique_ptr<WriteFile> file);
+
+  /// Returns a new unique file path with 'pathPrefix'.
+  static std::string makePath(const std::string& pathPrefix);
+
   uint32_t id() const {
     return id_;
   }
@@ -73,6 +81,11 @@ class SerializedPageFile {
       const std::string& fileCreateConfig,
       IoStats* ioStats);
 
+  SerializedPageFile(
+      uint32_t id,
+      std::string path,
+      std::unique_ptr<WriteFile> file);
+
   const uint32_t id_;
 
   const std::string path_;
@@ -160,6 +173,14 @@ class SerializedPageFileWriter {
   // Closes the current open file pointed by 'currentFile_'.
   virtual void closeFile();
 
+  // Returns the path prefix of the next file to create.
+  virtual std::string nextFilePathPrefix();
+
+  // Creates the file with 'id' and 'pathPrefix' to write to.
+  virtual std::unique_ptr<SerializedPageFile> createFile(
+      uint32_t id,
+      const std::string& pathPrefix);
+
   // Writes data from 'batch_' to the current output file. Returns the actual
   // written size.
   virtual uint64_t flush();
@@ -199,7 +220,8 @@ class SerializedPageFileReader {
   /// size. 'type' is the row type of the data. 'serde' is the VectorSerde
   /// instance to use. 'readOptions' specifies the deserialization options.
   /// 'pool' is used for buffering. 'ioStats' is used to collect
-  /// filesystem I/O stats such as wsServiceTime.
+  /// filesystem I/O stats such as wsServiceTime. If set, 'readAheadExecutor'
+  /// reads the next buffer ahead on file systems without async reads.
   SerializedPageFileReader(
       const std::string& path,
       uint64_t bufferSize,
@@ -207,7 +229,18 @@ class SerializedPageFileReader {
       VectorSerde* serde,
       std::unique_ptr<VectorSerde::Options> readOptions,
       memory::MemoryPool* pool,
-      IoStats* ioStats);
+      IoStats* ioStats,
+      folly::Executor* readAheadExecutor = nullptr);
+
+  /// Reads from 'file' instead of a file opened on the file system.
+  SerializedPageFileReader(
+      std::unique_ptr<ReadFile> file,
+      uint64_t bufferSize,
+      const RowTypePtr& type,
+      VectorSerde* serde,
+      std::unique_ptr<VectorSerde::Options> readOptions,
+      memory::MemoryPool* pool,
+      folly::Executor* readAheadExecutor = nullptr);
 
   virtual ~SerializedPageFileReader() = default;
 
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/serializers/AdaptiveCodecSelector.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::serializer::presto;
+
+namespace {
+
+using Codec = AdaptiveCodecSelector::Codec;
+
+class AdaptiveCodecSelectorTest : public testing::Test {
+ protected:
+  // Records typical measurements: LZ4 is the cheapest and ZSTD at the strong
+  // level has the best ratio.
+  static void recordCompressions(AdaptiveCodecSelector& selector) {
+    selector.recordCompression(Codec::kLz4, 1'000, 500, 1'000);
+    selector.recordCompression(Codec::kZstdFast, 1'000, 300, 3'000);
+    selector.recordCompression(Codec::kZstd, 1'000, 200, 10'000);
+  }
+};
+
+TEST_F(AdaptiveCodecSelectorTest, sample) {
+  AdaptiveCodecSelector selector({.sampleInterval = 4});
+  for (auto i = 0; i < 10; ++i) {
+    ASSERT_EQ(selector.startPage(), i % 4 == 0);
+  }
+  ASSERT_EQ(selector.stats().numSampledPages, 3);
+}
+
+TEST_F(AdaptiveCodecSelectorTest, chooseCodec) {
+  AdaptiveCodecSelector selector;
+  // Nothing is compressed before the codecs are measured.
+  ASSERT_EQ(selector.chooseCodec(0.8), Codec::kNone);
+
+  recordCompressions(selector);
+  ASSERT_EQ(selector.chooseCodec(0.8), Codec::kLz4);
+  // Only the codecs that reach the minimum ratio are considered.
+  ASSERT_EQ(selector.chooseCodec(0.4), Codec::kZstdFast);
+  ASSERT_EQ(selector.chooseCodec(0.25), Codec::kZstd);
+  ASSERT_EQ(selector.chooseCodec(0.1), Codec::kNone);
+
+  const auto stats = selector.stats();
+  ASSERT_EQ(stats.numPages[static_cast<int32_t>(Codec::kNone)], 2);
+  ASSERT_EQ(stats.numPages[static_cast<int32_t>(Codec::kLz4)], 1);
+  ASSERT_EQ(stats.numPages[static_cast<int32_t>(Codec::kZstdFast)], 1);
+  ASSERT_EQ(stats.numPages[static_cast<int32_t>(Codec::kZstd)], 1);
+}
+
+TEST_F(AdaptiveCodecSelectorTest, consumerBound) {
+  AdaptiveCodecSelector selector;
+  recordCompressions(selector);
+  ASSERT_FALSE(selector.consumerBound());
+
+  // The consumer becomes the bottleneck after the producer waited for it after
+  // a quarter of the recent pages.
+  selector.recordConsumerWait(true);
+  selector.recordConsumerWait(true);
+  ASSERT_FALSE(selector.consumerBound());
+  ASSERT_EQ(selector.chooseCodec(0.8), Codec::kLz4);
+  selector.recordConsumerWait(true);
+  ASSERT_TRUE(selector.consumerBound());
+  ASSERT_EQ(selector.chooseCodec(0.8), Codec::kZstd);
+
+  for (auto i = 0; i < 10; ++i) {
+    selector.recordConsumerWait(false);
+  }
+  ASSERT_FALSE(selector.consumerBound());
+  ASSERT_EQ(selector.chooseCodec(0.8), Codec::kLz4);
+}
+
+TEST_F(AdaptiveCodecSelectorTest, movingAverage) {
+  AdaptiveCodecSelector selector;
+  recordCompressions(selector);
+  ASSERT_EQ(selector.chooseCodec(0.8), Codec::kLz4);
+
+  // LZ4 stops compressing the data while ZSTD still does.
+  for (auto i = 0; i < 10; ++i) {
+    selector.recordCompression(Codec::kLz4, 1'000, 1'000, 1'000);
+  }
+  ASSERT_EQ(selector.chooseCodec(0.8), Codec::kZstdFast);
+}
+
+TEST_F(AdaptiveCodecSelectorTest, codecs) {
+  AdaptiveCodecSelector selector;
+  ASSERT_EQ(
+      selector.makeCodec(Codec::kNone)->type(),
+      folly::compression::CodecType::NO_COMPRESSION);
+  ASSERT_EQ(
+      selector.makeCodec(Codec::kLz4)->type(),
+      folly::compression::CodecType::LZ4);
+  ASSERT_EQ(
+      selector.makeCodec(Codec::kZstdFast)->type(),
+      folly::compression::CodecType::ZSTD);
+  ASSERT_EQ(
+      selector.makeCodec(Codec::kZstd)->type(),
+      folly::compression::CodecType::ZSTD);
+
+  ASSERT_EQ(
+      AdaptiveCodecSelector::compressionKind(Codec::kLz4),
+      common::CompressionKind_LZ4);
+  ASSERT_EQ(
+      AdaptiveCodecSelector::compressionKind(Codec::kZstdFast),
+      common::CompressionKind_ZSTD);
+  ASSERT_EQ(AdaptiveCodecSelector::toName(Codec::kZstdFast), "ZSTD_FAST");
+}
+
+} // namespace
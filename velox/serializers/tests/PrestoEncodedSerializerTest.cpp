@@ -0,0 +1,291 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/serializers/PrestoEncodedSerializer.h"
+
+#include <gtest/gtest.h>
+#include <numeric>
+
+#include "velox/common/memory/ByteStream.h"
+#include "velox/vector/tests/utils/VectorTestBase.h"
+
+namespace facebook::velox::serializer::presto {
+namespace {
+
+class PrestoEncodedSerializerTest : public ::testing::Test,
+                                    public velox::test::VectorTestBase {
+ protected:
+  static void SetUpTestCase() {
+    memory::MemoryManager::testingSetInstance(memory::MemoryManager::Options{});
+    PrestoVectorSerde::tryRegisterNamedVectorSerde();
+    PrestoEncodedVectorSerde::tryRegisterNamedVectorSerde();
+  }
+
+  static VectorSerde* serde() {
+    return getNamedVectorSerde(PrestoEncodedVectorSerde::name());
+  }
+
+  // Returns 'size' rows with a dictionary encoded, a constant and a flat
+  // column.
+  RowVectorPtr makeInput(vector_size_t size, int64_t constant) {
+    return makeRowVector({
+        wrapInDictionary(
+            makeIndices(size, [](auto row) { return row % 3; }),
+            size,
+            makeFlatVector<std::string>(
+                {"dimension 1", "dimension 2", "dimension 3"})),
+        makeConstant<int64_t>(constant, size),
+        makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+    });
+  }
+
+  // Serializes 'rows' of 'vectors[i]' for each i with one serializer.
+  std::string serialize(
+      const std::vector<RowVectorPtr>& vectors,
+      const std::vector<std::vector<vector_size_t>>& rows,
+      const PrestoVectorSerde::PrestoOptions& options) {
+    StreamArena arena(pool());
+    auto serializer = serde()->createIterativeSerializer(
+        asRowType(vectors[0]->type()), 0, &arena, &options);
+    Scratch scratch;
+    for (auto i = 0; i < vectors.size(); ++i) {
+      serializer->append(
+          vectors[i],
+          folly::Range<const vector_size_t*>(rows[i].data(), rows[i].size()),
+          scratch);
+    }
+    const auto size = serializer->maxSerializedSize();
+    std::ostringstream output;
+    PrestoOutputStreamListener listener;
+    OStreamOutputStream out(&output, &listener);
+    serializer->flush(&out);
+    EXPECT_EQ(size, output.str().size());
+    return output.str();
+  }
+
+  // Deserializes each page in 'data' with 'serdeKind' into a new vector.
+  std::vector<RowVectorPtr> deserialize(
+      const std::string& data,
+      const RowTypePtr& type,
+      const std::string& serdeKind,
+      const PrestoVectorSerde::PrestoOptions& options) {
+    ByteRange byteRange{
+        reinterpret_cast<uint8_t*>(const_cast<char*>(data.data())),
+        static_cast<int32_t>(data.size()),
+        0};
+    BufferInputStream input(std::vector<ByteRange>{byteRange});
+    std::vector<RowVectorPtr> pages;
+    while (!input.atEnd()) {
+      RowVectorPtr result;
+      getNamedVectorSerde(serdeKind)->deserialize(
+          &input, pool(), type, &result, 0, &options);
+      pages.push_back(std::move(result));
+    }
+    return pages;
+  }
+
+  static std::vector<vector_size_t> allRows(vector_size_t size) {
+    std::vector<vector_size_t> rows(size);
+    std::iota(rows.begin(), rows.end(), 0);
+    return rows;
+  }
+};
+
+TEST_F(PrestoEncodedSerializerTest, kind) {
+  ASSERT_EQ(serde()->kind(), "PrestoEncoded");
+  ASSERT_TRUE(serde()->preservesEncodings());
+  ASSERT_TRUE(serde()->supportsAppendInDeserialize());
+  ASSERT_FALSE(
+      getNamedVectorSerde(PrestoVectorSerde::name())->preservesEncodings());
+  ASSERT_EQ(
+      VectorSerde::kindByName("PrestoEncoded"),
+      VectorSerde::Kind::kPrestoEncoded);
+  ASSERT_EQ(
+      VectorSerde::kindName(VectorSerde::Kind::kPrestoEncoded),
+      "PrestoEncoded");
+}
+
+TEST_F(PrestoEncodedSerializerTest, keepsEncodings) {
+  const auto input = makeInput(1'000, 7);
+  const auto rowType = asRowType(input->type());
+  for (const auto compressionKind :
+       {common::CompressionKind::CompressionKind_NONE,
+        common::CompressionKind::CompressionKind_LZ4}) {
+    SCOPED_TRACE(common::compressionKindToString(compressionKind));
+    PrestoVectorSerde::PrestoOptions options(false, compressionKind);
+    const auto data = serialize({input}, {allRows(input->size())}, options);
+    // The pages are read by both serdes.
+    for (const auto& serdeKind :
+         {PrestoEncodedVectorSerde::name(), PrestoVectorSerde::name()}) {
+      const auto pages = deserialize(data, rowType, serdeKind, options);
+      ASSERT_EQ(pages.size(), 1);
+      const auto& result = pages[0];
+      ASSERT_EQ(
+          result->childAt(0)->encoding(), VectorEncoding::Simple::DICTIONARY);
+      ASSERT_EQ(
+          result->childAt(1)->encoding(), VectorEncoding::Simple::CONSTANT);
+      ASSERT_EQ(result->childAt(2)->encoding(), VectorEncoding::Simple::FLAT);
+      test::assertEqualVectors(input, result);
+    }
+  }
+
+  // The dictionary is smaller on the wire than the flat strings.
+  const PrestoVectorSerde::PrestoOptions options;
+  const auto flatInput = makeRowVector({
+      BaseVector::copy(*input->childAt(0)),
+      BaseVector::copy(*input->childAt(1)),
+      input->childAt(2),
+  });
+  ASSERT_LT(
+      serialize({input}, {allRows(input->size())}, options).size(),
+      serialize({flatInput}, {allRows(input->size())}, options).size());
+}
+
+TEST_F(PrestoEncodedSerializerTest, pagePerAppend) {
+  const std::vector<RowVectorPtr> inputs = {
+      makeInput(100, 1), makeInput(200, 2), makeInput(50, 3)};
+  // Non-contiguous rows, contiguous rows and no rows.
+  std::vector<std::vector<vector_size_t>> rows(3);
+  for (auto row = 0; row < 100; row += 3) {
+    rows[0].push_back(row);
+  }
+  rows[1] = allRows(150);
+
+  const PrestoVectorSerde::PrestoOptions options;
+  const auto data = serialize(inputs, rows, options);
+  const auto pages = deserialize(
+      data,
+      asRowType(inputs[0]->type()),
+      PrestoEncodedVectorSerde::name(),
+      options);
+  // Appending no rows writes no page.
+  ASSERT_EQ(pages.size(), 2);
+  for (auto i = 0; i < pages.size(); ++i) {
+    ASSERT_EQ(
+        pages[i]->childAt(0)->encoding(), VectorEncoding::Simple::DICTIONARY);
+    ASSERT_EQ(
+        pages[i]->childAt(1)->encoding(), VectorEncoding::Simple::CONSTANT);
+    test::assertEqualVectors(
+        BaseVector::wrapInDictionary(
+            nullptr,
+            makeIndices(rows[i]),
+            rows[i].size(),
+            inputs[i]),
+        pages[i]);
+  }
+
+  // A serializer without appended rows writes nothing.
+  ASSERT_TRUE(
+      serialize({inputs[2]}, {std::vector<vector_size_t>{}}, options).empty());
+}
+
+TEST_F(PrestoEncodedSerializerTest, flatRowsInOnePage) {
+  const auto flat = [&](vector_size_t size, int64_t offset) {
+    return makeRowVector({
+        makeFlatVector<std::string>(
+            size, [](auto row) { return fmt::format("dimension {}", row); }),
+        makeFlatVector<int64_t>(size, [&](auto /*row*/) { return offset; }),
+        makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+    });
+  };
+  const std::vector<RowVectorPtr> inputs = {
+      flat(100, 1), flat(50, 2), makeInput(10, 3), flat(20, 4)};
+  std::vector<std::vector<vector_size_t>> rows;
+  for (const auto& input : inputs) {
+    rows.push_back(allRows(input->size()));
+  }
+
+  const PrestoVectorSerde::PrestoOptions options;
+  const auto pages = deserialize(
+      serialize(inputs, rows, options),
+      asRowType(inputs[0]->type()),
+      PrestoEncodedVectorSerde::name(),
+      options);
+  // The rows of the flat inputs before the encoded one are in one page.
+  ASSERT_EQ(pages.size(), 3);
+  auto expected =
+      BaseVector::create<RowVector>(inputs[0]->type(), 0, pool());
+  expected->append(inputs[0].get());
+  expected->append(inputs[1].get());
+  test::assertEqualVectors(expected, pages[0]);
+  ASSERT_EQ(
+      pages[1]->childAt(0)->encoding(), VectorEncoding::Simple::DICTIONARY);
+  test::assertEqualVectors(inputs[2], pages[1]);
+  test::assertEqualVectors(inputs[3], pages[2]);
+}
+
+TEST_F(PrestoEncodedSerializerTest, compressionStats) {
+  const auto flat = makeRowVector({makeFlatVector<int64_t>({1, 2, 3})});
+  const auto encoded = makeRowVector({wrapInDictionary(
+      makeIndices(1'000, [](auto row) { return row % 500; }),
+      1'000,
+      makeFlatVector<int64_t>(500, [](auto row) { return row; }))});
+  const auto stats = [&](common::CompressionKind compressionKind,
+                         bool appendEncoded) {
+    const PrestoVectorSerde::PrestoOptions options(false, compressionKind);
+    StreamArena arena(pool());
+    auto serializer = serde()->createIterativeSerializer(
+        asRowType(flat->type()), 0, &arena, &options);
+    // Small flat batches are compressed together.
+    for (auto i = 0; i < 1'000; ++i) {
+      serializer->append(flat);
+    }
+    if (appendEncoded) {
+      serializer->append(encoded);
+    }
+    std::ostringstream output;
+    OStreamOutputStream out(&output);
+    serializer->flush(&out);
+    return serializer->runtimeStats();
+  };
+  const auto inputBytes =
+      [](const std::unordered_map<std::string, RuntimeCounter>& stats) {
+        return stats
+            .at(std::string(IterativeVectorSerializer::kCompressionInputBytes))
+            .value;
+      };
+
+  ASSERT_TRUE(
+      stats(common::CompressionKind::CompressionKind_NONE, true).empty());
+
+  const auto flatStats =
+      stats(common::CompressionKind::CompressionKind_LZ4, false);
+  ASSERT_EQ(
+      flatStats.count(
+          std::string(IterativeVectorSerializer::kCompressionSkippedBytes)),
+      0);
+  ASSERT_LT(
+      flatStats.at(std::string(IterativeVectorSerializer::kCompressedBytes))
+          .value,
+      inputBytes(flatStats) * 0.8);
+
+  // The page of the encoded input adds to the stats.
+  const auto allStats =
+      stats(common::CompressionKind::CompressionKind_LZ4, true);
+  ASSERT_GT(inputBytes(allStats), inputBytes(flatStats));
+}
+
+TEST_F(PrestoEncodedSerializerTest, clear) {
+  const auto input = makeInput(10, 1);
+  StreamArena arena(pool());
+  auto serializer =
+      serde()->createIterativeSerializer(asRowType(input->type()), 0, &arena);
+  serializer->append(input);
+  ASSERT_GT(serializer->maxSerializedSize(), 0);
+  serializer->clear();
+  ASSERT_EQ(serializer->maxSerializedSize(), 0);
+}
+} // namespace
+} // namespace facebook::velox::serializer::presto
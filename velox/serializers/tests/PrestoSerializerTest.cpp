@@ -25,6 +25,7 @@
 #include "velox/functions/prestosql/types/IPPrefixType.h"
 #include "velox/functions/prestosql/types/TimestampWithTimeZoneType.h"
 #include "velox/serializers/PrestoBatchVectorSerializer.h"
+#include "velox/serializers/PrestoSerializerDeserializationUtils.h"
 #include "velox/serializers/PrestoVectorLexer.h"
 #include "velox/vector/fuzzer/VectorFuzzer.h"
 #include "velox/vector/tests/utils/VectorTestBase.h"
@@ -1894,6 +1895,58 @@ TEST_P(PrestoSerializerTest, minCompressionPageSizeBytesAtBoundary) {
   EXPECT_EQ(stats.count("compressionSkippedBytes"), 0);
 }
 
+TEST_P(PrestoSerializerTest, adaptiveCompression) {
+  using AdaptiveCodecSelector = serializer::presto::AdaptiveCodecSelector;
+  auto options = getParamSerdeOptions(nullptr);
+  auto selector = std::make_shared<AdaptiveCodecSelector>(
+      AdaptiveCodecSelector::Options{.sampleInterval = 4});
+  options.codecSelector = selector;
+
+  // Writes each page with a new serializer sharing 'selector', as the
+  // destinations of a PartitionedOutput do.
+  facebook::velox::serializer::presto::PrestoOutputStreamListener listener;
+  std::vector<RowVectorPtr> testVectors;
+  std::vector<std::string> pages;
+  for (auto i = 0; i < 10; ++i) {
+    auto rowVector = makeTestVector(1'000 + i);
+    auto arena = std::make_unique<StreamArena>(pool_.get());
+    auto serializer = serde_->createIterativeSerializer(
+        asRowType(rowVector->type()), rowVector->size(), arena.get(), &options);
+    serializer->append(rowVector);
+    std::ostringstream output;
+    OStreamOutputStream out(&output, &listener);
+    serializer->flush(&out);
+    ASSERT_GT(serializer->runtimeStats().count("compressionInputBytes"), 0);
+    testVectors.push_back(std::move(rowVector));
+    pages.push_back(output.str());
+  }
+
+  const auto stats = selector->stats();
+  ASSERT_EQ(stats.numSampledPages, 3);
+  ASSERT_EQ(
+      stats.numPages[static_cast<int32_t>(AdaptiveCodecSelector::Codec::kNone)],
+      0);
+
+  // The pages record their codec and are read regardless of the compression
+  // kind of the reader.
+  const auto readOptions = getParamSerdeOptions(nullptr);
+  for (auto i = 0; i < pages.size(); ++i) {
+    const auto codecMarker = static_cast<int8_t>(pages[i][4]);
+    ASSERT_TRUE(serializer::presto::detail::isCompressedBitSet(codecMarker));
+    ASSERT_TRUE(serializer::presto::detail::codecKind(codecMarker).has_value());
+    auto byteStream = toByteStream(pages[i]);
+    RowVectorPtr deserialized;
+    serde_->deserialize(
+        byteStream.get(),
+        pool_.get(),
+        asRowType(testVectors[i]->type()),
+        &deserialized,
+        0,
+        &readOptions);
+    assertEqualVectors(testVectors[i], deserialized);
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     PrestoSerializerTest,
     PrestoSerializerTest,
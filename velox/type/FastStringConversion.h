@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+
+#include "velox/type/FastDate.h"
+#include "velox/type/Timestamp.h"
+#include "velox/type/TimestampConversion.h"
+
+/// Fast parsers for the common, canonical spellings of integers, ISO dates and
+/// ISO timestamps. Digits are validated and converted 8 bytes at a time within
+/// a 64-bit word. The parsers accept only a strict subset of what the regular
+/// casts in Conversions.h and TimestampConversion.h accept, and return
+/// std::nullopt for anything else, including invalid input. Callers fall back
+/// to the regular cast for those rows, which keeps error reporting and TRY
+/// semantics unchanged.
+namespace facebook::velox::util::fast {
+
+namespace detail {
+
+inline constexpr uint64_t kZeros = 0x3030303030303030ULL;
+
+inline uint64_t load8(const char* data) {
+  uint64_t word;
+  std::memcpy(&word, data, sizeof(word));
+  return word;
+}
+
+/// Loads 'size' <= 8 bytes into the high bytes of a word and fills the low
+/// bytes with '0'. The result parses as the same number as the input.
+inline uint64_t loadPadded(const char* data, size_t size) {
+  uint64_t word = kZeros;
+  std::memcpy(reinterpret_cast<char*>(&word) + (8 - size), data, size);
+  return word;
+}
+
+/// Returns true if all 8 bytes of 'word' are ASCII digits.
+inline bool allDigits(uint64_t word) {
+  return (((word & 0xF0F0F0F0F0F0F0F0ULL) |
+           (((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+          0x3333333333333333ULL);
+}
+
+/// Converts 8 ASCII digits in memory order to their value. 'word' must
+/// satisfy allDigits().
+inline uint32_t parse8Digits(uint64_t word) {
+  word = ((word & 0x0F0F0F0F0F0F0F0FULL) * 2561) >> 8;
+  word = ((word & 0x00FF00FF00FF00FFULL) * 6553601) >> 16;
+  return static_cast<uint32_t>(
+      ((word & 0x0000FFFF0000FFFFULL) * 42949672960001ULL) >> 32);
+}
+
+/// Parses exactly 2 ASCII digits. Returns -1 if either is not a digit.
+inline int32_t parse2Digits(const char* data) {
+  const auto high = static_cast<uint8_t>(data[0] - '0');
+  const auto low = static_cast<uint8_t>(data[1] - '0');
+  if (high > 9 || low > 9) {
+    return -1;
+  }
+  return high * 10 + low;
+}
+
+/// Parses 'YYYY-MM-DD' at 'data' into days since epoch.
+inline std::optional<int32_t> parseDate(const char* data) {
+  // 'YYYY-MM-' with the dashes replaced by '0' must be all digits.
+  constexpr uint64_t kDashes = 0xFF0000FF00000000ULL;
+  if (data[4] != '-' || data[7] != '-') {
+    return std::nullopt;
+  }
+  const auto digits = (load8(data) & ~kDashes) | (kZeros & kDashes);
+  if (!allDigits(digits)) {
+    return std::nullopt;
+  }
+  // The value of 'YYYY0MM0' is YYYY * 10'000 + MM * 10.
+  const auto value = parse8Digits(digits);
+  const int32_t year = value / 10'000;
+  const int32_t month = value % 10'000 / 10;
+  const int32_t day = parse2Digits(data + 8);
+  if (year == 0 || month < 1 || month > 12 || day < 1 ||
+      day > util::getMaxDayOfMonth(year, month)) {
+    return std::nullopt;
+  }
+  return ymdToDays(year, month, day);
+}
+
+} // namespace detail
+
+/// Parses '[-]d+' with at most 18 digits into an integer of type T. Returns
+/// std::nullopt if the input has any other form or does not fit in T.
+template <typename T>
+inline std::optional<T> parseInteger(const char* data, size_t size) {
+  static_assert(std::is_integral_v<T> && std::is_signed_v<T>);
+  const bool negative = size > 0 && data[0] == '-';
+  if (negative) {
+    ++data;
+    --size;
+  }
+  if (size == 0 || size > 18) {
+    return std::nullopt;
+  }
+
+  // Leading chunk of 1-8 digits, then whole 8 digit chunks.
+  const size_t head = size % 8 == 0 ? 8 : size % 8;
+  auto word = detail::loadPadded(data, head);
+  if (!detail::allDigits(word)) {
+    return std::nullopt;
+  }
+  int64_t value = detail::parse8Digits(word);
+  for (size_t i = head; i < size; i += 8) {
+    word = detail::load8(data + i);
+    if (!detail::allDigits(word)) {
+      return std::nullopt;
+    }
+    value = value * 100'000'000 + detail::parse8Digits(word);
+  }
+
+  if (negative) {
+    value = -value;
+  }
+  if (value < std::numeric_limits<T>::min() ||
+      value > std::numeric_limits<T>::max()) {
+    return std::nullopt;
+  }
+  return static_cast<T>(value);
+}
+
+/// Parses 'YYYY-MM-DD' with a 4 digit year into days since epoch. Returns
+/// std::nullopt if the input has any other form or is not a valid date.
+inline std::optional<int32_t> parseDate(const char* data, size_t size) {
+  if (size != 10) {
+    return std::nullopt;
+  }
+  return detail::parseDate(data);
+}
+
+/// Parses 'YYYY-MM-DD HH:MM:SS' or 'YYYY-MM-DD HH:MM:SS.fff' with a 4 digit
+/// year. The result is in the time zone of the input, i.e. not adjusted to
+/// GMT. Returns std::nullopt if the input has any other form or is not a
+/// valid timestamp.
+inline std::optional<Timestamp> parseTimestamp(const char* data, size_t size) {
+  if ((size != 19 && size != 23) || data[10] != ' ' || data[13] != ':' ||
+      data[16] != ':') {
+    return std::nullopt;
+  }
+  const auto days = detail::parseDate(data);
+  if (!days.has_value()) {
+    return std::nullopt;
+  }
+  const auto hour = detail::parse2Digits(data + 11);
+  const auto minute = detail::parse2Digits(data + 14);
+  const auto second = detail::parse2Digits(data + 17);
+  if (hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 ||
+      second > 59) {
+    return std::nullopt;
+  }
+  int64_t millis = 0;
+  if (size == 23) {
+    if (data[19] != '.') {
+      return std::nullopt;
+    }
+    // Pad '.fff' to '0000.fff', then make the '.' a '0'.
+    auto word = detail::loadPadded(data + 19, 4);
+    constexpr uint64_t kDot = 0x000000FF00000000ULL;
+    word = (word & ~kDot) | (detail::kZeros & kDot);
+    if (!detail::allDigits(word)) {
+      return std::nullopt;
+    }
+    millis = detail::parse8Digits(word);
+  }
+  const int64_t seconds =
+      static_cast<int64_t>(days.value()) * 86'400 + hour * 3'600 + minute * 60 +
+      second;
+  return Timestamp(seconds, millis * 1'000'000);
+}
+
+} // namespace facebook::velox::util::fast
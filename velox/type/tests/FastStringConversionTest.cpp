@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/type/FastStringConversion.h"
+
+#include <gtest/gtest.h>
+#include <random>
+
+#include "velox/type/Conversions.h"
+
+namespace facebook::velox::util::fast {
+namespace {
+
+template <typename T>
+std::optional<T> parseInteger(std::string_view str) {
+  return fast::parseInteger<T>(str.data(), str.size());
+}
+
+std::optional<int32_t> parseDate(std::string_view str) {
+  return fast::parseDate(str.data(), str.size());
+}
+
+std::optional<Timestamp> parseTimestamp(std::string_view str) {
+  return fast::parseTimestamp(str.data(), str.size());
+}
+
+TEST(FastStringConversionTest, integer) {
+  EXPECT_EQ(parseInteger<int64_t>("0"), 0);
+  EXPECT_EQ(parseInteger<int64_t>("-0"), 0);
+  EXPECT_EQ(parseInteger<int64_t>("7"), 7);
+  EXPECT_EQ(parseInteger<int64_t>("-12345678"), -12345678);
+  EXPECT_EQ(parseInteger<int64_t>("123456789"), 123456789);
+  EXPECT_EQ(parseInteger<int64_t>("0000000042"), 42);
+  EXPECT_EQ(
+      parseInteger<int64_t>("999999999999999999"), 999'999'999'999'999'999);
+  EXPECT_EQ(
+      parseInteger<int64_t>("-123456789012345678"), -123'456'789'012'345'678);
+  EXPECT_EQ(parseInteger<int8_t>("127"), 127);
+  EXPECT_EQ(parseInteger<int8_t>("-128"), -128);
+  EXPECT_EQ(parseInteger<int32_t>("-2147483648"), -2147483648);
+
+  // Out of range for the type. Left to the regular cast.
+  EXPECT_EQ(parseInteger<int8_t>("128"), std::nullopt);
+  EXPECT_EQ(parseInteger<int16_t>("-32769"), std::nullopt);
+  EXPECT_EQ(parseInteger<int32_t>("2147483648"), std::nullopt);
+
+  // Not in canonical form.
+  EXPECT_EQ(parseInteger<int64_t>(""), std::nullopt);
+  EXPECT_EQ(parseInteger<int64_t>("-"), std::nullopt);
+  EXPECT_EQ(parseInteger<int64_t>("+1"), std::nullopt);
+  EXPECT_EQ(parseInteger<int64_t>(" 1"), std::nullopt);
+  EXPECT_EQ(parseInteger<int64_t>("1 "), std::nullopt);
+  EXPECT_EQ(parseInteger<int64_t>("1.0"), std::nullopt);
+  EXPECT_EQ(parseInteger<int64_t>("12345678a"), std::nullopt);
+  EXPECT_EQ(parseInteger<int64_t>("1234567/9"), std::nullopt);
+  EXPECT_EQ(parseInteger<int64_t>("1234567:9"), std::nullopt);
+  EXPECT_EQ(parseInteger<int64_t>("1000000000000000000"), std::nullopt);
+}
+
+TEST(FastStringConversionTest, integerMatchesRegularCast) {
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int64_t> values(
+      -999'999'999'999'999'999, 999'999'999'999'999'999);
+  std::uniform_int_distribution<int> shifts(0, 60);
+  for (auto i = 0; i < 10'000; ++i) {
+    const auto value = values(rng) >> shifts(rng);
+    const auto str = std::to_string(value);
+    const auto expected =
+        Converter<TypeKind::BIGINT>::tryCast(StringView(str));
+    ASSERT_FALSE(expected.hasError()) << str;
+    ASSERT_EQ(parseInteger<int64_t>(str), expected.value()) << str;
+
+    const auto narrow = Converter<TypeKind::INTEGER>::tryCast(StringView(str));
+    const auto fast = parseInteger<int32_t>(str);
+    if (narrow.hasError()) {
+      ASSERT_EQ(fast, std::nullopt) << str;
+    } else {
+      ASSERT_EQ(fast, narrow.value()) << str;
+    }
+  }
+}
+
+TEST(FastStringConversionTest, date) {
+  EXPECT_EQ(parseDate("1970-01-01"), 0);
+  EXPECT_EQ(parseDate("1969-12-31"), -1);
+  EXPECT_EQ(parseDate("2024-02-29"), 19'782);
+  EXPECT_EQ(parseDate("0001-01-01"), -719'162);
+  EXPECT_EQ(parseDate("9999-12-31"), 2'932'896);
+
+  EXPECT_EQ(parseDate("2023-02-29"), std::nullopt);
+  EXPECT_EQ(parseDate("2024-13-01"), std::nullopt);
+  EXPECT_EQ(parseDate("2024-00-01"), std::nullopt);
+  EXPECT_EQ(parseDate("2024-01-00"), std::nullopt);
+  EXPECT_EQ(parseDate("2024-01-32"), std::nullopt);
+  EXPECT_EQ(parseDate("2024/01/01"), std::nullopt);
+  EXPECT_EQ(parseDate("2024-1-01 "), std::nullopt);
+  EXPECT_EQ(parseDate("202a-01-01"), std::nullopt);
+  EXPECT_EQ(parseDate("2024-01-0a"), std::nullopt);
+  EXPECT_EQ(parseDate("2024-01-1"), std::nullopt);
+  EXPECT_EQ(parseDate(" 2024-01-01"), std::nullopt);
+  EXPECT_EQ(parseDate("-2024-01-01"), std::nullopt);
+}
+
+TEST(FastStringConversionTest, dateMatchesRegularCast) {
+  for (int32_t days = -800'000; days < 3'000'000; days += 7) {
+    const auto ymd = daysToYmd(days);
+    if (ymd.year < 1 || ymd.year > 9999) {
+      continue;
+    }
+    const auto str =
+        fmt::format("{:04d}-{:02d}-{:02d}", ymd.year, ymd.month, ymd.day);
+    const auto expected =
+        fromDateString(str.data(), str.size(), ParseMode::kPrestoCast);
+    ASSERT_FALSE(expected.hasError()) << str;
+    ASSERT_EQ(parseDate(str), expected.value()) << str;
+  }
+}
+
+TEST(FastStringConversionTest, timestamp) {
+  EXPECT_EQ(parseTimestamp("1970-01-01 00:00:00"), Timestamp(0, 0));
+  EXPECT_EQ(parseTimestamp("1969-12-31 23:59:59"), Timestamp(-1, 0));
+  EXPECT_EQ(
+      parseTimestamp("2024-05-01 12:34:56.789"),
+      Timestamp(1714566896, 789'000'000));
+  EXPECT_EQ(
+      parseTimestamp("2024-05-01 12:34:56.007"),
+      Timestamp(1714566896, 7'000'000));
+
+  EXPECT_EQ(parseTimestamp("2024-05-01"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2024-05-01T12:34:56"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2024-05-01 24:00:00"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2024-05-01 12:60:00"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2024-05-01 12:00:60"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2024-05-01 12:00:0a"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2024-05-01 12:00:00.1"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2024-05-01 12:00:00,123"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2024-05-01 12:00:00.12a"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2024-05-01 12:00:00.123456"), std::nullopt);
+  EXPECT_EQ(parseTimestamp("2024-02-30 12:00:00"), std::nullopt);
+}
+
+TEST(FastStringConversionTest, timestampMatchesRegularCast) {
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int64_t> seconds(
+      -62'135'596'800, 253'402'300'799);
+  std::uniform_int_distribution<int32_t> millis(0, 999);
+  for (auto i = 0; i < 10'000; ++i) {
+    const Timestamp timestamp(seconds(rng), millis(rng) * 1'000'000);
+    const auto str = timestamp.toString(
+        {.precision = TimestampPrecision::kMilliseconds,
+         .zeroPaddingYear = true,
+         .dateTimeSeparator = ' '});
+    const auto expected = fromTimestampWithTimezoneString(
+        str.data(), str.size(), TimestampParseMode::kPrestoCast);
+    ASSERT_FALSE(expected.hasError()) << str;
+    ASSERT_EQ(parseTimestamp(str), expected.value().timestamp) << str;
+  }
+}
+
+} // namespace
+} // namespace facebook::velox::util::fast
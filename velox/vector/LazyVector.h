@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include "velox/type/Subfield.h"
 #include "velox/vector/DecodedVector.h"
 #include "velox/vector/SimpleVector.h"
 
@@ -212,6 +213,16 @@ class VectorLoader {
     return false;
   }
 
+  // Tells the loader that the consumer only accesses 'subfields' of the
+  // loaded value. Each subfield is rooted at the column being loaded, e.g.
+  // 'c0.a.b' or 'c0["k"].x' for column 'c0'. The loader may then skip
+  // decoding the parts not reached by any subfield and return nulls for them.
+  // Returns false if the hint is ignored. Must be called before load().
+  virtual bool pushdownSubfields(
+      const std::vector<common::Subfield>& /*subfields*/) {
+    return false;
+  }
+
  protected:
   friend class ChainedVectorLoader;
 
@@ -231,6 +242,11 @@ class ChainedVectorLoader : public VectorLoader {
       PostVectorLoadProcessor postLoadProc)
       : loader_(std::move(loader)), postLoadProc_(std::move(postLoadProc)) {}
 
+  bool pushdownSubfields(
+      const std::vector<common::Subfield>& subfields) override {
+    return loader_->pushdownSubfields(subfields);
+  }
+
  private:
   void loadInternal(
       RowSet rows,
@@ -381,6 +397,15 @@ class LazyVector : public BaseVector {
     return loader_->supportsHook();
   }
 
+  // Forwards 'subfields' to the loader. See VectorLoader::pushdownSubfields().
+  // Returns false if 'this' is already loaded or the loader cannot prune.
+  bool pushdownSubfields(const std::vector<common::Subfield>& subfields) {
+    if (allLoaded_) {
+      return false;
+    }
+    return loader_->pushdownSubfields(subfields);
+  }
+
   void chain(ChainedVectorLoader::PostVectorLoadProcessor postLoadProc) {
     VELOX_CHECK(!allLoaded_);
     loader_ = std::make_unique<ChainedVectorLoader>(
@@ -47,12 +47,52 @@ FOLLY_ALWAYS_INLINE int32_t toCacheIndex(const TypePtr& type) {
 
   return -1;
 }
+
+template <TypeKind kind>
+VectorPtr createInArena(
+    const TypePtr& type,
+    vector_size_t size,
+    memory::MemoryPool* pool,
+    BufferArena& arena) {
+  using T = typename TypeTraits<kind>::NativeType;
+
+  BufferPtr values;
+  if constexpr (std::is_same_v<T, StringView>) {
+    // Make sure to initialize StringView values so they can be safely accessed.
+    values = arena.allocate<T>(size, T());
+  } else {
+    values = arena.allocate<T>(size);
+  }
+  if (values == nullptr) {
+    return nullptr;
+  }
+  return std::make_shared<FlatVector<T>>(
+      pool,
+      type,
+      BufferPtr(nullptr),
+      size,
+      std::move(values),
+      std::vector<BufferPtr>());
+}
 } // namespace
 
 VectorPtr VectorPool::get(const TypePtr& type, vector_size_t size) {
   auto cacheIndex = toCacheIndex(type);
   if (cacheIndex >= 0 && size <= kMaxRecycleSize) {
-    return vectors_[cacheIndex].pop(type, size, *pool_);
+    if (auto vector = vectors_[cacheIndex].pop(size)) {
+      return vector;
+    }
+  }
+  return create(type, size);
+}
+
+VectorPtr VectorPool::create(const TypePtr& type, vector_size_t size) {
+  // Scalar type kinds are the ones up to HUGEINT.
+  if (arena_ != nullptr && type->kind() <= TypeKind::HUGEINT) {
+    if (auto vector = VELOX_DYNAMIC_SCALAR_TYPE_DISPATCH(
+            createInArena, type->kind(), type, size, pool_, *arena_)) {
+      return vector;
+    }
   }
   return BaseVector::create(type, size, pool_);
 }
@@ -69,6 +109,10 @@ bool VectorPool::release(VectorPtr& vector) {
   if (cacheIndex < 0) {
     return false;
   }
+  if (arena_ != nullptr && vector->values() != nullptr &&
+      BufferArena::isArenaBuffer(*vector->values())) {
+    return false;
+  }
   return vectors_[cacheIndex].maybePushBack(vector);
 }
 
@@ -105,10 +149,7 @@ bool VectorPool::TypePool::maybePushBack(VectorPtr& vector) {
   return true;
 }
 
-VectorPtr VectorPool::TypePool::pop(
-    const TypePtr& type,
-    vector_size_t vectorSize,
-    memory::MemoryPool& pool) {
+VectorPtr VectorPool::TypePool::pop(vector_size_t vectorSize) {
   if (size) {
     auto result = std::move(vectors[--size]);
     if (UNLIKELY(result->rawNulls() != nullptr)) {
@@ -131,7 +172,7 @@ VectorPtr VectorPool::TypePool::pop(
     }
     return result;
   }
-  return BaseVector::create(type, vectorSize, &pool);
+  return nullptr;
 }
 
 void VectorPool::TypePool::clear() {
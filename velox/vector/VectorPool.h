@@ -16,6 +16,7 @@
 #pragma once
 
 #include <folly/container/F14Map.h>
+#include "velox/buffer/BufferArena.h"
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox {
@@ -27,9 +28,20 @@ namespace facebook::velox {
 /// type, complex and custom types are not supported. Calling 'get' for an
 /// unsupported type already returns a newly allocated vector. Calling 'release'
 /// for an unsupported type is a no-op.
+///
+/// If 'arenaChunkSize' is not 0, new flat vectors of scalar types are
+/// allocated from a BufferArena with chunks of that size instead of one
+/// allocation per buffer. resetArena() lets the arena reuse the memory of the
+/// vectors of a batch once they are freed. The vectors from the arena are not
+/// recycled, so that their memory is freed with the batch.
 class VectorPool {
  public:
-  explicit VectorPool(memory::MemoryPool* pool) : pool_{pool} {}
+  explicit VectorPool(memory::MemoryPool* pool, uint64_t arenaChunkSize = 0)
+      : pool_{pool},
+        arena_{
+            arenaChunkSize > 0
+                ? std::make_unique<BufferArena>(pool, arenaChunkSize)
+                : nullptr} {}
 
   /// Gets a possibly recycled vector of 'type and 'size'. Allocates from
   /// 'pool_' if no pre-allocated vector or type is a complex type.
@@ -45,7 +57,23 @@ class VectorPool {
   /// Clears all the cached vectors.
   void clear();
 
+  /// Marks the end of a batch. No-op if there is no arena.
+  void resetArena() {
+    if (arena_ != nullptr) {
+      arena_->reset();
+    }
+  }
+
+  /// Returns the arena of new vectors, nullptr if disabled.
+  BufferArena* arena() const {
+    return arena_.get();
+  }
+
  private:
+  // Returns a new vector of 'type' and 'size', allocated from 'arena_' if
+  // possible.
+  VectorPtr create(const TypePtr& type, vector_size_t size);
+
   /// Max number of elements for a vector to be recyclable. The larger
   /// the batch the less the win from recycling.
   static constexpr vector_size_t kMaxRecycleSize = 64 * 1024;
@@ -57,16 +85,15 @@ class VectorPool {
 
     bool maybePushBack(VectorPtr& vector);
 
-    VectorPtr pop(
-        const TypePtr& type,
-        vector_size_t vectorSize,
-        memory::MemoryPool& pool);
+    /// Returns a cached vector resized to 'vectorSize', nullptr if none.
+    VectorPtr pop(vector_size_t vectorSize);
 
     /// Clears all the cached vectors.
     void clear();
   };
 
   memory::MemoryPool* const pool_;
+  const std::unique_ptr<BufferArena> arena_;
 
   static constexpr int32_t kNumCachedVectorTypes =
       static_cast<int32_t>(TypeKind::HUGEINT) + 1;
@@ -102,6 +102,8 @@ std::string VectorSerde::kindName(Kind kind) {
       return "CompactRow";
     case Kind::kUnsafeRow:
       return "UnsafeRow";
+    case Kind::kPrestoEncoded:
+      return "PrestoEncoded";
   }
   VELOX_UNREACHABLE(
       fmt::format("Unknown vector serde kind: {}", static_cast<int32_t>(kind)));
@@ -111,7 +113,8 @@ VectorSerde::Kind VectorSerde::kindByName(const std::string& kindName) {
   static const std::unordered_map<std::string, Kind> kNameToKind = {
       {"Presto", Kind::kPresto},
       {"CompactRow", Kind::kCompactRow},
-      {"UnsafeRow", Kind::kUnsafeRow}};
+      {"UnsafeRow", Kind::kUnsafeRow},
+      {"PrestoEncoded", Kind::kPrestoEncoded}};
   const auto it = kNameToKind.find(kindName);
   VELOX_CHECK(
       it != kNameToKind.end(), "Unknown vector serde kind: {}", kindName);
@@ -202,6 +205,14 @@ void VectorStreamGroup::append(const RowVectorPtr& vector) {
   serializer_->append(vector);
 }
 
+void VectorStreamGroup::appendColumn(
+    const RowVectorPtr& vector,
+    column_index_t column,
+    const folly::Range<const vector_size_t*>& rows,
+    Scratch& scratch) {
+  serializer_->appendColumn(vector, column, rows, scratch);
+}
+
 void VectorStreamGroup::append(
     const row::CompactRow& compactRow,
     const folly::Range<const vector_size_t*>& rows,
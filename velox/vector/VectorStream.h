@@ -105,6 +105,24 @@ class IterativeVectorSerializer {
     return false;
   }
 
+  /// Returns true if appendColumn() is supported.
+  virtual bool supportsAppendColumn() const {
+    return false;
+  }
+
+  /// Serializes 'rows' of the child of 'vector' at 'column'. Lets a caller
+  /// that scatters a vector over many serializers serialize one column for all
+  /// the serializers before moving to the next, which keeps the column in
+  /// cache. All the columns of 'vector' must be appended for the same 'rows',
+  /// starting with column 0, which counts the rows.
+  virtual void appendColumn(
+      const RowVectorPtr& /*vector*/,
+      column_index_t /*column*/,
+      const folly::Range<const vector_size_t*>& /*rows*/,
+      Scratch& /*scratch*/) {
+    VELOX_UNSUPPORTED("{}", __FUNCTION__);
+  }
+
   /// Returns the maximum serialized size of the data previously added via
   /// 'append' methods. Can be used to allocate buffer of exact or maximum size
   /// before calling 'flush'.
@@ -210,6 +228,7 @@ class VectorSerde {
     kPresto,
     kCompactRow,
     kUnsafeRow,
+    kPrestoEncoded,
   };
 
   static std::string kindName(Kind type);
@@ -320,6 +339,13 @@ class VectorSerde {
     return false;
   }
 
+  /// Returns true if 'deserialize' with a zero 'resultOffset' keeps the
+  /// dictionary and constant encodings of the serialized columns. Appending
+  /// more data to such a result flattens its encoded columns.
+  virtual bool preservesEncodings() const {
+    return false;
+  }
+
   /// Deserializes data from 'source' and appends to 'result' vector starting at
   /// 'resultOffset'.
   /// @param result Result vector to append new data to. Can be null only if
@@ -453,6 +479,17 @@ class VectorStreamGroup : public StreamArena {
 
   void append(const RowVectorPtr& vector);
 
+  /// See IterativeVectorSerializer::appendColumn().
+  void appendColumn(
+      const RowVectorPtr& vector,
+      column_index_t column,
+      const folly::Range<const vector_size_t*>& rows,
+      Scratch& scratch);
+
+  bool supportsAppendColumn() const {
+    return serializer_->supportsAppendColumn();
+  }
+
   void append(
       const row::CompactRow& compactRow,
       const folly::Range<const vector_size_t*>& rows,
@@ -198,4 +198,52 @@ TEST_F(VectorPoolTest, clear) {
     ASSERT_EQ(vectorPtrs[i].lock(), nullptr);
   }
 }
+
+TEST_F(VectorPoolTest, arena) {
+  VectorPool vectorPool(pool(), 1 << 20);
+  ASSERT_NE(vectorPool.arena(), nullptr);
+
+  // Flat vectors of scalar types, including ones that are not recycled, get
+  // their values from the arena.
+  const std::vector<TypePtr> types = {
+      BIGINT(), BOOLEAN(), VARCHAR(), DECIMAL(20, 2)};
+  for (const auto& type : types) {
+    SCOPED_TRACE(type->toString());
+    auto vector = vectorPool.get(type, 1'000);
+    ASSERT_EQ(vector->size(), 1'000);
+    ASSERT_TRUE(vector->isFlatEncoding());
+    ASSERT_TRUE(BufferArena::isArenaBuffer(*vector->values()));
+
+    // The vector is writable and resizable.
+    vector->setNull(0, true);
+    vector->resize(10'000);
+    ASSERT_TRUE(vector->isNullAt(0));
+
+    // Vectors from the arena are not recycled.
+    vector = vectorPool.get(type, 1'000);
+    ASSERT_FALSE(vectorPool.release(vector));
+  }
+  ASSERT_EQ(vectorPool.arena()->numChunkAllocations(), 1);
+
+  auto strings = vectorPool.get(VARCHAR(), 100);
+  for (auto i = 0; i < 100; ++i) {
+    ASSERT_TRUE(strings->as<FlatVector<StringView>>()->valueAt(i).empty());
+  }
+
+  // Complex types and vectors too large for the arena are allocated from the
+  // pool.
+  auto array = vectorPool.get(ARRAY(BIGINT()), 1'000);
+  ASSERT_EQ(array->encoding(), VectorEncoding::Simple::ARRAY);
+  auto large = vectorPool.get(BIGINT(), 20'000);
+  ASSERT_FALSE(BufferArena::isArenaBuffer(*large->values()));
+  ASSERT_TRUE(vectorPool.release(large));
+
+  // The arena reuses its memory for the next batch.
+  strings.reset();
+  vectorPool.resetArena();
+  auto* rawValues = vectorPool.get(INTEGER(), 1'000)->values()->as<char>();
+  vectorPool.resetArena();
+  ASSERT_EQ(vectorPool.get(INTEGER(), 1'000)->values()->as<char>(), rawValues);
+  ASSERT_EQ(vectorPool.arena()->numChunkAllocations(), 1);
+}
 } // namespace facebook::velox::test